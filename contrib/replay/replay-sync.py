@@ -0,0 +1,520 @@
+#!/usr/bin/env python3
+# Copyright (c) 2018 The XSN developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Replay a -capturemessages recording into a fresh xsnd and report sync figures.
+
+The recording is the message_capture/<peer> directory one node wrote for one of
+its peers. A fresh xsnd is started in an empty datadir and this script connects
+to it over loopback, standing in for that peer:
+
+- messages the peer sent are replayed in the recorded order, except for the
+  ones that only make sense on the original connection (version, ping, addr...)
+  and the ones that answered a getdata, which are served when the fresh node
+  asks for them instead,
+- before replaying what followed a sync request of the recording node
+  (getsporks, dseg, mnget, govsync...) the replay waits for the fresh node to
+  send the same request, so masternode data arrives when the node expects it.
+
+While replaying, the node is polled over RPC. At the end the script reports
+blocks/s, the ConnectBlock phase timings from getperfstats, the time each
+masternode sync stage finished and the peak RSS of xsnd.
+"""
+
+import argparse
+import base64
+import collections
+import hashlib
+import http.client
+import json
+import os
+import shutil
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+CHAINS = {
+    'main': (bytes.fromhex('bf0c6cbd'), '', []),
+    'test': (bytes.fromhex('cee2caff'), 'testnet3', ['-testnet']),
+    'regtest': (bytes.fromhex('fabfb5da'), 'regtest', ['-regtest']),
+}
+
+MSG_TYPE_MASK = 0xffffffff >> 2
+
+# inventory type -> command of the message answering a getdata for it
+INV_COMMANDS = {
+    1: 'tx', 2: 'block', 3: 'merkleblock', 4: 'cmpctblock',
+    1000: 'ix', 1001: 'txlvote', 1002: 'spork', 1003: 'mnw', 1004: 'mnwb',
+    1005: 'mnb', 1006: 'mnp', 1007: 'dstx', 1008: 'govobj', 1009: 'govobjvote',
+    1010: 'mnv', 1011: 'mrnv', 1012: 'mrnan', 1013: 'mrnp',
+}
+
+# tied to the original connection, never replayed
+SKIPPED_COMMANDS = {
+    'version', 'verack', 'ping', 'pong', 'addr', 'getaddr', 'sendheaders',
+    'sendcmpct', 'feefilter', 'reject', 'notfound', 'filterload', 'filteradd',
+    'filterclear', 'getdata', 'getheaders', 'getblocks', 'getblocktxn',
+    'mempool', 'getsporks', 'dseg', 'mnget', 'govsync', 'mrnseg', 'blocktxn',
+}
+
+# requests of the recording node whose answers are only replayed once the
+# fresh node sent the same request
+GATED_COMMANDS = {'getsporks', 'dseg', 'mnget', 'govsync', 'mrnseg', 'mempool'}
+
+MNSYNC_STAGES = [
+    ('blockchain', 'IsBlockchainSynced'),
+    ('masternode_list', 'IsMasternodeListSynced'),
+    ('winners_list', 'IsWinnersListSynced'),
+    ('finished', 'IsSynced'),
+]
+
+PERF_PREFIXES = ['connectblock.', 'connecttip.']
+
+
+def read_varint(data, pos):
+    n = data[pos]
+    if n < 0xfd:
+        return n, pos + 1
+    if n == 0xfd:
+        return struct.unpack_from('<H', data, pos + 1)[0], pos + 3
+    if n == 0xfe:
+        return struct.unpack_from('<I', data, pos + 1)[0], pos + 5
+    return struct.unpack_from('<Q', data, pos + 1)[0], pos + 9
+
+
+def parse_inv(payload):
+    count, pos = read_varint(payload, 0)
+    items = []
+    for _ in range(count):
+        inv_type, = struct.unpack_from('<I', payload, pos)
+        items.append((inv_type & MSG_TYPE_MASK, payload[pos + 4:pos + 36]))
+        pos += 36
+    return items
+
+
+def serialize_inv(items):
+    return struct.pack('<B', len(items)) + b''.join(struct.pack('<I', t) + h for t, h in items)
+
+
+class Record:
+    """One captured message, the payload stays on disk until it is needed"""
+    __slots__ = ('time', 'command', 'incoming', 'path', 'offset', 'size')
+
+    def __init__(self, time_us, command, incoming, path, offset, size):
+        self.time = time_us
+        self.command = command
+        self.incoming = incoming
+        self.path = path
+        self.offset = offset
+        self.size = size
+
+    def payload(self):
+        with open(self.path, 'rb') as f:
+            f.seek(self.offset)
+            return f.read(self.size)
+
+
+def read_capture(path, incoming):
+    records = []
+    with open(path, 'rb') as f:
+        while True:
+            header = f.read(24)
+            if len(header) < 24:
+                break
+            time_us, command, size = struct.unpack('<q12sI', header)
+            offset = f.tell()
+            f.seek(size, os.SEEK_CUR)
+            records.append(Record(time_us, command.rstrip(b'\0').decode('ascii'), incoming, path, offset, size))
+    return records
+
+
+class Recording:
+    """Captured messages of one peer, ordered as the recording node processed them"""
+
+    def __init__(self, capture_dir):
+        recv_path = os.path.join(capture_dir, 'msgs_recv.dat')
+        sent_path = os.path.join(capture_dir, 'msgs_sent.dat')
+        if not os.path.exists(recv_path):
+            raise RuntimeError('%s not found, was the node run with -capturemessages?' % recv_path)
+        records = read_capture(recv_path, True)
+        if os.path.exists(sent_path):
+            records += read_capture(sent_path, False)
+        self.records = sorted(records, key=lambda r: r.time)
+
+        # Pair every getdata the recording node sent with the answers that
+        # followed, peers answer getdata in order.
+        self.served = {}
+        self.replayed = []
+        self.version = None
+        pending = collections.defaultdict(collections.deque)
+        for r in self.records:
+            if not r.incoming:
+                if r.command == 'getdata':
+                    for inv_type, inv_hash in parse_inv(r.payload()):
+                        if inv_type in INV_COMMANDS:
+                            pending[INV_COMMANDS[inv_type]].append(inv_hash)
+                elif r.command in GATED_COMMANDS:
+                    self.replayed.append(r)
+                continue
+            if r.command == 'version' and self.version is None:
+                self.version = r.payload()
+            elif r.command == 'notfound':
+                for inv_type, inv_hash in parse_inv(r.payload()):
+                    queue = pending.get(INV_COMMANDS.get(inv_type))
+                    if queue and inv_hash in queue:
+                        queue.remove(inv_hash)
+            elif r.command == 'blocktxn':
+                # answers a getblocktxn, both start with the block hash
+                self.served[('blocktxn', r.payload()[:32])] = r
+            elif pending[r.command]:
+                self.served[(r.command, pending[r.command].popleft())] = r
+            elif r.command not in SKIPPED_COMMANDS:
+                self.replayed.append(r)
+        if self.version is None:
+            raise RuntimeError('no version message in the recording')
+
+
+class RPC:
+    def __init__(self, port, cookie_path):
+        self.port = port
+        self.cookie_path = cookie_path
+
+    def call(self, method, *params):
+        with open(self.cookie_path, 'r') as f:
+            auth = base64.b64encode(f.read().strip().encode()).decode()
+        conn = http.client.HTTPConnection('127.0.0.1', self.port, timeout=600)
+        body = json.dumps({'version': '1.1', 'method': method, 'params': list(params), 'id': 1})
+        conn.request('POST', '/', body, {'Authorization': 'Basic ' + auth, 'Content-Type': 'application/json'})
+        response = json.loads(conn.getresponse().read().decode())
+        conn.close()
+        if response.get('error'):
+            raise RuntimeError('%s: %s' % (method, response['error']))
+        return response['result']
+
+
+class Node:
+    def __init__(self, args, datadir, extra_args):
+        magic, subdir, chain_args = CHAINS[args.chain]
+        self.args = args
+        self.datadir = datadir
+        self.p2p_port = args.port
+        self.rpc = RPC(args.rpcport, os.path.join(datadir, subdir, '.cookie'))
+        self.cmd = [args.xsnd, '-datadir=' + datadir, '-server', '-listen=1', '-bind=127.0.0.1',
+                    '-port=%d' % args.port, '-rpcport=%d' % args.rpcport, '-rpcbind=127.0.0.1',
+                    '-rpcallowip=127.0.0.1', '-connect=0', '-dnsseed=0', '-discover=0', '-upnp=0',
+                    '-whitelist=127.0.0.1', '-printtoconsole=0',
+                    # recordings are older than the tip age that ends initial block download
+                    '-maxtipage=%d' % (10 * 365 * 24 * 60 * 60),
+                    # outbound masternode connections go nowhere, the replay stays offline
+                    '-proxy=127.0.0.1:1'] + chain_args + extra_args + args.xsnd_arg
+        self.process = None
+
+    def start(self):
+        self.process = subprocess.Popen(self.cmd)
+        deadline = time.time() + 120
+        while time.time() < deadline:
+            if self.process.poll() is not None:
+                raise RuntimeError('xsnd exited with code %d' % self.process.returncode)
+            try:
+                self.rpc.call('getblockcount')
+                return
+            except (OSError, RuntimeError, ValueError):
+                time.sleep(0.25)
+        raise RuntimeError('xsnd did not start')
+
+    def peak_rss_kb(self):
+        try:
+            with open('/proc/%d/status' % self.process.pid, 'r') as f:
+                for line in f:
+                    if line.startswith('VmHWM:'):
+                        return int(line.split()[1])
+        except OSError:
+            pass
+        return None
+
+    def stop(self):
+        try:
+            self.rpc.call('stop')
+        except (OSError, RuntimeError, ValueError):
+            self.process.terminate()
+        self.process.wait()
+
+
+class StandInPeer:
+    """Loopback connection to the fresh node playing the recorded peer"""
+
+    def __init__(self, magic, recording):
+        self.magic = magic
+        self.recording = recording
+        self.sock = None
+        self.send_lock = threading.Lock()
+        self.cond = threading.Condition()
+        self.received = collections.Counter()
+        self.served = 0
+        self.not_found = 0
+        self.closed = False
+
+    def connect(self, port):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        threading.Thread(target=self.receive_loop, daemon=True).start()
+        self.send('version', self.recording.version)
+        self.wait_for('verack', 1, 60)
+
+    def send(self, command, payload):
+        checksum = hashlib.sha256(hashlib.sha256(payload).digest()).digest()[:4]
+        header = self.magic + struct.pack('<12sI', command.encode('ascii'), len(payload)) + checksum
+        with self.send_lock:
+            self.sock.sendall(header + payload)
+
+    def read_exact(self, n):
+        data = b''
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise EOFError
+            data += chunk
+        return data
+
+    def receive_loop(self):
+        try:
+            while True:
+                header = self.read_exact(24)
+                command = header[4:16].rstrip(b'\0').decode('ascii')
+                size, = struct.unpack_from('<I', header, 16)
+                payload = self.read_exact(size)
+                self.process(command, payload)
+                with self.cond:
+                    self.received[command] += 1
+                    self.cond.notify_all()
+        except (EOFError, OSError):
+            with self.cond:
+                self.closed = True
+                self.cond.notify_all()
+
+    def process(self, command, payload):
+        if command == 'version':
+            self.send('verack', b'')
+        elif command == 'ping':
+            self.send('pong', payload)
+        elif command == 'getdata':
+            missing = []
+            for inv_type, inv_hash in parse_inv(payload):
+                r = self.recording.served.get((INV_COMMANDS.get(inv_type), inv_hash))
+                if r is None:
+                    missing.append((inv_type, inv_hash))
+                else:
+                    self.send(r.command, r.payload())
+                    self.served += 1
+            if missing:
+                self.not_found += len(missing)
+                for i in range(0, len(missing), 250):
+                    self.send('notfound', serialize_inv(missing[i:i + 250]))
+        elif command == 'getblocktxn':
+            r = self.recording.served.get(('blocktxn', payload[:32]))
+            if r is not None:
+                self.send(r.command, r.payload())
+                self.served += 1
+
+    def wait_for(self, command, count, timeout):
+        deadline = time.time() + timeout
+        with self.cond:
+            while self.received[command] < count and not self.closed:
+                remaining = deadline - time.time()
+                if remaining <= 0:
+                    return False
+                self.cond.wait(remaining)
+            if self.closed:
+                raise RuntimeError('xsnd closed the connection')
+        return True
+
+    def replay(self, gate_timeout, log):
+        sent_requests = collections.Counter()
+        forwarded = 0
+        gate_timeouts = 0
+        for r in self.recording.replayed:
+            if not r.incoming:
+                sent_requests[r.command] += 1
+                if not self.wait_for(r.command, sent_requests[r.command], gate_timeout):
+                    log('no %s from xsnd after %ds, replaying on' % (r.command, gate_timeout))
+                    gate_timeouts += 1
+                continue
+            self.send(r.command, r.payload())
+            forwarded += 1
+        return forwarded, gate_timeouts
+
+
+class Monitor:
+    """Polls the node while the replay runs"""
+
+    def __init__(self, node, t0):
+        self.node = node
+        self.t0 = t0
+        self.start_height = node.rpc.call('getblockcount')
+        self.height = self.start_height
+        self.height_time = t0
+        self.mnsync = {}
+        self.stopped = threading.Event()
+        self.thread = threading.Thread(target=self.run, daemon=True)
+        self.thread.start()
+
+    def run(self):
+        while not self.stopped.wait(0.5):
+            try:
+                now = time.time()
+                height = self.node.rpc.call('getblockcount')
+                if height != self.height:
+                    self.height = height
+                    self.height_time = now
+                status = self.node.rpc.call('mnsync', 'status')
+                for stage, key in MNSYNC_STAGES:
+                    if status.get(key) and stage not in self.mnsync:
+                        self.mnsync[stage] = now - self.t0
+            except (OSError, RuntimeError, ValueError):
+                pass
+
+    def stop(self):
+        self.stopped.set()
+        self.thread.join()
+
+
+def block_stats(start_height, end_height, seconds):
+    blocks = end_height - start_height
+    return {
+        'start_height': start_height,
+        'height': end_height,
+        'seconds': round(seconds, 3),
+        'blocks_per_second': round(blocks / seconds, 2) if seconds > 0 else None,
+    }
+
+
+def perf_stats(node):
+    ret = {}
+    for prefix in PERF_PREFIXES:
+        ret.update(node.rpc.call('getperfstats', prefix))
+    return ret
+
+
+def measure_reindex(args, datadir, height, log):
+    node = Node(args, datadir, ['-reindex'])
+    t0 = time.time()
+    node.start()
+    while True:
+        count = node.rpc.call('getblockcount')
+        if count >= height or time.time() - t0 > args.timeout:
+            break
+        time.sleep(0.5)
+    seconds = time.time() - t0
+    ret = block_stats(0, count, seconds)
+    ret['connectblock'] = perf_stats(node)
+    ret['peak_rss_kb'] = node.peak_rss_kb()
+    node.stop()
+    log('reindexed %d blocks in %.1fs' % (count, seconds))
+    return ret
+
+
+def print_report(result):
+    blocks = result['blocks']
+    print('Replayed %d messages, served %d requests (%d not in the recording)' %
+          (result['messages'], result['served'], result['not_found']))
+    print('Blocks: height %d -> %d in %.1fs, %s blocks/s' %
+          (blocks['start_height'], blocks['height'], blocks['seconds'], blocks['blocks_per_second']))
+    for title, stats in [('ConnectBlock phases', result['connectblock'])] + \
+            ([('ConnectBlock phases, reindex', result['reindex']['connectblock'])] if 'reindex' in result else []):
+        print('%s (count, total ms, average us, p90 us):' % title)
+        for name in sorted(stats):
+            s = stats[name]
+            print('  %-24s %8d %10.1f %10d %10d' % (name, s['count'], s['total'] / 1000.0, s['average'], s['p90']))
+    if 'reindex' in result:
+        r = result['reindex']
+        print('Reindex: %d blocks in %.1fs, %s blocks/s' % (r['height'], r['seconds'], r['blocks_per_second']))
+    print('Masternode sync (seconds after connecting):')
+    for stage, _ in MNSYNC_STAGES:
+        t = result['mnsync'].get(stage)
+        print('  %-16s %s' % (stage, 'not reached' if t is None else '%.1f' % t))
+    rss = result['peak_rss_kb']
+    print('Peak RSS: %s' % ('unknown' if rss is None else '%.1f MiB' % (rss / 1024.0)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture_dir', help='message_capture/<peer> directory written by xsnd -capturemessages')
+    parser.add_argument('--xsnd', default=os.environ.get('XSND', 'xsnd'), help='xsnd binary (default: $XSND or xsnd)')
+    parser.add_argument('--chain', choices=sorted(CHAINS), default='main', help='chain of the recording (default: main)')
+    parser.add_argument('--datadir', help='datadir to replay into, must not exist (default: a temporary directory)')
+    parser.add_argument('--keep-datadir', action='store_true', help='do not delete the datadir afterwards')
+    parser.add_argument('--port', type=int, default=29988, help='P2P port of the fresh node (default: 29988)')
+    parser.add_argument('--rpcport', type=int, default=29989, help='RPC port of the fresh node (default: 29989)')
+    parser.add_argument('--xsnd-arg', action='append', default=[], help='extra xsnd argument, can be given several times')
+    parser.add_argument('--gate-timeout', type=int, default=300,
+                        help='seconds to wait for xsnd to repeat a sync request of the recording (default: 300)')
+    parser.add_argument('--no-mnsync', action='store_true', help='do not wait for the masternode sync to finish')
+    parser.add_argument('--reindex', action='store_true', help='afterwards restart with -reindex and measure it as well')
+    parser.add_argument('--timeout', type=int, default=3600, help='give up waiting after this many seconds (default: 3600)')
+    parser.add_argument('--settle', type=int, default=10,
+                        help='seconds without a new block after the replay before the chain is done (default: 10)')
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    def log(msg):
+        print('replay: ' + msg, file=sys.stderr)
+
+    recording = Recording(args.capture_dir)
+    log('%d captured messages, %d to replay, %d to serve on request' %
+        (len(recording.records), len(recording.replayed), len(recording.served)))
+
+    datadir = args.datadir or tempfile.mkdtemp(prefix='xsn_replay_')
+    if args.datadir:
+        os.makedirs(datadir)
+    node = Node(args, datadir, [])
+    node.start()
+    try:
+        peer = StandInPeer(CHAINS[args.chain][0], recording)
+        t0 = time.time()
+        peer.connect(args.port)
+        monitor = Monitor(node, t0)
+        forwarded, gate_timeouts = peer.replay(args.gate_timeout, log)
+        log('replay finished after %.1fs, waiting for xsnd to catch up' % (time.time() - t0))
+
+        while time.time() - t0 < args.timeout:
+            settled = time.time() - monitor.height_time > args.settle
+            synced = args.no_mnsync or 'finished' in monitor.mnsync
+            if settled and synced:
+                break
+            time.sleep(0.5)
+        monitor.stop()
+
+        result = {
+            'chain': args.chain,
+            'messages': forwarded,
+            'served': peer.served,
+            'not_found': peer.not_found,
+            'gate_timeouts': gate_timeouts,
+            'blocks': block_stats(monitor.start_height, monitor.height, monitor.height_time - t0),
+            'connectblock': perf_stats(node),
+            'mnsync': monitor.mnsync,
+            'peak_rss_kb': node.peak_rss_kb(),
+        }
+    finally:
+        node.stop()
+
+    if args.reindex:
+        result['reindex'] = measure_reindex(args, datadir, result['blocks']['height'], log)
+
+    if not args.datadir and not args.keep_datadir:
+        shutil.rmtree(datadir)
+    elif args.keep_datadir:
+        log('datadir kept in %s' % datadir)
+
+    print_report(result)
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <bench/regression.h>
 
 #include <assert.h>
 #include <iostream>
@@ -81,6 +82,79 @@ void benchmark::PlotlyPrinter::footer()
               << "</script></body></html>";
 }
 
+void benchmark::JsonPrinter::header() {}
+
+// linear interpolation between the closest ranks of sorted results
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+    double rank = p * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    if (lower + 1 >= sorted.size()) {
+        return sorted.back();
+    }
+    return sorted[lower] + (rank - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+void benchmark::JsonPrinter::result(const State& state)
+{
+    auto results = state.m_elapsed_results;
+    std::sort(results.begin(), results.end());
+
+    UniValue bench(UniValue::VOBJ);
+    bench.pushKV("name", state.m_name);
+    bench.pushKV("evals", (uint64_t)state.m_num_evals);
+    bench.pushKV("iterations", (uint64_t)state.m_num_iters);
+    bench.pushKV("total", state.m_num_iters * std::accumulate(results.begin(), results.end(), 0.0));
+    if (!results.empty()) {
+        bench.pushKV("min", results.front());
+        bench.pushKV("max", results.back());
+        bench.pushKV("mean", std::accumulate(results.begin(), results.end(), 0.0) / results.size());
+        bench.pushKV("median", Percentile(results, 0.5));
+        bench.pushKV("p10", Percentile(results, 0.1));
+        bench.pushKV("p25", Percentile(results, 0.25));
+        bench.pushKV("p75", Percentile(results, 0.75));
+        bench.pushKV("p90", Percentile(results, 0.9));
+    }
+    UniValue samples(UniValue::VARR);
+    for (double e : state.m_elapsed_results) {
+        samples.push_back(e);
+    }
+    bench.pushKV("results", samples);
+    m_results.push_back(bench);
+}
+
+UniValue benchmark::JsonPrinter::GetDocument() const
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("system", GetSystemInfo());
+    ret.pushKV("benchmarks", m_results);
+    return ret;
+}
+
+void benchmark::JsonPrinter::footer()
+{
+    if (m_print) {
+        std::cout << GetDocument().write(4) << std::endl;
+    }
+}
+
+void benchmark::TeePrinter::header()
+{
+    m_first.header();
+    m_second.header();
+}
+
+void benchmark::TeePrinter::result(const State& state)
+{
+    m_first.result(state);
+    m_second.result(state);
+}
+
+void benchmark::TeePrinter::footer()
+{
+    m_first.footer();
+    m_second.footer();
+}
 
 benchmark::BenchRunner::BenchmarkMap& benchmark::BenchRunner::benchmarks()
 {
@@ -12,6 +12,8 @@
 #include <vector>
 #include <chrono>
 
+#include <univalue.h>
+
 #include <boost/preprocessor/cat.hpp>
 #include <boost/preprocessor/stringize.hpp>
 
@@ -130,6 +132,38 @@ private:
     int64_t m_width;
     int64_t m_height;
 };
+
+// machine readable results for regression tracking, one object per benchmark.
+// Prints the document to the console unless constructed with print = false.
+class JsonPrinter : public Printer
+{
+public:
+    explicit JsonPrinter(bool print = true) : m_print(print) {}
+    void header() override;
+    void result(const State& state) override;
+    void footer() override;
+
+    // results and the system they were taken on, as printed
+    UniValue GetDocument() const;
+
+private:
+    bool m_print;
+    UniValue m_results{UniValue::VARR};
+};
+
+// forwards to two printers, to keep results for regression tracking next to another output.
+class TeePrinter : public Printer
+{
+public:
+    TeePrinter(Printer& first, Printer& second) : m_first(first), m_second(second) {}
+    void header() override;
+    void result(const State& state) override;
+    void footer() override;
+
+private:
+    Printer& m_first;
+    Printer& m_second;
+};
 }
 
 
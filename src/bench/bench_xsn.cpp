@@ -3,7 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <bench/regression.h>
 
+#include <chainparams.h>
 #include <crypto/sha256.h>
 #include <key.h>
 #include <validation.h>
@@ -13,7 +15,10 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <sstream>
 
 static const int64_t DEFAULT_BENCH_EVALUATIONS = 5;
 static const char* DEFAULT_BENCH_FILTER = ".*";
@@ -22,6 +27,8 @@ static const char* DEFAULT_BENCH_PRINTER = "console";
 static const char* DEFAULT_PLOT_PLOTLYURL = "https://cdn.plot.ly/plotly-latest.min.js";
 static const int64_t DEFAULT_PLOT_WIDTH = 1024;
 static const int64_t DEFAULT_PLOT_HEIGHT = 768;
+static const char* DEFAULT_REGRESSION_THRESHOLD = "5";
+static const char* DEFAULT_REGRESSION_ALPHA = "0.05";
 
 static void SetupBenchArgs()
 {
@@ -30,10 +37,14 @@ static void SetupBenchArgs()
     gArgs.AddArg("-evals=<n>", strprintf("Number of measurement evaluations to perform. (default: %u)", DEFAULT_BENCH_EVALUATIONS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-filter=<regex>", strprintf("Regular expression filter to select benchmark by name (default: %s)", DEFAULT_BENCH_FILTER), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-scaling=<n>", strprintf("Scaling factor for benchmark's runtime (default: %u)", DEFAULT_BENCH_SCALING), false, OptionsCategory::OPTIONS);
-    gArgs.AddArg("-printer=(console|plot)", strprintf("Choose printer format. console: print data to console. plot: Print results as HTML graph (default: %s)", DEFAULT_BENCH_PRINTER), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-printer=(console|plot|json)", strprintf("Choose printer format. console: print data to console. plot: Print results as HTML graph. json: Print results as JSON for regression tracking (default: %s)", DEFAULT_BENCH_PRINTER), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-plot-plotlyurl=<uri>", strprintf("URL to use for plotly.js (default: %s)", DEFAULT_PLOT_PLOTLYURL), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-plot-width=<x>", strprintf("Plot width in pixel (default: %u)", DEFAULT_PLOT_WIDTH), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-plot-height=<x>", strprintf("Plot height in pixel (default: %u)", DEFAULT_PLOT_HEIGHT), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-output-json=<file>", "Also write the results as JSON to <file>, for use as a later -baseline", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-baseline=<file>", strprintf("Compare the results against a JSON file written by -output-json or -printer=json, print the comparison to stderr and exit with code %d if any benchmark regressed", benchmark::EXIT_REGRESSION), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-regression-threshold=<n>", strprintf("Slowdown of the median in percent from which a benchmark counts as regressed (default: %s)", DEFAULT_REGRESSION_THRESHOLD), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-regression-alpha=<n>", strprintf("Significance level of the Mann-Whitney U test a slowdown has to pass to count as regression, raise -evals to detect smaller ones (default: %s)", DEFAULT_REGRESSION_ALPHA), false, OptionsCategory::OPTIONS);
 
     // Hidden
     gArgs.AddArg("-h", "", false, OptionsCategory::HIDDEN);
@@ -59,6 +70,8 @@ int main(int argc, char** argv)
     RandomInit();
     ECC_Start();
     SetupEnvironment();
+    // the XSN benchmarks build fake regtest chains, masternode lists and contracts
+    SelectParams(CBaseChainParams::REGTEST);
 
     int64_t evaluations = gArgs.GetArg("-evals", DEFAULT_BENCH_EVALUATIONS);
     std::string regex_filter = gArgs.GetArg("-filter", DEFAULT_BENCH_FILTER);
@@ -71,6 +84,32 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    std::string threshold_str = gArgs.GetArg("-regression-threshold", DEFAULT_REGRESSION_THRESHOLD);
+    std::string alpha_str = gArgs.GetArg("-regression-alpha", DEFAULT_REGRESSION_ALPHA);
+    double threshold, alpha;
+    if (!ParseDouble(threshold_str, &threshold) || threshold < 0) {
+        fprintf(stderr, "Error parsing regression threshold: %s\n", threshold_str.c_str());
+        return EXIT_FAILURE;
+    }
+    if (!ParseDouble(alpha_str, &alpha) || alpha <= 0 || alpha > 1) {
+        fprintf(stderr, "Error parsing regression alpha: %s\n", alpha_str.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // read the baseline before spending time on the benchmarks
+    UniValue baseline;
+    std::string baseline_path = gArgs.GetArg("-baseline", "");
+    if (!baseline_path.empty()) {
+        std::ifstream file(baseline_path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        if (!file.is_open() || !baseline.read(contents.str()) || !baseline.isObject()) {
+            fprintf(stderr, "Error reading baseline %s\n", baseline_path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    std::string output_path = gArgs.GetArg("-output-json", "");
+
     std::unique_ptr<benchmark::Printer> printer(new benchmark::ConsolePrinter());
     std::string printer_arg = gArgs.GetArg("-printer", DEFAULT_BENCH_PRINTER);
     if ("plot" == printer_arg) {
@@ -78,11 +117,29 @@ int main(int argc, char** argv)
             gArgs.GetArg("-plot-plotlyurl", DEFAULT_PLOT_PLOTLYURL),
             gArgs.GetArg("-plot-width", DEFAULT_PLOT_WIDTH),
             gArgs.GetArg("-plot-height", DEFAULT_PLOT_HEIGHT)));
+    } else if ("json" == printer_arg) {
+        printer.reset(new benchmark::JsonPrinter());
     }
 
-    benchmark::BenchRunner::RunAll(*printer, evaluations, scaling_factor, regex_filter, is_list_only);
+    benchmark::JsonPrinter json_printer(false);
+    benchmark::TeePrinter tee_printer(*printer, json_printer);
+    benchmark::BenchRunner::RunAll(tee_printer, evaluations, scaling_factor, regex_filter, is_list_only);
 
     ECC_Stop();
 
+    const UniValue results = json_printer.GetDocument();
+    if (!output_path.empty()) {
+        std::ofstream file(output_path);
+        file << results.write(4) << std::endl;
+        if (!file.good()) {
+            fprintf(stderr, "Error writing results to %s\n", output_path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!baseline.isNull() && !is_list_only) {
+        return benchmark::CheckBaseline(baseline, results, threshold / 100, alpha, std::cerr);
+    }
+
     return EXIT_SUCCESS;
 }
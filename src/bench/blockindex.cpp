@@ -0,0 +1,60 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <support/allocators/arena.h>
+#include <validation.h>
+
+#include <vector>
+
+static const int BLOCK_INDEX_BENCH_ENTRIES = 100000;
+
+/** Build a block index of BLOCK_INDEX_BENCH_ENTRIES linked entries the way LoadBlockIndexGuts does */
+template <typename Alloc, typename Free>
+static void BuildBlockIndex(benchmark::State& state, Alloc alloc, Free free)
+{
+    std::vector<uint256> vHashes(BLOCK_INDEX_BENCH_ENTRIES);
+    for (int i = 0; i < BLOCK_INDEX_BENCH_ENTRIES; i++) {
+        vHashes[i] = ArithToUint256(arith_uint256(i + 1) * arith_uint256(2654435761U));
+    }
+
+    while (state.KeepRunning()) {
+        BlockMap map;
+        CBlockIndex* pprev = nullptr;
+        for (int i = 0; i < BLOCK_INDEX_BENCH_ENTRIES; i++) {
+            CBlockIndex* pindex = alloc();
+            auto mi = map.emplace(vHashes[i], pindex).first;
+            pindex->phashBlock = &mi->first;
+            pindex->pprev = pprev;
+            pindex->nHeight = i;
+            pindex->BuildSkip();
+            pprev = pindex;
+        }
+        free(map);
+    }
+}
+
+static void BlockIndexHeap(benchmark::State& state)
+{
+    BuildBlockIndex(state, [] { return new CBlockIndex(); }, [](BlockMap& map) {
+        for (auto& entry : map)
+            delete entry.second;
+    });
+}
+
+static void BlockIndexArena(benchmark::State& state)
+{
+    std::unique_ptr<MonotonicArena> arena;
+    BuildBlockIndex(state, [&arena] {
+        if (!arena)
+            arena.reset(new MonotonicArena(1 << 20));
+        return new (arena->Allocate(sizeof(CBlockIndex))) CBlockIndex();
+    }, [&arena](BlockMap& map) {
+        arena.reset();
+    });
+}
+
+BENCHMARK(BlockIndexHeap, 20);
+BENCHMARK(BlockIndexArena, 20);
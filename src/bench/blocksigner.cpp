@@ -0,0 +1,65 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blocksigner.h>
+#include <chainparams.h>
+#include <key.h>
+#include <keystore.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/standard.h>
+#include <tpos/tposutils.h>
+
+#include <assert.h>
+
+/** Check of a PoS block signature by a P2PKH staker, signed and checked at nHeight */
+static void CheckBlockSignatureAt(benchmark::State& state, int nHeight)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CBasicKeyStore keystore;
+    keystore.AddKey(key);
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    coinbase.vout[0].SetEmpty();
+
+    CMutableTransaction coinstake;
+    coinstake.vin.emplace_back(COutPoint(GetRandHash(), 0));
+    coinstake.vout.resize(2);
+    coinstake.vout[0].SetEmpty();
+    coinstake.vout[1] = CTxOut(1000 * COIN, GetScriptForDestination(key.GetPubKey().GetID()));
+
+    CBlock block;
+    block.hashPrevBlock = GetRandHash();
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    block.vtx.push_back(MakeTransactionRef(std::move(coinstake)));
+    block.hashMerkleRoot = GetRandHash();
+    assert(block.IsProofOfStake());
+
+    TPoSContract contract;
+    CBlockSigner signer(block, &keystore, contract, nHeight);
+    bool fSigned = signer.SignBlock();
+    assert(fSigned);
+
+    while (state.KeepRunning()) {
+        bool fValid = signer.CheckBlockSignature();
+        assert(fValid);
+    }
+}
+
+static void BlockSignatureCheck(benchmark::State& state)
+{
+    CheckBlockSignatureAt(state, Params().GetConsensus().nTPoSSignatureUpgradeHFHeight);
+}
+
+static void BlockSignatureCheckLegacy(benchmark::State& state)
+{
+    CheckBlockSignatureAt(state, Params().GetConsensus().nTPoSSignatureUpgradeHFHeight - 1);
+}
+
+BENCHMARK(BlockSignatureCheck, 10 * 1000);
+BENCHMARK(BlockSignatureCheckLegacy, 10 * 1000);
@@ -52,5 +52,23 @@ static void DeserializeAndCheckBlockTest(benchmark::State& state)
     }
 }
 
+// Same as above, with the block's transactions allocated from a per-block arena
+static void DeserializeBlockArenaTest(benchmark::State& state)
+{
+    CDataStream stream((const char*)block_bench::block413567,
+            (const char*)&block_bench::block413567[sizeof(block_bench::block413567)],
+            SER_NETWORK, PROTOCOL_VERSION);
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    while (state.KeepRunning()) {
+        CBlock block;
+        BlockTxArenaReader reader(block);
+        stream >> reader;
+        assert(stream.Rewind(sizeof(block_bench::block413567)));
+    }
+}
+
 BENCHMARK(DeserializeBlockTest, 130);
 BENCHMARK(DeserializeAndCheckBlockTest, 160);
+BENCHMARK(DeserializeBlockArenaTest, 130);
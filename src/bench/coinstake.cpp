@@ -0,0 +1,120 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/fakechain.h>
+#include <key.h>
+#include <random.h>
+#include <script/standard.h>
+#include <tpos/tposutils.h>
+#include <utiltime.h>
+#include <wallet/wallet.h>
+
+#include <assert.h>
+
+/** Target no kernel can meet, so every round searches all coins like most staking rounds do */
+static const unsigned int COINSTAKE_BENCH_BITS = 0x03000001;
+static const int COINSTAKE_BENCH_CHAIN_HEIGHT = 200;
+
+// A staking round of a wallet holding nCoins mature P2PKH outputs, spread over 100 blocks
+static void CreateCoinStake(benchmark::State& state, int nCoins)
+{
+    // CreateCoinStake keeps the stake candidates of each wallet and refreshes
+    // them every nStakeSetUpdateTime, so rounds after the first search the
+    // kept set. Every setup builds its chain an hour after the previous one.
+    static int64_t nMockTime = GetTime();
+    nMockTime += 60 * 60;
+    SetMockTime(nMockTime);
+
+    {
+        FakeChain chain(COINSTAKE_BENCH_CHAIN_HEIGHT, nMockTime - 10 * 60);
+        CWallet wallet("dummy", WalletDatabase::CreateDummy());
+
+        CKey key;
+        key.MakeNewKey(true);
+        wallet.LoadKey(key, key.GetPubKey());
+        const CScript script = GetScriptForDestination(key.GetPubKey().GetID());
+
+        for (int i = 0; i < nCoins; i++) {
+            CMutableTransaction tx;
+            tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+            tx.vout.emplace_back(1000 * COIN, script);
+            CWalletTx wtx(&wallet, MakeTransactionRef(std::move(tx)));
+            const CBlockIndex* pindex = chain[10 + i % 100];
+            wtx.SetMerkleBranch(pindex, 1 + i / 100);
+            wtx.nTimeReceived = pindex->nTime;
+            wallet.LoadToWallet(wtx);
+        }
+
+        while (state.KeepRunning()) {
+            CMutableTransaction txNew;
+            unsigned int nTxNewTime = 0;
+            std::vector<const CWalletTx*> vwtxPrev;
+            bool fFound = wallet.CreateCoinStake(COINSTAKE_BENCH_BITS, 10 * COIN, txNew, nTxNewTime, TPoSContract(), vwtxPrev, false);
+            assert(!fFound);
+        }
+    }
+
+    SetMockTime(0);
+}
+
+// A staking round of a merchant holding nContracts contracts of 10 coins each, searched in one pass
+static void CreateCoinStakeTPoS(benchmark::State& state, int nContracts)
+{
+    static int64_t nMockTime = GetTime();
+    nMockTime += 60 * 60;
+    SetMockTime(nMockTime);
+
+    {
+        FakeChain chain(COINSTAKE_BENCH_CHAIN_HEIGHT, nMockTime - 10 * 60);
+        CWallet wallet("dummy", WalletDatabase::CreateDummy());
+
+        CKey merchantKey;
+        merchantKey.MakeNewKey(true);
+        std::vector<TPoSContract> vContracts;
+        for (int i = 0; i < nContracts; i++) {
+            CKey tposKey;
+            tposKey.MakeNewKey(true);
+            CMutableTransaction txContract;
+            txContract.vin.emplace_back(COutPoint(GetRandHash(), 0));
+            TPoSContract contract(MakeTransactionRef(std::move(txContract)), merchantKey.GetPubKey().GetID(),
+                                  tposKey.GetPubKey().GetID(), 10, std::vector<unsigned char>(65, 1));
+            assert(contract.IsValid());
+            wallet.LoadWatchOnly(contract.scriptTPoSAddress);
+            vContracts.push_back(contract);
+
+            for (int j = 0; j < 10; j++) {
+                CMutableTransaction tx;
+                tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+                tx.vout.emplace_back(1000 * COIN, contract.scriptTPoSAddress);
+                CWalletTx wtx(&wallet, MakeTransactionRef(std::move(tx)));
+                const CBlockIndex* pindex = chain[10 + (i * 10 + j) % 100];
+                wtx.SetMerkleBranch(pindex, 1);
+                wtx.nTimeReceived = pindex->nTime;
+                wallet.LoadToWallet(wtx);
+            }
+        }
+
+        while (state.KeepRunning()) {
+            CMutableTransaction txNew;
+            unsigned int nTxNewTime = 0;
+            std::vector<const CWalletTx*> vwtxPrev;
+            TPoSContract contract;
+            bool fFound = wallet.CreateCoinStake(COINSTAKE_BENCH_BITS, 10 * COIN, txNew, nTxNewTime, vContracts, contract, vwtxPrev, false);
+            assert(!fFound);
+        }
+    }
+
+    SetMockTime(0);
+}
+
+static void CreateCoinStake100(benchmark::State& state) { CreateCoinStake(state, 100); }
+static void CreateCoinStake1000(benchmark::State& state) { CreateCoinStake(state, 1000); }
+
+BENCHMARK(CreateCoinStake100, 200);
+BENCHMARK(CreateCoinStake1000, 20);
+
+static void CreateCoinStakeTPoS100(benchmark::State& state) { CreateCoinStakeTPoS(state, 100); }
+
+BENCHMARK(CreateCoinStakeTPoS100, 20);
@@ -60,6 +60,23 @@ static void SHA512(benchmark::State& state)
         CSHA512().Write(in.data(), in.size()).Finalize(hash);
 }
 
+static void X11(benchmark::State& state)
+{
+    std::vector<uint8_t> in(BUFFER_SIZE,0);
+    while (state.KeepRunning())
+        HashX11(in.begin(), in.end());
+}
+
+/* X11 of a serialized block header, as done for every header received and every PoW check */
+static void X11_80b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(80,0);
+    while (state.KeepRunning()) {
+        uint256 hash = HashX11(in.begin(), in.end());
+        std::copy(hash.begin(), hash.end(), in.begin());
+    }
+}
+
 static void SipHash_32b(benchmark::State& state)
 {
     uint256 x;
@@ -91,8 +108,10 @@ BENCHMARK(RIPEMD160, 440);
 BENCHMARK(SHA1, 570);
 BENCHMARK(SHA256, 340);
 BENCHMARK(SHA512, 330);
+BENCHMARK(X11, 280);
 
 BENCHMARK(SHA256_32b, 4700 * 1000);
+BENCHMARK(X11_80b, 30 * 1000);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
@@ -0,0 +1,48 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/fakechain.h>
+
+#include <random.h>
+#include <validation.h>
+
+FakeChain::FakeChain(int nHeight, int64_t nLastBlockTime, int64_t nSpacing) :
+    vHashes(nHeight + 1),
+    vIndex(nHeight + 1)
+{
+    LOCK(cs_main);
+    for (int i = 0; i <= nHeight; i++) {
+        vHashes[i] = GetRandHash();
+        CBlockIndex& index = vIndex[i];
+        index.phashBlock = &vHashes[i];
+        index.pprev = i > 0 ? &vIndex[i - 1] : nullptr;
+        index.nHeight = i;
+        index.nTime = nLastBlockTime - (nHeight - i) * nSpacing;
+        index.nBits = 0x207fffff;
+        index.hashStakeModifierV3 = GetRandHash();
+        index.nStatus = BLOCK_VALID_SCRIPTS;
+        index.BuildSkip();
+        mapBlockIndex.emplace(vHashes[i], &index);
+    }
+    chainActive.SetTip(&vIndex.back());
+
+    pcoinsPrev = std::move(pcoinsTip);
+    pcoinsTip.reset(new CCoinsViewCache(&viewDummy));
+}
+
+FakeChain::~FakeChain()
+{
+    LOCK(cs_main);
+    pcoinsTip = std::move(pcoinsPrev);
+    chainActive.SetTip(nullptr);
+    for (const uint256& hash : vHashes) {
+        mapBlockIndex.erase(hash);
+    }
+}
+
+void FakeChain::AddCoin(const COutPoint& outpoint, const CTxOut& out, int nHeight)
+{
+    LOCK(cs_main);
+    pcoinsTip->AddCoin(outpoint, Coin(out, nHeight, false, false), false);
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BENCH_FAKECHAIN_H
+#define BITCOIN_BENCH_FAKECHAIN_H
+
+#include <chain.h>
+#include <coins.h>
+#include <uint256.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Active chain of nHeight + 1 headers without blocks, and an empty coins tip on
+ * top of nothing, for benchmarks of code that looks up block hashes, heights and
+ * UTXOs through the globals. Block i is timestamped nLastBlockTime - (nHeight - i) * nSpacing.
+ * Everything is undone on destruction.
+ */
+class FakeChain
+{
+public:
+    FakeChain(int nHeight, int64_t nLastBlockTime, int64_t nSpacing = 60);
+    ~FakeChain();
+
+    FakeChain(const FakeChain&) = delete;
+    FakeChain& operator=(const FakeChain&) = delete;
+
+    CBlockIndex* operator[](int nHeight) { return &vIndex[nHeight]; }
+    CBlockIndex* Tip() { return &vIndex.back(); }
+
+    /** Add an unspent output created at the given height to the coins tip */
+    void AddCoin(const COutPoint& outpoint, const CTxOut& out, int nHeight);
+
+private:
+    std::vector<uint256> vHashes;
+    std::vector<CBlockIndex> vIndex;
+    CCoinsView viewDummy;
+    std::unique_ptr<CCoinsViewCache> pcoinsPrev;
+};
+
+#endif // BITCOIN_BENCH_FAKECHAIN_H
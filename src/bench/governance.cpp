@@ -0,0 +1,75 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <governance/governance.h>
+#include <governance/governance-exceptions.h>
+#include <governance/governance-object.h>
+#include <governance/governance-vote.h>
+#include <key.h>
+#include <masternodeman.h>
+#include <net.h>
+#include <random.h>
+#include <timedata.h>
+#include <utilstrencodings.h>
+#include <version.h>
+
+#include <assert.h>
+
+/** Number of masternodes voting, each votes once on the object */
+static const int GOVERNANCE_BENCH_VOTERS = 1000;
+
+// Vote processing as done for every vote received from the network, signature check included
+static void GovernanceProcessVote(benchmark::State& state)
+{
+    CConnman connman(0x1337, 0x1337);
+
+    std::vector<CKey> vKeys(GOVERNANCE_BENCH_VOTERS);
+    std::vector<COutPoint> vOutpoints;
+    for (CKey& key : vKeys) {
+        key.MakeNewKey(true);
+        COutPoint outpoint(GetRandHash(), 0);
+        CMasternode mn(CService(), outpoint, key.GetPubKey(), key.GetPubKey(), PROTOCOL_VERSION);
+        mnodeman.Add(mn);
+        vOutpoints.push_back(outpoint);
+    }
+
+    // a watchdog only needs the signature of a known masternode to be accepted,
+    // proposals and triggers would need a confirmed collateral transaction
+    const std::string strData = "[[\"watchdog\",{\"type\":3}]]";
+    CGovernanceObject govobj(uint256(), 1, GetAdjustedTime(), uint256(), HexStr(strData.begin(), strData.end()));
+    govobj.SetMasternodeVin(vOutpoints[0]);
+    CPubKey pubKey = vKeys[0].GetPubKey();
+    bool fSigned = govobj.Sign(vKeys[0], pubKey);
+    assert(fSigned);
+
+    std::vector<CGovernanceVote> vVotes;
+    for (int i = 0; i < GOVERNANCE_BENCH_VOTERS; i++) {
+        CGovernanceVote vote(vOutpoints[i], govobj.GetHash(), VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES);
+        pubKey = vKeys[i].GetPubKey();
+        fSigned = vote.Sign(vKeys[i], pubKey);
+        assert(fSigned);
+        vVotes.push_back(vote);
+    }
+
+    size_t i = vVotes.size();
+    while (state.KeepRunning()) {
+        // every masternode voted, masternodes may only vote again after GOVERNANCE_UPDATE_MIN,
+        // so start over with a fresh copy of the object, amortized over all votes
+        if (i == vVotes.size()) {
+            governance.Clear();
+            CGovernanceObject govobjCopy(govobj);
+            governance.AddGovernanceObject(govobjCopy, connman);
+            i = 0;
+        }
+        CGovernanceException exception;
+        bool fAccepted = governance.ProcessVoteAndRelay(vVotes[i++], exception, connman);
+        assert(fAccepted);
+    }
+
+    governance.Clear();
+    mnodeman.Clear();
+}
+
+BENCHMARK(GovernanceProcessVote, 10 * 1000);
@@ -0,0 +1,35 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <kernel.h>
+#include <random.h>
+#include <utiltime.h>
+
+#include <assert.h>
+
+/** Target no kernel can meet, so every try runs the whole check like most staking attempts do */
+static const unsigned int KERNEL_BENCH_BITS = 0x03000001;
+
+// One kernel try, the staker does 45 of them per coin per round
+static void StakeKernelHash(benchmark::State& state)
+{
+    CBlockIndex prev;
+    prev.hashStakeModifierV3 = GetRandHash();
+
+    const uint256 hashBlockFrom = GetRandHash();
+    const COutPoint prevout(GetRandHash(), 1);
+    const int64_t nBlockFromTime = GetTime() - 24 * 60 * 60;
+    unsigned int nTimeTx = GetTime();
+    uint256 hashProofOfStake;
+
+    while (state.KeepRunning()) {
+        bool fFound = CheckStakeKernelHash(&prev, KERNEL_BENCH_BITS, hashBlockFrom, nBlockFromTime, 1000 * COIN,
+                                           prevout, nTimeTx++, hashProofOfStake, true, false);
+        assert(!fFound);
+    }
+}
+
+BENCHMARK(StakeKernelHash, 1000 * 1000);
@@ -0,0 +1,49 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <logging.h>
+
+static const std::string LOG_LINE = "CMasternodeMan::ProcessMessage -- MNPING -- Masternode ping, masternode=0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef-1\n";
+
+static void LogToFile(benchmark::State& state, bool fAsync)
+{
+    fs::path path = fs::temp_directory_path() / fs::unique_path();
+    {
+        BCLog::Logger logger;
+        logger.m_print_to_file = true;
+        logger.m_file_path = path;
+        logger.OpenDebugLog();
+        if (fAsync)
+            logger.StartAsyncWriter();
+        while (state.KeepRunning()) {
+            logger.LogPrintStr(LOG_LINE);
+        }
+        logger.StopAsyncWriter();
+    }
+    fs::remove(path);
+}
+
+static void LogSync(benchmark::State& state)
+{
+    LogToFile(state, false);
+}
+
+static void LogAsync(benchmark::State& state)
+{
+    LogToFile(state, true);
+}
+
+static void LogRateLimited(benchmark::State& state)
+{
+    BCLog::Logger logger;
+    logger.m_rate_limit = 1;
+    while (state.KeepRunning()) {
+        logger.WithinRateLimit(BCLog::MASTERNODE);
+    }
+}
+
+BENCHMARK(LogSync, 300 * 1000);
+BENCHMARK(LogAsync, 1000 * 1000);
+BENCHMARK(LogRateLimited, 30 * 1000 * 1000);
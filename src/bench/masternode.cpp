@@ -0,0 +1,120 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/fakechain.h>
+#include <masternode-sync.h>
+#include <masternodeman.h>
+#include <net.h>
+#include <random.h>
+#include <timedata.h>
+#include <utiltime.h>
+#include <version.h>
+
+#include <assert.h>
+
+/** Blocks on top of the masternode collaterals, on top of the list size so every node is old enough to be paid */
+static const int MASTERNODE_BENCH_EXTRA_BLOCKS = 200;
+
+/**
+ * Synced masternode list of nCount enabled masternodes with confirmed collaterals,
+ * on a fake chain where each of them is eligible for payment.
+ */
+class MasternodeListSetup
+{
+public:
+    explicit MasternodeListSetup(int nCount) :
+        connman(0x1337, 0x1337),
+        chain(nCount + MASTERNODE_BENCH_EXTRA_BLOCKS, GetTime())
+    {
+        // list and winners synced, the governance step does not matter here
+        masternodeSync.Reset();
+        while (!masternodeSync.IsWinnersListSynced()) {
+            masternodeSync.SwitchToNextAsset(connman);
+        }
+
+        for (int i = 0; i < nCount; i++) {
+            COutPoint outpoint(GetRandHash(), 0);
+            chain.AddCoin(outpoint, CTxOut(1000 * COIN, CScript()), 1);
+            CMasternode mn(CService(), outpoint, CPubKey(), CPubKey(), PROTOCOL_VERSION);
+            mn.sigTime = GetAdjustedTime() - 30 * 24 * 60 * 60;
+            mnodeman.Add(mn);
+            vOutpoints.push_back(outpoint);
+        }
+    }
+
+    ~MasternodeListSetup()
+    {
+        mnodeman.Clear();
+        masternodeSync.Reset();
+    }
+
+    int Height() { return chain.Tip()->nHeight; }
+
+    CConnman connman;
+    FakeChain chain;
+    std::vector<COutPoint> vOutpoints;
+};
+
+static void MasternodeRank(benchmark::State& state, int nCount)
+{
+    MasternodeListSetup setup(nCount);
+
+    // rank a different masternode against a different block every time, like
+    // the checks of incoming payment votes and pings do
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        int nRank;
+        const COutPoint& outpoint = setup.vOutpoints[i % setup.vOutpoints.size()];
+        bool fRanked = mnodeman.GetMasternodeRank(outpoint, nRank, setup.Height() - i % MASTERNODE_BENCH_EXTRA_BLOCKS);
+        assert(fRanked);
+        i++;
+    }
+}
+
+// rank a different masternode against the same block every time, like the
+// checks of the payment votes for the next block do
+static void MasternodeRankSameBlock(benchmark::State& state, int nCount)
+{
+    MasternodeListSetup setup(nCount);
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        int nRank;
+        const COutPoint& outpoint = setup.vOutpoints[i % setup.vOutpoints.size()];
+        bool fRanked = mnodeman.GetMasternodeRank(outpoint, nRank, setup.Height());
+        assert(fRanked);
+        i++;
+    }
+}
+
+static void MasternodePaymentQueue(benchmark::State& state, int nCount)
+{
+    MasternodeListSetup setup(nCount);
+
+    int i = 0;
+    while (state.KeepRunning()) {
+        int nCountRet;
+        masternode_info_t mnInfo;
+        bool fFound = mnodeman.GetNextMasternodeInQueueForPayment(setup.Height() + 1 - i % MASTERNODE_BENCH_EXTRA_BLOCKS, true, nCountRet, mnInfo);
+        assert(fFound && nCountRet == nCount);
+        i++;
+    }
+}
+
+static void MasternodeRank1000(benchmark::State& state) { MasternodeRank(state, 1000); }
+static void MasternodeRank5000(benchmark::State& state) { MasternodeRank(state, 5000); }
+static void MasternodeRank10000(benchmark::State& state) { MasternodeRank(state, 10000); }
+static void MasternodeRankSameBlock10000(benchmark::State& state) { MasternodeRankSameBlock(state, 10000); }
+static void MasternodePaymentQueue1000(benchmark::State& state) { MasternodePaymentQueue(state, 1000); }
+static void MasternodePaymentQueue5000(benchmark::State& state) { MasternodePaymentQueue(state, 5000); }
+static void MasternodePaymentQueue10000(benchmark::State& state) { MasternodePaymentQueue(state, 10000); }
+
+BENCHMARK(MasternodeRank1000, 1000);
+BENCHMARK(MasternodeRank5000, 200);
+BENCHMARK(MasternodeRank10000, 100);
+BENCHMARK(MasternodeRankSameBlock10000, 100 * 1000);
+BENCHMARK(MasternodePaymentQueue1000, 500);
+BENCHMARK(MasternodePaymentQueue5000, 100);
+BENCHMARK(MasternodePaymentQueue10000, 50);
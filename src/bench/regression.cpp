@@ -0,0 +1,196 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/regression.h>
+
+#include <clientversion.h>
+#include <tinyformat.h>
+#include <utiltime.h>
+
+#include <univalue.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <thread>
+
+/** Largest n * m for which the exact distribution of U is computed */
+static const size_t MANN_WHITNEY_EXACT_LIMIT = 400;
+
+static double Median(std::vector<double> v)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    size_t mid = v.size() / 2;
+    return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2;
+}
+
+static std::vector<double> GetSamples(const UniValue& bench)
+{
+    std::vector<double> ret;
+    const UniValue& results = find_value(bench, "results");
+    if (results.isArray()) {
+        for (const UniValue& e : results.getValues()) {
+            if (e.isNum())
+                ret.push_back(e.get_real());
+        }
+    }
+    return ret;
+}
+
+double benchmark::MannWhitneySlowerPValue(const std::vector<double>& baseline, const std::vector<double>& current)
+{
+    const size_t n = current.size();
+    const size_t m = baseline.size();
+    if (n == 0 || m == 0)
+        return 1.0;
+
+    // U counts the pairs in which the current sample is the slower one, ties count half
+    double u = 0;
+    bool fTies = false;
+    for (double c : current) {
+        for (double b : baseline) {
+            if (c > b) {
+                u += 1;
+            } else if (c == b) {
+                u += 0.5;
+                fTies = true;
+            }
+        }
+    }
+
+    if (!fTies && n * m <= MANN_WHITNEY_EXACT_LIMIT) {
+        // f[i][j][k]: orderings of i current and j baseline samples with U == k.
+        // The largest sample is either a current one, which beats all j baseline
+        // samples, or a baseline one, which adds nothing.
+        std::vector<std::vector<std::vector<double>>> f(n + 1, std::vector<std::vector<double>>(m + 1));
+        for (size_t i = 0; i <= n; i++) {
+            for (size_t j = 0; j <= m; j++) {
+                f[i][j].assign(i * j + 1, 0);
+                if (i == 0 || j == 0) {
+                    f[i][j][0] = 1;
+                    continue;
+                }
+                for (size_t k = 0; k <= i * j; k++) {
+                    double count = 0;
+                    if (k >= j && k - j <= (i - 1) * j)
+                        count += f[i - 1][j][k - j];
+                    if (k <= i * (j - 1))
+                        count += f[i][j - 1][k];
+                    f[i][j][k] = count;
+                }
+            }
+        }
+        double nTotal = 0, nAtLeast = 0;
+        for (size_t k = 0; k <= n * m; k++) {
+            nTotal += f[n][m][k];
+            if (k >= u)
+                nAtLeast += f[n][m][k];
+        }
+        return nAtLeast / nTotal;
+    }
+
+    // normal approximation, the variance shrinks with the number of tied samples
+    std::vector<double> all(current);
+    all.insert(all.end(), baseline.begin(), baseline.end());
+    std::sort(all.begin(), all.end());
+    double nTieSum = 0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j] == all[i])
+            j++;
+        double t = j - i;
+        nTieSum += t * t * t - t;
+        i = j;
+    }
+    const double N = n + m;
+    const double mean = n * m / 2.0;
+    const double variance = n * m / 12.0 * ((N + 1) - nTieSum / (N * (N - 1)));
+    if (variance <= 0)
+        return u > mean ? 0.0 : 1.0;
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+UniValue benchmark::GetSystemInfo()
+{
+    std::string strCPU = "unknown";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t pos = line.find(':');
+            if (pos != std::string::npos && pos + 2 <= line.size())
+                strCPU = line.substr(pos + 2);
+            break;
+        }
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("cpu", strCPU);
+    ret.pushKV("cores", (int)std::thread::hardware_concurrency());
+    ret.pushKV("version", FormatFullVersion());
+    ret.pushKV("time", GetTime());
+    return ret;
+}
+
+int benchmark::CompareToBaseline(const UniValue& baseline, const UniValue& current, double threshold, double alpha, std::ostream& out)
+{
+    const std::string strBaselineCPU = find_value(find_value(baseline, "system"), "cpu").getValStr();
+    const std::string strCPU = find_value(find_value(current, "system"), "cpu").getValStr();
+    if (strBaselineCPU != strCPU) {
+        out << "# WARNING: baseline was taken on \"" << strBaselineCPU << "\", this run on \"" << strCPU << "\"" << std::endl;
+    }
+
+    std::map<std::string, const UniValue*> mapBaseline;
+    const UniValue& baselineBenchmarks = find_value(baseline, "benchmarks");
+    if (baselineBenchmarks.isArray()) {
+        for (const UniValue& bench : baselineBenchmarks.getValues())
+            mapBaseline[find_value(bench, "name").getValStr()] = &bench;
+    }
+
+    int nRegressions = 0;
+    out << "# Benchmark, baseline median, median, change, p-value, result" << std::endl;
+    for (const UniValue& bench : find_value(current, "benchmarks").getValues()) {
+        const std::string strName = find_value(bench, "name").getValStr();
+        const std::vector<double> samples = GetSamples(bench);
+        auto it = mapBaseline.find(strName);
+        if (it == mapBaseline.end() || GetSamples(*it->second).empty() || samples.empty()) {
+            out << strName << ", -, " << Median(samples) << ", -, -, new" << std::endl;
+            continue;
+        }
+
+        const std::vector<double> baselineSamples = GetSamples(*it->second);
+        const double baselineMedian = Median(baselineSamples);
+        const double median = Median(samples);
+        const double change = baselineMedian > 0 ? median / baselineMedian - 1 : 0;
+
+        std::string strResult = "ok";
+        double pValue = MannWhitneySlowerPValue(baselineSamples, samples);
+        if (change > threshold && pValue < alpha) {
+            strResult = "REGRESSION";
+            nRegressions++;
+        } else if (change < -threshold) {
+            pValue = MannWhitneySlowerPValue(samples, baselineSamples);
+            if (pValue < alpha)
+                strResult = "improved";
+        }
+        out << strName << ", " << baselineMedian << ", " << median << ", " << strprintf("%+.2f%%", change * 100) << ", "
+            << strprintf("%.4f", pValue) << ", " << strResult << std::endl;
+    }
+    return nRegressions;
+}
+
+int benchmark::CheckBaseline(const UniValue& baseline, const UniValue& current, double threshold, double alpha, std::ostream& out)
+{
+    int nRegressions = CompareToBaseline(baseline, current, threshold, alpha, out);
+    if (nRegressions > 0) {
+        out << strprintf("%d benchmark(s) regressed by more than %g%% against the baseline", nRegressions, threshold * 100) << std::endl;
+        return EXIT_REGRESSION;
+    }
+    return EXIT_SUCCESS;
+}
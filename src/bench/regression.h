@@ -0,0 +1,46 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BENCH_REGRESSION_H
+#define BITCOIN_BENCH_REGRESSION_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class UniValue;
+
+namespace benchmark {
+
+/** Exit code when a benchmark regressed against -baseline, errors exit with EXIT_FAILURE */
+static const int EXIT_REGRESSION = 2;
+
+/**
+ * One sided Mann-Whitney U test: probability of seeing samples at least as
+ * much slower than the baseline as these if both came from the same
+ * distribution. Exact for small samples without ties, normal approximation
+ * with tie correction otherwise.
+ */
+double MannWhitneySlowerPValue(const std::vector<double>& baseline, const std::vector<double>& current);
+
+/** Machine and build the results were taken on, stored next to them */
+UniValue GetSystemInfo();
+
+/**
+ * Compare the results of a JsonPrinter against a baseline document written
+ * by an earlier run. A benchmark regressed when its median got slower by
+ * more than threshold (fraction) and the slowdown is significant at alpha.
+ * Writes one line per benchmark to out and returns the number of regressions.
+ */
+int CompareToBaseline(const UniValue& baseline, const UniValue& current, double threshold, double alpha, std::ostream& out);
+
+/**
+ * CompareToBaseline() followed by a summary line, returns the exit code of
+ * the run: EXIT_REGRESSION if any benchmark regressed, EXIT_SUCCESS otherwise.
+ */
+int CheckBaseline(const UniValue& baseline, const UniValue& current, double threshold, double alpha, std::ostream& out);
+
+} // namespace benchmark
+
+#endif // BITCOIN_BENCH_REGRESSION_H
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <key.h>
+#include <keystore.h>
+#include <random.h>
+#include <script/standard.h>
+#include <tpos/tposutils.h>
+
+#include <assert.h>
+
+/** Signed contract between a fresh owner and merchant, funded by a made up input */
+static CTransactionRef CreateSignedContract(bool fLegacy)
+{
+    CKey tposKey, merchantKey;
+    tposKey.MakeNewKey(true);
+    merchantKey.MakeNewKey(true);
+
+    CTxDestination tposAddress = tposKey.GetPubKey().GetID();
+    CTxDestination merchantAddress = merchantKey.GetPubKey().GetID();
+    if (!fLegacy) {
+        tposAddress = WitnessV0KeyHash(tposKey.GetPubKey().GetID());
+        merchantAddress = WitnessV0KeyHash(merchantKey.GetPubKey().GetID());
+    }
+
+    CMutableTransaction tx;
+    std::string strError;
+    bool fCreated = TPoSUtils::CreateTPoSTransaction(tx, tposAddress, merchantAddress, 10, fLegacy, strError);
+    assert(fCreated);
+    tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+
+    CBasicKeyStore keystore;
+    keystore.AddKey(tposKey);
+    auto contract = TPoSContract::FromTPoSContractTx(MakeTransactionRef(tx));
+    contract.nVersion = fLegacy ? 1 : 2;
+    bool fSigned = TPoSUtils::SignTPoSContract(tx, &keystore, contract);
+    assert(fSigned);
+
+    return MakeTransactionRef(std::move(tx));
+}
+
+// Contract checks run for every TPoS block, signature included, the collateral lookup is left out
+static void CheckContract(benchmark::State& state, bool fLegacy)
+{
+    const CTransactionRef txContract = CreateSignedContract(fLegacy);
+    const int nHeight = Params().GetConsensus().nTPoSSignatureUpgradeHFHeight;
+
+    while (state.KeepRunning()) {
+        TPoSContract contract;
+        std::string strError;
+        bool fValid = TPoSUtils::CheckContract(txContract, contract, nHeight, true, false, strError);
+        assert(fValid);
+    }
+}
+
+static void TPoSCheckContract(benchmark::State& state) { CheckContract(state, false); }
+// legacy contracts are checked against the new signature format first
+static void TPoSCheckContractLegacy(benchmark::State& state) { CheckContract(state, true); }
+
+BENCHMARK(TPoSCheckContract, 5 * 1000);
+BENCHMARK(TPoSCheckContractLegacy, 5 * 1000);
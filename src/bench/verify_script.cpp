@@ -4,11 +4,13 @@
 
 #include <bench/bench.h>
 #include <key.h>
+#include <random.h>
 #if defined(HAVE_CONSENSUS_LIB)
 #include <script/xsnconsensus.h>
 #endif
 #include <script/script.h>
 #include <script/sign.h>
+#include <script/standard.h>
 #include <streams.h>
 
 #include <array>
@@ -105,4 +107,66 @@ static void VerifyScriptBench(benchmark::State& state)
     }
 }
 
+// Microbenchmark for a single ECDSA verification, isolated from script
+// interpretation. This is the operation affected by the libsecp256k1 build
+// options (--enable-secp256k1-endomorphism, --with-secp256k1-ecmult-window).
+static void VerifyECDSABench(benchmark::State& state)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pubkey = key.GetPubKey();
+    uint256 hash = GetRandHash();
+    std::vector<unsigned char> vchSig;
+    key.Sign(hash, vchSig);
+
+    while (state.KeepRunning()) {
+        bool success = pubkey.Verify(hash, vchSig);
+        assert(success);
+    }
+}
+
+// Verification of a block's worth of P2PKH inputs, each signed by a distinct
+// key, the way ConnectBlock runs them when every signature check of a block
+// is gathered in one pass (no signature cache hits).
+static void VerifyScriptBlockBench(benchmark::State& state)
+{
+    static const int NUM_INPUTS = 250;
+    const int flags = SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC | SCRIPT_VERIFY_DERSIG | SCRIPT_VERIFY_LOW_S;
+
+    std::vector<CMutableTransaction> vCredits;
+    std::vector<CMutableTransaction> vSpends;
+    vCredits.reserve(NUM_INPUTS);
+    vSpends.reserve(NUM_INPUTS);
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        CKey key;
+        key.MakeNewKey(true);
+        CPubKey pubkey = key.GetPubKey();
+        CScript scriptPubKey = GetScriptForDestination(pubkey.GetID());
+        vCredits.push_back(BuildCreditingTransaction(scriptPubKey));
+        CMutableTransaction txSpend = BuildSpendingTransaction(CScript(), vCredits.back());
+        std::vector<unsigned char> vchSig;
+        key.Sign(SignatureHash(scriptPubKey, txSpend, 0, SIGHASH_ALL, vCredits.back().vout[0].nValue, SigVersion::BASE), vchSig);
+        vchSig.push_back(static_cast<unsigned char>(SIGHASH_ALL));
+        txSpend.vin[0].scriptSig = CScript() << vchSig << ToByteVector(pubkey);
+        vSpends.push_back(txSpend);
+    }
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < NUM_INPUTS; ++i) {
+            ScriptError err;
+            bool success = VerifyScript(
+                vSpends[i].vin[0].scriptSig,
+                vCredits[i].vout[0].scriptPubKey,
+                nullptr,
+                flags,
+                MutableTransactionSignatureChecker(&vSpends[i], 0, vCredits[i].vout[0].nValue),
+                &err);
+            assert(err == SCRIPT_ERR_OK);
+            assert(success);
+        }
+    }
+}
+
 BENCHMARK(VerifyScriptBench, 6300);
+BENCHMARK(VerifyECDSABench, 7000);
+BENCHMARK(VerifyScriptBlockBench, 25);
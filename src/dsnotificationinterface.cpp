@@ -15,6 +15,7 @@
 void CDSNotificationInterface::InitializeCurrentBlockTip()
 {
     LOCK(cs_main);
+    mnodeman.SetTipHeight(chainActive.Height());
     UpdatedBlockTip(chainActive.Tip(), NULL, IsInitialBlockDownload());
 }
 
@@ -68,6 +69,11 @@ void CDSNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock
     {
         instantsend.SyncTransaction(tx, nullptr);
     }
+
+    mnodeman.BlockConnected(*block, pindex);
+
+    if (!fLiteMode)
+        mnpayeeindex.BlockConnected(*block, pindex, mnpayments.GetStorageLimit());
 }
 
 void CDSNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock> &block)
@@ -76,4 +82,9 @@ void CDSNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBl
     {
         instantsend.SyncTransaction(tx, nullptr);
     }
+
+    mnodeman.BlockDisconnected(*block);
+
+    if (!fLiteMode)
+        mnpayeeindex.BlockDisconnected(*block);
 }
@@ -139,6 +139,7 @@ bool CGovernanceTriggerManager::AddNewTrigger(uint256 nHash)
 
 //    DBG( cout << "CGovernanceTriggerManager::AddNewTrigger: Inserting trigger" << endl; );
     mapTrigger.insert(std::make_pair(nHash, pSuperblock));
+    mapTriggerByHeight.insert(std::make_pair(pSuperblock->GetBlockStart(), pSuperblock));
 
 //    DBG( cout << "CGovernanceTriggerManager::AddNewTrigger: End" << endl; );
 
@@ -230,6 +231,15 @@ void CGovernanceTriggerManager::CleanAndRemove()
 //                     << endl;
 //               );
             LogPrint(BCLog::GOBJECT, "CGovernanceTriggerManager::CleanAndRemove -- Removing trigger object\n");
+            if(pSuperblock) {
+                auto range = mapTriggerByHeight.equal_range(pSuperblock->GetBlockStart());
+                for(auto itHeight = range.first; itHeight != range.second; ++itHeight) {
+                    if(itHeight->second == pSuperblock) {
+                        mapTriggerByHeight.erase(itHeight);
+                        break;
+                    }
+                }
+            }
             mapTrigger.erase(it++);
         }
         else  {
@@ -272,6 +282,21 @@ std::vector<CSuperblock_sptr> CGovernanceTriggerManager::GetActiveTriggers()
     return vecResults;
 }
 
+std::vector<CSuperblock_sptr> CGovernanceTriggerManager::GetActiveTriggers(int nBlockHeight)
+{
+    AssertLockHeld(governance.cs);
+    std::vector<CSuperblock_sptr> vecResults;
+
+    auto range = mapTriggerByHeight.equal_range(nBlockHeight);
+    for(auto it = range.first; it != range.second; ++it) {
+        if(it->second->GetGovernanceObject()) {
+            vecResults.push_back(it->second);
+        }
+    }
+
+    return vecResults;
+}
+
 /**
 *   Is Superblock Triggered
 *
@@ -286,8 +311,8 @@ bool CSuperblockManager::IsSuperblockTriggered(int nBlockHeight)
     }
 
     LOCK(governance.cs);
-    // GET ALL ACTIVE TRIGGERS
-    std::vector<CSuperblock_sptr> vecTriggers = triggerman.GetActiveTriggers();
+    // GET THE ACTIVE TRIGGERS FOR THIS BLOCK
+    std::vector<CSuperblock_sptr> vecTriggers = triggerman.GetActiveTriggers(nBlockHeight);
 
     LogPrint(BCLog::GOBJECT, "CSuperblockManager::IsSuperblockTriggered -- vecTriggers.size() = %d\n", vecTriggers.size());
 
@@ -350,7 +375,7 @@ bool CSuperblockManager::GetBestSuperblock(CSuperblock_sptr& pSuperblockRet, int
     }
 
     AssertLockHeld(governance.cs);
-    std::vector<CSuperblock_sptr> vecTriggers = triggerman.GetActiveTriggers();
+    std::vector<CSuperblock_sptr> vecTriggers = triggerman.GetActiveTriggers(nBlockHeight);
     int nYesCount = 0;
 
     BOOST_FOREACH(CSuperblock_sptr pSuperblock, vecTriggers) {
@@ -466,7 +491,8 @@ CSuperblock()
     : nGovObjHash(),
       nEpochStart(0),
       nStatus(SEEN_OBJECT_UNKNOWN),
-      vecPayments()
+      vecPayments(),
+      nPaymentsTotalAmount(0)
 {}
 
 CSuperblock::
@@ -474,7 +500,8 @@ CSuperblock(uint256& nHash)
     : nGovObjHash(nHash),
       nEpochStart(0),
       nStatus(SEEN_OBJECT_UNKNOWN),
-      vecPayments()
+      vecPayments(),
+      nPaymentsTotalAmount(0)
 {
 //    DBG( cout << "CSuperblock Constructor Start" << endl; );
 
@@ -598,9 +625,11 @@ void CSuperblock::ParsePaymentSchedule(std::string& strPaymentAddresses, std::st
         CGovernancePayment payment(address, nAmount);
         if(payment.IsValid()) {
             vecPayments.push_back(payment);
+            nPaymentsTotalAmount += nAmount;
         }
         else {
             vecPayments.clear();
+            nPaymentsTotalAmount = 0;
             std::ostringstream ostr;
             ostr << "CSuperblock::ParsePaymentSchedule -- Invalid payment found: address = " << address.ToString()
                  << ", amount = " << nAmount;
@@ -620,18 +649,6 @@ bool CSuperblock::GetPayment(int nPaymentIndex, CGovernancePayment& paymentRet)
     return true;
 }
 
-CAmount CSuperblock::GetPaymentsTotalAmount()
-{
-    CAmount nPaymentsTotalAmount = 0;
-    int nPayments = CountPayments();
-
-    for(int i = 0; i < nPayments; i++) {
-        nPaymentsTotalAmount += vecPayments[i].nAmount;
-    }
-
-    return nPaymentsTotalAmount;
-}
-
 /**
 *   Is Transaction Valid
 *
@@ -689,12 +706,7 @@ bool CSuperblock::IsValid(const CTransactionRef& txNew, int nBlockHeight, CAmoun
 
     int nVoutIndex = 0;
     for(int i = 0; i < nPayments; i++) {
-        CGovernancePayment payment;
-        if(!GetPayment(i, payment)) {
-            // This shouldn't happen so log a warning
-            LogPrintf("CSuperblock::IsValid -- WARNING: Failed to find payment: %d of %d total payments\n", i, nPayments);
-            continue;
-        }
+        const CGovernancePayment& payment = vecPayments[i];
 
         bool fPaymentMatch = false;
 
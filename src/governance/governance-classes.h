@@ -41,20 +41,26 @@ class CGovernanceTriggerManager
 {
     friend class CSuperblockManager;
     friend class CGovernanceManager;
+    friend struct CGovernanceTest; // for test access to the triggers
 
 private:
     typedef std::map<uint256, CSuperblock_sptr> trigger_m_t;
     typedef trigger_m_t::iterator trigger_m_it;
     typedef trigger_m_t::const_iterator trigger_m_cit;
+    typedef std::multimap<int, CSuperblock_sptr> trigger_height_m_t;
 
     trigger_m_t mapTrigger;
+    // the triggers of mapTrigger by the height of the block they pay in
+    trigger_height_m_t mapTriggerByHeight;
 
     std::vector<CSuperblock_sptr> GetActiveTriggers();
+    /// Active triggers paying in the block at nBlockHeight, without looking at the others
+    std::vector<CSuperblock_sptr> GetActiveTriggers(int nBlockHeight);
     bool AddNewTrigger(uint256 nHash);
     void CleanAndRemove();
 
 public:
-    CGovernanceTriggerManager() : mapTrigger() {}
+    CGovernanceTriggerManager() : mapTrigger(), mapTriggerByHeight() {}
 };
 
 /**
@@ -150,7 +156,9 @@ private:
 
     int nEpochStart;
     int nStatus;
+    // parsed once from the object data, never changes afterwards
     std::vector<CGovernancePayment> vecPayments;
+    CAmount nPaymentsTotalAmount;
 
     void ParsePaymentSchedule(std::string& strPaymentAddresses, std::string& strPaymentAmounts);
 
@@ -201,7 +209,8 @@ public:
 
     int CountPayments() { return (int)vecPayments.size(); }
     bool GetPayment(int nPaymentIndex, CGovernancePayment& paymentRet);
-    CAmount GetPaymentsTotalAmount();
+    const std::vector<CGovernancePayment>& GetPayments() const { return vecPayments; }
+    CAmount GetPaymentsTotalAmount() const { return nPaymentsTotalAmount; }
 
     bool IsValid(const CTransactionRef &txNew, int nBlockHeight, CAmount expectedReward, CAmount actualReward);
 };
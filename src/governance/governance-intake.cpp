@@ -0,0 +1,162 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/governance-intake.h>
+
+#include <governance/governance.h>
+#include <net.h>
+#include <perfstats.h>
+#include <util.h>
+
+CGovernanceIntake governanceintake;
+
+void CGovernanceIntake::Start(int nThreads, CConnman* connmanIn)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fRunning || nThreads <= 0)
+        return;
+    fRunning = true;
+    fStop = false;
+    connman = connmanIn;
+    for (int i = 0; i < nThreads; i++)
+        vThreads.emplace_back(&CGovernanceIntake::ThreadValidate, this);
+    LogPrintf("CGovernanceIntake::Start -- %d governance object validation threads\n", nThreads);
+}
+
+void CGovernanceIntake::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fRunning)
+            return;
+        fStop = true;
+        cond.notify_all();
+    }
+    for (std::thread& thread : vThreads)
+        thread.join();
+    vThreads.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ReleaseItems();
+    fRunning = false;
+    connman = nullptr;
+}
+
+bool CGovernanceIntake::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return fRunning && !fStop;
+}
+
+bool CGovernanceIntake::Push(CNode* pfrom, const CGovernanceObject& govobj, bool fRateCheckBypassed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fRunning || fStop)
+        return false;
+    if (setQueued.size() >= MAX_GOVERNANCE_INTAKE_QUEUE) {
+        stats.nDropped++;
+        return false;
+    }
+
+    pfrom->AddRef();
+    queue.push_back(Item{nNextSequence++, pfrom, govobj, fRateCheckBypassed, CGovernanceObjectPrecheck(), std::chrono::steady_clock::now()});
+    setQueued.insert(govobj.GetHash());
+    stats.nQueuedMax = std::max(stats.nQueuedMax, setQueued.size());
+    cond.notify_one();
+    return true;
+}
+
+bool CGovernanceIntake::IsQueued(const uint256& nHash) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return setQueued.count(nHash);
+}
+
+CGovernanceIntake::Stats CGovernanceIntake::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats ret = stats;
+    ret.nQueued = setQueued.size();
+    return ret;
+}
+
+void CGovernanceIntake::ThreadValidate()
+{
+    RenameThread("xsn-govvalidate");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cond.wait(lock, [this] { return fStop || !queue.empty(); });
+        if (fStop)
+            return;
+
+        Item item = std::move(queue.front());
+        queue.pop_front();
+        stats.nValidating++;
+        lock.unlock();
+
+        {
+            PERF_SCOPE("governance.object.validate");
+            Validate(item.govobj, item.precheck);
+        }
+
+        lock.lock();
+        stats.nValidating--;
+        uint64_t nSequence = item.nSequence;
+        mapValidated.emplace(nSequence, std::move(item));
+        CommitReady(lock);
+    }
+}
+
+void CGovernanceIntake::CommitReady(std::unique_lock<std::mutex>& lock)
+{
+    // The thread already committing picks up what becomes ready meanwhile
+    if (fCommitting)
+        return;
+    fCommitting = true;
+
+    static CPerfCounter& counterWait = GetPerfCounter("governance.object.wait");
+    while (!mapValidated.empty() && mapValidated.begin()->first == nNextCommit) {
+        Item item = std::move(mapValidated.begin()->second);
+        mapValidated.erase(mapValidated.begin());
+        nNextCommit++;
+        lock.unlock();
+
+        counterWait.Add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - item.timeQueued).count());
+        {
+            PERF_SCOPE("governance.object.commit");
+            Commit(item.pfrom, item.govobj, item.fRateCheckBypassed, item.precheck);
+        }
+        item.pfrom->Release();
+
+        lock.lock();
+        // Only forget the object once it is known to the governance manager, so it is not asked for again meanwhile
+        setQueued.erase(item.govobj.GetHash());
+        stats.nCommitted++;
+    }
+
+    fCommitting = false;
+}
+
+void CGovernanceIntake::Validate(CGovernanceObject& govobj, CGovernanceObjectPrecheck& precheck)
+{
+    govobj.Precheck(precheck);
+}
+
+void CGovernanceIntake::Commit(CNode* pfrom, CGovernanceObject& govobj, bool fRateCheckBypassed, const CGovernanceObjectPrecheck& precheck)
+{
+    governance.ProcessObject(pfrom, govobj, fRateCheckBypassed, &precheck, *connman);
+}
+
+void CGovernanceIntake::ReleaseItems()
+{
+    for (Item& item : queue)
+        item.pfrom->Release();
+    for (auto& pair : mapValidated)
+        pair.second.pfrom->Release();
+    queue.clear();
+    mapValidated.clear();
+    setQueued.clear();
+    nNextSequence = nNextCommit = 0;
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GOVERNANCE_INTAKE_H
+#define GOVERNANCE_INTAKE_H
+
+#include <governance/governance-object.h>
+#include <uint256.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class CConnman;
+class CNode;
+class CGovernanceIntake;
+
+/** Default number of governance object validation threads, 0 validates on the message thread */
+static const int DEFAULT_GOVERNANCE_VALIDATION_THREADS = 2;
+static const int MAX_GOVERNANCE_VALIDATION_THREADS = 16;
+/** Objects waiting in the intake before new ones are asked for again later */
+static const size_t MAX_GOVERNANCE_INTAKE_QUEUE = 500;
+
+extern CGovernanceIntake governanceintake;
+
+/**
+ * Staged intake of the governance objects received from peers. The message
+ * thread queues an object once the cheap checks passed, a pool of workers runs
+ * CGovernanceObject::Precheck on them in parallel and the results are handed
+ * to CGovernanceManager::ProcessObject in the order the objects arrived, so
+ * which objects get accepted does not depend on which worker finished first.
+ */
+class CGovernanceIntake
+{
+public:
+    struct Stats
+    {
+        /** Objects queued, being validated or waiting for their turn to commit */
+        size_t nQueued = 0;
+        size_t nQueuedMax = 0;
+        size_t nValidating = 0;
+        uint64_t nCommitted = 0;
+        /** Objects turned away because the intake was full */
+        uint64_t nDropped = 0;
+    };
+
+    CGovernanceIntake() {}
+    virtual ~CGovernanceIntake() { Stop(); }
+
+    CGovernanceIntake(const CGovernanceIntake&) = delete;
+    CGovernanceIntake& operator=(const CGovernanceIntake&) = delete;
+
+    void Start(int nThreads, CConnman* connmanIn);
+    /** Join the workers and drop what is still queued, must run before connman stops */
+    void Stop();
+    bool IsRunning() const;
+
+    /** Queue a received object, false if the intake is full or not running */
+    bool Push(CNode* pfrom, const CGovernanceObject& govobj, bool fRateCheckBypassed);
+    /** Whether the object is somewhere between Push and the end of its commit */
+    bool IsQueued(const uint256& nHash) const;
+
+    Stats GetStats() const;
+
+protected:
+    /** Runs on the workers, CGovernanceObject::Precheck */
+    virtual void Validate(CGovernanceObject& govobj, CGovernanceObjectPrecheck& precheck);
+    /** Runs in arrival order, CGovernanceManager::ProcessObject */
+    virtual void Commit(CNode* pfrom, CGovernanceObject& govobj, bool fRateCheckBypassed, const CGovernanceObjectPrecheck& precheck);
+
+private:
+    struct Item
+    {
+        uint64_t nSequence;
+        CNode* pfrom;
+        CGovernanceObject govobj;
+        bool fRateCheckBypassed;
+        CGovernanceObjectPrecheck precheck;
+        std::chrono::steady_clock::time_point timeQueued;
+    };
+
+    void ThreadValidate();
+    /** Commit the validated objects whose turn it is, one thread at a time */
+    void CommitReady(std::unique_lock<std::mutex>& lock);
+    void ReleaseItems();
+
+    mutable std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::thread> vThreads;
+    CConnman* connman = nullptr;
+    bool fRunning = false;
+    bool fStop = false;
+    bool fCommitting = false;
+
+    std::deque<Item> queue;
+    /** Validated objects by arrival sequence, committed once nNextCommit reaches them */
+    std::map<uint64_t, Item> mapValidated;
+    std::set<uint256> setQueued;
+    uint64_t nNextSequence = 0;
+    uint64_t nNextCommit = 0;
+
+    Stats stats;
+};
+
+#endif // GOVERNANCE_INTAKE_H
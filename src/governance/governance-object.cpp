@@ -7,12 +7,14 @@
 #include <governance/governance-classes.h>
 #include <governance/governance-object.h>
 #include <governance/governance-vote.h>
+#include <index/txindex.h>
 #include <instantx.h>
 #include <masternode-sync.h>
 #include <masternodeman.h>
 #include <messagesigner.h>
 #include <util.h>
 #include <txdb.h>
+#include <txmempool.h>
 
 #include <univalue.h>
 
@@ -428,7 +430,7 @@ bool CGovernanceObject::IsValidLocally(std::string& strError, bool fCheckCollate
     return IsValidLocally(strError, fMissingMasternode, fMissingConfirmations, fCheckCollateral);
 }
 
-bool CGovernanceObject::IsValidLocally(std::string& strError, bool& fMissingMasternode, bool& fMissingConfirmations, bool fCheckCollateral)
+bool CGovernanceObject::IsValidLocally(std::string& strError, bool& fMissingMasternode, bool& fMissingConfirmations, bool fCheckCollateral, const CGovernanceObjectPrecheck* pPrecheck)
 {
     fMissingMasternode = false;
     fMissingConfirmations = false;
@@ -471,8 +473,9 @@ bool CGovernanceObject::IsValidLocally(std::string& strError, bool& fMissingMast
                 return false;
             }
 
-            // Check that we have a valid MN signature
-            if(!CheckSignature(infoMn.pubKeyMasternode)) {
+            // Check that we have a valid MN signature, unless it was already verified against the same key
+            bool fSignatureChecked = pPrecheck && pPrecheck->pubKeyMasternode.IsValid() && pPrecheck->pubKeyMasternode == infoMn.pubKeyMasternode;
+            if(!fSignatureChecked && !CheckSignature(infoMn.pubKeyMasternode)) {
                 strError = "Invalid masternode signature for: " + strOutpoint + ", pubkey id = " + infoMn.pubKeyMasternode.GetID().ToString();
                 return false;
             }
@@ -480,7 +483,7 @@ bool CGovernanceObject::IsValidLocally(std::string& strError, bool& fMissingMast
             return true;
         }
 
-        if (!IsCollateralValid(strError, fMissingConfirmations))
+        if (!IsCollateralValid(strError, fMissingConfirmations, pPrecheck))
             return false;
     }
 
@@ -500,6 +503,28 @@ bool CGovernanceObject::IsValidLocally(std::string& strError, bool& fMissingMast
     return true;
 }
 
+void CGovernanceObject::Precheck(CGovernanceObjectPrecheck& precheck)
+{
+    if(fUnparsable) {
+        return;
+    }
+
+    if((nObjectType == GOVERNANCE_OBJECT_TRIGGER) || (nObjectType == GOVERNANCE_OBJECT_WATCHDOG)) {
+        masternode_info_t infoMn;
+        if(mnodeman.GetMasternodeInfo(vinMasternode.prevout, infoMn) && CheckSignature(infoMn.pubKeyMasternode)) {
+            precheck.pubKeyMasternode = infoMn.pubKeyMasternode;
+        }
+    } else if(nObjectType == GOVERNANCE_OBJECT_PROPOSAL) {
+        // GetTransaction would take cs_main, the mempool and the tx index don't need it.
+        // Without the index the collateral is looked up when the object is committed.
+        precheck.txCollateral = mempool.get(nCollateralHash);
+        if(!precheck.txCollateral && g_txindex && !g_txindex->FindTx(nCollateralHash, precheck.nCollateralBlockHash, precheck.txCollateral)) {
+            precheck.txCollateral.reset();
+            precheck.nCollateralBlockHash.SetNull();
+        }
+    }
+}
+
 CAmount CGovernanceObject::GetMinCollateralFee()
 {
     // Only 1 type has a fee for the moment but switch statement allows for future object types
@@ -511,7 +536,7 @@ CAmount CGovernanceObject::GetMinCollateralFee()
     }
 }
 
-bool CGovernanceObject::IsCollateralValid(std::string& strError, bool& fMissingConfirmations)
+bool CGovernanceObject::IsCollateralValid(std::string& strError, bool& fMissingConfirmations, const CGovernanceObjectPrecheck* pPrecheck)
 {
     strError = "";
     fMissingConfirmations = false;
@@ -521,9 +546,12 @@ bool CGovernanceObject::IsCollateralValid(std::string& strError, bool& fMissingC
     CTransactionRef txCollateral;
     uint256 nBlockHash;
 
-    // RETRIEVE TRANSACTION IN QUESTION
+    // RETRIEVE TRANSACTION IN QUESTION, a prefetched one only if it was mined already
 
-    if(!GetTransaction(nCollateralHash, txCollateral, Params().GetConsensus(), nBlockHash)){
+    if(pPrecheck && pPrecheck->txCollateral && pPrecheck->nCollateralBlockHash != uint256()) {
+        txCollateral = pPrecheck->txCollateral;
+        nBlockHash = pPrecheck->nCollateralBlockHash;
+    } else if(!GetTransaction(nCollateralHash, txCollateral, Params().GetConsensus(), nBlockHash)){
         strError = strprintf("Can't find collateral tx %s", nCollateralHash.ToString());
         LogPrintf("CGovernanceObject::IsCollateralValid -- %s\n", strError);
         return false;
@@ -13,6 +13,7 @@
 #include <governance/governance-votedb.h>
 #include <key.h>
 #include <net.h>
+#include <primitives/transaction.h>
 #include <sync.h>
 #include <util.h>
 
@@ -104,6 +105,21 @@ struct vote_rec_t {
      }
 };
 
+/**
+ * Results of the checks on a received object which need neither cs_main nor
+ * the governance lock for long: the masternode signature of triggers and
+ * watchdogs and the collateral lookup of proposals. Computed off the message
+ * thread and handed to IsValidLocally, which then only repeats the parts that
+ * depend on the current chain and masternode list.
+ */
+struct CGovernanceObjectPrecheck
+{
+    /** Masternode key the signature was verified against, invalid if it was not */
+    CPubKey pubKeyMasternode;
+    CTransactionRef txCollateral;
+    uint256 nCollateralBlockHash;
+};
+
 /**
 * Governance Object
 *
@@ -264,10 +280,13 @@ public:
 
     bool IsValidLocally(std::string& strError, bool fCheckCollateral);
 
-    bool IsValidLocally(std::string& strError, bool& fMissingMasternode, bool& fMissingConfirmations, bool fCheckCollateral);
+    bool IsValidLocally(std::string& strError, bool& fMissingMasternode, bool& fMissingConfirmations, bool fCheckCollateral, const CGovernanceObjectPrecheck* pPrecheck = nullptr);
 
     /// Check the collateral transaction for the budget proposal/finalized budget
-    bool IsCollateralValid(std::string& strError, bool &fMissingConfirmations);
+    bool IsCollateralValid(std::string& strError, bool &fMissingConfirmations, const CGovernanceObjectPrecheck* pPrecheck = nullptr);
+
+    /// Verify the signature or fetch the collateral ahead of IsValidLocally, without holding cs_main
+    void Precheck(CGovernanceObjectPrecheck& precheck);
 
     void UpdateLocalValidity();
 
@@ -6,6 +6,7 @@
 #include <governance/governance-object.h>
 #include <governance/governance-vote.h>
 #include <governance/governance-classes.h>
+#include <governance/governance-intake.h>
 #include <net_processing.h>
 #include <masternode.h>
 #include <masternode-sync.h>
@@ -170,64 +171,32 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
-        LOCK2(cs_main, cs);
-
-        if(mapObjects.count(nHash) || mapPostponedObjects.count(nHash) ||
-           mapErasedGovernanceObjects.count(nHash) || mapMasternodeOrphanObjects.count(nHash)) {
-            // TODO - print error code? what if it's GOVOBJ_ERROR_IMMATURE?
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received already seen object: %s\n", strHash);
-            return;
-        }
-
         bool fRateCheckBypassed = false;
-        if(!MasternodeRateCheck(govobj, true, false, fRateCheckBypassed)) {
-            LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
-            return;
-        }
-
-        std::string strError = "";
-        // CHECK OBJECT AGAINST LOCAL BLOCKCHAIN
+        {
+            LOCK(cs);
 
-        bool fMasternodeMissing = false;
-        bool fMissingConfirmations = false;
-        bool fIsValid = govobj.IsValidLocally(strError, fMasternodeMissing, fMissingConfirmations, true);
+            if(IsObjectKnown(nHash) || governanceintake.IsQueued(nHash)) {
+                // TODO - print error code? what if it's GOVOBJ_ERROR_IMMATURE?
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received already seen object: %s\n", strHash);
+                return;
+            }
 
-        if(fRateCheckBypassed && (fIsValid || fMasternodeMissing)) {
-            if(!MasternodeRateCheck(govobj, true)) {
-                LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed (after signature verification) - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
+            if(!MasternodeRateCheck(govobj, true, false, fRateCheckBypassed)) {
+                LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
                 return;
             }
         }
 
-        if(!fIsValid) {
-            if(fMasternodeMissing) {
-
-                int& count = mapMasternodeOrphanCounter[govobj.GetMasternodeVin().prevout];
-                if (count >= 10) {
-                    LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Too many orphan objects, missing masternode=%s\n", govobj.GetMasternodeVin().prevout.ToString());
-                    // ask for this object again in 2 minutes
-                    CInv inv(MSG_GOVERNANCE_OBJECT, govobj.GetHash());
-                    pfrom->AskFor(inv);
-                    return;
-                }
-
-                count++;
-                ExpirationInfo info(pfrom->GetId(), GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME);
-                mapMasternodeOrphanObjects.insert(std::make_pair(nHash, object_info_pair_t(govobj, info)));
-                LogPrintf("MNGOVERNANCEOBJECT -- Missing masternode for: %s, strError = %s\n", strHash, strError);
-            } else if(fMissingConfirmations) {
-                AddPostponedObject(govobj);
-                LogPrintf("MNGOVERNANCEOBJECT -- Not enough fee confirmations for: %s, strError = %s\n", strHash, strError);
-            } else {
-                LogPrintf("MNGOVERNANCEOBJECT -- Governance object is invalid - %s\n", strError);
-                // apply node's ban score
-                Misbehaving(pfrom->GetId(), 20);
+        // Leave the signature and collateral checks to the validation threads if there are any
+        if(governanceintake.IsRunning()) {
+            if(!governanceintake.Push(pfrom, govobj, fRateCheckBypassed)) {
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- validation queue is full, asking for %s again later\n", strHash);
+                pfrom->AskFor(CInv(MSG_GOVERNANCE_OBJECT, nHash));
             }
-
             return;
         }
 
-        AddGovernanceObject(govobj, connman, pfrom);
+        ProcessObject(pfrom, govobj, fRateCheckBypassed, nullptr, connman);
     }
 
     // A NEW GOVERNANCE OBJECT VOTE HAS ARRIVED
@@ -273,6 +242,64 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
     }
 }
 
+void CGovernanceManager::ProcessObject(CNode* pfrom, CGovernanceObject& govobj, bool fRateCheckBypassed, const CGovernanceObjectPrecheck* pPrecheck, CConnman& connman)
+{
+    uint256 nHash = govobj.GetHash();
+    std::string strHash = nHash.ToString();
+
+    LOCK2(cs_main, cs);
+
+    // It may have been added by someone else while it was being validated
+    if(IsObjectKnown(nHash)) {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received already seen object: %s\n", strHash);
+        return;
+    }
+
+    std::string strError = "";
+    // CHECK OBJECT AGAINST LOCAL BLOCKCHAIN
+
+    bool fMasternodeMissing = false;
+    bool fMissingConfirmations = false;
+    bool fIsValid = govobj.IsValidLocally(strError, fMasternodeMissing, fMissingConfirmations, true, pPrecheck);
+
+    if(fRateCheckBypassed && (fIsValid || fMasternodeMissing)) {
+        if(!MasternodeRateCheck(govobj, true)) {
+            LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed (after signature verification) - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
+            return;
+        }
+    }
+
+    if(!fIsValid) {
+        if(fMasternodeMissing) {
+
+            int& count = mapMasternodeOrphanCounter[govobj.GetMasternodeVin().prevout];
+            if (count >= 10) {
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Too many orphan objects, missing masternode=%s\n", govobj.GetMasternodeVin().prevout.ToString());
+                // ask for this object again in 2 minutes
+                CInv inv(MSG_GOVERNANCE_OBJECT, govobj.GetHash());
+                pfrom->AskFor(inv);
+                return;
+            }
+
+            count++;
+            ExpirationInfo info(pfrom->GetId(), GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME);
+            mapMasternodeOrphanObjects.insert(std::make_pair(nHash, object_info_pair_t(govobj, info)));
+            LogPrintf("MNGOVERNANCEOBJECT -- Missing masternode for: %s, strError = %s\n", strHash, strError);
+        } else if(fMissingConfirmations) {
+            AddPostponedObject(govobj);
+            LogPrintf("MNGOVERNANCEOBJECT -- Not enough fee confirmations for: %s, strError = %s\n", strHash, strError);
+        } else {
+            LogPrintf("MNGOVERNANCEOBJECT -- Governance object is invalid - %s\n", strError);
+            // apply node's ban score
+            Misbehaving(pfrom->GetId(), 20);
+        }
+
+        return;
+    }
+
+    AddGovernanceObject(govobj, connman, pfrom, pPrecheck);
+}
+
 void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernanceException& exception, CConnman& connman)
 {
     uint256 nHash = govobj.GetHash();
@@ -300,7 +327,7 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernance
     }
 }
 
-void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, CNode* pfrom)
+void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, CNode* pfrom, const CGovernanceObjectPrecheck* pPrecheck)
 {
     uint256 nHash = govobj.GetHash();
     std::string strHash = nHash.ToString();
@@ -314,7 +341,9 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
 
     // MAKE SURE THIS OBJECT IS OK
 
-    if(!govobj.IsValidLocally(strError, true)) {
+    bool fMissingMasternode = false;
+    bool fMissingConfirmations = false;
+    if(!govobj.IsValidLocally(strError, fMissingMasternode, fMissingConfirmations, true, pPrecheck)) {
         LogPrintf("CGovernanceManager::AddGovernanceObject -- invalid governance object - %s - (nCachedBlockHeight %d) \n", strError, nCachedBlockHeight);
         return;
     }
@@ -675,6 +704,13 @@ void CGovernanceManager::DoMaintenance(CConnman& connman)
     UpdateCachesAndClean();
 }
 
+bool CGovernanceManager::IsObjectKnown(const uint256& nHash) const
+{
+    AssertLockHeld(cs);
+    return mapObjects.count(nHash) || mapPostponedObjects.count(nHash) ||
+           mapErasedGovernanceObjects.count(nHash) || mapMasternodeOrphanObjects.count(nHash);
+}
+
 bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
 {
     // do not request objects until it's time to sync
@@ -688,7 +724,7 @@ bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
     switch(inv.type) {
     case MSG_GOVERNANCE_OBJECT:
     {
-        if(mapObjects.count(inv.hash) == 1 || mapPostponedObjects.count(inv.hash) == 1) {
+        if(mapObjects.count(inv.hash) == 1 || mapPostponedObjects.count(inv.hash) == 1 || governanceintake.IsQueued(inv.hash)) {
             LogPrint(BCLog::GOBJECT, "CGovernanceManager::ConfirmInventoryRequest already have governance object, returning false\n");
             return false;
         }
@@ -147,6 +147,7 @@ public:
 class CGovernanceManager
 {
     friend class CGovernanceObject;
+    friend struct CGovernanceTest; // for test access to mapObjects and nCachedBlockHeight
 
 public: // Types
     struct last_object_rec {
@@ -312,7 +313,14 @@ public:
     std::vector<CGovernanceObject*> GetAllNewerThan(int64_t nMoreThanTime);
 
     bool IsBudgetPaymentBlock(int nBlockHeight);
-    void AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, CNode* pfrom = NULL);
+    void AddGovernanceObject(CGovernanceObject& govobj, CConnman& connman, CNode* pfrom = NULL, const CGovernanceObjectPrecheck* pPrecheck = nullptr);
+
+    /**
+     * Validate a received object against the chain and the masternode list and
+     * add, postpone or reject it. Called on the message thread, or by the
+     * governance intake with the results of CGovernanceObject::Precheck.
+     */
+    void ProcessObject(CNode* pfrom, CGovernanceObject& govobj, bool fRateCheckBypassed, const CGovernanceObjectPrecheck* pPrecheck, CConnman& connman);
 
     std::string GetRequiredPaymentsString(int nBlockHeight);
 
@@ -441,6 +449,9 @@ private:
     /// Called to indicate a requested object has been received
     bool AcceptObjectMessage(const uint256& nHash);
 
+    /// Whether the object was added, postponed, erased or kept as an orphan already, requires cs
+    bool IsObjectKnown(const uint256& nHash) const;
+
     /// Called to indicate a requested vote has been received
     bool AcceptVoteMessage(const uint256& nHash);
 
@@ -62,6 +62,7 @@
 #include <tpos/merchantnodeman.h>
 #include <netfulfilledman.h>
 #include <governance/governance.h>
+#include <governance/governance-intake.h>
 #include <tpos/merchantnode-sync.h>
 #include <flat-database.h>
 
@@ -298,6 +299,8 @@ void Shutdown()
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
+    // Holds references to nodes and commits through connman
+    governanceintake.Stop();
     if (g_connman) g_connman->Stop();
     peerLogic.reset();
     g_connman.reset();
@@ -385,6 +388,7 @@ void Shutdown()
     globalVerifyHandle.reset();
     ECC_Stop();
     LogPrintf("%s: done\n", __func__);
+    g_logger->StopAsyncWriter();
 }
 
 /**
@@ -457,6 +461,8 @@ void SetupServerArgs()
     gArgs.AddArg("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-loadblock=<file>", "Imports blocks from external blk000??.dat file on startup", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-loadblockthreads=<n>", strprintf("Set the number of threads reading block files during -reindex and -loadblock (%u to %d, 0 = auto, <0 = leave that many cores free, 1 = read on the import thread, default: %d)",
+        -GetNumCores(), MAX_LOADBLOCK_THREADS, DEFAULT_LOADBLOCK_THREADS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY), false, OptionsCategory::OPTIONS);
@@ -541,9 +547,11 @@ void SetupServerArgs()
     gArgs.AddArg("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-capturemessages", strprintf("Capture all P2P messages to disk, for replay with contrib/replay (default: %u)", DEFAULT_CAPTUREMESSAGES), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-dropmessagestest=<n>", "Randomly drop 1 of every <n> network messages", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-stopafterblockimport", strprintf("Stop running after importing blocks from disk (default: %u)", DEFAULT_STOPAFTERBLOCKIMPORT), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-schedulerthreads=<n>", strprintf("Number of threads running background tasks and validation interface callbacks, more than one runs periodic tasks concurrently (1 to %d, default: %d)", MAX_SCHEDULER_THREADS, DEFAULT_SCHEDULER_THREADS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-stopatheight", strprintf("Stop running after reaching the given height in the main chain (default: %u)", DEFAULT_STOPATHEIGHT), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-limitancestorcount=<n>", strprintf("Do not accept transactions if number of in-mempool ancestors is <n> or more (default: %u)", DEFAULT_ANCESTOR_LIMIT), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-limitancestorsize=<n>", strprintf("Do not accept transactions whose size with all in-mempool ancestors exceeds <n> kilobytes (default: %u)", DEFAULT_ANCESTOR_SIZE_LIMIT), true, OptionsCategory::DEBUG_TEST);
@@ -551,12 +559,15 @@ void SetupServerArgs()
     gArgs.AddArg("-limitdescendantsize=<n>", strprintf("Do not accept transactions if any ancestor would have more than <n> kilobytes of in-mempool descendants (default: %u).", DEFAULT_DESCENDANT_SIZE_LIMIT), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-vbparams=deployment:start:end", "Use given start/end times for specified version bits deployment (regtest-only)", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-addrmantest", "Allows to test address relay on localhost", true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-scriptcachewarmup", strprintf("Verify mempool transactions in the background when the next block brings new script flags, so block connection hits the script caches (default: %u)", DEFAULT_SCRIPT_CACHE_WARMUP), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-debug=<category>", strprintf("Output debugging information (default: %u, supplying <category> is optional)", 0) + ". " +
         "If <category> is not supplied or if <category> = 1, output all debugging information. <category> can be: " + ListLogCategories() + ".", false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-debugexclude=<category>", strprintf("Exclude debugging information for a category. Can be used in conjunction with -debug=1 to output debug logs for all categories except one or more specified categories."), false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-help-debug", "Show all debugging options (usage: --help -help-debug)", false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logips", strprintf("Include IP addresses in debug output (default: %u)", DEFAULT_LOGIPS), false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logtimestamps", strprintf("Prepend debug output with timestamp (default: %u)", DEFAULT_LOGTIMESTAMPS), false, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-logasync", strprintf("Write debug.log from a background thread instead of the logging thread; the last lines before a crash may be lost (default: %u)", DEFAULT_LOGASYNC), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-lograte=<n>", strprintf("Log at most <n> lines per second for each -debug category, 0 = unlimited (default: %u)", DEFAULT_LOGRATELIMIT), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
@@ -608,6 +619,7 @@ void SetupServerArgs()
     gArgs.AddArg("-mnconflock=<n>", "Lock masternodes from masternode configuration file (default: %u)", false, OptionsCategory::MASTERNODE);
     gArgs.AddArg("-masternodeprivkey=<n>", "Set the masternode private key", false, OptionsCategory::MASTERNODE);
     gArgs.AddArg("-clearmncache", "Clears mncache on startup", false, OptionsCategory::MASTERNODE);
+    gArgs.AddArg("-govvalidationthreads=<n>", strprintf("Number of threads validating received governance objects, 0 validates them on the message thread (0 to %d, default: %d)", MAX_GOVERNANCE_VALIDATION_THREADS, DEFAULT_GOVERNANCE_VALIDATION_THREADS), true, OptionsCategory::MASTERNODE);
 
     gArgs.AddArg("-merchantnode=<n>", "Enable the client to act as a merchantnode (0-1, default: false", false, OptionsCategory::MERCHANTNODE);
     gArgs.AddArg("-merchantnodeprivkey=<n>", "Set the masternode private key", false, OptionsCategory::MERCHANTNODE);
@@ -737,20 +749,23 @@ static void ThreadImport(std::vector<fs::path> vImportFiles)
     {
         CImportingNow imp;
 
+        // -loadblockthreads=0 means autodetect, 1 reads block files on this thread only
+        int nReadThreads = gArgs.GetArg("-loadblockthreads", DEFAULT_LOADBLOCK_THREADS);
+        if (nReadThreads <= 0)
+            nReadThreads += GetNumCores();
+        nReadThreads = std::max(1, std::min(nReadThreads, MAX_LOADBLOCK_THREADS));
+
         // -reindex
         if (fReindex) {
-            int nFile = 0;
+            std::vector<fs::path> vBlockFiles;
             while (true) {
-                CDiskBlockPos pos(nFile, 0);
-                if (!fs::exists(GetBlockPosFilename(pos, "blk")))
+                fs::path path = GetBlockPosFilename(CDiskBlockPos(vBlockFiles.size(), 0), "blk");
+                if (!fs::exists(path))
                     break; // No block files left to reindex
-                FILE *file = OpenBlockFile(pos, true);
-                if (!file)
-                    break; // This error is logged in OpenBlockFile
-                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-                LoadExternalBlockFile(chainparams, file, &pos);
-                nFile++;
+                vBlockFiles.push_back(path);
             }
+            LogPrintf("Reindexing %u block files using %d reader threads\n", vBlockFiles.size(), nReadThreads);
+            LoadExternalBlockFiles(chainparams, vBlockFiles, true, nReadThreads);
             pblocktree->WriteReindexing(false);
             fReindex = false;
             LogPrintf("Reindexing finished\n");
@@ -773,15 +788,7 @@ static void ThreadImport(std::vector<fs::path> vImportFiles)
         }
 
         // -loadblock=
-        for (const fs::path& path : vImportFiles) {
-            FILE *file = fsbridge::fopen(path, "rb");
-            if (file) {
-                LogPrintf("Importing blocks file %s...\n", path.string());
-                LoadExternalBlockFile(chainparams, file);
-            } else {
-                LogPrintf("Warning: Could not open blocks file %s\n", path.string());
-            }
-        }
+        LoadExternalBlockFiles(chainparams, vImportFiles, false, nReadThreads);
 
         // scan for better chains in the block chain database, that are not yet connected in the active best chain
         CValidationState state;
@@ -935,6 +942,7 @@ void InitLogging()
     g_logger->m_print_to_console = gArgs.GetBoolArg("-printtoconsole", !gArgs.GetBoolArg("-daemon", false));
     g_logger->m_log_timestamps = gArgs.GetBoolArg("-logtimestamps", DEFAULT_LOGTIMESTAMPS);
     g_logger->m_log_time_micros = gArgs.GetBoolArg("-logtimemicros", DEFAULT_LOGTIMEMICROS);
+    g_logger->m_rate_limit = std::max<int64_t>(0, gArgs.GetArg("-lograte", DEFAULT_LOGRATELIMIT));
 
     fLogIPs = gArgs.GetBoolArg("-logips", DEFAULT_LOGIPS);
 
@@ -1455,6 +1463,9 @@ bool AppInitMain()
             return InitError(strprintf("Could not open debug log file %s",
                                        g_logger->m_file_path.string()));
         }
+        if (gArgs.GetBoolArg("-logasync", DEFAULT_LOGASYNC)) {
+            g_logger->StartAsyncWriter();
+        }
     }
 
     if (!g_logger->m_log_timestamps)
@@ -1482,11 +1493,14 @@ bool AppInitMain()
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
-    // Start the lightweight task scheduler thread
+    // Start the lightweight task scheduler threads
+    int nSchedulerThreads = std::max(1, std::min<int>(gArgs.GetArg("-schedulerthreads", DEFAULT_SCHEDULER_THREADS), MAX_SCHEDULER_THREADS));
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
-    threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
+    for (int i = 0; i < nSchedulerThreads; i++) {
+        threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
+    }
 
-    GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+    GetMainSignals().RegisterBackgroundSignalScheduler(scheduler, nSchedulerThreads);
     GetMainSignals().RegisterWithMempoolSignals(mempool);
 
     /* Register RPC commands regardless of -server setting so they will be
@@ -1523,7 +1537,7 @@ bool AppInitMain()
     CConnman& connman = *g_connman;
 
     peerLogic.reset(new PeerLogicValidation(&connman, scheduler));
-    RegisterValidationInterface(peerLogic.get());
+    RegisterValidationInterface(peerLogic.get(), "net_processing");
 
     // sanitize comments per BIP-0014, format user agent and check total size
     std::vector<std::string> uacomments;
@@ -1615,12 +1629,12 @@ bool AppInitMain()
     pzmqNotificationInterface = CZMQNotificationInterface::Create();
 
     if (pzmqNotificationInterface) {
-        RegisterValidationInterface(pzmqNotificationInterface);
+        RegisterValidationInterface(pzmqNotificationInterface, "zmq");
     }
 #endif
 
     pdsNotificationInterface = new CDSNotificationInterface(connman);
-    RegisterValidationInterface(pdsNotificationInterface);
+    RegisterValidationInterface(pdsNotificationInterface, "dsnotification");
 
     uint64_t nMaxOutboundLimit = 0; //unlimited unless -maxuploadtarget is set
     uint64_t nMaxOutboundTimeframe = MAX_UPLOAD_TIMEFRAME;
@@ -1747,6 +1761,19 @@ bool AppInitMain()
                 pcoinsTip.reset(new CCoinsViewCache(pcoinscatcher.get()));
 
                 bool is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
+
+                // TPoS contracts are indexed as blocks get connected, so a chainstate built before
+                // the index existed has to be replayed before block files may be pruned.
+                bool fTPoSContractIndex = false;
+                pblocktree->ReadFlag("tposcontractindex", fTPoSContractIndex);
+                if (is_coinsview_empty && !fTPoSContractIndex) {
+                    pblocktree->WriteFlag("tposcontractindex", true);
+                } else if (!fTPoSContractIndex && fPruneMode) {
+                    strLoadError = fHavePruned ?
+                                _("You need to rebuild the database using -reindex to build the TPoS contract index required in prune mode.") :
+                                _("You need to rebuild the database using -reindex-chainstate to build the TPoS contract index required in prune mode.");
+                    break;
+                }
                 if (!is_coinsview_empty) {
                     // LoadChainTip sets chainActive based on pcoinsTip's best block
                     if (!LoadChainTip(chainparams)) {
@@ -1921,6 +1948,10 @@ bool AppInitMain()
     // ********************************************************* Step 11d: start thread for xsn extensions
 
     threadGroup.create_thread(boost::bind(net_processing_xsn::ThreadProcessExtensions, g_connman.get()));
+    if(!fLiteMode) {
+        int nGovValidationThreads = std::max(0, std::min<int>(gArgs.GetArg("-govvalidationthreads", DEFAULT_GOVERNANCE_VALIDATION_THREADS), MAX_GOVERNANCE_VALIDATION_THREADS));
+        governanceintake.Start(nGovValidationThreads, g_connman.get());
+    }
 
     // ********************************************************* Step 12: start node
 
@@ -1956,6 +1987,7 @@ bool AppInitMain()
     connOptions.nSendBufferMaxSize = 1000*gArgs.GetArg("-maxsendbuffer", DEFAULT_MAXSENDBUFFER);
     connOptions.nReceiveFloodSize = 1000*gArgs.GetArg("-maxreceivebuffer", DEFAULT_MAXRECEIVEBUFFER);
     connOptions.m_added_nodes = gArgs.GetArgs("-addnode");
+    connOptions.m_capture_messages = gArgs.GetBoolArg("-capturemessages", DEFAULT_CAPTUREMESSAGES);
 
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
@@ -2005,6 +2037,10 @@ bool AppInitMain()
     SetRPCWarmupFinished();
     uiInterface.InitMessage(_("Done loading"));
 
+    if (gArgs.GetBoolArg("-scriptcachewarmup", DEFAULT_SCRIPT_CACHE_WARMUP)) {
+        scheduler.scheduleEvery([&chainparams] { WarmScriptCacheFromMempool(chainparams, SCRIPT_CACHE_WARMUP_BATCH); }, SCRIPT_CACHE_WARMUP_INTERVAL);
+    }
+
     g_wallet_init_interface.Start(scheduler);
     if(GetWallets().front() && gArgs.GetBoolArg("-staking", true))
     {
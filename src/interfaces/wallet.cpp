@@ -83,6 +83,7 @@ WalletTx MakeWalletTx(CWallet& wallet, const CWalletTx& wtx)
     result.time = wtx.GetTxTime();
     result.value_map = wtx.mapValue;
     result.is_coinbase = wtx.IsCoinBase();
+    result.order_pos = wtx.nOrderPos;
     return result;
 }
 
@@ -316,6 +317,26 @@ public:
         return result;
     }
 
+    std::vector<WalletTx> getWalletTxsOrdered(int64_t& order_pos, size_t max_count) override
+    {
+        LOCK2(::cs_main, m_wallet.cs_wallet);
+        std::vector<WalletTx> result;
+        auto it = m_wallet.wtxOrdered.lower_bound(order_pos);
+        while (it != m_wallet.wtxOrdered.begin()) {
+            // never split entries sharing an order position across pages
+            if (result.size() >= max_count && std::prev(it)->first != order_pos) break;
+            --it;
+            order_pos = it->first;
+            if (CWalletTx* wtx = it->second.first) {
+                result.emplace_back(MakeWalletTx(m_wallet, *wtx));
+            }
+        }
+        if (it == m_wallet.wtxOrdered.begin()) {
+            order_pos = std::numeric_limits<int64_t>::min();
+        }
+        return result;
+    }
+
     const std::map<uint256, TPoSContract> &getOwnerContracts() const override
     {
         return m_wallet.tposOwnerContracts;
@@ -348,6 +369,23 @@ public:
         tx_status = MakeWalletTxStatus(mi->second);
         return true;
     }
+    std::vector<std::pair<uint256, WalletTxStatus>> getTxStatuses(const std::vector<uint256>& txids,
+        int& num_blocks,
+        int64_t& adjusted_time) override
+    {
+        LOCK2(::cs_main, m_wallet.cs_wallet);
+        std::vector<std::pair<uint256, WalletTxStatus>> result;
+        result.reserve(txids.size());
+        for (const uint256& txid : txids) {
+            auto mi = m_wallet.mapWallet.find(txid);
+            if (mi != m_wallet.mapWallet.end()) {
+                result.emplace_back(txid, MakeWalletTxStatus(mi->second));
+            }
+        }
+        num_blocks = ::chainActive.Height();
+        adjusted_time = GetAdjustedTime();
+        return result;
+    }
     WalletTx getWalletTxDetails(const uint256& txid,
         WalletTxStatus& tx_status,
         WalletOrderForm& order_form,
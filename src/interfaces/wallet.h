@@ -189,6 +189,10 @@ public:
     //! Get list of all wallet transactions.
     virtual std::vector<WalletTx> getWalletTxs() = 0;
 
+    //! Get up to max_count wallet transactions ordered before order_pos, newest
+    //! first, and move order_pos past the last one returned.
+    virtual std::vector<WalletTx> getWalletTxsOrdered(int64_t& order_pos, size_t max_count) = 0;
+
     virtual const std::map<uint256, TPoSContract> &getOwnerContracts() const = 0;
 
     virtual CAmount getStakeSplitThreshold() const = 0;
@@ -199,6 +203,12 @@ public:
         int& num_blocks,
         int64_t& adjusted_time) = 0;
 
+    //! Get updated status for a batch of transactions, taking the locks once.
+    //! Transactions no longer in the wallet are left out of the result.
+    virtual std::vector<std::pair<uint256, WalletTxStatus>> getTxStatuses(const std::vector<uint256>& txids,
+        int& num_blocks,
+        int64_t& adjusted_time) = 0;
+
     //! Get transaction details.
     virtual WalletTx getWalletTxDetails(const uint256& txid,
         WalletTxStatus& tx_status,
@@ -359,6 +369,7 @@ struct WalletTx
     int64_t time;
     std::map<std::string, std::string> value_map;
     bool is_coinbase;
+    int64_t order_pos;
 };
 
 //! Updated transaction status.
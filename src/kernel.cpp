@@ -7,7 +7,9 @@
 #include <boost/lexical_cast.hpp>
 
 #include <db.h>
+#include <index/txindex.h>
 #include <kernel.h>
+#include <perfstats.h>
 #include <script/interpreter.h>
 #include <timedata.h>
 #include <util.h>
@@ -17,6 +19,7 @@
 #include <init.h>
 #include <validation.h>
 #include <tpos/tposutils.h>
+#include <undo.h>
 #include <utiltime.h>
 
 #include <numeric>
@@ -255,10 +258,12 @@ bool ComputeNextStakeModifier(const CBlockIndex* pindexCurrent, uint64_t& nStake
 static bool GetKernlStakeModifierV03(uint256 hashBlockFrom, unsigned int nTimeTx, uint64_t& nStakeModifier, int& nStakeModifierHeight, int64_t& nStakeModifierTime, bool fPrintProofOfStake)
 {
     nStakeModifier = 0;
-    if (!mapBlockIndex.count(hashBlockFrom))
+    // find() rather than operator[], stakers look blocks up from several threads at once
+    BlockMap::const_iterator it = mapBlockIndex.find(hashBlockFrom);
+    if (it == mapBlockIndex.end())
         return error("GetKernelStakeModifier() : block not indexed");
 
-    const CBlockIndex* pindexFrom = mapBlockIndex[hashBlockFrom];
+    const CBlockIndex* pindexFrom = it->second;
     nStakeModifierHeight = pindexFrom->nHeight;
     nStakeModifierTime = pindexFrom->GetBlockTime();
     int64_t nStakeModifierSelectionInterval = GetStakeModifierSelectionInterval();
@@ -384,10 +389,23 @@ uint256 stakeHash(unsigned int nTimeTx, CDataStream ss, unsigned int prevoutInde
 //   quantities so as to generate blocks faster, degrading the system back into
 //   a proof-of-work situation.
 //
-bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, uint256 hashBlockFrom, int64_t blockFromTime,
-                          const CTransactionRef& txPrev, const COutPoint& prevout, unsigned int nTimeTx,
-                          uint256& hashProofOfStake, bool fPoSV3, bool fPrintProofOfStake)
+bool GetStakeModifier(const CBlockIndex* pindexPrev, const uint256& hashBlockFrom, bool fPoSV3, CStakeModifier& modifier)
+{
+    modifier = CStakeModifier();
+    modifier.fPoSV3 = fPoSV3;
+    if (fPoSV3) {
+        modifier.hashStakeModifierV3 = pindexPrev->hashStakeModifierV3;
+        return true;
+    }
+
+    // the v0.3 modifier only depends on the block of the staked coin, not on the time of the stake
+    return GetKernelStakeModifier(hashBlockFrom, 0, modifier.nStakeModifier, modifier.nStakeModifierHeight, modifier.nStakeModifierTime, false);
+}
+
+bool CheckStakeKernelHash(const CStakeModifier& modifier, unsigned int nBits, int64_t blockFromTime, CAmount nValueIn,
+                          const COutPoint& prevout, unsigned int nTimeTx, uint256& hashProofOfStake)
 {
+    hashProofOfStake.SetNull();
     auto nTxPrevOffset = 336;
     auto txPrevTime = blockFromTime;
     unsigned int nTimeBlockFrom = blockFromTime;
@@ -401,7 +419,6 @@ bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, uin
 
     arith_uint256 bnTargetPerCoinDay;
     bnTargetPerCoinDay.SetCompact(nBits);
-    CAmount nValueIn = txPrev->vout[prevout.n].nValue;
     // v0.3 protocol kernel hash weight starts from 0 at the 30-day min age
     // this change increases active coins participating the hash and helps
     // to secure the network when proof-of-stake difficulty is low
@@ -410,62 +427,53 @@ bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, uin
 
     // Calculate hash
     CDataStream ss(SER_GETHASH, 0);
-    uint64_t nStakeModifier = 0;
-    int nStakeModifierHeight = 0;
-    int64_t nStakeModifierTime = 0;
-
-    if(fPoSV3) {
-        ss << pindexPrev->hashStakeModifierV3;
+    if(modifier.fPoSV3) {
+        ss << modifier.hashStakeModifierV3;
     }
     else {
-
-        if (!GetKernelStakeModifier(hashBlockFrom, nTimeTx, nStakeModifier, nStakeModifierHeight, nStakeModifierTime, fPrintProofOfStake))
-            return error("Failed to get kernel stake modifier");
-
-        ss << nStakeModifier;
+        ss << modifier.nStakeModifier;
     }
 
     ss << nTimeBlockFrom << nTxPrevOffset << txPrevTime << prevout.n << nTimeTx;
     hashProofOfStake = Hash(ss.begin(), ss.end());
-    if (fPrintProofOfStake)
-    {
-        LogPrint(BCLog::KERNEL, "%s : using modifier 0x%016" PRI64x" at height=%d timestamp=%s for block from height=%d timestamp=%s\n",
-                 __func__,
-                 nStakeModifier, nStakeModifierHeight,
-                 DateTimeStrFormat("%Y-%m-%d %H:%M:%S", nStakeModifierTime).c_str(),
-                 mapBlockIndex[hashBlockFrom]->nHeight,
-                 DateTimeStrFormat("%Y-%m-%d %H:%M:%S", blockFromTime).c_str());
-
-        LogPrint(BCLog::KERNEL, "%s : check protocol=%s modifier=0x%016" PRI64x" nTimeBlockFrom=%u nTxPrevOffset=%u nTimeTxPrev=%u nPrevout=%u nTimeTx=%u hashProof=%s\n",
-                 __func__,
-                 "0.5",
-                 nStakeModifier,
-                 blockFromTime, nTxPrevOffset,
-                 txPrevTime, prevout.n, nTimeTx,
-                 hashProofOfStake.ToString().c_str());
-    }
 
     // Now check if proof-of-stake hash meets target protocol
-    if (UintToArith256(hashProofOfStake) > bnCoinDayWeight * bnTargetPerCoinDay)
-        return false;
+    return UintToArith256(hashProofOfStake) <= bnCoinDayWeight * bnTargetPerCoinDay;
+}
+
+bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, uint256 hashBlockFrom, int64_t blockFromTime,
+                          CAmount nValueIn, const COutPoint& prevout, unsigned int nTimeTx,
+                          uint256& hashProofOfStake, bool fPoSV3, bool fPrintProofOfStake)
+{
+    CStakeModifier modifier;
+    if (!GetStakeModifier(pindexPrev, hashBlockFrom, fPoSV3, modifier))
+        return error("Failed to get kernel stake modifier");
 
+    bool fPass = CheckStakeKernelHash(modifier, nBits, blockFromTime, nValueIn, prevout, nTimeTx, hashProofOfStake);
     if (fPrintProofOfStake)
     {
-        LogPrint(BCLog::KERNEL, "%s : Generated using modifier 0x%016" PRI64x" at height=%d timestamp=%s for block from height=%d timestamp=%s\n",
+        int nHeightBlockFrom = -1;
+        BlockMap::const_iterator it = mapBlockIndex.find(hashBlockFrom);
+        if (it != mapBlockIndex.end())
+            nHeightBlockFrom = it->second->nHeight;
+
+        LogPrint(BCLog::KERNEL, "%s : %s modifier 0x%016" PRI64x" at height=%d timestamp=%s for block from height=%d timestamp=%s\n",
                  __func__,
-                 nStakeModifier, nStakeModifierHeight,
-                 DateTimeStrFormat("%Y-%m-%d %H:%M:%S", nStakeModifierTime).c_str(),
-                 mapBlockIndex[hashBlockFrom]->nHeight,
+                 fPass ? "Generated using" : "using",
+                 modifier.nStakeModifier, modifier.nStakeModifierHeight,
+                 DateTimeStrFormat("%Y-%m-%d %H:%M:%S", modifier.nStakeModifierTime).c_str(),
+                 nHeightBlockFrom,
                  DateTimeStrFormat("%Y-%m-%d %H:%M:%S", blockFromTime).c_str());
 
-        LogPrint(BCLog::KERNEL, "%s : Generated pass protocol=%s modifier=0x%016" PRI64x" nTimeBlockFrom=%u nTxPrevOffset=%u nTimeTxPrev=%u nPrevout=%u nTimeTx=%u hashProof=%s\n",
+        LogPrint(BCLog::KERNEL, "%s : %s protocol=%s modifier=0x%016" PRI64x" nTimeBlockFrom=%u nTxPrevOffset=%u nTimeTxPrev=%u nPrevout=%u nTimeTx=%u hashProof=%s\n",
                  __func__,
+                 fPass ? "Generated pass" : "check",
                  "0.5",
-                 nStakeModifier,
-                 blockFromTime, nTxPrevOffset, txPrevTime, prevout.n, nTimeTx,
+                 modifier.nStakeModifier,
+                 blockFromTime, 336, blockFromTime, prevout.n, nTimeTx,
                  hashProofOfStake.ToString().c_str());
     }
-    return true;
+    return fPass;
 }
 
 bool CheckKernelScript(CScript scriptVin, CScript scriptVout)
@@ -494,9 +502,128 @@ bool CheckKernelScript(CScript scriptVin, CScript scriptVout)
     return extractKeyID(scriptVin) == extractKeyID(scriptVout);
 }
 
+// Whether prevout is spent by one of the blocks after pindexFork on the branch ending at pindexPrev
+static bool IsSpentOnBranch(const CBlockIndex* pindexPrev, const CBlockIndex* pindexFork, const COutPoint& prevout,
+                            bool& fMissingInputs, const Consensus::Params& params)
+{
+    for (const CBlockIndex* pindex = pindexPrev; pindex != pindexFork; pindex = pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, params)) {
+            fMissingInputs = true;
+            return true;
+        }
+        for (const auto& tx : block.vtx) {
+            for (const CTxIn& txin : tx->vin) {
+                if (txin.prevout == prevout)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool GetKernelInput(const CBlockIndex* pindexPrev, const COutPoint& prevout, CTxOut& txout,
+                    const CBlockIndex*& pindexFrom, bool& fMissingInputs, const Consensus::Params& params)
+{
+    AssertLockHeld(cs_main);
+
+    fMissingInputs = false;
+    const CBlockIndex* pindexFork = chainActive.FindFork(pindexPrev);
+    if (!pindexFork)
+        return false;
+    const int nActiveDepth = chainActive.Height() - pindexFork->nHeight;
+    const int nForkDepth = pindexPrev->nHeight - pindexFork->nHeight;
+
+    bool fFound = false;
+
+    // Common case: the output is unspent at our tip and confirmed no later than the fork point
+    Coin coin;
+    if (pcoinsTip->GetCoin(prevout, coin) && static_cast<int>(coin.nHeight) <= pindexFork->nHeight) {
+        txout = coin.out;
+        pindexFrom = chainActive[coin.nHeight];
+        fFound = true;
+    }
+
+    // Spent at our tip or confirmed on a fork: the transaction index knows where it was confirmed
+    CTransactionRef txPrev;
+    uint256 hashBlock;
+    if (!fFound && g_txindex && g_txindex->FindTx(prevout.hash, hashBlock, txPrev) && prevout.n < txPrev->vout.size()) {
+        const CBlockIndex* pindex = LookupBlockIndex(hashBlock);
+        if (pindex && pindexPrev->GetAncestor(pindex->nHeight) == pindex) {
+            txout = txPrev->vout[prevout.n];
+            pindexFrom = pindex;
+            fFound = true;
+        }
+    }
+
+    // Without the index, walk the blocks around a shallow fork
+    if (!fFound) {
+        if (nActiveDepth > MAX_KERNEL_FORK_WALK || nForkDepth > MAX_KERNEL_FORK_WALK) {
+            fMissingInputs = true;
+            return false;
+        }
+
+        // The output may have been spent by one of our blocks after the fork point; its undo data still has it
+        for (const CBlockIndex* pindex = chainActive.Tip(); pindex != pindexFork && !fFound; pindex = pindex->pprev) {
+            CBlock block;
+            CBlockUndo blockundo;
+            if (!ReadBlockFromDisk(block, pindex, params) || !UndoReadFromDisk(blockundo, pindex)) {
+                fMissingInputs = true;
+                return false;
+            }
+            for (size_t i = 1; i < block.vtx.size() && !fFound; ++i) {
+                const CTransaction& tx = *block.vtx[i];
+                for (size_t j = 0; j < tx.vin.size(); ++j) {
+                    if (tx.vin[j].prevout != prevout)
+                        continue;
+                    const Coin& spent = blockundo.vtxundo[i - 1].vprevout[j];
+                    if (static_cast<int>(spent.nHeight) > pindexFork->nHeight)
+                        break; // confirmed after the fork point, look for it on the fork below
+                    txout = spent.out;
+                    pindexFrom = chainActive[spent.nHeight];
+                    fFound = true;
+                    break;
+                }
+            }
+        }
+
+        // Otherwise it must have been confirmed on the fork itself
+        for (const CBlockIndex* pindex = pindexPrev; pindex != pindexFork && !fFound; pindex = pindex->pprev) {
+            CBlock block;
+            if (!ReadBlockFromDisk(block, pindex, params)) {
+                fMissingInputs = true;
+                return false;
+            }
+            for (const auto& tx : block.vtx) {
+                if (tx->GetHash() == prevout.hash) {
+                    if (prevout.n >= tx->vout.size())
+                        return false;
+                    txout = tx->vout[prevout.n];
+                    pindexFrom = pindex;
+                    fFound = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!fFound)
+        return false;
+
+    // Our chainstate says nothing about the fork, so make sure the output is still unspent there.
+    // Deeper forks are left to ConnectBlock, which rejects the double spend once the fork is connected.
+    if (pindexFork != pindexPrev && nForkDepth <= MAX_KERNEL_FORK_WALK &&
+            IsSpentOnBranch(pindexPrev, pindexFork, prevout, fMissingInputs, params)) {
+        return false;
+    }
+
+    return true;
+}
+
 // Check kernel hash target and coinstake signature
-bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint256& hashProofOfStake, const Consensus::Params &params)
+bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint256& hashProofOfStake, const Consensus::Params &params, bool* pfMissingInputs)
 {
+    PERF_SCOPE("kernel.checkproofofstake");
     const CTransactionRef &tx = block.vtx[1];
     if (!tx->IsCoinStake())
         return error("CheckProofOfStake() : called on non-coinstake %s", tx->GetHash().ToString().c_str());
@@ -504,14 +631,15 @@ bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint2
     // Kernel (input 0) must match the stake hash target per coin age (nBits)
     const CTxIn& txin = tx->vin[0];
 
-    // First try finding the previous transaction in database
-    uint256 hashBlock;
-    CTransactionRef txPrev;
-
-    if (!GetTransaction(txin.prevout.hash, txPrev, params, hashBlock, true))
-        return error("CheckProofOfStake() : INFO: read txPrev failed");
+    CTxOut prevTxOut;
+    const CBlockIndex* pindexFrom = nullptr;
+    bool fMissingInputs = false;
+    if (!GetKernelInput(pindexPrev, txin.prevout, prevTxOut, pindexFrom, fMissingInputs, params)) {
+        if (pfMissingInputs)
+            *pfMissingInputs = fMissingInputs;
+        return error("CheckProofOfStake() : INFO: kernel input %s %s", txin.prevout.ToString(), fMissingInputs ? "not available" : "not found");
+    }
 
-    CTxOut prevTxOut = txPrev->vout[txin.prevout.n];
     //verify signature and script, don't check script if it's tpos block, signature check will happen in different place
     if (!block.IsTPoSBlock() &&
             !VerifyScript(txin.scriptSig, prevTxOut.scriptPubKey,
@@ -521,25 +649,13 @@ bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint2
         return error("CheckProofOfStake() : VerifySignature failed on coinstake %s", tx->GetHash().ToString().c_str());
     }
 
-    CBlockIndex* pindex = nullptr;
-    BlockMap::iterator it = mapBlockIndex.find(hashBlock);
-    if (it != mapBlockIndex.end())
-        pindex = it->second;
-    else
-        return error("CheckProofOfStake() : read block failed");
-
-    // Read block header
-    CBlock blockprev;
-    if (!ReadBlockFromDisk(blockprev, pindex->GetBlockPos(), params))
-        return error("CheckProofOfStake(): INFO: failed to find block");
-
     if(!CheckKernelScript(prevTxOut.scriptPubKey, tx->vout[1].scriptPubKey))
         return error("CheckProofOfStake() : INFO: check kernel script failed on coinstake %s, hashProof=%s \n", tx->GetHash().ToString().c_str(), hashProofOfStake.ToString().c_str());
 
     bool isProofOfStakeV3 = params.nPoSUpdgradeHFHeight < pindexPrev->nHeight;
 
     unsigned int nTime = block.nTime;
-    if (!CheckStakeKernelHash(pindexPrev, block.nBits, blockprev.GetHash(), blockprev.GetBlockTime(), txPrev, txin.prevout, nTime, hashProofOfStake, isProofOfStakeV3, true))
+    if (!CheckStakeKernelHash(pindexPrev, block.nBits, pindexFrom->GetBlockHash(), pindexFrom->GetBlockTime(), prevTxOut.nValue, txin.prevout, nTime, hashProofOfStake, isProofOfStakeV3, true))
         return error("CheckProofOfStake() : INFO: check kernel failed on coinstake %s, hashProof=%s \n", tx->GetHash().ToString().c_str(), hashProofOfStake.ToString().c_str()); // may occur during initial download or if behind on block chain sync
 
     return true;
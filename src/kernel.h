@@ -31,15 +31,50 @@ static const int MODIFIER_INTERVAL_RATIO = 3;
 uint256 ComputeStakeModifierV3(const CBlockIndex* pindexPrev, const uint256& kernel);
 bool ComputeNextStakeModifier(const CBlockIndex* pindexCurrent, uint64_t& nStakeModifier, bool& fGeneratedStakeModifier);
 
+// Stake modifier a kernel hash is computed with, looked up ahead so that
+// stakers can try kernels from several threads without cs_main
+struct CStakeModifier
+{
+    bool fPoSV3 = false;
+    // of the block the stake builds on, since the PoS v3 fork
+    uint256 hashStakeModifierV3;
+    // of the block a selection interval after the staked coin's, before it
+    uint64_t nStakeModifier = 0;
+    int nStakeModifierHeight = 0;
+    int64_t nStakeModifierTime = 0;
+};
+
+// Look up the modifier of a stake on top of pindexPrev of a coin confirmed in hashBlockFrom,
+// reads chainActive and mapBlockIndex so cs_main must be held
+bool GetStakeModifier(const CBlockIndex* pindexPrev, const uint256& hashBlockFrom, bool fPoSV3, CStakeModifier& modifier);
+
+// Check whether stake kernel meets hash target, with a modifier from GetStakeModifier
+// Doesn't touch the block index. Sets hashProofOfStake on success return
+bool CheckStakeKernelHash(const CStakeModifier& modifier, unsigned int nBits, int64_t blockFromTime, CAmount nValueIn,
+                          const COutPoint& prevout, unsigned int nTimeTx, uint256& hashProofOfStake);
+
 // Check whether stake kernel meets hash target
 // Sets hashProofOfStake on success return
-bool CheckStakeKernelHash(const CBlockIndex *pindexPrev, unsigned int nBits, uint256 hashBlockFrom, int64_t blockFromTime, const CTransactionRef& txPrev,
+bool CheckStakeKernelHash(const CBlockIndex *pindexPrev, unsigned int nBits, uint256 hashBlockFrom, int64_t blockFromTime, CAmount nValueIn,
                           const COutPoint& prevout, unsigned int nTimeTx,
                           uint256& hashProofOfStake, bool fPoSV3, bool fPrintProofOfStake);
 
+// Number of blocks GetKernelInput reads on either side of a fork, when the transaction index
+// can't tell where the kernel input was confirmed or whether it is spent on the fork
+static const int MAX_KERNEL_FORK_WALK = 100;
+
+// Find the output spent by a coinstake kernel and the block that confirmed it, as seen from the
+// chain ending at pindexPrev. The chainstate and the transaction index are tried first; without
+// them, the blocks of a fork up to MAX_KERNEL_FORK_WALK deep are read. Fails if the output is
+// spent on the fork. fMissingInputs is set when the lookup couldn't be done, as opposed to failing.
+bool GetKernelInput(const CBlockIndex* pindexPrev, const COutPoint& prevout, CTxOut& txout,
+                    const CBlockIndex*& pindexFrom, bool& fMissingInputs, const Consensus::Params& params);
+
 // Check kernel hash target and coinstake signature
-// Sets hashProofOfStake on success return
-bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint256& hashProofOfStake, const Consensus::Params &params);
+// Sets hashProofOfStake on success return. The staked output is taken from the chainstate,
+// so this does not depend on the funding block being on disk. pfMissingInputs is set when
+// the kernel input could not be looked up, as opposed to being invalid.
+bool CheckProofOfStake(const CBlockIndex *pindexPrev, const CBlock &block, uint256& hashProofOfStake, const Consensus::Params &params, bool* pfMissingInputs = nullptr);
 
 // Check whether the coinstake timestamp meets protocol
 bool CheckCoinStakeTimestamp(int64_t nTimeBlock, int64_t nTimeTx);
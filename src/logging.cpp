@@ -30,6 +30,13 @@ static int FileWriteStr(const std::string &str, FILE *fp)
     return fwrite(str.data(), 1, str.size(), fp);
 }
 
+BCLog::Logger::~Logger()
+{
+    StopAsyncWriter();
+    if (m_fileout)
+        fclose(m_fileout);
+}
+
 bool BCLog::Logger::OpenDebugLog()
 {
     std::lock_guard<std::mutex> scoped_lock(m_file_mutex);
@@ -199,10 +206,18 @@ bool BCLog::Logger::OpenDebugLogHelper()
         return false;
     }
 
-    setbuf(m_fileout, nullptr); // unbuffered
+    // The writer thread flushes after every batch it writes
+    if (!m_writer_running)
+        setbuf(m_fileout, nullptr); // unbuffered
+
+    boost::system::error_code ec;
+    m_file_size = fs::file_size(m_file_path, ec);
+    if (ec)
+        m_file_size = 0;
+
     // dump buffered messages from before we opened the log
     while (!m_msgs_before_open.empty()) {
-        FileWriteStr(m_msgs_before_open.front(), m_fileout);
+        m_file_size += FileWriteStr(m_msgs_before_open.front(), m_fileout);
         m_msgs_before_open.pop_front();
     }
 
@@ -213,8 +228,7 @@ void BCLog::Logger::RotateLogs()
 {
     static constexpr size_t MAX_LOG_SIZE = 1024 * 1024 * 500; // 500  MB
     boost::system::error_code ec;
-    auto fileSize = fs::file_size(m_file_path, ec);
-    if(fileSize > MAX_LOG_SIZE)
+    if(m_file_size > MAX_LOG_SIZE)
     {
         if(m_fileout)
         {
@@ -233,8 +247,40 @@ void BCLog::Logger::RotateLogs()
     }
 }
 
+void BCLog::Logger::WriteToFile(const std::string& str)
+{
+    // buffer if we haven't opened the log yet
+    if (m_fileout == nullptr) {
+        m_msgs_before_open.push_back(str);
+        return;
+    }
+
+    RotateLogs();
+
+    // reopen the log file, if requested
+    if (m_reopen_file) {
+        m_reopen_file = false;
+        m_fileout = fsbridge::freopen(m_file_path, "a", m_fileout);
+        if (!m_fileout) {
+            return;
+        }
+        if (!m_writer_running)
+            setbuf(m_fileout, nullptr); // unbuffered
+        boost::system::error_code ec;
+        m_file_size = fs::file_size(m_file_path, ec);
+        if (ec)
+            m_file_size = 0;
+    }
+
+    if (m_fileout)
+        m_file_size += FileWriteStr(str, m_fileout);
+}
+
 void BCLog::Logger::LogPrintStr(const std::string &str)
 {
+    /** Output the writer thread may fall behind by before callers have to wait for it */
+    static constexpr size_t MAX_ASYNC_BUFFER_SIZE = 16 * 1024 * 1024;
+
     std::string strTimestamped = LogTimestampStr(str);
 
     if (m_print_to_console) {
@@ -243,30 +289,122 @@ void BCLog::Logger::LogPrintStr(const std::string &str)
         fflush(stdout);
     }
     if (m_print_to_file) {
+        {
+            std::unique_lock<std::mutex> lock(m_buffer_mutex);
+            if (m_writer_running) {
+                m_buffer_cond.wait(lock, [this] { return m_buffer.size() < MAX_ASYNC_BUFFER_SIZE || !m_writer_running; });
+                if (m_writer_running) {
+                    // The writer only sleeps while the buffer is empty
+                    bool fWakeWriter = m_buffer.empty();
+                    m_buffer += strTimestamped;
+                    if (fWakeWriter)
+                        m_buffer_cond.notify_all();
+                    return;
+                }
+            }
+        }
+
         std::lock_guard<std::mutex> scoped_lock(m_file_mutex);
+        WriteToFile(strTimestamped);
+    }
+}
 
-        // buffer if we haven't opened the log yet
-        if (m_fileout == nullptr) {
-            m_msgs_before_open.push_back(strTimestamped);
-        }
-        else
+void BCLog::Logger::ThreadWriter()
+{
+    std::string batch;
+    std::unique_lock<std::mutex> lock(m_buffer_mutex);
+    while (true) {
+        m_buffer_cond.wait(lock, [this] { return !m_buffer.empty() || m_writer_stop; });
+        if (m_buffer.empty())
+            break;
+        batch.clear();
+        batch.swap(m_buffer);
+        // Wake up callers waiting for room in the buffer
+        m_buffer_cond.notify_all();
+        lock.unlock();
         {
+            std::lock_guard<std::mutex> scoped_lock(m_file_mutex);
+            WriteToFile(batch);
+            if (m_fileout)
+                fflush(m_fileout);
+        }
+        lock.lock();
+    }
+}
 
-            RotateLogs();
+void BCLog::Logger::StartAsyncWriter()
+{
+    std::lock_guard<std::mutex> scoped_lock(m_file_mutex);
+    std::lock_guard<std::mutex> buffer_lock(m_buffer_mutex);
+    if (m_writer_running)
+        return;
+    m_writer_running = true;
+    m_writer_stop = false;
+    if (m_fileout)
+        setvbuf(m_fileout, nullptr, _IOFBF, 1 << 16);
+    m_writer_thread = std::thread(&BCLog::Logger::ThreadWriter, this);
+}
 
-            // reopen the log file, if requested
-            if (m_reopen_file) {
-                m_reopen_file = false;
-                m_fileout = fsbridge::freopen(m_file_path, "a", m_fileout);
-                if (!m_fileout) {
-                    return;
+void BCLog::Logger::StopAsyncWriter()
+{
+    {
+        std::lock_guard<std::mutex> buffer_lock(m_buffer_mutex);
+        if (!m_writer_running)
+            return;
+        m_writer_stop = true;
+        m_buffer_cond.notify_all();
+    }
+    // The writer drains the buffer before it exits
+    m_writer_thread.join();
+
+    std::lock_guard<std::mutex> scoped_lock(m_file_mutex);
+    {
+        // Output appended after the writer exited
+        std::lock_guard<std::mutex> buffer_lock(m_buffer_mutex);
+        if (!m_buffer.empty())
+            WriteToFile(m_buffer);
+        m_buffer.clear();
+        m_writer_running = false;
+        m_buffer_cond.notify_all();
+    }
+    if (m_fileout) {
+        fflush(m_fileout);
+        setbuf(m_fileout, nullptr); // unbuffered
+    }
+}
+
+bool BCLog::Logger::WithinRateLimit(BCLog::LogFlags category)
+{
+    uint32_t limit = m_rate_limit.load(std::memory_order_relaxed);
+    if (limit == 0 || category == BCLog::NONE)
+        return true;
+
+    int bit = 0;
+    while (!(category & (1U << bit)))
+        bit++;
+    RateLimitWindow& window = m_rate_limit_windows[bit];
+
+    int64_t now = GetTimeMillis() / 1000;
+    int64_t second = window.second.load(std::memory_order_relaxed);
+    if (second != now && window.second.compare_exchange_strong(second, now)) {
+        window.count = 0;
+        uint32_t suppressed = window.suppressed.exchange(0);
+        if (suppressed > 0) {
+            std::string name;
+            for (const CLogCategoryDesc& category_desc : LogCategories) {
+                if (category_desc.flag == (1U << bit)) {
+                    name = category_desc.category;
+                    break;
                 }
-                setbuf(m_fileout, nullptr); // unbuffered
             }
-
-            FileWriteStr(strTimestamped, m_fileout);
+            LogPrintStr(strprintf("Suppressed %u %s log messages (-lograte=%u)\n", suppressed, name, limit));
         }
     }
+
+    if (window.count.fetch_add(1, std::memory_order_relaxed) < limit)
+        return true;
+    window.suppressed++;
+    return false;
 }
 
 void BCLog::Logger::ShrinkDebugFile()
@@ -10,15 +10,19 @@
 #include <tinyformat.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 static const bool DEFAULT_LOGTIMEMICROS = false;
 static const bool DEFAULT_LOGIPS        = false;
 static const bool DEFAULT_LOGTIMESTAMPS = true;
+static const bool DEFAULT_LOGASYNC      = false;
+static const unsigned int DEFAULT_LOGRATELIMIT = 0;
 extern const char * const DEFAULT_DEBUGLOGFILE;
 
 extern bool fLogIPs;
@@ -72,6 +76,30 @@ namespace BCLog {
         std::mutex m_file_mutex;
         std::list<std::string> m_msgs_before_open;
 
+        /** Size of the file at m_file_path as far as we know, so rotation doesn't need a stat per line */
+        uint64_t m_file_size = 0;
+
+        /**
+         * Output waiting for the writer thread, when writing asynchronously.
+         * Callers only append to it; the writer swaps it out and does the file
+         * I/O without holding m_buffer_mutex.
+         */
+        std::mutex m_buffer_mutex;
+        std::condition_variable m_buffer_cond;
+        std::string m_buffer;
+        bool m_writer_running = false;
+        bool m_writer_stop = false;
+        std::thread m_writer_thread;
+
+        /** Lines logged by LogPrint in the current second, per category bit */
+        struct RateLimitWindow
+        {
+            std::atomic<int64_t> second{0};
+            std::atomic<uint32_t> count{0};
+            std::atomic<uint32_t> suppressed{0};
+        };
+        RateLimitWindow m_rate_limit_windows[32];
+
         /**
          * m_started_new_line is a state variable that will suppress printing of
          * the timestamp when multiple calls are made that don't end in a
@@ -85,8 +113,12 @@ namespace BCLog {
         std::string LogTimestampStr(const std::string& str);
         bool OpenDebugLogHelper();
         void RotateLogs();
+        void WriteToFile(const std::string& str);
+        void ThreadWriter();
 
     public:
+        ~Logger();
+
         bool m_print_to_console = false;
         bool m_print_to_file = false;
 
@@ -96,6 +128,9 @@ namespace BCLog {
         fs::path m_file_path;
         std::atomic<bool> m_reopen_file{false};
 
+        /** Maximum number of LogPrint lines per category per second, 0 = unlimited */
+        std::atomic<uint32_t> m_rate_limit{DEFAULT_LOGRATELIMIT};
+
         /** Send a string to the log output */
         void LogPrintStr(const std::string &str);
 
@@ -105,6 +140,14 @@ namespace BCLog {
         bool OpenDebugLog();
         void ShrinkDebugFile();
 
+        /** Hand file output to a background thread instead of writing it from the logging thread */
+        void StartAsyncWriter();
+        /** Write out everything buffered and return to writing synchronously */
+        void StopAsyncWriter();
+
+        /** Returns whether another LogPrint line of this category fits in the rate limit */
+        bool WithinRateLimit(LogFlags category);
+
         uint32_t GetCategoryMask() const { return m_categories.load(); }
 
         void EnableCategory(LogFlags flag);
@@ -168,7 +211,7 @@ template<typename T, typename... Args> static inline void MarkUsed(const T& t, c
 } while(0)
 
 #define LogPrint(category, ...) do { \
-    if (LogAcceptCategory((category))) { \
+    if (LogAcceptCategory((category)) && g_logger->WithinRateLimit((category))) { \
         LogPrintf(__VA_ARGS__); \
     } \
 } while(0)
@@ -20,6 +20,8 @@
 
 /** Object for who's going to get paid on which blocks */
 CMasternodePayments mnpayments;
+/** Who got paid in the recent blocks */
+CMasternodePayeeIndex mnpayeeindex;
 
 CCriticalSection cs_vecPayees;
 CCriticalSection cs_mapMasternodeBlocks;
@@ -1126,3 +1128,122 @@ void AdjustMasternodePayment(CMutableTransaction &tx, const CTxOut &txoutMastern
         }
     }
 }
+
+void CMasternodePayeeIndex::AddBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs);
+
+    RemoveHeight(pindex->nHeight);
+
+    BlockPayees& entry = mapBlocks[pindex->nHeight];
+    entry.hashBlock = pindex->GetBlockHash();
+
+    const size_t nTx = pindex->nHeight > Params().GetConsensus().nLastPoWBlock ? 1 : 0;
+    if(block.vtx.size() <= nTx)
+        return;
+
+    CAmount nMasternodePayment = GetMasternodePayment(pindex->nHeight, pindex->nMint);
+    for(const CTxOut& txout : block.vtx[nTx]->vout) {
+        if(txout.nValue == nMasternodePayment && !txout.scriptPubKey.empty()) {
+            entry.vPayees.push_back(txout.scriptPubKey);
+            mapPayeeHeights[txout.scriptPubKey].insert(pindex->nHeight);
+        }
+    }
+}
+
+void CMasternodePayeeIndex::RemoveHeight(int nHeight)
+{
+    AssertLockHeld(cs);
+
+    auto it = mapBlocks.find(nHeight);
+    if(it == mapBlocks.end())
+        return;
+
+    for(const CScript& payee : it->second.vPayees) {
+        auto itPayee = mapPayeeHeights.find(payee);
+        if(itPayee == mapPayeeHeights.end())
+            continue;
+        itPayee->second.erase(nHeight);
+        if(itPayee->second.empty())
+            mapPayeeHeights.erase(itPayee);
+    }
+    mapBlocks.erase(it);
+}
+
+void CMasternodePayeeIndex::BlockConnected(const CBlock& block, const CBlockIndex* pindex, int nKeep)
+{
+    LOCK(cs);
+
+    AddBlock(block, pindex);
+
+    while(!mapBlocks.empty() && mapBlocks.begin()->first <= pindex->nHeight - nKeep)
+        RemoveHeight(mapBlocks.begin()->first);
+}
+
+void CMasternodePayeeIndex::BlockDisconnected(const CBlock& block)
+{
+    LOCK(cs);
+
+    // blocks are disconnected from the tip, look from the top
+    const uint256 hashBlock = block.GetHash();
+    for(auto it = mapBlocks.rbegin(); it != mapBlocks.rend(); ++it) {
+        if(it->second.hashBlock == hashBlock) {
+            RemoveHeight(it->first);
+            return;
+        }
+    }
+}
+
+void CMasternodePayeeIndex::Fill(const CBlockIndex* pindex, int nBlocks)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+
+    for(int i = 0; pindex && i < nBlocks; i++, pindex = pindex->pprev) {
+        auto it = mapBlocks.find(pindex->nHeight);
+        if(it != mapBlocks.end() && it->second.hashBlock == pindex->GetBlockHash())
+            continue;
+
+        CBlock block;
+        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) // shouldn't really happen
+            continue;
+        AddBlock(block, pindex);
+    }
+}
+
+std::vector<int> CMasternodePayeeIndex::GetPaidHeights(const CScript& payee, const CBlockIndex* pindex, int nMinHeight) const
+{
+    std::vector<int> vHeights;
+    if(!pindex)
+        return vHeights;
+
+    LOCK(cs);
+
+    auto itPayee = mapPayeeHeights.find(payee);
+    if(itPayee == mapPayeeHeights.end())
+        return vHeights;
+
+    const std::set<int>& setHeights = itPayee->second;
+    for(auto it = setHeights.upper_bound(pindex->nHeight); it != setHeights.begin();) {
+        const int nHeight = *--it;
+        if(nHeight < nMinHeight)
+            break;
+        // entries of blocks that are not (or no longer) on pindex's chain don't count
+        if(mapBlocks.at(nHeight).hashBlock == pindex->GetAncestor(nHeight)->GetBlockHash())
+            vHeights.push_back(nHeight);
+    }
+    return vHeights;
+}
+
+size_t CMasternodePayeeIndex::size() const
+{
+    LOCK(cs);
+    return mapBlocks.size();
+}
+
+void CMasternodePayeeIndex::Clear()
+{
+    LOCK(cs);
+    mapBlocks.clear();
+    mapPayeeHeights.clear();
+}
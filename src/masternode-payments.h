@@ -12,6 +12,7 @@
 #include <net_processing.h>
 #include <utilstrencodings.h>
 
+class CMasternodePayeeIndex;
 class CMasternodePayments;
 class CMasternodePaymentVote;
 class CMasternodeBlockPayees;
@@ -32,6 +33,7 @@ extern CCriticalSection cs_mapMasternodeBlocks;
 extern CCriticalSection cs_mapMasternodePayeeVotes;
 
 extern CMasternodePayments mnpayments;
+extern CMasternodePayeeIndex mnpayeeindex;
 
 /// TODO: all 4 functions do not belong here really, they should be refactored/moved somewhere (main.cpp ?)
 bool IsBlockValueValid(const CBlock& block, int nBlockHeight, CAmount expectedReward, CAmount actualReward, std::string &strErrorRet);
@@ -225,4 +227,43 @@ public:
     void UpdatedBlockTip(const CBlockIndex *pindex, CConnman& connman);
 };
 
+/**
+ * Masternode payees of the recent blocks of the active chain. Filled once per
+ * connected block from the outputs of its coinbase (PoW) or coinstake (PoS)
+ * paying the masternode reward, so finding when a masternode was paid last is
+ * a lookup instead of reading the blocks back from disk for every masternode.
+ */
+class CMasternodePayeeIndex
+{
+private:
+    struct BlockPayees {
+        uint256 hashBlock;
+        std::vector<CScript> vPayees;
+    };
+
+    mutable CCriticalSection cs;
+    std::map<int, BlockPayees> mapBlocks;
+    std::map<CScript, std::set<int>> mapPayeeHeights;
+
+    void AddBlock(const CBlock& block, const CBlockIndex* pindex);
+    void RemoveHeight(int nHeight);
+
+public:
+    /** Index a newly connected block and forget blocks more than nKeep below it */
+    void BlockConnected(const CBlock& block, const CBlockIndex* pindex, int nKeep);
+    void BlockDisconnected(const CBlock& block);
+
+    /**
+     * Read the blocks among the last nBlocks up to pindex which are missing or
+     * stale in the index from disk, e.g. right after startup. Requires cs_main.
+     */
+    void Fill(const CBlockIndex* pindex, int nBlocks);
+
+    /** Heights in [nMinHeight, pindex->nHeight] of the blocks of pindex's chain paying payee, latest first */
+    std::vector<int> GetPaidHeights(const CScript& payee, const CBlockIndex* pindex, int nMinHeight) const;
+
+    size_t size() const;
+    void Clear();
+};
+
 #endif
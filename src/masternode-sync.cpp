@@ -10,6 +10,7 @@
 #include <masternode-payments.h>
 #include <masternode-sync.h>
 #include <masternodeman.h>
+#include <net_processing_xsn.h>
 #include <netfulfilledman.h>
 #include <spork.h>
 #include <ui_interface.h>
@@ -32,6 +33,55 @@ void CMasternodeSync::Reset()
     nTimeAssetSyncStarted = GetTime();
     nTimeLastBumped = GetTime();
     nTimeLastFailure = 0;
+    StartAssetProgress();
+}
+
+void CMasternodeSync::StartAssetProgress()
+{
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_INITIAL) {
+        progress.Clear();
+    }
+
+    switch(nRequestedMasternodeAssets) {
+        case(MASTERNODE_SYNC_LIST):
+        case(MASTERNODE_SYNC_MNW):
+        case(MASTERNODE_SYNC_GOVERNANCE):
+            progress.Start(nRequestedMasternodeAssets);
+            break;
+        default:
+            progress.Start(MASTERNODE_SYNC_INITIAL);
+    }
+    nTimeGovernanceVotesAsked = 0;
+}
+
+int CMasternodeSync::GetItemAsset(int nInvType)
+{
+    switch(nInvType) {
+        case(MSG_MASTERNODE_ANNOUNCE):
+        case(MSG_MASTERNODE_PING):
+            return MASTERNODE_SYNC_LIST;
+        case(MSG_MASTERNODE_PAYMENT_VOTE):
+        case(MSG_MASTERNODE_PAYMENT_BLOCK):
+            return MASTERNODE_SYNC_MNW;
+        case(MSG_GOVERNANCE_OBJECT):
+        case(MSG_GOVERNANCE_OBJECT_VOTE):
+            return MASTERNODE_SYNC_GOVERNANCE;
+        default:
+            return MASTERNODE_SYNC_INITIAL;
+    }
+}
+
+bool CMasternodeSync::UpdateAssetProgress(const std::vector<NodeId>& vConnected)
+{
+    if(!progress.Update(vConnected)) {
+        return false;
+    }
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
+        // Give the peers a tick to answer the last vote requests
+        int64_t nTimeVotesAsked = nTimeGovernanceVotesAsked;
+        return nTimeVotesAsked != 0 && GetTime() - nTimeVotesAsked >= MASTERNODE_SYNC_TICK_SECONDS;
+    }
+    return true;
 }
 
 void CMasternodeSync::BumpAssetLastTime(std::string strFuncName)
@@ -43,7 +93,12 @@ void CMasternodeSync::BumpAssetLastTime(std::string strFuncName)
 
 std::string CMasternodeSync::GetAssetName()
 {
-    switch(nRequestedMasternodeAssets)
+    return GetAssetName(nRequestedMasternodeAssets);
+}
+
+std::string CMasternodeSync::GetAssetName(int nAsset)
+{
+    switch(nAsset)
     {
         case(MASTERNODE_SYNC_INITIAL):      return "MASTERNODE_SYNC_INITIAL";
         case(MASTERNODE_SYNC_WAITING):      return "MASTERNODE_SYNC_WAITING";
@@ -105,6 +160,7 @@ void CMasternodeSync::SwitchToNextAsset(CConnman& connman)
     nRequestedMasternodeAttempt = 0;
     nTimeAssetSyncStarted = GetTime();
     BumpAssetLastTime("CMasternodeSync::SwitchToNextAsset");
+    StartAssetProgress();
 }
 
 std::string CMasternodeSync::GetSyncStatus()
@@ -133,6 +189,11 @@ void CMasternodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand
         vRecv >> nItemID >> nCount;
 
         LogPrint(BCLog::MNSYNC, "SYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->GetId());
+
+        // The count follows the inventory it is about, so every item the peer has for us was asked for by now
+        int nAsset = (nItemID == MASTERNODE_SYNC_GOVOBJ || nItemID == MASTERNODE_SYNC_GOVOBJ_VOTE) ? MASTERNODE_SYNC_GOVERNANCE : nItemID;
+        // votes are answered per object after the objects, the objects answer counts
+        progress.Answered(pfrom->GetId(), nAsset, nCount, nItemID != MASTERNODE_SYNC_GOVOBJ_VOTE);
     }
 }
 
@@ -154,7 +215,7 @@ void CMasternodeSync::ClearFulfilledRequests(CConnman& connman)
 void CMasternodeSync::ProcessTick(CConnman& connman)
 {
     static int nTick = 0;
-    if(nTick++ % MASTERNODE_SYNC_TICK_SECONDS != 0) return;
+    nTick++;
 
     // reset the sync process if the last call to this function was more than 60 minutes ago (client was in sleep mode)
     static int64_t nTimeLastProcess = GetTime();
@@ -179,6 +240,7 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
 
     // gradually request the rest of the votes after sync finished
     if(IsSynced()) {
+        if(nTick % MASTERNODE_SYNC_TICK_SECONDS != 0) return;
         std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
         governance.RequestGovernanceObjectVotes(vNodesCopy, connman);
         connman.ReleaseNodeVector(vNodesCopy);
@@ -191,6 +253,8 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
     uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
 
     std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
+    std::vector<NodeId> vConnected;
+    bool fGovernanceVotesAsked = true;
 
     for(CNode* pnode : vNodesCopy)
     {
@@ -203,6 +267,7 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
         // QUICK MODE (REGTEST ONLY!)
         if(Params().NetworkIDString() == CBaseChainParams::REGTEST)
         {
+            if(nTick % MASTERNODE_SYNC_TICK_SECONDS != 0) break;
             if(nRequestedMasternodeAttempt <= 2) {
                 connman.PushMessage(pnode, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::GETSPORKS)); //get current network sporks
             } else if(nRequestedMasternodeAttempt < 4) {
@@ -220,184 +285,157 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
         }
 
         // NORMAL NETWORK MODE - TESTNET/MAINNET
-        {
-            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-sync")) {
-                // We already fully synced from this node recently,
-                // disconnect to free this connection slot for another peer.
-                pnode->fDisconnect = true;
-                LogPrintf("CMasternodeSync::ProcessTick -- disconnecting from recently synced peer %d\n", pnode->GetId());
-                continue;
-            }
+        if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-sync")) {
+            // We already fully synced from this node recently,
+            // disconnect to free this connection slot for another peer.
+            pnode->fDisconnect = true;
+            LogPrintf("CMasternodeSync::ProcessTick -- disconnecting from recently synced peer %d\n", pnode->GetId());
+            continue;
+        }
 
-            // SPORK : ALWAYS ASK FOR SPORKS AS WE SYNC
+        // SPORK : ALWAYS ASK FOR SPORKS AS WE SYNC
 
-            if(!netfulfilledman.HasFulfilledRequest(pnode->addr, "spork-sync")) {
-                // always get sporks first, only request once from each peer
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "spork-sync");
-                // get current network sporks
-                connman.PushMessage(pnode, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::GETSPORKS));
-                LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- requesting sporks from peer %d\n", nTick, nRequestedMasternodeAssets, pnode->GetId());
-            }
+        if(!netfulfilledman.HasFulfilledRequest(pnode->addr, "spork-sync")) {
+            // always get sporks first, only request once from each peer
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "spork-sync");
+            // get current network sporks
+            connman.PushMessage(pnode, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::GETSPORKS));
+            LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- requesting sporks from peer %d\n", nTick, nRequestedMasternodeAssets, pnode->GetId());
+        }
 
-            // INITIAL TIMEOUT
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_WAITING) {
-                if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    // At this point we know that:
-                    // a) there are peers (because we are looping on at least one of them);
-                    // b) we waited for at least MASTERNODE_SYNC_TIMEOUT_SECONDS since we reached
-                    //    the headers tip the last time (i.e. since we switched from
-                    //     MASTERNODE_SYNC_INITIAL to MASTERNODE_SYNC_WAITING and bumped time);
-                    // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
-                    //    for at least MASTERNODE_SYNC_TIMEOUT_SECONDS.
-                    // We must be at the tip already, let's move to the next asset.
-                    SwitchToNextAsset(connman);
-                }
-            }
+        vConnected.push_back(pnode->GetId());
 
-            // MNLIST : SYNC MASTERNODE LIST FROM OTHER CONNECTED CLIENTS
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
-                LogPrint(BCLog::MASTERNODE, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld GetTime() %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, GetTime(), GetTime() - nTimeLastBumped);
-                // check for timeout first
-                if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if (nRequestedMasternodeAttempt == 0) {
-                        LogPrintf("CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
-                        // there is no way we can continue without masternode list, fail here and try later
-                        Fail();
-                        connman.ReleaseNodeVector(vNodesCopy);
-                        return;
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // only request once from each peer
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternode-list-sync")) continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "masternode-list-sync");
-
-//                if (pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
-                nRequestedMasternodeAttempt++;
+        // Request the current asset from every peer at once, up to MASTERNODE_SYNC_ENOUGH_PEERS of them
 
-                mnodeman.DsegUpdate(pnode, connman);
+        // MNLIST : SYNC MASTERNODE LIST FROM OTHER CONNECTED CLIENTS
 
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
-            }
+        if(nRequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
+            if(nRequestedMasternodeAttempt >= MASTERNODE_SYNC_ENOUGH_PEERS) continue;
+
+            // only request once from each peer
+            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternode-list-sync")) continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "masternode-list-sync");
 
-            // MNW : SYNC MASTERNODE PAYMENT VOTES FROM OTHER CONNECTED CLIENTS
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
-                LogPrint(BCLog::MNPAYMENTS, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld GetTime() %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, GetTime(), GetTime() - nTimeLastBumped);
-                // check for timeout first
-                // This might take a lot longer than MASTERNODE_SYNC_TIMEOUT_SECONDS due to new blocks,
-                // but that should be OK and it should timeout eventually.
-                if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if (nRequestedMasternodeAttempt == 0) {
-                        LogPrintf("CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
-                        // probably not a good idea to proceed without winner list
-                        Fail();
-                        connman.ReleaseNodeVector(vNodesCopy);
-                        return;
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // check for data
-                // if mnpayments already has enough blocks and votes, switch to the next asset
-                // try to fetch data from at least two peers though
-                if(nRequestedMasternodeAttempt > 1 && mnpayments.IsEnoughData()) {
-                    LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- found enough data\n", nTick, nRequestedMasternodeAssets);
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // only request once from each peer
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternode-payment-sync")) continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "masternode-payment-sync");
-
-                if(pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
-                nRequestedMasternodeAttempt++;
-
-                // ask node for all payment votes it has (new nodes will only return votes for future payments)
-                connman.PushMessage(pnode, CNetMsgMaker(pnode->GetSendVersion()).Make(NetMsgType::MASTERNODEPAYMENTSYNC, mnpayments.GetStorageLimit()));
-                // ask node for missing pieces only (old nodes will not be asked)
-                mnpayments.RequestLowDataPaymentBlocks(pnode, connman);
-
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
+            nRequestedMasternodeAttempt++;
+            // a peer asked recently is not asked again and will not answer
+            if(mnodeman.DsegUpdate(pnode, connman)) {
+                RequestedAsset(pnode->GetId());
             }
+        }
 
-            // GOVOBJ : SYNC GOVERNANCE ITEMS FROM OUR PEERS
+        // MNW : SYNC MASTERNODE PAYMENT VOTES FROM OTHER CONNECTED CLIENTS
 
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
-                LogPrint(BCLog::GOBJECT, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld GetTime() %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, GetTime(), GetTime() - nTimeLastBumped);
-
-                // check for timeout first
-                if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if(nRequestedMasternodeAttempt == 0) {
-                        LogPrintf("CMasternodeSync::ProcessTick -- WARNING: failed to sync %s\n", GetAssetName());
-                        // it's kind of ok to skip this for now, hopefully we'll catch up later?
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // only request obj sync once from each peer, then request votes on per-obj basis
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "governance-sync")) {
-                    int nObjsLeftToAsk = governance.RequestGovernanceObjectVotes(pnode, connman);
-                    static int64_t nTimeNoObjectsLeft = 0;
-                    // check for data
-                    if(nObjsLeftToAsk == 0) {
-                        static int nLastTick = 0;
-                        static int nLastVotes = 0;
-                        if(nTimeNoObjectsLeft == 0) {
-                            // asked all objects for votes for the first time
-                            nTimeNoObjectsLeft = GetTime();
-                        }
-                        // make sure the condition below is checked only once per tick
-                        if(nLastTick == nTick) continue;
-                        if(GetTime() - nTimeNoObjectsLeft > MASTERNODE_SYNC_TIMEOUT_SECONDS &&
-                            governance.GetVoteCount() - nLastVotes < std::max(int(0.0001 * nLastVotes), MASTERNODE_SYNC_TICK_SECONDS)
-                        ) {
-                            // We already asked for all objects, waited for MASTERNODE_SYNC_TIMEOUT_SECONDS
-                            // after that and less then 0.01% or MASTERNODE_SYNC_TICK_SECONDS
-                            // (i.e. 1 per second) votes were recieved during the last tick.
-                            // We can be pretty sure that we are done syncing.
-                            LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- asked for all objects, nothing to do\n", nTick, nRequestedMasternodeAssets);
-                            // reset nTimeNoObjectsLeft to be able to use the same condition on resync
-                            nTimeNoObjectsLeft = 0;
-                            SwitchToNextAsset(connman);
-                            connman.ReleaseNodeVector(vNodesCopy);
-                            return;
-                        }
-                        nLastTick = nTick;
-                        nLastVotes = governance.GetVoteCount();
-                    }
-                    continue;
-                }
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "governance-sync");
-
-                if (pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) continue;
-                nRequestedMasternodeAttempt++;
+        if(nRequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
+            if(nRequestedMasternodeAttempt >= MASTERNODE_SYNC_ENOUGH_PEERS) continue;
 
-                SendGovernanceSyncRequest(pnode, connman);
+            // only request once from each peer
+            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternode-payment-sync")) continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "masternode-payment-sync");
 
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
+            if(pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
+            nRequestedMasternodeAttempt++;
+            RequestedAsset(pnode->GetId());
+
+            // ask node for all payment votes it has (new nodes will only return votes for future payments)
+            connman.PushMessage(pnode, CNetMsgMaker(pnode->GetSendVersion()).Make(NetMsgType::MASTERNODEPAYMENTSYNC, mnpayments.GetStorageLimit()));
+            // ask node for missing pieces only (old nodes will not be asked)
+            mnpayments.RequestLowDataPaymentBlocks(pnode, connman);
+        }
+
+        // GOVOBJ : SYNC GOVERNANCE ITEMS FROM OUR PEERS
+
+        if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
+            // only request obj sync once from each peer, then request votes on per-obj basis
+            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "governance-sync")) {
+                int nObjsLeftToAsk = governance.RequestGovernanceObjectVotes(pnode, connman);
+                if(nObjsLeftToAsk > 0) fGovernanceVotesAsked = false;
+                continue;
             }
+            if(nRequestedMasternodeAttempt >= MASTERNODE_SYNC_ENOUGH_PEERS) continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "governance-sync");
+
+            if (pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) continue;
+            nRequestedMasternodeAttempt++;
+            RequestedAsset(pnode->GetId());
+            fGovernanceVotesAsked = false;
+
+            SendGovernanceSyncRequest(pnode, connman);
         }
     }
+    bool fReachedPeersHeight = nRequestedMasternodeAssets == MASTERNODE_SYNC_WAITING && CSyncProgressTracker::ReachedPeersHeight(vNodesCopy);
     // looped through all nodes, release them
     connman.ReleaseNodeVector(vNodesCopy);
+
+    // nothing can complete or time out without peers
+    if(vConnected.empty()) return;
+
+    // INITIAL TIMEOUT
+
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_WAITING) {
+        if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
+            // At this point we know that:
+            // a) there are peers;
+            // b) we waited for at least MASTERNODE_SYNC_TIMEOUT_SECONDS since we reached
+            //    the headers tip the last time (i.e. since we switched from
+            //     MASTERNODE_SYNC_INITIAL to MASTERNODE_SYNC_WAITING and bumped time);
+            // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
+            //    for at least MASTERNODE_SYNC_TIMEOUT_SECONDS.
+            // We must be at the tip already, let's move to the next asset.
+            SwitchToNextAsset(connman);
+        } else if(fReachedPeersHeight) {
+            // No need to wait for more blocks, we have all the ones our peers told us about
+            LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- reached the height of our peers\n", nTick, nRequestedMasternodeAssets);
+            SwitchToNextAsset(connman);
+        }
+        return;
+    }
+
+    if(nRequestedMasternodeAssets != MASTERNODE_SYNC_LIST && nRequestedMasternodeAssets != MASTERNODE_SYNC_MNW &&
+       nRequestedMasternodeAssets != MASTERNODE_SYNC_GOVERNANCE) {
+        return;
+    }
+
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
+        if(!fGovernanceVotesAsked) {
+            nTimeGovernanceVotesAsked = 0;
+        } else if(nTimeGovernanceVotesAsked == 0) {
+            nTimeGovernanceVotesAsked = GetTime();
+        }
+    }
+
+    // COMPLETION : ENOUGH PEERS ANSWERED AND EVERYTHING WE ASKED THEM FOR ARRIVED
+
+    if(UpdateAssetProgress(vConnected)) {
+        LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- received all data\n", nTick, nRequestedMasternodeAssets);
+        SwitchToNextAsset(connman);
+        return;
+    }
+
+    // if mnpayments already has enough blocks and votes, switch to the next asset
+    // try to fetch data from at least two peers though
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_MNW && nRequestedMasternodeAttempt > 1 && mnpayments.IsEnoughData()) {
+        LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- found enough data\n", nTick, nRequestedMasternodeAssets);
+        SwitchToNextAsset(connman);
+        return;
+    }
+
+    // TIMEOUT : PEERS WHICH DO NOT ANSWER
+
+    if(GetTime() - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
+        LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
+        if(nRequestedMasternodeAttempt == 0) {
+            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
+                LogPrintf("CMasternodeSync::ProcessTick -- WARNING: failed to sync %s\n", GetAssetName());
+                // it's kind of ok to skip this for now, hopefully we'll catch up later?
+            } else {
+                LogPrintf("CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
+                // there is no way we can continue without masternode list or winner list, fail here and try later
+                Fail();
+                return;
+            }
+        }
+        SwitchToNextAsset(connman);
+    }
 }
 
 void CMasternodeSync::SendGovernanceSyncRequest(CNode* pnode, CConnman& connman)
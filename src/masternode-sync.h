@@ -6,9 +6,13 @@
 
 #include <chain.h>
 #include <net.h>
+#include <syncprogress.h>
 
 #include <univalue.h>
 
+#include <atomic>
+#include <map>
+
 class CMasternodeSync;
 
 static const int MASTERNODE_SYNC_FAILED          = -1;
@@ -31,10 +35,21 @@ extern CMasternodeSync masternodeSync;
 //
 // CMasternodeSync : Sync masternode assets in stages
 //
+// Each asset is requested from up to MASTERNODE_SYNC_ENOUGH_PEERS peers at once.
+// Peers answer a request with SYNCSTATUSCOUNT after pushing the inventory, so
+// once enough of them answered and everything we asked them for arrived, the
+// asset is complete and the next one starts right away. The timeouts are only
+// a fallback for peers which do not answer. The answers and items are tracked
+// by a CSyncProgressTracker, shared with the merchantnode sync.
+//
 
 class CMasternodeSync
 {
 private:
+    CSyncProgressTracker progress;
+    // Governance: since when every peer was asked for the votes of every object, 0 while there is more to ask
+    std::atomic<int64_t> nTimeGovernanceVotesAsked;
+
     // Keep track of current asset
     int nRequestedMasternodeAssets;
     // Count peers we've requested the asset from
@@ -49,9 +64,11 @@ private:
 
     void Fail();
     void ClearFulfilledRequests(CConnman& connman);
+    void StartAssetProgress();
+    static int GetItemAsset(int nInvType);
 
 public:
-    CMasternodeSync() { Reset(); }
+    CMasternodeSync() : progress(&CMasternodeSync::GetItemAsset), nTimeGovernanceVotesAsked(0) { Reset(); }
 
 
     void SendGovernanceSyncRequest(CNode* pnode, CConnman& connman);
@@ -67,7 +84,9 @@ public:
     void BumpAssetLastTime(std::string strFuncName);
     int64_t GetAssetStartTime() { return nTimeAssetSyncStarted; }
     std::string GetAssetName();
+    static std::string GetAssetName(int nAsset);
     std::string GetSyncStatus();
+    std::map<int, CSyncAssetProgress> GetProgress() const { return progress.GetProgress(); }
 
     void Reset();
     void SwitchToNextAsset(CConnman& connman);
@@ -75,6 +94,16 @@ public:
     void ProcessMessage(CNode* pfrom, const std::string &strCommand, CDataStream& vRecv);
     void ProcessTick(CConnman& connman);
 
+    /** Called when the current asset was requested from a peer */
+    void RequestedAsset(NodeId nodeId) { progress.RequestedAsset(nodeId); }
+    /** Called for every item we ask a peer for after its inventory */
+    void RequestedItem(const CInv& inv) { progress.RequestedItem(inv); }
+    /**
+     * Drop the pending items which arrived or timed out and tell whether the
+     * current asset is complete, given the peers still connected.
+     */
+    bool UpdateAssetProgress(const std::vector<NodeId>& vConnected);
+
     void AcceptedBlockHeader(const CBlockIndex *pindexNew);
     void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload, CConnman& connman);
     void UpdatedBlockTip(const CBlockIndex *pindexNew, bool fInitialDownload, CConnman& connman);
@@ -42,6 +42,7 @@ CMasternode::CMasternode(CService addr, COutPoint outpoint, CPubKey pubKeyCollat
 
 CMasternode::CMasternode(const CMasternode& other) :
     masternode_info_t{other},
+    fCollateralChecked(other.fCollateralChecked),
     lastPing(other.lastPing),
     vchSig(other.vchSig),
     nCollateralMinConfBlockHash(other.nCollateralMinConfBlockHash),
@@ -133,9 +134,36 @@ CMasternode::CollateralStatus CMasternode::CheckCollateral(const COutPoint& outp
     return COLLATERAL_OK;
 }
 
+void CMasternode::CheckCollateralOnce()
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+
+    if(fCollateralChecked || fUnitTest) return;
+    fCollateralChecked = true;
+
+    if(!IsOutpointSpent() && CheckCollateral(vin.prevout) == COLLATERAL_UTXO_NOT_FOUND) {
+        nActiveState = MASTERNODE_OUTPOINT_SPENT;
+        LogPrint(BCLog::MASTERNODE, "CMasternode::Check -- Failed to find Masternode UTXO, masternode=%s\n", vin.prevout.ToString());
+    }
+}
+
+void CMasternode::SetCollateralSpent()
+{
+    LOCK(cs);
+
+    fCollateralChecked = true;
+    if(IsOutpointSpent()) return;
+
+    nActiveState = MASTERNODE_OUTPOINT_SPENT;
+    LogPrint(BCLog::MASTERNODE, "CMasternode::SetCollateralSpent -- Masternode %s collateral spent\n", vin.prevout.ToString());
+}
+
 void CMasternode::Check(bool fForce)
 {
-    LOCK2(cs_main, cs);
+    // Never takes cs_main, masternodes whose collateral was not looked up
+    // yet are handled by CMasternodeMan::Check under cs_main -> cs.
+    LOCK(cs);
 
     if(ShutdownRequested()) return;
 
@@ -149,14 +177,7 @@ void CMasternode::Check(bool fForce)
 
     int nHeight = 0;
     if(!fUnitTest) {
-        CollateralStatus err = CheckCollateral(vin.prevout);
-        if (err == COLLATERAL_UTXO_NOT_FOUND) {
-            nActiveState = MASTERNODE_OUTPOINT_SPENT;
-            LogPrint(BCLog::MASTERNODE, "CMasternode::Check -- Failed to find Masternode UTXO, masternode=%s\n", vin.prevout.ToString());
-            return;
-        }
-
-        nHeight = chainActive.Height();
+        nHeight = mnodeman.GetTipHeight();
     }
 
     if(IsPoSeBanned()) {
@@ -272,6 +293,10 @@ bool CMasternode::IsInputAssociatedWithPubkey() const
     CScript payee;
     payee = GetScriptForDestination(pubKeyCollateralAddress.GetID());
 
+    Coin coin;
+    if(GetUTXOCoin(vin.prevout, coin) && coin.out.nValue == 15000 * COIN && coin.out.scriptPubKey == payee)
+        return true;
+
     CTransactionRef tx;
     uint256 hash;
     if(GetTransaction(vin.prevout.hash, tx, Params().GetConsensus(), hash, true)) {
@@ -334,36 +359,24 @@ void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScan
 {
     if(!pindex) return;
 
-    const CBlockIndex *BlockReading = pindex;
-
     CScript mnpayee = GetScriptForDestination(pubKeyCollateralAddress.GetID());
     // LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s\n", vin.prevout.ToString());
 
+    // the blocks within the scan window that actually paid mnpayee, latest first
+    int nMinHeight = std::max(nBlockLastPaid + 1, pindex->nHeight - nMaxBlocksToScanBack + 1);
+    std::vector<int> vPaidHeights = mnpayeeindex.GetPaidHeights(mnpayee, pindex, nMinHeight);
+
     LOCK(cs_mapMasternodeBlocks);
 
-    for (int i = 0; BlockReading && BlockReading->nHeight > nBlockLastPaid && i < nMaxBlocksToScanBack; i++) {
-        if(mnpayments.mapMasternodeBlocks.count(BlockReading->nHeight) &&
-            mnpayments.mapMasternodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(mnpayee, 2))
+    for (int nHeight : vPaidHeights) {
+        if(mnpayments.mapMasternodeBlocks.count(nHeight) &&
+            mnpayments.mapMasternodeBlocks[nHeight].HasPayeeWithVotes(mnpayee, 2))
         {
-            CBlock block;
-            if(!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus())) // shouldn't really happen
-                continue;
-
-            const auto& coinbaseTransaction = (BlockReading->nHeight > Params().GetConsensus().nLastPoWBlock ? block.vtx[1] : block.vtx[0]);
-
-            CAmount nMasternodePayment = GetMasternodePayment(BlockReading->nHeight, BlockReading->nMint);
-
-            for(const CTxOut &txout : coinbaseTransaction->vout)
-                if(mnpayee == txout.scriptPubKey && nMasternodePayment == txout.nValue) {
-                    nBlockLastPaid = BlockReading->nHeight;
-                    nTimeLastPaid = BlockReading->nTime;
-                    LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", vin.prevout.ToString(), nBlockLastPaid);
-                    return;
-                }
+            nBlockLastPaid = nHeight;
+            nTimeLastPaid = pindex->GetAncestor(nHeight)->nTime;
+            LogPrint(BCLog::MASTERNODE, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", vin.prevout.ToString(), nBlockLastPaid);
+            return;
         }
-
-        if (BlockReading->pprev == NULL) { assert(BlockReading); break; }
-        BlockReading = BlockReading->pprev;
     }
 
     // Last payment for this masternode wasn't found in latest mnpayments blocks
@@ -570,6 +583,7 @@ bool CMasternodeBroadcast::CheckOutpoint(int& nDos)
         return false;
     }
 
+    int nHeight;
     {
         TRY_LOCK(cs_main, lockMain);
         if(!lockMain) {
@@ -579,7 +593,6 @@ bool CMasternodeBroadcast::CheckOutpoint(int& nDos)
             return false;
         }
 
-        int nHeight;
         CollateralStatus err = CheckCollateral(vin.prevout, nHeight);
         if (err == COLLATERAL_UTXO_NOT_FOUND) {
             LogPrint(BCLog::MASTERNODE, "CMasternodeBroadcast::CheckOutpoint -- Failed to find Masternode UTXO, masternode=%s\n", vin.prevout.ToString());
@@ -614,15 +627,11 @@ bool CMasternodeBroadcast::CheckOutpoint(int& nDos)
 
     // verify that sig time is legit in past
     // should be at least not earlier than block when 1000 XSN tx got nMasternodeMinimumConfirmations
-    uint256 hashBlock = uint256();
-    CTransactionRef tx2;
-    GetTransaction(vin.prevout.hash, tx2, Params().GetConsensus(), hashBlock, true);
+    // the collateral height comes from the UTXO set, so the 1000 XSN tx itself isn't needed
     {
         LOCK(cs_main);
-        BlockMap::iterator mi = mapBlockIndex.find(hashBlock);
-        if (mi != mapBlockIndex.end() && (*mi).second) {
-            CBlockIndex* pMNIndex = (*mi).second; // block for 1000 XSN tx -> 1 confirmation
-            CBlockIndex* pConfIndex = chainActive[pMNIndex->nHeight + Params().GetConsensus().nMasternodeMinimumConfirmations - 1]; // block where tx got nMasternodeMinimumConfirmations
+        CBlockIndex* pConfIndex = chainActive[nHeight + Params().GetConsensus().nMasternodeMinimumConfirmations - 1]; // block where tx got nMasternodeMinimumConfirmations
+        if (pConfIndex) {
             if(pConfIndex->GetBlockTime() > sigTime) {
                 LogPrintf("CMasternodeBroadcast::CheckOutpoint -- Bad sigTime %d (%d conf block is at %d) for Masternode %s %s\n",
                           sigTime, Params().GetConsensus().nMasternodeMinimumConfirmations, pConfIndex->GetBlockTime(), vin.prevout.ToString(), addr.ToString());
@@ -135,6 +135,9 @@ private:
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
 
+    // collateral was looked up in the UTXO set, spends are tracked from blocks since
+    bool fCollateralChecked = false;
+
 public:
     enum state {
         MASTERNODE_PRE_ENABLED,
@@ -208,6 +211,12 @@ public:
     static CollateralStatus CheckCollateral(const COutPoint& outpoint, int& nHeightRet);
     void Check(bool fForce = false);
 
+    /// Look the collateral up in the UTXO set unless that was done already, requires cs_main
+    void CheckCollateralOnce();
+    bool IsCollateralChecked() const { LOCK(cs); return fCollateralChecked || fUnitTest; }
+    void ResetCollateralChecked() { LOCK(cs); fCollateralChecked = false; }
+    void SetCollateralSpent();
+
     bool IsBroadcastedWithin(int nSeconds) const { return GetAdjustedTime() - sigTime < nSeconds; }
 
     bool IsPingedWithin(int nSeconds, int64_t nTimeToCheckAt = -1) const
@@ -281,6 +290,7 @@ public:
         nPoSeBanHeight = from.nPoSeBanHeight;
         fAllowMixingTx = from.fAllowMixingTx;
         fUnitTest = from.fUnitTest;
+        fCollateralChecked = from.fCollateralChecked;
         mapGovernanceObjectsVotedOn = from.mapGovernanceObjectsVotedOn;
         return *this;
     }
@@ -53,6 +53,17 @@ static int GetUTXOConfirmations(const COutPoint& outpoint)
     return (nPrevoutHeight > -1 && chainActive.Tip()) ? chainActive.Height() - nPrevoutHeight + 1 : -1;
 }
 
+static void EraseByAddr(std::multimap<CService, COutPoint>& mapByAddr, const CService& addr, const COutPoint& outpoint)
+{
+    auto range = mapByAddr.equal_range(addr);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == outpoint) {
+            mapByAddr.erase(it);
+            return;
+        }
+    }
+}
+
 const std::string CMasternodeMan::SERIALIZATION_VERSION_STRING = "CMasternodeMan-Version-7";
 
 struct CompareLastPaidBlock
@@ -73,18 +84,9 @@ struct CompareScoreMN
     }
 };
 
-struct CompareByAddr
-
-{
-    bool operator()(const CMasternode* t1,
-                    const CMasternode* t2) const
-    {
-        return t1->addr < t2->addr;
-    }
-};
-
 CMasternodeMan::CMasternodeMan()
     : cs(),
+      nTipHeight(0),
       mapMasternodes(),
       mAskedUsForMasternodeList(),
       mWeAskedForMasternodeList(),
@@ -110,6 +112,8 @@ bool CMasternodeMan::Add(CMasternode &mn)
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMasternodes[mn.vin.prevout] = mn;
+    mapMasternodesByAddr.emplace(mn.addr, mn.vin.prevout);
+    ClearRankSnapshots();
     fMasternodesAdded = true;
     return true;
 }
@@ -183,7 +187,37 @@ bool CMasternodeMan::PoSeBan(const COutPoint &outpoint)
 
 void CMasternodeMan::Check()
 {
-    LOCK2(cs_main, cs);
+    // Collaterals are looked up in the UTXO set once per masternode, later
+    // spends are caught by BlockConnected. cs_main is only needed while some
+    // masternodes were not looked up yet, e.g. the ones added since last time.
+    // Take it together with cs before touching any masternode so that the
+    // lookups and the checks below keep the cs_main -> cs order.
+    bool fCollateralsChecked = true;
+    {
+        LOCK(cs);
+        for (const auto& mnpair : mapMasternodes) {
+            if (!mnpair.second.IsCollateralChecked()) {
+                fCollateralsChecked = false;
+                break;
+            }
+        }
+    }
+
+    if (fCollateralsChecked) {
+        LOCK(cs);
+        CheckMasternodes();
+    } else {
+        LOCK2(cs_main, cs);
+        for (auto& mnpair : mapMasternodes) {
+            mnpair.second.CheckCollateralOnce();
+        }
+        CheckMasternodes();
+    }
+}
+
+void CMasternodeMan::CheckMasternodes()
+{
+    AssertLockHeld(cs);
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Check -- nLastWatchdogVoteTime=%d, IsWatchdogActive()=%d\n", nLastWatchdogVoteTime, IsWatchdogActive());
 
@@ -223,7 +257,9 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
 
                 // and finally remove it from the list
                 it->second.FlagGovernanceItemsAsDirty();
+                EraseByAddr(mapMasternodesByAddr, it->second.addr, it->first);
                 mapMasternodes.erase(it++);
+                ClearRankSnapshots();
                 fMasternodesRemoved = true;
             } else {
                 bool fAsk = (nAskForMnbRecovery > 0) &&
@@ -379,6 +415,8 @@ void CMasternodeMan::Clear()
 {
     LOCK(cs);
     mapMasternodes.clear();
+    mapMasternodesByAddr.clear();
+    ClearRankSnapshots();
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
@@ -388,6 +426,28 @@ void CMasternodeMan::Clear()
     nLastWatchdogVoteTime = 0;
 }
 
+void CMasternodeMan::UpdatedMasternode(const CMasternode* pmn, const CService& addrOld, int nProtocolVersionOld)
+{
+    AssertLockHeld(cs);
+    if(pmn->addr != addrOld) {
+        EraseByAddr(mapMasternodesByAddr, addrOld, pmn->vin.prevout);
+        mapMasternodesByAddr.emplace(pmn->addr, pmn->vin.prevout);
+    }
+    if(pmn->nProtocolVersion != nProtocolVersionOld) {
+        ClearRankSnapshots();
+    }
+}
+
+void CMasternodeMan::RebuildIndexes()
+{
+    AssertLockHeld(cs);
+    mapMasternodesByAddr.clear();
+    for (const auto& mnpair : mapMasternodes) {
+        mapMasternodesByAddr.emplace(mnpair.second.addr, mnpair.first);
+    }
+    ClearRankSnapshots();
+}
+
 int CMasternodeMan::CountMasternodes(int nProtocolVersion) const
 {
     LOCK(cs);
@@ -433,7 +493,7 @@ int CMasternodeMan::CountByIP(int nNetworkType)
 }
 */
 
-void CMasternodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
+bool CMasternodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
 {
     LOCK(cs);
 
@@ -442,7 +502,7 @@ void CMasternodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
             std::map<CNetAddr, int64_t>::iterator it = mWeAskedForMasternodeList.find(pnode->addr);
             if(it != mWeAskedForMasternodeList.end() && GetTime() < (*it).second) {
                 LogPrintf("CMasternodeMan::DsegUpdate -- we already asked %s for the list; skipping...\n", pnode->addr.ToString());
-                return;
+                return false;
             }
         }
     }
@@ -452,6 +512,7 @@ void CMasternodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
     mWeAskedForMasternodeList[pnode->addr] = askAgain;
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DsegUpdate -- asked %s for the list\n", pnode->addr.ToString());
+    return true;
 }
 
 CMasternode* CMasternodeMan::Find(const COutPoint &outpoint)
@@ -666,6 +727,54 @@ bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, CMasternodeM
     return !vecMasternodeScoresRet.empty();
 }
 
+int CMasternodeMan::RankSnapshot::GetRank(const COutPoint& outpoint) const
+{
+    auto it = std::lower_bound(vecRankByOutpoint.begin(), vecRankByOutpoint.end(), std::make_pair(outpoint, 0));
+    if (it == vecRankByOutpoint.end() || it->first != outpoint)
+        return -1;
+    return it->second;
+}
+
+CMasternodeMan::rank_snapshot_ptr_t CMasternodeMan::GetRankSnapshot(const uint256& nBlockHash, int nMinProtocol)
+{
+    AssertLockHeld(cs);
+
+    const std::pair<uint256, int> key(nBlockHash, nMinProtocol);
+    auto it = mapRankSnapshots.find(key);
+    if (it != mapRankSnapshots.end())
+        return it->second;
+
+    score_pair_vec_t vecMasternodeScores;
+    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+        return nullptr;
+
+    auto pSnapshot = std::make_shared<RankSnapshot>();
+    pSnapshot->vecRanked.reserve(vecMasternodeScores.size());
+    pSnapshot->vecRankByOutpoint.reserve(vecMasternodeScores.size());
+    int nRank = 0;
+    for (auto& scorePair : vecMasternodeScores) {
+        nRank++;
+        pSnapshot->vecRanked.push_back(scorePair.second->vin.prevout);
+        pSnapshot->vecRankByOutpoint.emplace_back(scorePair.second->vin.prevout, nRank);
+    }
+    std::sort(pSnapshot->vecRankByOutpoint.begin(), pSnapshot->vecRankByOutpoint.end());
+
+    if (listRankSnapshotKeys.size() >= MAX_RANK_SNAPSHOTS) {
+        mapRankSnapshots.erase(listRankSnapshotKeys.front());
+        listRankSnapshotKeys.pop_front();
+    }
+    listRankSnapshotKeys.push_back(key);
+    mapRankSnapshots.emplace(key, pSnapshot);
+
+    return pSnapshot;
+}
+
+void CMasternodeMan::ClearRankSnapshots()
+{
+    mapRankSnapshots.clear();
+    listRankSnapshotKeys.clear();
+}
+
 bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
 {
     nRankRet = -1;
@@ -682,20 +791,12 @@ bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet,
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    rank_snapshot_ptr_t pRanks = GetRankSnapshot(nBlockHash, nMinProtocol);
+    if (!pRanks)
         return false;
 
-    int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        if(scorePair.second->vin.prevout == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
-    }
-
-    return false;
+    nRankRet = pRanks->GetRank(outpoint);
+    return nRankRet != -1;
 }
 
 bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight, int nMinProtocol)
@@ -714,14 +815,14 @@ bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMast
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    rank_snapshot_ptr_t pRanks = GetRankSnapshot(nBlockHash, nMinProtocol);
+    if (!pRanks)
         return false;
 
+    vecMasternodeRanksRet.reserve(pRanks->vecRanked.size());
     int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        vecMasternodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
+    for (const COutPoint& outpoint : pRanks->vecRanked) {
+        vecMasternodeRanksRet.push_back(std::make_pair(++nRank, mapMasternodes.at(outpoint)));
     }
 
     return true;
@@ -943,72 +1044,52 @@ void CMasternodeMan::DoFullVerificationStep(CConnman& connman)
     if(activeMasternode.outpoint == COutPoint()) return;
     if(!masternodeSync.IsSynced()) return;
 
-    rank_pair_vec_t vecMasternodeRanks;
-    GetMasternodeRanks(vecMasternodeRanks, nCachedBlockHeight - 1, MIN_POSE_PROTO_VERSION);
+    uint256 nBlockHash;
+    if(!GetBlockHash(nBlockHash, nCachedBlockHeight - 1)) return;
 
     // Need LOCK2 here to ensure consistent locking order because the SendVerifyRequest call below locks cs_main
     // through GetHeight() signal in ConnectNode
     LOCK2(cs_main, cs);
 
+    rank_snapshot_ptr_t pRanks = GetRankSnapshot(nBlockHash, MIN_POSE_PROTO_VERSION);
+    if(!pRanks) return;
+
     int nCount = 0;
 
-    int nMyRank = -1;
-    int nRanksTotal = (int)vecMasternodeRanks.size();
-
-    // send verify requests only if we are in top MAX_POSE_RANK
-    std::vector<std::pair<int, CMasternode> >::iterator it = vecMasternodeRanks.begin();
-    while(it != vecMasternodeRanks.end()) {
-        if(it->first > MAX_POSE_RANK) {
-            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Must be in top %d to send verify request\n",
-                     (int)MAX_POSE_RANK);
-            return;
-        }
-        if(it->second.vin.prevout == activeMasternode.outpoint) {
-            nMyRank = it->first;
-            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Found self at rank %d/%d, verifying up to %d masternodes\n",
-                     nMyRank, nRanksTotal, (int)MAX_POSE_CONNECTIONS);
-            break;
-        }
-        ++it;
-    }
+    int nMyRank = pRanks->GetRank(activeMasternode.outpoint);
+    int nRanksTotal = (int)pRanks->vecRanked.size();
 
     // edge case: list is too short and this masternode is not enabled
     if(nMyRank == -1) return;
 
-    // send verify requests to up to MAX_POSE_CONNECTIONS masternodes
-    // starting from MAX_POSE_RANK + nMyRank and using MAX_POSE_CONNECTIONS as a step
-    int nOffset = MAX_POSE_RANK + nMyRank - 1;
-    if(nOffset >= (int)vecMasternodeRanks.size()) return;
-
-    std::vector<CMasternode*> vSortedByAddr;
-    for (auto& mnpair : mapMasternodes) {
-        vSortedByAddr.push_back(&mnpair.second);
+    // send verify requests only if we are in top MAX_POSE_RANK
+    if(nMyRank > MAX_POSE_RANK) {
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Must be in top %d to send verify request\n",
+                 (int)MAX_POSE_RANK);
+        return;
     }
+    LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Found self at rank %d/%d, verifying up to %d masternodes\n",
+             nMyRank, nRanksTotal, (int)MAX_POSE_CONNECTIONS);
 
-    sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
-    it = vecMasternodeRanks.begin() + nOffset;
-    while(it != vecMasternodeRanks.end()) {
-        if(it->second.IsPoSeVerified() || it->second.IsPoSeBanned()) {
+    // send verify requests to up to MAX_POSE_CONNECTIONS masternodes
+    // starting from MAX_POSE_RANK + nMyRank and using MAX_POSE_CONNECTIONS as a step
+    for(int nOffset = MAX_POSE_RANK + nMyRank - 1; nOffset < nRanksTotal; nOffset += MAX_POSE_CONNECTIONS) {
+        CMasternode* pmn = Find(pRanks->vecRanked[nOffset]);
+        if(!pmn) continue;
+        if(pmn->IsPoSeVerified() || pmn->IsPoSeBanned()) {
             LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Already %s%s%s masternode %s address %s, skipping...\n",
-                     it->second.IsPoSeVerified() ? "verified" : "",
-                     it->second.IsPoSeVerified() && it->second.IsPoSeBanned() ? " and " : "",
-                     it->second.IsPoSeBanned() ? "banned" : "",
-                     it->second.vin.prevout.ToString(), it->second.addr.ToString());
-            nOffset += MAX_POSE_CONNECTIONS;
-            if(nOffset >= (int)vecMasternodeRanks.size()) break;
-            it += MAX_POSE_CONNECTIONS;
+                     pmn->IsPoSeVerified() ? "verified" : "",
+                     pmn->IsPoSeVerified() && pmn->IsPoSeBanned() ? " and " : "",
+                     pmn->IsPoSeBanned() ? "banned" : "",
+                     pmn->vin.prevout.ToString(), pmn->addr.ToString());
             continue;
         }
         LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Verifying masternode %s rank %d/%d address %s\n",
-                 it->second.vin.prevout.ToString(), it->first, nRanksTotal, it->second.addr.ToString());
-        if(SendVerifyRequest(CAddress(it->second.addr, NODE_NETWORK), vSortedByAddr, connman)) {
+                 pmn->vin.prevout.ToString(), nOffset + 1, nRanksTotal, pmn->addr.ToString());
+        if(SendVerifyRequest(CAddress(pmn->addr, NODE_NETWORK), connman)) {
             nCount++;
             if(nCount >= MAX_POSE_CONNECTIONS) break;
         }
-        nOffset += MAX_POSE_CONNECTIONS;
-        if(nOffset >= (int)vecMasternodeRanks.size()) break;
-        it += MAX_POSE_CONNECTIONS;
     }
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Sent verification requests to %d masternodes\n", nCount);
@@ -1024,7 +1105,6 @@ void CMasternodeMan::CheckSameAddr()
     if(!masternodeSync.IsSynced() || mapMasternodes.empty()) return;
 
     std::vector<CMasternode*> vBan;
-    std::vector<CMasternode*> vSortedByAddr;
 
     {
         LOCK(cs);
@@ -1032,13 +1112,8 @@ void CMasternodeMan::CheckSameAddr()
         CMasternode* pprevMasternode = NULL;
         CMasternode* pverifiedMasternode = NULL;
 
-        for (auto& mnpair : mapMasternodes) {
-            vSortedByAddr.push_back(&mnpair.second);
-        }
-
-        std::sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
-        for(CMasternode* pmn : vSortedByAddr) {
+        for(const auto& addrpair : mapMasternodesByAddr) {
+            CMasternode* pmn = &mapMasternodes.at(addrpair.second);
             // check only (pre)enabled masternodes
             if(!pmn->IsEnabled() && !pmn->IsPreEnabled()) continue;
             // initial step
@@ -1072,7 +1147,7 @@ void CMasternodeMan::CheckSameAddr()
     }
 }
 
-bool CMasternodeMan::SendVerifyRequest(const CAddress& addr, const std::vector<CMasternode*>& vSortedByAddr, CConnman& connman)
+bool CMasternodeMan::SendVerifyRequest(const CAddress& addr, CConnman& connman)
 {
     if(netfulfilledman.HasFulfilledRequest(addr, strprintf("%s", NetMsgType::MNVERIFY)+"-request")) {
         // we already asked for verification, not a good idea to do this too often, skip it
@@ -1183,44 +1258,44 @@ void CMasternodeMan::ProcessVerifyReply(CNode* pnode, CMasternodeVerification& m
         CMasternode* prealMasternode = NULL;
         std::vector<CMasternode*> vpMasternodesToBan;
         std::string strMessage1 = strprintf("%s%d%s", pnode->addr.ToString(false), mnv.nonce, blockHash.ToString());
-        for (auto& mnpair : mapMasternodes) {
-            if(CAddress(mnpair.second.addr, NODE_NETWORK) == pnode->addr) {
-                if(CMessageSigner::VerifyMessage(mnpair.second.pubKeyMasternode.GetID(), mnv.vchSig1, strMessage1, strError)) {
-                    // found it!
-                    prealMasternode = &mnpair.second;
-                    if(!mnpair.second.IsPoSeVerified()) {
-                        mnpair.second.DecreasePoSeBanScore();
-                    }
-                    netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MNVERIFY)+"-done");
-
-                    // we can only broadcast it if we are an activated masternode
-                    if(activeMasternode.outpoint == COutPoint()) continue;
-                    // update ...
-                    mnv.addr = mnpair.second.addr;
-                    mnv.vin1 = mnpair.second.vin;
-                    mnv.vin2 = CTxIn(activeMasternode.outpoint);
-                    std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(false), mnv.nonce, blockHash.ToString(),
-                                                        mnv.vin1.prevout.ToStringShort(), mnv.vin2.prevout.ToStringShort());
-                    // ... and sign it
-                    if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMasternode.keyMasternode, CPubKey::InputScriptType::SPENDP2PKH)) {
-                        LogPrintf("MasternodeMan::ProcessVerifyReply -- SignMessage() failed\n");
-                        return;
-                    }
+        auto range = mapMasternodesByAddr.equal_range(pnode->addr);
+        for (auto it = range.first; it != range.second; ++it) {
+            CMasternode& mn = mapMasternodes.at(it->second);
+            if(CMessageSigner::VerifyMessage(mn.pubKeyMasternode.GetID(), mnv.vchSig1, strMessage1, strError)) {
+                // found it!
+                prealMasternode = &mn;
+                if(!mn.IsPoSeVerified()) {
+                    mn.DecreasePoSeBanScore();
+                }
+                netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MNVERIFY)+"-done");
+
+                // we can only broadcast it if we are an activated masternode
+                if(activeMasternode.outpoint == COutPoint()) continue;
+                // update ...
+                mnv.addr = mn.addr;
+                mnv.vin1 = mn.vin;
+                mnv.vin2 = CTxIn(activeMasternode.outpoint);
+                std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(false), mnv.nonce, blockHash.ToString(),
+                                                    mnv.vin1.prevout.ToStringShort(), mnv.vin2.prevout.ToStringShort());
+                // ... and sign it
+                if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMasternode.keyMasternode, CPubKey::InputScriptType::SPENDP2PKH)) {
+                    LogPrintf("MasternodeMan::ProcessVerifyReply -- SignMessage() failed\n");
+                    return;
+                }
 
-                    std::string strError;
+                std::string strError;
 
-                    if(!CMessageSigner::VerifyMessage(activeMasternode.pubKeyMasternode.GetID(), mnv.vchSig2, strMessage2, strError)) {
-                        LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
-                        return;
-                    }
+                if(!CMessageSigner::VerifyMessage(activeMasternode.pubKeyMasternode.GetID(), mnv.vchSig2, strMessage2, strError)) {
+                    LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
+                    return;
+                }
 
-                    mWeAskedForVerification[pnode->addr] = mnv;
-                    mapSeenMasternodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
-                    mnv.Relay();
+                mWeAskedForVerification[pnode->addr] = mnv;
+                mapSeenMasternodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
+                mnv.Relay();
 
-                } else {
-                    vpMasternodesToBan.push_back(&mnpair.second);
-                }
+            } else {
+                vpMasternodesToBan.push_back(&mn);
             }
         }
         // no real masternode found?...
@@ -1377,7 +1452,11 @@ void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& co
         }
     } else {
         CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-        if(pmn->UpdateFromNewBroadcast(mnb, connman)) {
+        const CService addrOld = pmn->addr;
+        const int nProtocolVersionOld = pmn->nProtocolVersion;
+        bool fUpdated = pmn->UpdateFromNewBroadcast(mnb, connman);
+        UpdatedMasternode(pmn, addrOld, nProtocolVersionOld);
+        if(fUpdated) {
             masternodeSync.BumpAssetLastTime("CMasternodeMan::UpdateMasternodeList - seen");
             mapSeenMasternodeBroadcast.erase(mnbOld.GetHash());
         }
@@ -1440,7 +1519,11 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
         CMasternode* pmn = Find(mnb.vin.prevout);
         if(pmn) {
             CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-            if(!mnb.Update(pmn, nDos, connman)) {
+            const CService addrOld = pmn->addr;
+            const int nProtocolVersionOld = pmn->nProtocolVersion;
+            bool fUpdated = mnb.Update(pmn, nDos, connman);
+            UpdatedMasternode(pmn, addrOld, nProtocolVersionOld);
+            if(!fUpdated) {
                 LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Update() failed, masternode=%s\n", mnb.vin.prevout.ToString());
                 return false;
             }
@@ -1492,6 +1575,9 @@ void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
     // LogPrint(BCLog::MNPAYMENTS, "CMasternodeMan::UpdateLastPaid -- nHeight=%d, nMaxBlocksToScanBack=%d, IsFirstRun=%s\n",
     //                         nCachedBlockHeight, nMaxBlocksToScanBack, IsFirstRun ? "true" : "false");
 
+    // blocks connected before startup are not indexed yet, read each of them once
+    mnpayeeindex.Fill(pindex, nMaxBlocksToScanBack);
+
     for (auto& mnpair: mapMasternodes) {
         mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
     }
@@ -1590,6 +1676,42 @@ void CMasternodeMan::UpdatedBlockTip(const CBlockIndex *pindex)
     }
 }
 
+void CMasternodeMan::BlockConnected(const CBlock& block, const CBlockIndex* pindex)
+{
+    nTipHeight = pindex->nHeight;
+
+    LOCK(cs);
+    if (mapMasternodes.empty()) return;
+
+    for (const auto& tx : block.vtx) {
+        for (const CTxIn& txin : tx->vin) {
+            auto it = mapMasternodes.find(txin.prevout);
+            if (it != mapMasternodes.end()) {
+                it->second.SetCollateralSpent();
+            }
+        }
+    }
+}
+
+void CMasternodeMan::BlockDisconnected(const CBlock& block)
+{
+    nTipHeight--;
+
+    LOCK(cs);
+    if (mapMasternodes.empty()) return;
+
+    // a collateral created by the block is gone from the UTXO set now, spends
+    // the block undoes are not revived, spent masternodes have to be started again
+    for (const auto& tx : block.vtx) {
+        for (size_t i = 0; i < tx->vout.size(); i++) {
+            auto it = mapMasternodes.find(COutPoint(tx->GetHash(), i));
+            if (it != mapMasternodes.end()) {
+                it->second.ResetCollateralChecked();
+            }
+        }
+    }
+}
+
 void CMasternodeMan::NotifyMasternodeUpdates(CConnman& connman)
 {
     // Avoid double locking
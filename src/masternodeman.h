@@ -23,6 +23,19 @@ public:
     typedef std::pair<int, CMasternode> rank_pair_t;
     typedef std::vector<rank_pair_t> rank_pair_vec_t;
 
+    /** Masternodes ranked by score against one block, shared by everyone asking about that block */
+    struct RankSnapshot
+    {
+        /// outpoint of the masternode at rank i + 1
+        std::vector<COutPoint> vecRanked;
+        /// (outpoint, rank) sorted by outpoint
+        std::vector<std::pair<COutPoint, int> > vecRankByOutpoint;
+
+        /// rank of the masternode or -1 if it is not ranked
+        int GetRank(const COutPoint& outpoint) const;
+    };
+    typedef std::shared_ptr<const RankSnapshot> rank_snapshot_ptr_t;
+
 private:
     static const std::string SERIALIZATION_VERSION_STRING;
 
@@ -41,15 +54,26 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    static const size_t MAX_RANK_SNAPSHOTS          = 20;
+
 
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
 
     // Keep track of current block height
     int nCachedBlockHeight;
+    // Height of the chain the collateral states are up to date with, follows
+    // BlockConnected/BlockDisconnected so Check() can do without cs_main
+    std::atomic<int> nTipHeight;
 
     // map to hold all MNs
     std::map<COutPoint, CMasternode> mapMasternodes;
+    // all MNs ordered by address, kept in step with mapMasternodes
+    std::multimap<CService, COutPoint> mapMasternodesByAddr;
+    // rank snapshots by (block hash, min protocol), oldest first in listRankSnapshotKeys,
+    // dropped whenever the list or a protocol version changes
+    std::map<std::pair<uint256, int>, rank_snapshot_ptr_t> mapRankSnapshots;
+    std::list<std::pair<uint256, int> > listRankSnapshotKeys;
     // who's asked for the Masternode list and the last time
     std::map<CNetAddr, int64_t> mAskedUsForMasternodeList;
     // who we asked for the Masternode list and the last time
@@ -79,6 +103,15 @@ private:
     CMasternode* Find(const COutPoint& outpoint);
 
     bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    /// Ranks against the block, computed once per block and list state
+    rank_snapshot_ptr_t GetRankSnapshot(const uint256& nBlockHash, int nMinProtocol);
+
+    /// Keep the address index and rank snapshots in step after pmn was updated from a broadcast
+    void UpdatedMasternode(const CMasternode* pmn, const CService& addrOld, int nProtocolVersionOld);
+    void RebuildIndexes();
+    void ClearRankSnapshots();
+    /// Check all Masternodes, requires cs, collaterals are not looked up here
+    void CheckMasternodes();
 
 public:
     // Keep track of all broadcasts I've seen
@@ -119,6 +152,9 @@ public:
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if(ser_action.ForRead()) {
+            RebuildIndexes();
+        }
     }
 
     CMasternodeMan();
@@ -155,7 +191,8 @@ public:
     /// Count Masternodes by network type - NET_IPV4, NET_IPV6, NET_TOR
     // int CountByIP(int nNetworkType);
 
-    void DsegUpdate(CNode* pnode, CConnman& connman);
+    /// Ask a peer for the whole list, false if it was asked recently
+    bool DsegUpdate(CNode* pnode, CConnman& connman);
 
     /// Versions of Find that are safe to use from outside the class
     bool Get(const COutPoint& outpoint, CMasternode& masternodeRet);
@@ -185,7 +222,7 @@ public:
 
     void DoFullVerificationStep(CConnman& connman);
     void CheckSameAddr();
-    bool SendVerifyRequest(const CAddress& addr, const std::vector<CMasternode*>& vSortedByAddr, CConnman& connman);
+    bool SendVerifyRequest(const CAddress& addr, CConnman& connman);
     void SendVerifyReply(CNode* pnode, CMasternodeVerification& mnv, CConnman& connman);
     void ProcessVerifyReply(CNode* pnode, CMasternodeVerification& mnv);
     void ProcessVerifyBroadcast(CNode* pnode, const CMasternodeVerification& mnv);
@@ -229,6 +266,13 @@ public:
 
     void UpdatedBlockTip(const CBlockIndex *pindex);
 
+    /// Mark the masternodes whose collateral the block spends as spent
+    void BlockConnected(const CBlock& block, const CBlockIndex* pindex);
+    /// Have the masternodes whose collateral the block created looked up again
+    void BlockDisconnected(const CBlock& block);
+    int GetTipHeight() const { return nTipHeight; }
+    void SetTipHeight(int nHeight) { nTipHeight = nHeight; }
+
     /**
      * Called to notify CGovernanceManager that the masternode index has been updated.
      * Must be called while not holding the CMasternodeMan::cs mutex
@@ -16,6 +16,7 @@
 #include <hash.h>
 #include <validation.h>
 #include <net.h>
+#include <perfstats.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
@@ -125,7 +126,8 @@ void BlockAssembler::resetBlock()
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx)
 {
-    return CreateNewBlock(nullptr, scriptPubKeyIn, false, {}, fMineWitnessTx);
+    TPoSContract tposContract;
+    return CreateNewBlock(nullptr, scriptPubKeyIn, false, {}, tposContract, fMineWitnessTx);
 }
 
 static bool SignInputsInCoinstake(const SigningProvider &provider, CMutableTransaction &txNew, const std::vector<const CWalletTx*> &vwtxPrev)
@@ -142,8 +144,10 @@ static bool SignInputsInCoinstake(const SigningProvider &provider, CMutableTrans
     return true;
 }
 
-std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet, const CScript &scriptPubKeyIn, bool fProofOfStake, const TPoSContract &tposContract, bool fMineWitnessTx)
+std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet, const CScript &scriptPubKeyIn, bool fProofOfStake, const std::vector<TPoSContract> &vTPoSContracts, TPoSContract &tposContractRet, bool fMineWitnessTx)
 {
+    tposContractRet = TPoSContract();
+
     int64_t nTimeStart = GetTimeMicros();
 
     resetBlock();
@@ -215,15 +219,15 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet,
             unsigned int nTxNewTime = 0;
             if (wallet->CreateCoinStake(pblock->nBits, blockReward,
                                         coinstakeTx, nTxNewTime,
-                                        tposContract, vwtxPrev, fIncludeWitness))
+                                        vTPoSContracts, tposContractRet, vwtxPrev, fIncludeWitness))
             {
                 pblock->nTime = nTxNewTime;
                 coinbaseTx.vout[0].SetEmpty();
                 pblock->vtx.emplace_back(MakeTransactionRef(coinstakeTx));
 
-                if(tposContract.IsValid())
+                if(tposContractRet.IsValid())
                 {
-                    pblock->hashTPoSContractTx = tposContract.txContract->GetHash();
+                    pblock->hashTPoSContractTx = tposContractRet.txContract->GetHash();
                 }
 
                 fStakeFound = true;
@@ -575,6 +579,25 @@ static bool ProcessBlockFound(const std::shared_ptr<const CBlock> &pblock, const
     return true;
 }
 
+// Merchant contracts of the wallet paying scriptMerchantAddress whose collateral is unspent
+static std::vector<TPoSContract> GetActiveTPoSContracts(CWallet *pwallet, const CScript &scriptMerchantAddress)
+{
+    std::vector<TPoSContract> vContracts;
+    // the contracts have to be valid in the block we are going to stake
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height() + 1;
+    }
+    for(const TPoSContract &contract : pwallet->GetTPoSContractsByMerchantScript(scriptMerchantAddress)) {
+        TPoSContract checkedContract;
+        std::string strError;
+        if(TPoSUtils::CheckContract(contract.txContract->GetHash(), checkedContract, nHeight, true, true, strError))
+            vContracts.push_back(contract);
+    }
+    return vContracts;
+}
+
 // ***TODO*** that part changed in xsn, we are using a mix with old one here for now
 void static XSNMiner(const CChainParams& chainparams, CConnman& connman,
                      CWallet* pwallet, bool fProofOfStake)
@@ -610,7 +633,7 @@ void static XSNMiner(const CChainParams& chainparams, CConnman& connman,
 
             bool isTPoS = false;
             uint256 hashTPoSContractTxId;
-            TPoSContract contract;
+            std::vector<TPoSContract> vTPoSContracts;
 
             if(fProofOfStake) {
                 if (chainActive.Tip()->nHeight < chainparams.GetConsensus().nLastPoWBlock ||
@@ -620,26 +643,38 @@ void static XSNMiner(const CChainParams& chainparams, CConnman& connman,
                     continue;
                 }
 
-                LOCK(csTPoSParams);
-
-                isTPoS = tposParams.fUseTPoS;
-                hashTPoSContractTxId = tposParams.hashTPoSContractTxId;
+                std::tie(isTPoS, hashTPoSContractTxId) = GetTPoSMinningParams();
 
                 if(isTPoS) {
-                    auto it = pwallet->tposMerchantContracts.find(hashTPoSContractTxId);
-                    if(it != std::end(pwallet->tposMerchantContracts))
-                        contract = it->second;
-
                     // check if our merchant node is set, otherwise block won't be accepted.
                     CMerchantnode merchantNode;
                     bool isValidForPayment = merchantnodeman.Get(activeMerchantnode.pubKeyMerchantnode, merchantNode);
 
                     isValidForPayment &= merchantNode.IsValidForPayment();
                     auto merchantnodePayee = CBitcoinAddress(activeMerchantnode.pubKeyMerchantnode.GetID());
+
+                    bool isValidContract = false;
                     CTxDestination merchantAddress;
-                    ExtractDestination(contract.scriptMerchantAddress, merchantAddress);
+                    if(hashTPoSContractTxId.IsNull()) {
+                        // every contract paying our merchant node which can still stake
+                        vTPoSContracts = GetActiveTPoSContracts(pwallet, GetScriptForDestination(merchantnodePayee.Get()));
+                        isValidContract = !vTPoSContracts.empty();
+                        merchantAddress = merchantnodePayee.Get();
+                    }
+                    else {
+                        TPoSContract contract;
+                        {
+                            LOCK(pwallet->cs_wallet);
+                            auto it = pwallet->tposMerchantContracts.find(hashTPoSContractTxId);
+                            if(it != std::end(pwallet->tposMerchantContracts))
+                                contract = it->second;
+                        }
+
+                        ExtractDestination(contract.scriptMerchantAddress, merchantAddress);
+                        isValidContract = merchantAddress == merchantnodePayee.Get();
+                        vTPoSContracts.push_back(contract);
+                    }
 
-                    bool isValidContract = merchantAddress == merchantnodePayee.Get();
                     if(!isValidForPayment || !isValidContract)
                     {
                         LogPrintf("Won't tpos, merchant node valid for payment: %d isValidContract: %d\n Contract address: %s, merchantnode address: %s\n",
@@ -667,7 +702,13 @@ void static XSNMiner(const CChainParams& chainparams, CConnman& connman,
             if(!pindexPrev) break;
 
             BlockAssembler assemlber(chainparams);
-            auto pblocktemplate = assemlber.CreateNewBlock(pwallet, coinbaseScript->reserveScript, fProofOfStake, contract, true);
+            std::unique_ptr<CBlockTemplate> pblocktemplate;
+            TPoSContract contract;
+            {
+                // for proof of stake this includes the search for a kernel
+                PERF_SCOPE("staker.createnewblock");
+                pblocktemplate = assemlber.CreateNewBlock(pwallet, coinbaseScript->reserveScript, fProofOfStake, vTPoSContracts, contract, true);
+            }
             if (!pblocktemplate.get()) {
                 LogPrintf("XsnMiner -- Failed to find a coinstake\n");
                 MilliSleep(5000);
@@ -683,6 +724,7 @@ void static XSNMiner(const CChainParams& chainparams, CConnman& connman,
             if (fProofOfStake) {
                 LogPrintf("CPUMiner : proof-of-stake block found %s \n", pblock->GetHash().ToString().c_str());
 
+                PERF_SCOPE("staker.signblock");
                 CBlockSigner signer(*pblock, pwallet, contract, pindexPrev->nHeight + 1);
 
                 if (!signer.SignBlock()) {
@@ -164,10 +164,12 @@ public:
 
     /** Construct a new block template with coinbase to scriptPubKeyIn */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true);
+    /** Proof of stake blocks stake for one of vTPoSContracts, returned in tposContractRet, or for our own coins if there are none */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(CWallet *wallet,
                                                    const CScript& scriptPubKeyIn,
                                                    bool fProofOfStake,
-                                                   const TPoSContract &tposContract, bool fMineWitnessTx);
+                                                   const std::vector<TPoSContract> &vTPoSContracts,
+                                                   TPoSContract &tposContractRet, bool fMineWitnessTx);
 
 
 private:
@@ -212,6 +214,7 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 void GenerateXSNs(bool fGenerate, int nThreads, const CChainParams& chainparams, CConnman &connman);
 void ThreadStakeMinter(const CChainParams& chainparams, CConnman &connman, CWallet *pwallet);
 
+/** Stake for a single merchant contract, or for all of them with a null hashTPoSContractTxId */
 void SetTPoSMinningParams(bool fUseTPoS, uint256 hashTPoSContractTxId);
 std::tuple<bool, uint256> GetTPoSMinningParams();
 
@@ -2823,6 +2823,7 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
     size_t nMessageSize = msg.data.size();
     size_t nTotalSize = nMessageSize + CMessageHeader::HEADER_SIZE;
     LogPrint(BCLog::NET, "sending %s (%d bytes) peer=%d\n",  SanitizeString(msg.command.c_str()), nMessageSize, pnode->GetId());
+    CaptureMessage(pnode, msg.command, msg.data.data(), nMessageSize, false);
 
     std::vector<unsigned char> serializedHeader;
     serializedHeader.reserve(CMessageHeader::HEADER_SIZE);
@@ -2855,6 +2856,34 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         RecordBytesSent(nBytesSent);
 }
 
+void CConnman::CaptureMessage(const CNode* pnode, const std::string& strCommand, const unsigned char* pData, size_t nSize, bool fIncoming)
+{
+    if (!fCaptureMessages)
+        return;
+
+    // Received messages are captured when they are processed rather than when
+    // they come off the socket, in the order the node acted on them
+    const int64_t nTime = GetTimeMicros();
+    std::string strPeer = pnode->addr.ToString();
+    std::replace(strPeer.begin(), strPeer.end(), ':', '_');
+    const fs::path dir = GetDataDir() / "message_capture" / strPeer;
+
+    char command[CMessageHeader::COMMAND_SIZE] = {};
+    strncpy(command, strCommand.c_str(), CMessageHeader::COMMAND_SIZE);
+
+    LOCK(cs_capture);
+    TryCreateDirectories(dir);
+    CAutoFile file(fsbridge::fopen(dir / (fIncoming ? "msgs_recv.dat" : "msgs_sent.dat"), "ab"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        LogPrintf("%s: failed to open capture file in %s\n", __func__, dir.string());
+        return;
+    }
+    file << nTime;
+    file.write(command, CMessageHeader::COMMAND_SIZE);
+    file << (uint32_t)nSize;
+    file.write((const char*)pData, nSize);
+}
+
 bool CConnman::ForNode(NodeId id, std::function<bool(CNode* pnode)> func)
 {
     CNode* found = nullptr;
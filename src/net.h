@@ -75,6 +75,8 @@ static const uint64_t DEFAULT_MAX_UPLOAD_TARGET = 0;
 static const uint64_t MAX_UPLOAD_TIMEFRAME = 60 * 60 * 24;
 /** Default for blocks only*/
 static const bool DEFAULT_BLOCKSONLY = false;
+/** Default for -capturemessages */
+static const bool DEFAULT_CAPTUREMESSAGES = false;
 
 static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
@@ -141,6 +143,7 @@ public:
         bool m_use_addrman_outgoing = true;
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
+        bool m_capture_messages = DEFAULT_CAPTUREMESSAGES;
     };
 
     void Init(const Options& connOptions) {
@@ -160,6 +163,7 @@ public:
             nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
         }
         vWhitelistedRange = connOptions.vWhitelistedRange;
+        fCaptureMessages = connOptions.m_capture_messages;
         {
             LOCK(cs_vAddedNodes);
             vAddedNodes = connOptions.m_added_nodes;
@@ -191,6 +195,14 @@ public:
 
     void PushMessage(CNode* pnode, CSerializedNetMsg&& msg);
 
+    /**
+     * Append a message to <datadir>/message_capture/<peer>/msgs_(recv|sent).dat
+     * when -capturemessages is set. Each record is the time in microseconds
+     * (int64), the command (12 bytes, zero padded), the payload size (uint32)
+     * and the payload. contrib/replay reads these to replay a sync.
+     */
+    void CaptureMessage(const CNode* pnode, const std::string& strCommand, const unsigned char* pData, size_t nSize, bool fIncoming);
+
     template<typename Callable>
     void ForEachNode(Callable&& func)
     {
@@ -404,6 +416,9 @@ private:
     unsigned int nSendBufferMaxSize;
     unsigned int nReceiveFloodSize;
 
+    bool fCaptureMessages;
+    CCriticalSection cs_capture;
+
     std::vector<ListenSocket> vhListenSocket;
     std::atomic<bool> fNetworkActive;
     banmap_t setBanned;
@@ -16,6 +16,7 @@
 #include <merkleblock.h>
 #include <netmessagemaker.h>
 #include <netbase.h>
+#include <perfstats.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
@@ -1958,6 +1959,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     LogPrint(BCLog::NET, "transaction (%s) inv sent in violation of protocol peer=%d\n", inv.hash.ToString(), pfrom->GetId());
                 } else if (!fAlreadyHave && !fImporting && !fReindex && !IsInitialBlockDownload()) {
                     pfrom->AskFor(inv);
+                    net_processing_xsn::AskedFor(inv);
                 }
             }
 
@@ -2990,6 +2992,22 @@ static bool SendRejectsAndCheckIfBanned(CNode* pnode, CConnman* connman)
     return false;
 }
 
+/** Counter for the time spent in ProcessMessage per command, unknown commands share one */
+static CPerfCounter& MessagePerfCounter(const std::string& strCommand)
+{
+    // built once and never modified, so lookups need no lock
+    static const std::map<std::string, CPerfCounter*> mapCounters = [] {
+        std::map<std::string, CPerfCounter*> ret;
+        for (const std::string& msg : getAllNetMessageTypes())
+            ret.emplace(msg, &GetPerfCounter("net.msg." + msg));
+        return ret;
+    }();
+    static CPerfCounter& perfOther = GetPerfCounter("net.msg.other");
+
+    auto it = mapCounters.find(strCommand);
+    return it != mapCounters.end() ? *it->second : perfOther;
+}
+
 bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
 {
     const CChainParams& chainparams = Params();
@@ -3061,11 +3079,16 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
         return fMoreWork;
     }
 
+    connman->CaptureMessage(pfrom, strCommand, (const unsigned char*)vRecv.data(), vRecv.size(), true);
+
     // Process message
     bool fRet = false;
     try
     {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+        {
+            CPerfTimer perfTimer(MessagePerfCounter(strCommand));
+            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+        }
         if (interruptMsgProc)
             return false;
         if (!pfrom->vRecvGetData.empty())
@@ -13,6 +13,7 @@
 #include <activemasternode.h>
 #include <tpos/activemerchantnode.h>
 #include <instantx.h>
+#include <perfstats.h>
 #include <init.h>
 #include <boost/thread.hpp>
 
@@ -219,7 +220,10 @@ void net_processing_xsn::ThreadProcessExtensions(CConnman *pConnman)
 
             if(masternodeSync.IsBlockchainSynced()) {
                 // make sure to check all masternodes first
-                mnodeman.Check();
+                {
+                    PERF_SCOPE("masternode.check");
+                    mnodeman.Check();
+                }
 
                 // check if we should activate or ping every few minutes,
                 // slightly postpone first run to give net thread a chance to connect to some peers
@@ -227,6 +231,7 @@ void net_processing_xsn::ThreadProcessExtensions(CConnman *pConnman)
                     activeMasternode.ManageState(connman);
 
                 if(nTick % 60 == 0) {
+                    PERF_SCOPE("masternode.maintenance");
                     mnodeman.ProcessMasternodeConnections(connman);
                     mnodeman.CheckAndRemove(connman);
                     mnpayments.CheckAndRemove();
@@ -237,17 +242,22 @@ void net_processing_xsn::ThreadProcessExtensions(CConnman *pConnman)
                 }
 
                 if(nTick % (60 * 5) == 0) {
+                    PERF_SCOPE("governance.maintenance");
                     governance.DoMaintenance(connman);
                 }
             }
 
             if(merchantnodeSync.IsBlockchainSynced()) {
 
-                merchantnodeman.Check();
+                {
+                    PERF_SCOPE("merchantnode.check");
+                    merchantnodeman.Check();
+                }
                 if(nTick % MERCHANTNODE_MIN_MNP_SECONDS == 15)
                     activeMerchantnode.ManageState(connman);
 
                 if(nTick % 60 == 0) {
+                    PERF_SCOPE("merchantnode.maintenance");
                     merchantnodeman.ProcessMerchantnodeConnections(connman);
                     merchantnodeman.CheckAndRemove(connman);
                     merchantnodeman.AskForMissing(connman);
@@ -261,6 +271,13 @@ void net_processing_xsn::ThreadProcessExtensions(CConnman *pConnman)
 }
 
 
+void net_processing_xsn::AskedFor(const CInv &inv)
+{
+    // lets the masternode and merchantnode syncs tell when everything they asked for arrived
+    masternodeSync.RequestedItem(inv);
+    merchantnodeSync.RequestedItem(inv);
+}
+
 bool net_processing_xsn::AlreadyHave(const CInv &inv)
 {
     switch(inv.type)
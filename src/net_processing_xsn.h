@@ -19,6 +19,9 @@ void ProcessExtension(CNode* pfrom, const std::string &strCommand, CDataStream&
 
 bool AlreadyHave(const CInv &inv);
 
+/** Called for every inventory item we are going to ask a peer for */
+void AskedFor(const CInv &inv);
+
 bool TransformInvForLegacyVersion(CInv &inv, CNode *pfrom, bool fForSending);
 
 /** Run an instance of extension processor */
@@ -0,0 +1,169 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <perfstats.h>
+
+#include <tinyformat.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+int64_t CPerfStats::Quantile(double q) const
+{
+    if (nCount == 0)
+        return 0;
+    uint64_t nRank = (uint64_t)(q * nCount);
+    if (nRank >= nCount)
+        nRank = nCount - 1;
+    uint64_t nSeen = 0;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS - 1; ++i) {
+        nSeen += vBuckets[i];
+        if (nSeen > nRank)
+            return std::min<int64_t>(int64_t{1} << i, nMaxMicros);
+    }
+    return nMaxMicros;
+}
+
+static int BucketIndex(int64_t nMicros)
+{
+    int i = 0;
+    while (nMicros > 0 && i < PERF_HISTOGRAM_BUCKETS - 1) {
+        nMicros >>= 1;
+        ++i;
+    }
+    return i;
+}
+
+static unsigned int ThreadShard()
+{
+    static std::atomic<unsigned int> nNextShard{0};
+    static thread_local unsigned int nShard = nNextShard++ % PERF_COUNTER_SHARDS;
+    return nShard;
+}
+
+CPerfCounter::CPerfCounter(const std::string& nameIn) : name(nameIn)
+{
+}
+
+void CPerfCounter::Add(int64_t nMicros)
+{
+    if (nMicros < 0)
+        nMicros = 0;
+    Shard& shard = shards[ThreadShard()];
+    shard.nCount.fetch_add(1, std::memory_order_relaxed);
+    shard.nTotalMicros.fetch_add(nMicros, std::memory_order_relaxed);
+    shard.vBuckets[BucketIndex(nMicros)].fetch_add(1, std::memory_order_relaxed);
+    int64_t nMax = shard.nMaxMicros.load(std::memory_order_relaxed);
+    while (nMicros > nMax && !shard.nMaxMicros.compare_exchange_weak(nMax, nMicros, std::memory_order_relaxed)) {
+    }
+}
+
+CPerfStats CPerfCounter::Get() const
+{
+    CPerfStats stats;
+    stats.name = name;
+    for (const Shard& shard : shards) {
+        stats.nCount += shard.nCount.load(std::memory_order_relaxed);
+        stats.nTotalMicros += shard.nTotalMicros.load(std::memory_order_relaxed);
+        stats.nMaxMicros = std::max(stats.nMaxMicros, shard.nMaxMicros.load(std::memory_order_relaxed));
+        for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; ++i)
+            stats.vBuckets[i] += shard.vBuckets[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void CPerfCounter::Reset()
+{
+    for (Shard& shard : shards) {
+        shard.nCount = 0;
+        shard.nTotalMicros = 0;
+        shard.nMaxMicros = 0;
+        for (auto& bucket : shard.vBuckets)
+            bucket = 0;
+    }
+}
+
+namespace {
+
+/** Owns all counters. The lock is only taken to look up a counter by name and to list them. */
+class CPerfRegistry
+{
+public:
+    CPerfCounter& Get(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        std::unique_ptr<CPerfCounter>& counter = mapCounters[name];
+        if (!counter)
+            counter.reset(new CPerfCounter(name));
+        return *counter;
+    }
+
+    std::vector<CPerfStats> List(const std::string& prefix)
+    {
+        std::vector<CPerfStats> ret;
+        std::lock_guard<std::mutex> lock(cs);
+        for (auto it = mapCounters.lower_bound(prefix); it != mapCounters.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            ret.push_back(it->second->Get());
+        return ret;
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        for (auto& entry : mapCounters)
+            entry.second->Reset();
+    }
+
+private:
+    std::mutex cs;
+    std::map<std::string, std::unique_ptr<CPerfCounter>> mapCounters;
+};
+
+CPerfRegistry& PerfRegistry()
+{
+    // Never destroyed, counters may still be updated by threads during shutdown
+    static CPerfRegistry* registry = new CPerfRegistry();
+    return *registry;
+}
+
+} // namespace
+
+CPerfCounter& GetPerfCounter(const std::string& name)
+{
+    return PerfRegistry().Get(name);
+}
+
+std::vector<CPerfStats> GetPerfStats(const std::string& prefix)
+{
+    return PerfRegistry().List(prefix);
+}
+
+void ResetPerfStats()
+{
+    PerfRegistry().Reset();
+}
+
+std::string FormatPerfStatsPrometheus(const std::vector<CPerfStats>& stats)
+{
+    std::string ret;
+    ret += "# HELP xsn_perf_seconds Time spent in instrumented code paths.\n";
+    ret += "# TYPE xsn_perf_seconds histogram\n";
+    for (const CPerfStats& s : stats) {
+        uint64_t nCumulative = 0;
+        for (int i = 0; i < PERF_HISTOGRAM_BUCKETS - 1; ++i) {
+            nCumulative += s.vBuckets[i];
+            ret += strprintf("xsn_perf_seconds_bucket{name=\"%s\",le=\"%.6f\"} %u\n", s.name, (int64_t{1} << i) * 0.000001, nCumulative);
+        }
+        ret += strprintf("xsn_perf_seconds_bucket{name=\"%s\",le=\"+Inf\"} %u\n", s.name, s.nCount);
+        ret += strprintf("xsn_perf_seconds_sum{name=\"%s\"} %.6f\n", s.name, s.nTotalMicros * 0.000001);
+        ret += strprintf("xsn_perf_seconds_count{name=\"%s\"} %u\n", s.name, s.nCount);
+    }
+    ret += "# HELP xsn_perf_max_seconds Longest single sample of an instrumented code path.\n";
+    ret += "# TYPE xsn_perf_max_seconds gauge\n";
+    for (const CPerfStats& s : stats)
+        ret += strprintf("xsn_perf_max_seconds{name=\"%s\"} %.6f\n", s.name, s.nMaxMicros * 0.000001);
+    return ret;
+}
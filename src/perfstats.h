@@ -0,0 +1,95 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PERFSTATS_H
+#define BITCOIN_PERFSTATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** Histogram bucket i counts samples shorter than 2^i microseconds, the last bucket everything longer */
+static const int PERF_HISTOGRAM_BUCKETS = 24;
+/** Number of per-thread slots each counter is spread over */
+static const int PERF_COUNTER_SHARDS = 8;
+
+/** Aggregated state of a performance counter */
+struct CPerfStats
+{
+    std::string name;
+    uint64_t nCount = 0;
+    int64_t nTotalMicros = 0;
+    int64_t nMaxMicros = 0;
+    std::array<uint64_t, PERF_HISTOGRAM_BUCKETS> vBuckets{};
+
+    /** Upper bound in microseconds of the given quantile (0..1), taken from the histogram */
+    int64_t Quantile(double q) const;
+};
+
+/**
+ * Duration counter with a log2 histogram. Samples are added lock-free to one of
+ * PERF_COUNTER_SHARDS slots picked per thread, so threads recording the same
+ * counter rarely touch the same cache line. Reading sums up the slots.
+ */
+class CPerfCounter
+{
+public:
+    explicit CPerfCounter(const std::string& nameIn);
+
+    CPerfCounter(const CPerfCounter&) = delete;
+    CPerfCounter& operator=(const CPerfCounter&) = delete;
+
+    void Add(int64_t nMicros);
+    CPerfStats Get() const;
+    void Reset();
+
+    const std::string& GetName() const { return name; }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> nCount{0};
+        std::atomic<int64_t> nTotalMicros{0};
+        std::atomic<int64_t> nMaxMicros{0};
+        std::atomic<uint64_t> vBuckets[PERF_HISTOGRAM_BUCKETS] = {};
+    };
+
+    const std::string name;
+    Shard shards[PERF_COUNTER_SHARDS];
+};
+
+/** Adds the time between its construction and destruction to a counter */
+class CPerfTimer
+{
+public:
+    explicit CPerfTimer(CPerfCounter& counterIn) : counter(counterIn), start(std::chrono::steady_clock::now()) {}
+    ~CPerfTimer()
+    {
+        counter.Add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    CPerfCounter& counter;
+    const std::chrono::steady_clock::time_point start;
+};
+
+/** Counter registered under the given name. Counters are never removed, the reference stays valid. */
+CPerfCounter& GetPerfCounter(const std::string& name);
+/** Stats of all counters whose name starts with prefix, ordered by name */
+std::vector<CPerfStats> GetPerfStats(const std::string& prefix = "");
+/** Clear all counters */
+void ResetPerfStats();
+/** Stats in the Prometheus text exposition format */
+std::string FormatPerfStatsPrometheus(const std::vector<CPerfStats>& stats);
+
+/** Time the rest of the enclosing scope under a fixed counter name */
+#define PERF_SCOPE_CONCAT2(a, b) a##b
+#define PERF_SCOPE_CONCAT(a, b) PERF_SCOPE_CONCAT2(a, b)
+#define PERF_SCOPE(name) \
+    static CPerfCounter& PERF_SCOPE_CONCAT(perf_counter_, __LINE__) = GetPerfCounter(name); \
+    CPerfTimer PERF_SCOPE_CONCAT(perf_timer_, __LINE__)(PERF_SCOPE_CONCAT(perf_counter_, __LINE__))
+
+#endif // BITCOIN_PERFSTATS_H
@@ -14,6 +14,11 @@
 
 static constexpr double INF_FEERATE = 1e99;
 
+/** Minimum client version able to read the flat fee estimates file format */
+static constexpr int FEE_ESTIMATES_FLAT_VERSION = 1002400;
+/** Decay multiplier below which pending decay is folded into the stored averages */
+static constexpr double MIN_DECAY_MULTIPLIER = 1e-30;
+
 std::string StringForFeeEstimateHorizon(FeeEstimateHorizon horizon) {
     static const std::map<FeeEstimateHorizon, std::string> horizon_strings = {
         {FeeEstimateHorizon::SHORT_HALFLIFE, "short"},
@@ -98,6 +103,11 @@ private:
 
     double decay;
 
+    // The moving averages above are stored without the decay accumulated since
+    // the last call to ApplyDecay. Their actual values are the stored values times
+    // decayMultiplier, so a new block only has to update this single factor.
+    double decayMultiplier;
+
     // Resolution (# of blocks) with which confirmations are tracked
     unsigned int scale;
 
@@ -107,9 +117,14 @@ private:
     std::vector<std::vector<int> > unconfTxs;  //unconfTxs[Y][X]
     // transactions still unconfirmed after GetMaxConfirms for each bucket
     std::vector<int> oldUnconfTxs;
+    // sum of unconfTxs[Y][X] over all Y for each bucket X
+    std::vector<int> unconfTxsTotal;
 
     void resizeInMemoryCounters(size_t newbuckets);
 
+    /** Fold the pending decay into the stored moving averages */
+    void ApplyDecay();
+
 public:
     /**
      * Create new TxConfirmStats. This is called by BlockPolicyEstimator's
@@ -161,8 +176,8 @@ public:
     /** Return the max number of confirms we're tracking */
     unsigned int GetMaxConfirms() const { return scale * confAvg.size(); }
 
-    /** Write state of estimation data to a file*/
-    void Write(CAutoFile& fileout) const;
+    /** Write state of estimation data to a stream in the flat format */
+    void Write(CDataStream& stream) const;
 
     /**
      * Read saved state of estimation data from a file and replace all internal data structures and
@@ -178,6 +193,7 @@ TxConfirmStats::TxConfirmStats(const std::vector<double>& defaultBuckets,
     : buckets(defaultBuckets), bucketMap(defaultBucketMap)
 {
     decay = _decay;
+    decayMultiplier = 1;
     assert(_scale != 0 && "_scale must be non-zero");
     scale = _scale;
     confAvg.resize(maxPeriods);
@@ -202,6 +218,12 @@ void TxConfirmStats::resizeInMemoryCounters(size_t newbuckets) {
         unconfTxs[i].resize(newbuckets);
     }
     oldUnconfTxs.resize(newbuckets);
+    unconfTxsTotal.assign(newbuckets, 0);
+    for (unsigned int i = 0; i < unconfTxs.size(); i++) {
+        for (unsigned int j = 0; j < newbuckets; j++) {
+            unconfTxsTotal[j] += unconfTxs[i][j];
+        }
+    }
 }
 
 // Roll the unconfirmed txs circular buffer
@@ -209,6 +231,7 @@ void TxConfirmStats::ClearCurrent(unsigned int nBlockHeight)
 {
     for (unsigned int j = 0; j < buckets.size(); j++) {
         oldUnconfTxs[j] += unconfTxs[nBlockHeight%unconfTxs.size()][j];
+        unconfTxsTotal[j] -= unconfTxs[nBlockHeight%unconfTxs.size()][j];
         unconfTxs[nBlockHeight%unconfTxs.size()][j] = 0;
     }
 }
@@ -221,23 +244,34 @@ void TxConfirmStats::Record(int blocksToConfirm, double val)
         return;
     int periodsToConfirm = (blocksToConfirm + scale - 1)/scale;
     unsigned int bucketindex = bucketMap.lower_bound(val)->second;
+    // Scale the data point up so it is unaffected by the pending decay
+    double weight = 1 / decayMultiplier;
     for (size_t i = periodsToConfirm; i <= confAvg.size(); i++) {
-        confAvg[i - 1][bucketindex]++;
+        confAvg[i - 1][bucketindex] += weight;
     }
-    txCtAvg[bucketindex]++;
-    avg[bucketindex] += val;
+    txCtAvg[bucketindex] += weight;
+    avg[bucketindex] += val * weight;
 }
 
 void TxConfirmStats::UpdateMovingAverages()
+{
+    decayMultiplier *= decay;
+    if (decayMultiplier < MIN_DECAY_MULTIPLIER) {
+        ApplyDecay();
+    }
+}
+
+void TxConfirmStats::ApplyDecay()
 {
     for (unsigned int j = 0; j < buckets.size(); j++) {
         for (unsigned int i = 0; i < confAvg.size(); i++)
-            confAvg[i][j] = confAvg[i][j] * decay;
+            confAvg[i][j] = confAvg[i][j] * decayMultiplier;
         for (unsigned int i = 0; i < failAvg.size(); i++)
-            failAvg[i][j] = failAvg[i][j] * decay;
-        avg[j] = avg[j] * decay;
-        txCtAvg[j] = txCtAvg[j] * decay;
+            failAvg[i][j] = failAvg[i][j] * decayMultiplier;
+        avg[j] = avg[j] * decayMultiplier;
+        txCtAvg[j] = txCtAvg[j] * decayMultiplier;
     }
+    decayMultiplier = 1;
 }
 
 // returns -1 on error conditions
@@ -285,11 +319,19 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
             newBucketRange = false;
         }
         curFarBucket = bucket;
-        nConf += confAvg[periodTarget - 1][bucket];
-        totalNum += txCtAvg[bucket];
-        failNum += failAvg[periodTarget - 1][bucket];
-        for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
-            extraNum += unconfTxs[(nBlockHeight - confct)%bins][bucket];
+        nConf += confAvg[periodTarget - 1][bucket] * decayMultiplier;
+        totalNum += txCtAvg[bucket] * decayMultiplier;
+        failNum += failAvg[periodTarget - 1][bucket] * decayMultiplier;
+        // Count the txs unconfirmed for confTarget or more blocks, walking
+        // whichever side of the circular buffer is shorter
+        if (2 * (unsigned int)confTarget < bins) {
+            extraNum += unconfTxsTotal[bucket];
+            for (unsigned int confct = 0; confct < (unsigned int)confTarget; confct++)
+                extraNum -= unconfTxs[(nBlockHeight - confct)%bins][bucket];
+        } else {
+            for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
+                extraNum += unconfTxs[(nBlockHeight - confct)%bins][bucket];
+        }
         extraNum += oldUnconfTxs[bucket];
         // If we have enough transaction data points in this range of buckets,
         // we can test for success
@@ -393,14 +435,25 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     return median;
 }
 
-void TxConfirmStats::Write(CAutoFile& fileout) const
+void TxConfirmStats::Write(CDataStream& stream) const
 {
-    fileout << decay;
-    fileout << scale;
-    fileout << avg;
-    fileout << txCtAvg;
-    fileout << confAvg;
-    fileout << failAvg;
+    // All averages are written with the pending decay applied, as one flat
+    // array: avg, txCtAvg, then each row of confAvg and failAvg.
+    std::vector<double> data;
+    data.reserve(buckets.size() * (2 + confAvg.size() + failAvg.size()));
+    for (double val : avg) data.push_back(val * decayMultiplier);
+    for (double val : txCtAvg) data.push_back(val * decayMultiplier);
+    for (const auto& row : confAvg) {
+        for (double val : row) data.push_back(val * decayMultiplier);
+    }
+    for (const auto& row : failAvg) {
+        for (double val : row) data.push_back(val * decayMultiplier);
+    }
+
+    stream << decay;
+    stream << scale;
+    stream << (uint32_t)confAvg.size();
+    stream << data;
 }
 
 void TxConfirmStats::Read(CAutoFile& filein, int nFileVersion, size_t numBuckets)
@@ -419,6 +472,40 @@ void TxConfirmStats::Read(CAutoFile& filein, int nFileVersion, size_t numBuckets
     if (scale == 0) {
         throw std::runtime_error("Corrupt estimates file. Scale must be non-zero");
     }
+    decayMultiplier = 1;
+
+    if (nFileVersion >= FEE_ESTIMATES_FLAT_VERSION) {
+        uint32_t nPeriods;
+        std::vector<double> data;
+        filein >> nPeriods;
+        maxPeriods = nPeriods;
+        maxConfirms = scale * maxPeriods;
+        if (maxConfirms <= 0 || maxConfirms > 6 * 24 * 7) { // one week
+            throw std::runtime_error("Corrupt estimates file.  Must maintain estimates for between 1 and 1008 (one week) confirms");
+        }
+        filein >> data;
+        if (data.size() != numBuckets * (2 + 2 * maxPeriods)) {
+            throw std::runtime_error("Corrupt estimates file. Mismatch in estimate data size");
+        }
+        auto it = data.begin();
+        avg.assign(it, it + numBuckets);
+        it += numBuckets;
+        txCtAvg.assign(it, it + numBuckets);
+        it += numBuckets;
+        confAvg.resize(maxPeriods);
+        for (unsigned int i = 0; i < maxPeriods; i++, it += numBuckets) {
+            confAvg[i].assign(it, it + numBuckets);
+        }
+        failAvg.resize(maxPeriods);
+        for (unsigned int i = 0; i < maxPeriods; i++, it += numBuckets) {
+            failAvg[i].assign(it, it + numBuckets);
+        }
+        resizeInMemoryCounters(numBuckets);
+
+        LogPrint(BCLog::ESTIMATEFEE, "Reading estimates: %u buckets counting confirms up to %u blocks\n",
+                 numBuckets, maxConfirms);
+        return;
+    }
 
     filein >> avg;
     if (avg.size() != numBuckets) {
@@ -464,6 +551,7 @@ unsigned int TxConfirmStats::NewTx(unsigned int nBlockHeight, double val)
     unsigned int bucketindex = bucketMap.lower_bound(val)->second;
     unsigned int blockIndex = nBlockHeight % unconfTxs.size();
     unconfTxs[blockIndex][bucketindex]++;
+    unconfTxsTotal[bucketindex]++;
     return bucketindex;
 }
 
@@ -490,6 +578,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         unsigned int blockIndex = entryHeight % unconfTxs.size();
         if (unconfTxs[blockIndex][bucketindex] > 0) {
             unconfTxs[blockIndex][bucketindex]--;
+            unconfTxsTotal[bucketindex]--;
         } else {
             LogPrint(BCLog::ESTIMATEFEE, "Blockpolicy error, mempool tx removed from blockIndex=%u,bucketIndex=%u already\n",
                      blockIndex, bucketindex);
@@ -499,7 +588,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         assert(scale != 0);
         unsigned int periodsAgo = blocksAgo / scale;
         for (size_t i = 0; i < periodsAgo && i < failAvg.size(); i++) {
-            failAvg[i][bucketindex]++;
+            failAvg[i][bucketindex] += 1 / decayMultiplier;
         }
     }
 }
@@ -514,6 +603,10 @@ bool CBlockPolicyEstimator::removeTx(uint256 hash, bool inBlock)
     LOCK(cs_feeEstimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        // Txs that entered at the current height are not counted by any estimate yet
+        if (pos->second.blockHeight != nBestSeenHeight) {
+            mapSmartFeeCache.clear();
+        }
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -565,6 +658,9 @@ void CBlockPolicyEstimator::processTransaction(const CTxMemPoolEntry& entry, boo
         return;
     }
 
+    // A tx tracked at the current height only starts counting towards estimates
+    // once the next block arrives, so the cached estimates remain valid.
+
     // Only want to be updating estimates when our blockchain is synced,
     // otherwise we'll miscalculate how many blocks its taking to get included.
     if (!validFeeEstimate) {
@@ -629,6 +725,7 @@ void CBlockPolicyEstimator::processBlock(unsigned int nBlockHeight,
     // calls to removeTx (via processBlockTx) correctly calculate age
     // of unconfirmed txs to remove from tracking.
     nBestSeenHeight = nBlockHeight;
+    mapSmartFeeCache.clear();
 
     // Update unconfirmed circular buffer
     feeStats->ClearCurrent(nBlockHeight);
@@ -821,6 +918,19 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
 {
     LOCK(cs_feeEstimator);
 
+    auto key = std::make_pair(confTarget, conservative);
+    auto it = mapSmartFeeCache.find(key);
+    if (it == mapSmartFeeCache.end()) {
+        FeeCalculation calc;
+        CFeeRate feeRate = estimateSmartFeeUncached(confTarget, &calc, conservative);
+        it = mapSmartFeeCache.emplace(key, std::make_pair(feeRate, calc)).first;
+    }
+    if (feeCalc) *feeCalc = it->second.second;
+    return it->second.first;
+}
+
+CFeeRate CBlockPolicyEstimator::estimateSmartFeeUncached(int confTarget, FeeCalculation *feeCalc, bool conservative) const
+{
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
         feeCalc->returnedTarget = confTarget;
@@ -900,19 +1010,22 @@ bool CBlockPolicyEstimator::Write(CAutoFile& fileout) const
 {
     try {
         LOCK(cs_feeEstimator);
-        fileout << 149900; // version required to read: 0.14.99 or later
-        fileout << CLIENT_VERSION; // version that wrote the file
-        fileout << nBestSeenHeight;
+        // Serialize into memory first so the file is written with a single call
+        CDataStream stream(SER_DISK, CLIENT_VERSION);
+        stream << FEE_ESTIMATES_FLAT_VERSION; // version required to read
+        stream << CLIENT_VERSION; // version that wrote the file
+        stream << nBestSeenHeight;
         if (BlockSpan() > HistoricalBlockSpan()/2) {
-            fileout << firstRecordedHeight << nBestSeenHeight;
+            stream << firstRecordedHeight << nBestSeenHeight;
         }
         else {
-            fileout << historicalFirst << historicalBest;
+            stream << historicalFirst << historicalBest;
         }
-        fileout << buckets;
-        feeStats->Write(fileout);
-        shortStats->Write(fileout);
-        longStats->Write(fileout);
+        stream << buckets;
+        feeStats->Write(stream);
+        shortStats->Write(stream);
+        longStats->Write(stream);
+        fileout.write(stream.data(), stream.size());
     }
     catch (const std::exception&) {
         LogPrintf("CBlockPolicyEstimator::Write(): unable to write policy estimator data (non-fatal)\n");
@@ -952,9 +1065,9 @@ bool CBlockPolicyEstimator::Read(CAutoFile& filein)
             std::unique_ptr<TxConfirmStats> fileFeeStats(new TxConfirmStats(buckets, bucketMap, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
             std::unique_ptr<TxConfirmStats> fileShortStats(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
             std::unique_ptr<TxConfirmStats> fileLongStats(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
-            fileFeeStats->Read(filein, nVersionThatWrote, numBuckets);
-            fileShortStats->Read(filein, nVersionThatWrote, numBuckets);
-            fileLongStats->Read(filein, nVersionThatWrote, numBuckets);
+            fileFeeStats->Read(filein, nVersionRequired, numBuckets);
+            fileShortStats->Read(filein, nVersionRequired, numBuckets);
+            fileLongStats->Read(filein, nVersionRequired, numBuckets);
 
             // Fee estimates file parsed correctly
             // Copy buckets from file and refresh our bucketmap
@@ -972,6 +1085,7 @@ bool CBlockPolicyEstimator::Read(CAutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            mapSmartFeeCache.clear();
         }
     }
     catch (const std::exception& e) {
@@ -258,9 +258,15 @@ private:
 
     mutable CCriticalSection cs_feeEstimator;
 
+    /** Estimates already computed by estimateSmartFee, keyed by (confTarget, conservative).
+     *  Cleared whenever the tracked data an estimate depends on changes. */
+    mutable std::map<std::pair<int, bool>, std::pair<CFeeRate, FeeCalculation>> mapSmartFeeCache;
+
     /** Process a transaction confirmed in a block*/
     bool processBlockTx(unsigned int nBlockHeight, const CTxMemPoolEntry* entry);
 
+    /** Computes estimateSmartFee without consulting mapSmartFeeCache */
+    CFeeRate estimateSmartFeeUncached(int confTarget, FeeCalculation *feeCalc, bool conservative) const;
     /** Helper for estimateSmartFee */
     double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const;
     /** Helper for estimateSmartFee */
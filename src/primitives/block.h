@@ -8,6 +8,7 @@
 
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/arena.h>
 #include <uint256.h>
 
 /** Nodes collect new transactions into a block, hash them into a hash tree,
@@ -134,6 +135,48 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Deserializes a CBlock with each of its transactions (the CTransaction together
+ * with its shared_ptr control block) allocated from one per-block arena instead
+ * of one heap allocation each. Every transaction keeps the arena alive, so it is
+ * freed once the last of them is released. Meant for read-only paths such as
+ * getblock, where the block is dropped as soon as it has been used; vin, vout
+ * and scripts still use the default allocator.
+ */
+class BlockTxArenaReader
+{
+public:
+    explicit BlockTxArenaReader(CBlock& blockIn) : block(blockIn) {}
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> static_cast<CBlockHeader&>(block);
+
+        block.vtx.clear();
+        unsigned int nSize = ReadCompactSize(s);
+        arena_allocator<CTransaction> alloc(std::make_shared<MonotonicArena>());
+        // Limit size per reservation so a bogus size value won't cause out of memory
+        unsigned int nMid = 0;
+        while (block.vtx.size() < nSize) {
+            nMid = std::min(nSize, nMid + (unsigned int)(5000000 / sizeof(CTransactionRef)));
+            block.vtx.reserve(nMid);
+            while (block.vtx.size() < nMid) {
+                block.vtx.push_back(std::allocate_shared<const CTransaction>(alloc, deserialize, s));
+            }
+        }
+
+        // same trailer as CBlock::SerializationOp
+        if (block.vtx.size() > 1 && block.vtx[1]->IsCoinStake()) {
+            s >> block.vchBlockSig;
+            s >> block.hashTPoSContractTx;
+        }
+    }
+
+private:
+    CBlock& block;
+};
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
@@ -7,6 +7,7 @@
 #include <qt/bantablemodel.h>
 #include <qt/guiconstants.h>
 #include <qt/guiutil.h>
+#include <qt/notificationqueue.h>
 #include <qt/peertablemodel.h>
 
 #include <chain.h>
@@ -30,9 +31,6 @@
 
 class CBlockIndex;
 
-static int64_t nLastHeaderTipUpdateNotification = 0;
-static int64_t nLastBlockTipUpdateNotification = 0;
-
 static void NotifyAdditionalDataSyncProgressChanged(ClientModel *clientmodel, double nSyncProgress)
 {
     QMetaObject::invokeMethod(clientmodel, "additionalDataSyncProgressChanged", Qt::QueuedConnection,
@@ -62,6 +60,15 @@ ClientModel::ClientModel(interfaces::Node& node, OptionsModel *_optionsModel, QO
     // no need to update as frequent as data for balances/txes/blocks
     pollMnTimer->start(MODEL_UPDATE_DELAY * 4);
 
+    // during initial sync only the latest block and header tip of every
+    // MODEL_UPDATE_DELAY window reach the UI
+    blockTipQueue = new NotificationQueue<bool, BlockTipNotification>("blocktip", MODEL_UPDATE_DELAY,
+        [this](const std::vector<std::pair<bool, BlockTipNotification>>& batch) {
+            for (const auto& entry : batch) {
+                Q_EMIT numBlocksChanged(entry.second.height, QDateTime::fromTime_t(entry.second.blockTime),
+                                        entry.second.verificationProgress, entry.first);
+            }
+        }, this);
 
     subscribeToCoreSignals();
 }
@@ -284,30 +291,19 @@ static void BannedListChanged(ClientModel *clientmodel)
 
 static void BlockTipChanged(ClientModel *clientmodel, bool initialSync, int height, int64_t blockTime, double verificationProgress, bool fHeader)
 {
-    // lock free async UI updates in case we have a new block tip
-    // during initial sync, only update the UI if the last update
-    // was > 250ms (MODEL_UPDATE_DELAY) ago
-    int64_t now = 0;
-    if (initialSync)
-        now = GetTimeMillis();
-
-    int64_t& nLastUpdateNotification = fHeader ? nLastHeaderTipUpdateNotification : nLastBlockTipUpdateNotification;
-
     if (fHeader) {
         // cache best headers time and height to reduce future cs_main locks
         clientmodel->cachedBestHeaderHeight = height;
         clientmodel->cachedBestHeaderTime = blockTime;
     }
-    // if we are in-sync, update the UI regardless of last update time
-    if (!initialSync || now - nLastUpdateNotification > MODEL_UPDATE_DELAY) {
-        //pass an async signal to the UI thread
-        QMetaObject::invokeMethod(clientmodel, "numBlocksChanged", Qt::QueuedConnection,
-                                  Q_ARG(int, height),
-                                  Q_ARG(QDateTime, QDateTime::fromTime_t(blockTime)),
-                                  Q_ARG(double, verificationProgress),
-                                  Q_ARG(bool, fHeader));
-        nLastUpdateNotification = now;
-    }
+    // lock free async UI update, tips arriving within MODEL_UPDATE_DELAY of
+    // each other are coalesced into one numBlocksChanged per tip kind
+    clientmodel->queueBlockTip(fHeader, BlockTipNotification{height, blockTime, verificationProgress});
+}
+
+void ClientModel::queueBlockTip(bool fHeader, const BlockTipNotification& tip)
+{
+    blockTipQueue->push(fHeader, tip);
 }
 
 void ClientModel::subscribeToCoreSignals()
@@ -17,6 +17,9 @@ class PeerTableModel;
 
 class CBlockIndex;
 
+template <typename Key, typename T>
+class NotificationQueue;
+
 namespace interfaces {
 class Handler;
 class Node;
@@ -33,6 +36,13 @@ enum class BlockSource {
     NETWORK
 };
 
+/** Block or header tip as reported by the node, see ClientModel::queueBlockTip */
+struct BlockTipNotification {
+    int height;
+    int64_t blockTime;
+    double verificationProgress;
+};
+
 enum NumConnections {
     CONNECTIONS_NONE = 0,
     CONNECTIONS_IN   = (1U << 0),
@@ -76,6 +86,9 @@ public:
 
     bool getProxyInfo(std::string& ip_port) const;
 
+    //! Queue a tip change for the GUI thread, may be called from any thread
+    void queueBlockTip(bool fHeader, const BlockTipNotification& tip);
+
     // caches for the best header
     mutable std::atomic<int> cachedBestHeaderHeight;
     mutable std::atomic<int64_t> cachedBestHeaderTime;
@@ -98,6 +111,8 @@ private:
 
     QTimer *pollTimer;
     QTimer *pollMnTimer;
+    // coalesces block and header tip changes, keyed by fHeader
+    NotificationQueue<bool, BlockTipNotification> *blockTipQueue;
 
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
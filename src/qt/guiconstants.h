@@ -34,6 +34,9 @@ static const bool DEFAULT_SPLASHSCREEN = true;
 /* Transaction list -- TX status decoration - default color */
 #define COLOR_BLACK QColor(0, 0, 0)
 
+/* Transaction list -- number of wallet transactions loaded at a time */
+static const int TRANSACTION_TABLE_PAGE_SIZE = 500;
+
 /* Tooltips longer than this (in characters) are converted into rich text,
    so that they can be word-wrapped.
  */
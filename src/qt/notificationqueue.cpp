@@ -0,0 +1,77 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <qt/notificationqueue.h>
+
+#include <util.h>
+#include <utiltime.h>
+
+#include <QTimer>
+
+#include <algorithm>
+
+/** Log the batching statistics at most this often (milliseconds) */
+static const int64_t NOTIFICATION_STATS_INTERVAL = 10 * 1000;
+
+NotificationQueueBase::NotificationQueueBase(const QString& _name, int _delay, QObject* parent) :
+    QObject(parent),
+    name(_name),
+    delay(_delay),
+    fScheduled(false),
+    nPosted(0),
+    nLastFlush(0),
+    nDelivered(0),
+    nBatches(0),
+    nDeliverMicros(0),
+    nStartMicros(GetTimeMicros()),
+    nLastLog(GetTimeMillis())
+{
+}
+
+NotificationQueueBase::~NotificationQueueBase()
+{
+    if (nBatches > 0)
+        logStats();
+}
+
+void NotificationQueueBase::schedule()
+{
+    nPosted++;
+    if (!fScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+    }
+}
+
+void NotificationQueueBase::scheduleFlush()
+{
+    // deliver right away unless the previous batch went out less than delay ago
+    int64_t nWait = std::max<int64_t>(0, nLastFlush + delay - GetTimeMillis());
+    QTimer::singleShot(nWait, this, SLOT(flush()));
+}
+
+void NotificationQueueBase::flush()
+{
+    // anything queued from now on needs another flush
+    fScheduled = false;
+
+    int64_t nStart = GetTimeMicros();
+    size_t nSize = deliver();
+    nDeliverMicros += GetTimeMicros() - nStart;
+    nDelivered += nSize;
+    nBatches++;
+    nLastFlush = GetTimeMillis();
+
+    if (nLastFlush - nLastLog > NOTIFICATION_STATS_INTERVAL) {
+        logStats();
+        nLastLog = nLastFlush;
+    }
+}
+
+void NotificationQueueBase::logStats()
+{
+    int64_t nElapsed = std::max<int64_t>(1, GetTimeMicros() - nStartMicros);
+    LogPrint(BCLog::QT, "%s: %u notifications delivered as %u updates in %u batches, GUI thread busy %.2fms (%.2f%% of %.2fs)\n",
+        name.toStdString(), nPosted.load(), nDelivered, nBatches, nDeliverMicros * 0.001,
+        100.0 * nDeliverMicros / nElapsed, nElapsed * 0.000001);
+}
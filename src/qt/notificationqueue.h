@@ -0,0 +1,110 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_QT_NOTIFICATIONQUEUE_H
+#define BITCOIN_QT_NOTIFICATIONQUEUE_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/** Collects notifications posted by core threads and hands them to the GUI
+ * thread in batches, at most one batch per delay milliseconds. During initial
+ * sync or a rescan this turns one queued Qt event per block or transaction into
+ * one model update per window. The time the GUI thread spends on the batches is
+ * logged under -debug=qt.
+ */
+class NotificationQueueBase : public QObject
+{
+    Q_OBJECT
+
+public:
+    NotificationQueueBase(const QString& name, int delay, QObject* parent);
+    ~NotificationQueueBase();
+
+protected:
+    /** Make sure a batch gets delivered, call after queueing from any thread */
+    void schedule();
+    /** Hand everything queued so far to the consumer, returns the batch size */
+    virtual size_t deliver() = 0;
+
+private Q_SLOTS:
+    void scheduleFlush();
+    void flush();
+
+private:
+    const QString name;
+    const int delay;
+    std::atomic<bool> fScheduled;
+    std::atomic<uint64_t> nPosted;
+
+    // GUI thread only
+    int64_t nLastFlush;
+    uint64_t nDelivered;
+    uint64_t nBatches;
+    int64_t nDeliverMicros;
+    int64_t nStartMicros;
+    int64_t nLastLog;
+
+    void logStats();
+};
+
+/** Notification queue that coalesces notifications by key: a notification
+ * replaces a pending one with the same key, which keeps its place in the batch.
+ */
+template <typename Key, typename T>
+class NotificationQueue : public NotificationQueueBase
+{
+public:
+    typedef std::vector<std::pair<Key, T>> Batch;
+    typedef std::function<void(const Batch&)> Consumer;
+
+    NotificationQueue(const QString& name, int delay, Consumer consumerIn, QObject* parent) :
+        NotificationQueueBase(name, delay, parent), consumer(std::move(consumerIn)) {}
+
+    /** Queue a notification, may be called from any thread */
+    void push(const Key& key, const T& value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            auto it = mapPending.find(key);
+            if (it != mapPending.end()) {
+                vPending[it->second].second = value;
+            } else {
+                mapPending.emplace(key, vPending.size());
+                vPending.emplace_back(key, value);
+            }
+        }
+        schedule();
+    }
+
+protected:
+    size_t deliver() override
+    {
+        Batch batch;
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            batch.swap(vPending);
+            mapPending.clear();
+        }
+        if (!batch.empty())
+            consumer(batch);
+        return batch.size();
+    }
+
+private:
+    const Consumer consumer;
+    std::mutex cs;
+    Batch vPending;
+    std::map<Key, size_t> mapPending;
+};
+
+#endif // BITCOIN_QT_NOTIFICATIONQUEUE_H
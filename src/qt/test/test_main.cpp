@@ -14,6 +14,7 @@
 
 #ifdef ENABLE_WALLET
 #include <test/paymentservertests.h>
+#include <test/transactiontabletests.h>
 #endif
 
 #include <QCoreApplication>
@@ -58,6 +59,11 @@ int main(int argc, char *argv[])
     TrafficGraphDataTests test5;
     if (QTest::qExec(&test5) != 0)
         fInvalid = true;
+#ifdef ENABLE_WALLET
+    TransactionTableTests test6;
+    if (QTest::qExec(&test6) != 0)
+        fInvalid = true;
+#endif
 
     return fInvalid;
 }
@@ -0,0 +1,124 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <qt/test/transactiontabletests.h>
+
+#include <interfaces/node.h>
+#include <interfaces/wallet.h>
+#include <qt/guiconstants.h>
+#include <qt/optionsmodel.h>
+#include <qt/transactionrecord.h>
+#include <qt/transactiontablemodel.h>
+#include <qt/walletmodel.h>
+#include <script/standard.h>
+#include <test/test_xsn.h>
+#include <ui_interface.h>
+#include <validation.h>
+#include <wallet/db.h>
+#include <wallet/wallet.h>
+
+#include <QSet>
+#include <QSignalSpy>
+
+namespace {
+//! Add nCount transactions paying to script, oldest first
+std::vector<uint256> AddTransactions(CWallet& wallet, const CScript& script, int nCount)
+{
+    std::vector<uint256> hashes;
+    for (int i = 0; i < nCount; i++) {
+        CMutableTransaction tx;
+        tx.vout.emplace_back(COIN + i, script);
+        CWalletTx wtx(&wallet, MakeTransactionRef(tx));
+        LOCK(cs_main);
+        wallet.AddToWallet(wtx);
+        hashes.push_back(wtx.GetHash());
+    }
+    return hashes;
+}
+
+QString RowHash(TransactionTableModel* model, int row)
+{
+    return model->index(row, 0).data(TransactionTableModel::TxHashRole).toString();
+}
+
+QString TxHash(const uint256& hash)
+{
+    return QString::fromStdString(hash.GetHex());
+}
+
+void DeleteTransaction(TransactionTableModel* model, const uint256& hash)
+{
+    model->updateTransaction(TxHash(hash), CT_DELETED, false);
+}
+} // namespace
+
+void TransactionTableTests::transactionTableTests()
+{
+    TestingSetup test;
+
+    CWallet wallet("mock", WalletDatabase::CreateMock());
+    bool fFirstRun;
+    wallet.LoadWallet(fFirstRun);
+    CKey key;
+    key.MakeNewKey(true);
+    {
+        LOCK(wallet.cs_wallet);
+        QVERIFY(wallet.AddKeyPubKey(key, key.GetPubKey()));
+    }
+    const int nPage = TRANSACTION_TABLE_PAGE_SIZE;
+    const int nTxs = 2 * nPage + 10;
+    std::vector<uint256> hashes = AddTransactions(wallet, GetScriptForDestination(key.GetPubKey().GetID()), nTxs);
+
+    std::unique_ptr<interfaces::Node> node = interfaces::MakeNode();
+    OptionsModel optionsModel(*node);
+    WalletModel walletModel(interfaces::MakeWallet(wallet), *node, nullptr, &optionsModel);
+    TransactionTableModel* model = walletModel.getTransactionTableModel();
+
+    // History comes in a page at a time, newest first
+    QCOMPARE(model->rowCount(QModelIndex()), nPage);
+    QVERIFY(model->canFetchMore(QModelIndex()));
+    QCOMPARE(RowHash(model, 0), TxHash(hashes[nTxs - 1]));
+    QCOMPARE(RowHash(model, nPage - 1), TxHash(hashes[nTxs - nPage]));
+    model->fetchMore(QModelIndex());
+    QCOMPARE(model->rowCount(QModelIndex()), 2 * nPage);
+    QCOMPARE(RowHash(model, nPage), TxHash(hashes[nTxs - 1 - nPage]));
+    QVERIFY(model->canFetchMore(QModelIndex()));
+
+    // The hash to row map follows rows as they move: deleting a transaction
+    // removes its own row only, also after the rows below it moved up
+    DeleteTransaction(model, hashes[nTxs - 1 - 10]);
+    QCOMPARE(model->rowCount(QModelIndex()), 2 * nPage - 1);
+    QCOMPARE(RowHash(model, 9), TxHash(hashes[nTxs - 1 - 9]));
+    QCOMPARE(RowHash(model, 10), TxHash(hashes[nTxs - 1 - 11]));
+    DeleteTransaction(model, hashes[nTxs - 1 - 600]);
+    QCOMPARE(model->rowCount(QModelIndex()), 2 * nPage - 2);
+    QCOMPARE(RowHash(model, 598), TxHash(hashes[nTxs - 1 - 599]));
+    QCOMPARE(RowHash(model, 599), TxHash(hashes[nTxs - 1 - 601]));
+
+    // The status of a row is looked up by the worker once the row is shown
+    QCOMPARE(model->index(0, 0).data(TransactionTableModel::StatusRole).toInt(), (int)TransactionStatus::Offline);
+    QSignalSpy changedSpy(model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QVERIFY(changedSpy.wait());
+    QCOMPARE(model->index(0, 0).data(TransactionTableModel::StatusRole).toInt(), (int)TransactionStatus::Unconfirmed);
+
+    // The worker loads the rest of the history with the status of every transaction
+    QSignalSpy loadedSpy(model, SIGNAL(allLoaded()));
+    model->fetchAll();
+    QVERIFY(model->loadingAll());
+    QVERIFY(!model->canFetchMore(QModelIndex()));
+    QVERIFY(loadedSpy.wait());
+    QVERIFY(!model->loadingAll());
+    QVERIFY(!model->canFetchMore(QModelIndex()));
+    QCOMPARE(model->rowCount(QModelIndex()), nTxs - 2);
+    QCOMPARE(RowHash(model, nTxs - 3), TxHash(hashes[0]));
+    QCOMPARE(model->index(nTxs - 3, 0).data(TransactionTableModel::StatusRole).toInt(), (int)TransactionStatus::Unconfirmed);
+    QCOMPARE(model->index(nPage, 0).data(TransactionTableModel::StatusRole).toInt(), (int)TransactionStatus::Unconfirmed);
+
+    // Every transaction is in the model once
+    QSet<QString> setHashes;
+    for (int row = 0; row < model->rowCount(QModelIndex()); row++)
+        setHashes.insert(RowHash(model, row));
+    QCOMPARE(setHashes.size(), nTxs - 2);
+    QVERIFY(!setHashes.contains(TxHash(hashes[nTxs - 1 - 600])));
+}
@@ -0,0 +1,19 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_QT_TEST_TRANSACTIONTABLETESTS_H
+#define BITCOIN_QT_TEST_TRANSACTIONTABLETESTS_H
+
+#include <QObject>
+#include <QTest>
+
+class TransactionTableTests : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void transactionTableTests();
+};
+
+#endif // BITCOIN_QT_TEST_TRANSACTIONTABLETESTS_H
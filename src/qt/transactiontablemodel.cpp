@@ -7,6 +7,7 @@
 #include <qt/addresstablemodel.h>
 #include <qt/guiconstants.h>
 #include <qt/guiutil.h>
+#include <qt/notificationqueue.h>
 #include <qt/optionsmodel.h>
 #include <qt/platformstyle.h>
 #include <qt/transactiondesc.h>
@@ -27,6 +28,12 @@
 #include <QIcon>
 #include <QList>
 
+#include <atomic>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+
 // Amount column is right-aligned it contains numbers
 static int column_alignments[] = {
         Qt::AlignLeft|Qt::AlignVCenter, /* status */
@@ -37,72 +44,170 @@ static int column_alignments[] = {
         Qt::AlignRight|Qt::AlignVCenter /* amount */
     };
 
-// Comparison operator for sort/binary search of model tx list
-struct TxLessThan
+class TransactionTablePriv;
+
+/* Status of a transaction, looked up by the worker at chain height numBlocks */
+struct TransactionStatusResult
 {
-    bool operator()(const TransactionRecord &a, const TransactionRecord &b) const
-    {
-        return a.hash < b.hash;
-    }
-    bool operator()(const TransactionRecord &a, const uint256 &b) const
-    {
-        return a.hash < b;
-    }
-    bool operator()(const uint256 &a, const TransactionRecord &b) const
-    {
-        return a < b.hash;
-    }
+    uint256 hash;
+    interfaces::WalletTxStatus status;
+    int numBlocks;
+    int64_t adjustedTime;
+};
+
+/* Looks up transaction status and loads the rest of the history in a background
+ * thread, so that painting, sorting or exporting the table never waits for
+ * cs_main or the wallet lock.
+ */
+class TransactionStatusWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    TransactionStatusWorker(interfaces::Wallet& _wallet, TransactionTablePriv *_priv) :
+        wallet(_wallet), priv(_priv) {}
+
+public Q_SLOTS:
+    void refresh();
+    /* Load the history older than the pages in the model a page at a time,
+       together with the status of its transactions */
+    void loadAll();
+
+Q_SIGNALS:
+    void refreshed();
+    void loaded();
+
+private:
+    interfaces::Wallet& wallet;
+    TransactionTablePriv *priv;
+
+    void lookUpStatuses(const std::vector<uint256> &hashes, std::vector<TransactionStatusResult> &results);
 };
 
+#include <qt/transactiontablemodel.moc>
+
 // Private implementation
 class TransactionTablePriv
 {
 public:
     TransactionTablePriv(TransactionTableModel *_parent) :
-        parent(_parent)
+        parent(_parent),
+        nNextOrderPos(std::numeric_limits<int64_t>::max()),
+        numBlocks(-1),
+        fLoadingAll(false),
+        worker(nullptr),
+        fShutdown(false),
+        nLoadOrderPos(std::numeric_limits<int64_t>::min()),
+        fLoadDone(false)
     {
     }
 
     TransactionTableModel *parent;
 
     /* Local cache of wallet.
-     * As it is in the same order as the CWallet, by definition
-     * this is sorted by sha256.
+     * Transactions are paged in newest first from the wallet's ordered index,
+     * transactions added to the wallet later on are appended at the end.
      */
     QList<TransactionRecord> cachedWallet;
 
-    /* Query entire wallet anew from core.
+    /* Row of the first record of each transaction in cachedWallet */
+    std::map<uint256, int> mapRows;
+
+    /* Wallet transactions ordered before this position haven't been loaded yet */
+    int64_t nNextOrderPos;
+
+    /* Chain height that record statuses should reflect */
+    int numBlocks;
+
+    /* Transactions whose status was requested from the worker and not applied yet */
+    std::set<uint256> setStatusRequested;
+
+    /* The worker is loading the rest of the history */
+    bool fLoadingAll;
+
+    TransactionStatusWorker *worker;
+
+    /* Tells the worker to stop loading, the model is going away */
+    std::atomic<bool> fShutdown;
+
+    /* Requests for and results from the worker thread */
+    std::mutex cs_status;
+    std::vector<uint256> vStatusRequests;
+    std::vector<uint256> vStatusDone;
+    std::vector<TransactionStatusResult> vStatusResults;
+    int64_t nLoadOrderPos;
+    std::vector<uint256> vLoadStatusRequests;
+    QList<TransactionRecord> vLoadedRecords;
+    std::vector<TransactionStatusResult> vLoadedStatuses;
+    bool fLoadDone;
+
+    /* Load the first page of the wallet anew from core.
      */
     void refreshWallet(interfaces::Wallet& wallet)
     {
         qDebug() << "TransactionTablePriv::refreshWallet";
         cachedWallet.clear();
-        {
-            for (const auto& wtx : wallet.getWalletTxs()) {
-                if (TransactionRecord::showTransaction()) {
-                    cachedWallet.append(TransactionRecord::decomposeTransaction(wtx, wallet));
-                }
+        mapRows.clear();
+        nNextOrderPos = std::numeric_limits<int64_t>::max();
+        fetchPage(wallet);
+    }
+
+    bool fullyLoaded() const
+    {
+        return nNextOrderPos == std::numeric_limits<int64_t>::min();
+    }
+
+    /* Load the next page of wallet transactions, older than everything loaded so far.
+     */
+    void fetchPage(interfaces::Wallet& wallet)
+    {
+        QList<TransactionRecord> toInsert;
+        for (const auto& wtx : wallet.getWalletTxsOrdered(nNextOrderPos, TRANSACTION_TABLE_PAGE_SIZE)) {
+            // It may already be in the model through an update notification
+            if (TransactionRecord::showTransaction() && !mapRows.count(wtx.tx->GetHash())) {
+                toInsert.append(TransactionRecord::decomposeTransaction(wtx, wallet));
             }
         }
+        // Older history coming in is not news, no balloons for it
+        parent->fProcessingQueuedTransactions = true;
+        appendRecords(toInsert);
+        parent->fProcessingQueuedTransactions = false;
+    }
+
+    void appendRecords(const QList<TransactionRecord> &toInsert)
+    {
+        if (toInsert.isEmpty())
+            return;
+
+        int first = cachedWallet.size();
+        parent->beginInsertRows(QModelIndex(), first, first + toInsert.size() - 1);
+        for (const TransactionRecord &rec : toInsert)
+        {
+            mapRows.emplace(rec.hash, cachedWallet.size());
+            cachedWallet.append(rec);
+            // status is computed once the record is shown
+            cachedWallet.back().status.needsUpdate = true;
+        }
+        parent->endInsertRows();
     }
 
     /* Update our model of the wallet incrementally, to synchronize our model of the wallet
        with that of the core.
 
-       Call with transaction that was added, removed or changed.
+       Call with transaction that was added, removed or changed. When pendingInsert is
+       given, new records are collected there for the caller to append in one go.
      */
-    void updateWallet(interfaces::Wallet& wallet, const uint256 &hash, int status, bool showTransaction)
+    void updateWallet(interfaces::Wallet& wallet, const uint256 &hash, int status, bool showTransaction, QList<TransactionRecord> *pendingInsert = nullptr)
     {
         qDebug() << "TransactionTablePriv::updateWallet: " + QString::fromStdString(hash.ToString()) + " " + QString::number(status);
 
         // Find bounds of this transaction in model
-        QList<TransactionRecord>::iterator lower = qLowerBound(
-            cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-        QList<TransactionRecord>::iterator upper = qUpperBound(
-            cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-        int lowerIndex = (lower - cachedWallet.begin());
-        int upperIndex = (upper - cachedWallet.begin());
-        bool inModel = (lower != upper);
+        auto it = mapRows.find(hash);
+        bool inModel = (it != mapRows.end());
+        int lowerIndex = inModel ? it->second : cachedWallet.size();
+        int upperIndex = lowerIndex;
+        while (inModel && upperIndex < cachedWallet.size() && cachedWallet[upperIndex].hash == hash)
+            upperIndex++;
 
         if(status == CT_UPDATED)
         {
@@ -133,20 +238,14 @@ public:
                     qWarning() << "TransactionTablePriv::updateWallet: Warning: Got CT_NEW, but transaction is not in wallet";
                     break;
                 }
-                // Added -- insert at the right position
-                QList<TransactionRecord> toInsert =
-                        TransactionRecord::decomposeTransaction(wtx, wallet);
-                if(!toInsert.isEmpty()) /* only if something to insert */
-                {
-                    parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+toInsert.size()-1);
-                    int insert_idx = lowerIndex;
-                    for (const TransactionRecord &rec : toInsert)
-                    {
-                        cachedWallet.insert(insert_idx, rec);
-                        insert_idx += 1;
-                    }
-                    parent->endInsertRows();
-                }
+                // Not paged in yet, it shows up along with its page
+                if(wtx.order_pos < nNextOrderPos)
+                    break;
+                // Added -- append to the model
+                if(pendingInsert)
+                    pendingInsert->append(TransactionRecord::decomposeTransaction(wtx, wallet));
+                else
+                    appendRecords(TransactionRecord::decomposeTransaction(wtx, wallet));
             }
             break;
         case CT_DELETED:
@@ -157,7 +256,13 @@ public:
             }
             // Removed -- remove entire transaction from table
             parent->beginRemoveRows(QModelIndex(), lowerIndex, upperIndex-1);
-            cachedWallet.erase(lower, upper);
+            cachedWallet.erase(cachedWallet.begin() + lowerIndex, cachedWallet.begin() + upperIndex);
+            mapRows.erase(it);
+            for (auto &row : mapRows)
+            {
+                if (row.second > lowerIndex)
+                    row.second -= upperIndex - lowerIndex;
+            }
             parent->endRemoveRows();
             break;
         case CT_UPDATED:
@@ -182,24 +287,128 @@ public:
         {
             TransactionRecord *rec = &cachedWallet[idx];
 
-            // Get required locks upfront. This avoids the GUI from getting
-            // stuck if the core is holding the locks for a longer time - for
-            // example, during a wallet rescan.
-            //
             // If a status update is needed (blocks came in since last check),
-            //  update the status of this transaction from the wallet. Otherwise,
-            // simply re-use the cached status.
-            interfaces::WalletTxStatus wtx;
-            int numBlocks;
-            int64_t adjustedTime;
-            if (wallet.tryGetTxStatus(rec->hash, wtx, numBlocks, adjustedTime) && rec->statusUpdateNeeded(numBlocks)) {
-                rec->updateStatus(wtx, numBlocks, adjustedTime);
+            // have the worker thread look it up. Until it is done, simply
+            // re-use the cached status.
+            if (rec->statusUpdateNeeded(numBlocks)) {
+                requestStatus(rec->hash);
             }
             return rec;
         }
         return 0;
     }
 
+    void requestStatus(const uint256 &hash)
+    {
+        if (!worker || !setStatusRequested.insert(hash).second)
+            return;
+
+        bool fWakeWorker;
+        {
+            std::lock_guard<std::mutex> lock(cs_status);
+            fWakeWorker = vStatusRequests.empty();
+            vStatusRequests.push_back(hash);
+        }
+        if (fWakeWorker)
+            QMetaObject::invokeMethod(worker, "refresh", Qt::QueuedConnection);
+    }
+
+    /* Apply statuses looked up by the worker, adding the rows that changed to rows.
+       Each record keeps the height its status was looked up at, so that a result
+       older than numBlocks gets looked up again; numBlocks itself only moves forward. */
+    void applyStatusResults(const std::vector<TransactionStatusResult> &results, std::vector<int> &rows)
+    {
+        for (const TransactionStatusResult &result : results)
+        {
+            if (result.numBlocks > numBlocks)
+                numBlocks = result.numBlocks;
+            auto it = mapRows.find(result.hash);
+            if (it == mapRows.end())
+                continue;
+            for (int row = it->second; row < cachedWallet.size() && cachedWallet[row].hash == result.hash; row++)
+            {
+                cachedWallet[row].updateStatus(result.status, result.numBlocks, result.adjustedTime);
+                rows.push_back(row);
+            }
+        }
+    }
+
+    /* Apply the statuses looked up by the worker, returns the rows that changed */
+    std::vector<int> applyStatusUpdates()
+    {
+        std::vector<uint256> done;
+        std::vector<TransactionStatusResult> results;
+        {
+            std::lock_guard<std::mutex> lock(cs_status);
+            done.swap(vStatusDone);
+            results.swap(vStatusResults);
+        }
+        for (const uint256 &hash : done)
+            setStatusRequested.erase(hash);
+
+        std::vector<int> rows;
+        applyStatusResults(results, rows);
+        return rows;
+    }
+
+    /* Have the worker load the rest of the history and look up every status that is out of date */
+    void requestLoadAll()
+    {
+        if (!worker || fLoadingAll)
+            return;
+        fLoadingAll = true;
+
+        std::vector<uint256> hashes;
+        for (const auto &row : mapRows)
+        {
+            if (cachedWallet[row.second].statusUpdateNeeded(numBlocks))
+                hashes.push_back(row.first);
+        }
+        {
+            std::lock_guard<std::mutex> lock(cs_status);
+            nLoadOrderPos = nNextOrderPos;
+            vLoadStatusRequests.swap(hashes);
+            fLoadDone = false;
+        }
+        QMetaObject::invokeMethod(worker, "loadAll", Qt::QueuedConnection);
+    }
+
+    /* Append what the worker loaded so far and apply its statuses, adding the
+       rows whose status changed to rows. Returns whether the whole history is in. */
+    bool applyLoaded(std::vector<int> &rows)
+    {
+        QList<TransactionRecord> loaded;
+        std::vector<TransactionStatusResult> results;
+        bool fDone;
+        {
+            std::lock_guard<std::mutex> lock(cs_status);
+            loaded.swap(vLoadedRecords);
+            results.swap(vLoadedStatuses);
+            fDone = fLoadDone;
+        }
+
+        QList<TransactionRecord> toInsert;
+        for (const TransactionRecord &rec : loaded)
+        {
+            // It may already be in the model through an update notification
+            if (!mapRows.count(rec.hash))
+                toInsert.append(rec);
+        }
+        // Older history coming in is not news, no balloons for it
+        parent->fProcessingQueuedTransactions = true;
+        appendRecords(toInsert);
+        parent->fProcessingQueuedTransactions = false;
+
+        applyStatusResults(results, rows);
+
+        if (fDone)
+        {
+            nNextOrderPos = std::numeric_limits<int64_t>::min();
+            fLoadingAll = false;
+        }
+        return fDone;
+    }
+
     QString describe(interfaces::Node& node, interfaces::Wallet& wallet, TransactionRecord *rec, int unit)
     {
         return TransactionDesc::toHTML(node, wallet, rec, unit);
@@ -216,11 +425,92 @@ public:
     }
 };
 
+void TransactionStatusWorker::lookUpStatuses(const std::vector<uint256> &hashes, std::vector<TransactionStatusResult> &results)
+{
+    int numBlocks;
+    int64_t adjustedTime;
+    for (const auto &result : wallet.getTxStatuses(hashes, numBlocks, adjustedTime))
+        results.push_back({result.first, result.second, numBlocks, adjustedTime});
+}
+
+void TransactionStatusWorker::refresh()
+{
+    std::vector<uint256> requests;
+    {
+        std::lock_guard<std::mutex> lock(priv->cs_status);
+        requests.swap(priv->vStatusRequests);
+    }
+    if (requests.empty())
+        return;
+
+    std::vector<TransactionStatusResult> results;
+    lookUpStatuses(requests, results);
+    {
+        std::lock_guard<std::mutex> lock(priv->cs_status);
+        priv->vStatusDone.insert(priv->vStatusDone.end(), requests.begin(), requests.end());
+        priv->vStatusResults.insert(priv->vStatusResults.end(), results.begin(), results.end());
+    }
+    Q_EMIT refreshed();
+}
+
+void TransactionStatusWorker::loadAll()
+{
+    int64_t nOrderPos;
+    std::vector<uint256> requests;
+    {
+        std::lock_guard<std::mutex> lock(priv->cs_status);
+        nOrderPos = priv->nLoadOrderPos;
+        requests.swap(priv->vLoadStatusRequests);
+    }
+
+    // Records already in the model, a page worth of them per lookup so that
+    // cs_main and the wallet lock are only held briefly at a time
+    for (size_t i = 0; i < requests.size() && !priv->fShutdown; i += TRANSACTION_TABLE_PAGE_SIZE)
+    {
+        std::vector<uint256> hashes(requests.begin() + i, requests.begin() + std::min(requests.size(), i + TRANSACTION_TABLE_PAGE_SIZE));
+        std::vector<TransactionStatusResult> results;
+        lookUpStatuses(hashes, results);
+        {
+            std::lock_guard<std::mutex> lock(priv->cs_status);
+            priv->vLoadedStatuses.insert(priv->vLoadedStatuses.end(), results.begin(), results.end());
+        }
+        Q_EMIT loaded();
+    }
+
+    // The history that isn't in the model yet, a page at a time
+    while (nOrderPos != std::numeric_limits<int64_t>::min() && !priv->fShutdown)
+    {
+        QList<TransactionRecord> records;
+        std::vector<uint256> hashes;
+        for (const auto& wtx : wallet.getWalletTxsOrdered(nOrderPos, TRANSACTION_TABLE_PAGE_SIZE)) {
+            if (TransactionRecord::showTransaction()) {
+                records.append(TransactionRecord::decomposeTransaction(wtx, wallet));
+                hashes.push_back(wtx.tx->GetHash());
+            }
+        }
+        std::vector<TransactionStatusResult> results;
+        lookUpStatuses(hashes, results);
+        {
+            std::lock_guard<std::mutex> lock(priv->cs_status);
+            priv->vLoadedRecords.append(records);
+            priv->vLoadedStatuses.insert(priv->vLoadedStatuses.end(), results.begin(), results.end());
+        }
+        Q_EMIT loaded();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(priv->cs_status);
+        priv->fLoadDone = true;
+    }
+    Q_EMIT loaded();
+}
+
 TransactionTableModel::TransactionTableModel(const PlatformStyle *_platformStyle, WalletModel *parent):
         QAbstractTableModel(parent),
         walletModel(parent),
         priv(new TransactionTablePriv(this)),
         fProcessingQueuedTransactions(false),
+        transactionQueue(0),
         platformStyle(_platformStyle)
 {
     columns << QString() << QString() << tr("Date") << tr("Type") << tr("Label") << BitcoinUnits::getAmountColumnTitle(walletModel->getOptionsModel()->getDisplayUnit());
@@ -228,15 +518,39 @@ TransactionTableModel::TransactionTableModel(const PlatformStyle *_platformStyle
 
     connect(walletModel->getOptionsModel(), SIGNAL(displayUnitChanged(int)), this, SLOT(updateDisplayUnit()));
 
+    // Wallet notifications arriving within MODEL_UPDATE_DELAY of each other,
+    // e.g. during a rescan or while catching up, are applied as one update
+    transactionQueue = new NotificationQueue<uint256, TransactionNotification>("transactiontable", MODEL_UPDATE_DELAY,
+        [this](const std::vector<std::pair<uint256, TransactionNotification>>& batch) { updateTransactions(batch); }, this);
+
+    startStatusWorker();
     subscribeToCoreSignals();
 }
 
 TransactionTableModel::~TransactionTableModel()
 {
     unsubscribeFromCoreSignals();
+    priv->fShutdown = true;
+    statusThread.quit();
+    statusThread.wait();
     delete priv;
 }
 
+void TransactionTableModel::startStatusWorker()
+{
+    TransactionStatusWorker *worker = new TransactionStatusWorker(walletModel->wallet(), priv);
+    worker->moveToThread(&statusThread);
+    priv->worker = worker;
+
+    // Results from the worker must go to this object
+    connect(worker, SIGNAL(refreshed()), this, SLOT(updateStatuses()));
+    connect(worker, SIGNAL(loaded()), this, SLOT(updateLoaded()));
+    // Queue the worker for deletion (in its thread) once the thread is stopped
+    connect(&statusThread, SIGNAL(finished()), worker, SLOT(deleteLater()), Qt::DirectConnection);
+
+    statusThread.start();
+}
+
 /** Updates the column title to "Amount (DisplayUnit)" and emits headerDataChanged() signal for table headers to react. */
 void TransactionTableModel::updateAmountColumnTitle()
 {
@@ -252,16 +566,75 @@ void TransactionTableModel::updateTransaction(const QString &hash, int status, b
     priv->updateWallet(walletModel->wallet(), updated, status, showTransaction);
 }
 
-void TransactionTableModel::updateConfirmations()
+void TransactionTableModel::updateTransactions(const std::vector<std::pair<uint256, TransactionNotification>>& batch)
+{
+    // prevent balloon spam, show maximum 10 balloons and none during a rescan:
+    // the records of all other transactions are inserted quietly and at once
+    size_t nQuiet = batch.size() > 10 ? batch.size() - 10 : 0;
+    QList<TransactionRecord> toInsert;
+    fProcessingQueuedTransactions = true;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (i < nQuiet || batch[i].second.inProgress)
+            priv->updateWallet(walletModel->wallet(), batch[i].first, batch[i].second.status, batch[i].second.showTransaction, &toInsert);
+    }
+    priv->appendRecords(toInsert);
+    fProcessingQueuedTransactions = false;
+
+    for (size_t i = nQuiet; i < batch.size(); ++i) {
+        if (!batch[i].second.inProgress)
+            priv->updateWallet(walletModel->wallet(), batch[i].first, batch[i].second.status, batch[i].second.showTransaction);
+    }
+}
+
+void TransactionTableModel::updateConfirmations(int numBlocks)
 {
     // Blocks came in since last poll.
     // Invalidate status (number of confirmations) and (possibly) description
     //  for all rows. Qt is smart enough to only actually request the data for the
-    //  visible rows.
+    //  visible rows, whose status then gets looked up by the worker.
+    priv->numBlocks = numBlocks;
     Q_EMIT dataChanged(index(0, Status), index(priv->size()-1, Status));
     Q_EMIT dataChanged(index(0, ToAddress), index(priv->size()-1, ToAddress));
 }
 
+void TransactionTableModel::updateStatuses()
+{
+    for (int row : priv->applyStatusUpdates())
+        Q_EMIT dataChanged(index(row, 0), index(row, columns.length() - 1));
+}
+
+void TransactionTableModel::updateLoaded()
+{
+    std::vector<int> rows;
+    bool fDone = priv->applyLoaded(rows);
+    for (int row : rows)
+        Q_EMIT dataChanged(index(row, 0), index(row, columns.length() - 1));
+    if (fDone)
+        Q_EMIT allLoaded();
+}
+
+void TransactionTableModel::fetchAll()
+{
+    priv->requestLoadAll();
+}
+
+bool TransactionTableModel::loadingAll() const
+{
+    return priv->fLoadingAll;
+}
+
+bool TransactionTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    // While the worker loads the rest, pages come in from there
+    return !parent.isValid() && !priv->fullyLoaded() && !priv->fLoadingAll;
+}
+
+void TransactionTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid())
+        priv->fetchPage(walletModel->wallet());
+}
+
 int TransactionTableModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
@@ -705,31 +1078,8 @@ void TransactionTableModel::updateDisplayUnit()
     Q_EMIT dataChanged(index(0, Amount), index(priv->size()-1, Amount));
 }
 
-// queue notifications to show a non freezing progress dialog e.g. for rescan
-struct TransactionNotification
-{
-public:
-    TransactionNotification() {}
-    TransactionNotification(uint256 _hash, ChangeType _status, bool _showTransaction):
-        hash(_hash), status(_status), showTransaction(_showTransaction) {}
-
-    void invoke(QObject *ttm)
-    {
-        QString strHash = QString::fromStdString(hash.GetHex());
-        qDebug() << "NotifyTransactionChanged: " + strHash + " status= " + QString::number(status);
-        QMetaObject::invokeMethod(ttm, "updateTransaction", Qt::QueuedConnection,
-                                  Q_ARG(QString, strHash),
-                                  Q_ARG(int, status),
-                                  Q_ARG(bool, showTransaction));
-    }
-private:
-    uint256 hash;
-    ChangeType status;
-    bool showTransaction;
-};
-
-static bool fQueueNotifications = false;
-static std::vector< TransactionNotification > vQueueNotifications;
+// set while the wallet shows a progress dialog, e.g. for rescan
+static std::atomic<bool> fWalletInProgress(false);
 
 static void NotifyTransactionChanged(TransactionTableModel *ttm, const uint256 &hash, ChangeType status)
 {
@@ -737,35 +1087,20 @@ static void NotifyTransactionChanged(TransactionTableModel *ttm, const uint256 &
     // Determine whether to show transaction or not (determine this here so that no relocking is needed in GUI thread)
     bool showTransaction = TransactionRecord::showTransaction();
 
-    TransactionNotification notification(hash, status, showTransaction);
-
-    if (fQueueNotifications)
-    {
-        vQueueNotifications.push_back(notification);
-        return;
-    }
-    notification.invoke(ttm);
+    qDebug() << "NotifyTransactionChanged: " + QString::fromStdString(hash.GetHex()) + " status= " + QString::number(status);
+    ttm->queueTransaction(hash, TransactionNotification{status, showTransaction, fWalletInProgress});
 }
 
 static void ShowProgress(TransactionTableModel *ttm, const std::string &title, int nProgress)
 {
-    if (nProgress == 0)
-        fQueueNotifications = true;
-
-    if (nProgress == 100)
-    {
-        fQueueNotifications = false;
-        if (vQueueNotifications.size() > 10) // prevent balloon spam, show maximum 10 balloons
-            QMetaObject::invokeMethod(ttm, "setProcessingQueuedTransactions", Qt::QueuedConnection, Q_ARG(bool, true));
-        for (unsigned int i = 0; i < vQueueNotifications.size(); ++i)
-        {
-            if (vQueueNotifications.size() - i <= 10)
-                QMetaObject::invokeMethod(ttm, "setProcessingQueuedTransactions", Qt::QueuedConnection, Q_ARG(bool, false));
+    Q_UNUSED(ttm);
+    Q_UNUSED(title);
+    fWalletInProgress = nProgress < 100;
+}
 
-            vQueueNotifications[i].invoke(ttm);
-        }
-        std::vector<TransactionNotification >().swap(vQueueNotifications); // clear
-    }
+void TransactionTableModel::queueTransaction(const uint256 &hash, const TransactionNotification &notification)
+{
+    transactionQueue->push(hash, notification);
 }
 
 void TransactionTableModel::subscribeToCoreSignals()
@@ -9,8 +9,11 @@
 
 #include <QAbstractTableModel>
 #include <QStringList>
+#include <QThread>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace interfaces {
 class Handler;
@@ -20,6 +23,18 @@ class PlatformStyle;
 class TransactionRecord;
 class TransactionTablePriv;
 class WalletModel;
+class uint256;
+
+template <typename Key, typename T>
+class NotificationQueue;
+
+/** Wallet transaction change waiting to be applied to the transaction table */
+struct TransactionNotification {
+    int status;
+    bool showTransaction;
+    /* Changed during a rescan or similar, not worth a balloon */
+    bool inProgress;
+};
 
 /** UI model for the transaction table of a wallet.
  */
@@ -81,7 +96,20 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const;
     QModelIndex index(int row, int column, const QModelIndex & parent = QModelIndex()) const;
+    /** Wallet history is loaded a page at a time, newest first */
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+    /**
+     * Load the rest of the wallet history and the status of every transaction, e.g. for
+     * exporting it. This happens on the status worker thread, rows come in a page at a
+     * time and allLoaded() is emitted once all of them are in.
+     */
+    void fetchAll();
+    /** fetchAll() is in progress */
+    bool loadingAll() const;
     bool processingQueuedTransactions() const { return fProcessingQueuedTransactions; }
+    /** Queue a transaction change for the GUI thread, may be called from any thread */
+    void queueTransaction(const uint256 &hash, const TransactionNotification &notification);
 
 private:
     WalletModel *walletModel;
@@ -90,10 +118,16 @@ private:
     QStringList columns;
     TransactionTablePriv *priv;
     bool fProcessingQueuedTransactions;
+    NotificationQueue<uint256, TransactionNotification> *transactionQueue;
     const PlatformStyle *platformStyle;
+    /** Thread looking up transaction status off the GUI thread */
+    QThread statusThread;
 
+    void startStatusWorker();
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
+    /* New transactions, or transactions changed status */
+    void updateTransactions(const std::vector<std::pair<uint256, TransactionNotification>>& batch);
 
     QString lookupAddress(const std::string &address, bool tooltip) const;
     QVariant addressColor(const TransactionRecord *wtx) const;
@@ -107,15 +141,21 @@ private:
     QVariant txWatchonlyDecoration(const TransactionRecord *wtx) const;
     QVariant txAddressDecoration(const TransactionRecord *wtx) const;
 
+Q_SIGNALS:
+    /** The whole history requested by fetchAll() is in the model */
+    void allLoaded();
+
 public Q_SLOTS:
     /* New transaction, or transaction changed status */
     void updateTransaction(const QString &hash, int status, bool showTransaction);
-    void updateConfirmations();
+    void updateConfirmations(int numBlocks);
+    /* Transaction status looked up by the worker thread is available */
+    void updateStatuses();
+    /* History loaded by the worker thread is available */
+    void updateLoaded();
     void updateDisplayUnit();
     /** Updates the column title to "Amount (DisplayUnit)" and emits headerDataChanged() signal for table headers to react. */
     void updateAmountColumnTitle();
-    /* Needed to update fProcessingQueuedTransactions through a QueuedConnection */
-    void setProcessingQueuedTransactions(bool value) { fProcessingQueuedTransactions = value; }
 
     friend class TransactionTablePriv;
 };
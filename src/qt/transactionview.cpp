@@ -229,6 +229,8 @@ void TransactionView::setModel(WalletModel *_model)
         transactionView->setSortingEnabled(true);
         transactionView->sortByColumn(TransactionTableModel::Date, Qt::DescendingOrder);
         transactionView->verticalHeader()->hide();
+        connect(transactionView->horizontalHeader(), SIGNAL(sortIndicatorChanged(int,Qt::SortOrder)), this, SLOT(sortChanged(int,Qt::SortOrder)));
+        connect(_model->getTransactionTableModel(), SIGNAL(allLoaded()), this, SLOT(historyLoaded()));
 
         transactionView->setColumnWidth(TransactionTableModel::Status, STATUS_COLUMN_WIDTH);
         transactionView->setColumnWidth(TransactionTableModel::Watchonly, WATCHONLY_COLUMN_WIDTH);
@@ -349,6 +351,18 @@ void TransactionView::changedAmount()
     }
 }
 
+void TransactionView::sortChanged(int column, Qt::SortOrder order)
+{
+    if(!model)
+        return;
+    // History is loaded a page at a time newest first, which only gives the top of
+    // the list when sorting by date descending. Any other order needs all of it:
+    // the proxy sorts the rows loaded so far, the rest is loaded in the background
+    // and sorted in as it comes.
+    if(column != TransactionTableModel::Date || order != Qt::DescendingOrder)
+        model->getTransactionTableModel()->fetchAll();
+}
+
 void TransactionView::exportClicked()
 {
     if (!model || !model->getOptionsModel()) {
@@ -363,6 +377,19 @@ void TransactionView::exportClicked()
     if (filename.isNull())
         return;
 
+    // The model loads history a page at a time, export once the worker has loaded
+    // all of it along with the status of every transaction
+    pendingExportFilename = filename;
+    model->getTransactionTableModel()->fetchAll();
+}
+
+void TransactionView::historyLoaded()
+{
+    if (pendingExportFilename.isNull() || !model || !model->getOptionsModel())
+        return;
+    QString filename = pendingExportFilename;
+    pendingExportFilename = QString();
+
     CSVModelWriter writer(filename);
 
     // name, column, role
@@ -80,6 +80,9 @@ private:
     QAction *abandonAction;
     QAction *bumpFeeAction;
 
+    /* Where to export the history to once all of it is loaded */
+    QString pendingExportFilename;
+
     QWidget *createDateRangeWidget();
 
     GUIUtil::TableViewLastColumnResizingFixer *columnResizingFixer;
@@ -103,6 +106,8 @@ private Q_SLOTS:
     void updateWatchOnlyColumn(bool fHaveWatchOnly);
     void abandonTx();
     void bumpFee();
+    void sortChanged(int column, Qt::SortOrder order);
+    void historyLoaded();
 
 Q_SIGNALS:
     void doubleClicked(const QModelIndex&);
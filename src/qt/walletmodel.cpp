@@ -6,6 +6,7 @@
 
 #include <qt/addresstablemodel.h>
 #include <qt/guiconstants.h>
+#include <qt/notificationqueue.h>
 #include <qt/optionsmodel.h>
 #include <qt/paymentserver.h>
 #include <qt/recentrequeststablemodel.h>
@@ -50,6 +51,9 @@ WalletModel::WalletModel(std::unique_ptr<interfaces::Wallet> wallet, interfaces:
     connect(pollTimer, SIGNAL(timeout()), this, SLOT(pollBalanceChanged()));
     pollTimer->start(MODEL_UPDATE_DELAY);
 
+    transactionQueue = new NotificationQueue<int, int>("wallettx", MODEL_UPDATE_DELAY,
+        [this](const std::vector<std::pair<int, int>>& batch) { updateTransaction(); }, this);
+
     subscribeToCoreSignals();
 }
 
@@ -88,7 +92,7 @@ void WalletModel::pollBalanceChanged()
 
         checkBalanceChanged(new_balances);
         if(transactionTableModel)
-            transactionTableModel->updateConfirmations();
+            transactionTableModel->updateConfirmations(cachedNumBlocks);
     }
 }
 
@@ -417,7 +421,13 @@ static void NotifyTransactionChanged(WalletModel *walletmodel, const uint256 &ha
 {
     Q_UNUSED(hash);
     Q_UNUSED(status);
-    QMetaObject::invokeMethod(walletmodel, "updateTransaction", Qt::QueuedConnection);
+    walletmodel->queueTransactionChanged();
+}
+
+void WalletModel::queueTransactionChanged()
+{
+    // only the balance needs rechecking, so all changes collapse into one entry
+    transactionQueue->push(0, 0);
 }
 
 static void ShowProgress(WalletModel *walletmodel, const std::string &title, int nProgress)
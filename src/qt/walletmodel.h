@@ -38,6 +38,9 @@ class COutput;
 class CPubKey;
 class uint256;
 
+template <typename Key, typename T>
+class NotificationQueue;
+
 namespace interfaces {
 class Node;
 } // namespace interfaces
@@ -212,6 +215,9 @@ public:
     bool isMultiwallet();
 
     AddressTableModel* getAddressTableModel() const { return addressTableModel; }
+
+    //! Queue a transaction change for the GUI thread, may be called from any thread
+    void queueTransactionChanged();
 private:
     std::unique_ptr<interfaces::Wallet> m_wallet;
     std::unique_ptr<interfaces::Handler> m_handler_status_changed;
@@ -239,6 +245,8 @@ private:
     int cachedNumBlocks;
 
     QTimer *pollTimer;
+    // coalesces transaction change notifications into one updateTransaction
+    NotificationQueue<int, int> *transactionQueue;
 
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
@@ -11,6 +11,7 @@
 #include <primitives/transaction.h>
 #include <validation.h>
 #include <httpserver.h>
+#include <perfstats.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
 #include <streams.h>
@@ -30,6 +31,7 @@ enum class RetFormat {
     BINARY,
     HEX,
     JSON,
+    TEXT,
 };
 
 static const struct {
@@ -40,6 +42,7 @@ static const struct {
       {RetFormat::BINARY, "bin"},
       {RetFormat::HEX, "hex"},
       {RetFormat::JSON, "json"},
+      {RetFormat::TEXT, "txt"},
 };
 
 struct CCoin {
@@ -93,7 +96,8 @@ static std::string AvailableDataFormatsString()
 {
     std::string formats;
     for (unsigned int i = 0; i < ARRAYLEN(rf_names); i++)
-        if (strlen(rf_names[i].name) > 0) {
+        // plain text is only served by /rest/perfstats
+        if (strlen(rf_names[i].name) > 0 && rf_names[i].rf != RetFormat::TEXT) {
             formats.append(".");
             formats.append(rf_names[i].name);
             formats.append(", ");
@@ -220,7 +224,7 @@ static bool rest_block(HTTPRequest* req,
         if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
 
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus(), true))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
@@ -296,6 +300,24 @@ static bool rest_chaininfo(HTTPRequest* req, const std::string& strURIPart)
     }
 }
 
+static bool rest_perfstats(HTTPRequest* req, const std::string& strURIPart)
+{
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+
+    switch (rf) {
+    case RetFormat::TEXT: {
+        // Prometheus text exposition format
+        req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+        req->WriteReply(HTTP_OK, FormatPerfStatsPrometheus(GetPerfStats()));
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: txt)");
+    }
+    }
+}
+
 static bool rest_mempool_info(HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -581,6 +603,7 @@ static const struct {
       {"/rest/block/notxdetails/", rest_block_notxdetails},
       {"/rest/block/", rest_block_extended},
       {"/rest/chaininfo", rest_chaininfo},
+      {"/rest/perfstats", rest_perfstats},
       {"/rest/mempool/info", rest_mempool_info},
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
@@ -343,6 +343,40 @@ static UniValue syncwithvalidationinterfacequeue(const JSONRPCRequest& request)
     return NullUniValue;
 }
 
+static UniValue getvalidationqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 0) {
+        throw std::runtime_error(
+            "getvalidationqueueinfo\n"
+            "\nReturns the callback queue of every validation interface subscriber.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"name\": \"xxxx\",           (string) Subscriber\n"
+            "    \"pending\": n,               (numeric) Callbacks waiting to run\n"
+            "    \"maxpending\": n,            (numeric) Deepest the queue has been since the subscriber registered\n"
+            "    \"processed\": n              (numeric) Callbacks run since the subscriber registered\n"
+            "  },\n"
+            "  ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getvalidationqueueinfo","")
+            + HelpExampleRpc("getvalidationqueueinfo","")
+        );
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const ValidationInterfaceQueueStats& stats : GetMainSignals().GetQueueStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", stats.name);
+        obj.pushKV("pending", (uint64_t)stats.pending);
+        obj.pushKV("maxpending", (uint64_t)stats.maxPending);
+        obj.pushKV("processed", stats.processed);
+        ret.push_back(obj);
+    }
+    return ret;
+}
+
 static UniValue getdifficulty(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -814,7 +848,7 @@ static UniValue getblock(const JSONRPCRequest& request)
     if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
 
-    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus(), true))
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
         // non-whitelisted node sends us an unrequested long chain of valid
@@ -1430,6 +1464,52 @@ static UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+static UniValue ScriptCacheStatsToJSON(const CScriptCacheStats& stats)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", stats.nHeight);
+    ret.pushKV("hash", stats.hashBlock.GetHex());
+    ret.pushKV("sigcachehits", stats.nSigCacheHits);
+    ret.pushKV("sigcachemisses", stats.nSigCacheMisses);
+    ret.pushKV("scriptcachehits", stats.nScriptCacheHits);
+    ret.pushKV("scriptcachemisses", stats.nScriptCacheMisses);
+    return ret;
+}
+
+static UniValue getscriptcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getscriptcacheinfo\n"
+            "\nReturns signature cache and script execution cache lookups made while connecting blocks.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"lastblock\": {               (json object) Lookups of the last connected block\n"
+            "    \"height\": xxxxx,             (numeric) Height of the block\n"
+            "    \"hash\": \"hex\",              (string) Hash of the block\n"
+            "    \"sigcachehits\": xxxxx,       (numeric) Signature cache hits\n"
+            "    \"sigcachemisses\": xxxxx,     (numeric) Signature cache misses\n"
+            "    \"scriptcachehits\": xxxxx,    (numeric) Script execution cache hits\n"
+            "    \"scriptcachemisses\": xxxxx   (numeric) Script execution cache misses\n"
+            "  },\n"
+            "  \"total\": { ... },             (json object) Same fields, summed over all blocks connected since startup\n"
+            "  \"warmedtxs\": xxxxx           (numeric) Mempool transactions verified ahead of block connection (see -scriptcachewarmup)\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getscriptcacheinfo", "")
+            + HelpExampleRpc("getscriptcacheinfo", "")
+        );
+
+    CScriptCacheStats lastBlock, total;
+    GetScriptCacheStats(lastBlock, total);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("lastblock", ScriptCacheStatsToJSON(lastBlock));
+    ret.pushKV("total", ScriptCacheStatsToJSON(total));
+    ret.pushKV("warmedtxs", total.nWarmedTxs);
+    return ret;
+}
+
 static UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1658,6 +1738,8 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"} },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        {"txid"} },
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         {} },
+    { "blockchain",         "getvalidationqueueinfo", &getvalidationqueueinfo, {} },
+    { "blockchain",         "getscriptcacheinfo",     &getscriptcacheinfo,     {} },
     { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"} },
     { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
@@ -8,6 +8,7 @@
 #include <governance/governance.h>
 #include <governance/governance-vote.h>
 #include <governance/governance-classes.h>
+#include <governance/governance-intake.h>
 #include <governance/governance-validators.h>
 #include <init.h>
 #include <core_io.h>
@@ -933,7 +934,15 @@ UniValue getgovernanceinfo(const JSONRPCRequest& request)
                                                                                                                                                                          "  \"lastsuperblock\": xxxxx,                (numeric) the block number of the last superblock\n"
                                                                                                                                                                          "  \"nextsuperblock\": xxxxx,                (numeric) the block number of the next superblock\n"
                                                                                                                                                                          "  \"maxgovobjdatasize\": xxxxx,             (numeric) maximum governance object data size in bytes\n"
-                                                                                                                                                                         "}\n"
+                    "  \"objectqueue\": {                         (json object) received objects waiting for validation, timings are in getperfstats \"governance.object.\"\n"
+                    "    \"running\": true|false,                 (boolean) whether objects are validated off the message thread\n"
+                    "    \"queued\": xxxxx,                       (numeric) objects queued, being validated or waiting to be committed\n"
+                    "    \"queuedmax\": xxxxx,                    (numeric) highest number of objects queued at once\n"
+                    "    \"validating\": xxxxx,                   (numeric) objects being validated right now\n"
+                    "    \"committed\": xxxxx,                    (numeric) objects validated and committed\n"
+                    "    \"dropped\": xxxxx                       (numeric) objects asked for again later because the queue was full\n"
+                    "  }\n"
+                    "}\n"
                                                                                                                                                                          "\nExamples:\n"
                     + HelpExampleCli("getgovernanceinfo", "")
                     + HelpExampleRpc("getgovernanceinfo", "")
@@ -975,6 +984,16 @@ UniValue getgovernanceinfo(const JSONRPCRequest& request)
     obj.push_back(Pair("nextsuperblock", nNextSuperblock));
     obj.push_back(Pair("maxgovobjdatasize", MAX_GOVERNANCE_OBJECT_DATA_SIZE));
 
+    CGovernanceIntake::Stats stats = governanceintake.GetStats();
+    UniValue objQueue(UniValue::VOBJ);
+    objQueue.push_back(Pair("running", governanceintake.IsRunning()));
+    objQueue.push_back(Pair("queued", (uint64_t)stats.nQueued));
+    objQueue.push_back(Pair("queuedmax", (uint64_t)stats.nQueuedMax));
+    objQueue.push_back(Pair("validating", (uint64_t)stats.nValidating));
+    objQueue.push_back(Pair("committed", stats.nCommitted));
+    objQueue.push_back(Pair("dropped", stats.nDropped));
+    obj.push_back(Pair("objectqueue", objQueue));
+
     return obj;
 }
 
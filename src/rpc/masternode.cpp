@@ -265,6 +265,12 @@ UniValue mnsync(const JSONRPCRequest& request)
         objStatus.push_back(Pair("IsWinnersListSynced", masternodeSync.IsWinnersListSynced()));
         objStatus.push_back(Pair("IsSynced", masternodeSync.IsSynced()));
         objStatus.push_back(Pair("IsFailed", masternodeSync.IsFailed()));
+
+        UniValue objProgress(UniValue::VOBJ);
+        for (const auto& pair : masternodeSync.GetProgress()) {
+            objProgress.push_back(Pair(CMasternodeSync::GetAssetName(pair.first), pair.second.ToJSON()));
+        }
+        objStatus.push_back(Pair("Progress", objProgress));
         return objStatus;
     }
 
@@ -44,6 +44,12 @@ static UniValue merchantsync(const JSONRPCRequest& request)
         objStatus.push_back(Pair("IsMasternodeListSynced", merchantnodeSync.IsMerchantnodeListSynced()));
         objStatus.push_back(Pair("IsSynced", merchantnodeSync.IsSynced()));
         objStatus.push_back(Pair("IsFailed", merchantnodeSync.IsFailed()));
+
+        UniValue objProgress(UniValue::VOBJ);
+        for (const auto& pair : merchantnodeSync.GetProgress()) {
+            objProgress.push_back(Pair(CMerchantnodeSync::GetAssetName(pair.first), pair.second.ToJSON()));
+        }
+        objStatus.push_back(Pair("Progress", objProgress));
         return objStatus;
     }
 
@@ -749,7 +749,7 @@ static UniValue submitblock(const JSONRPCRequest& request)
     }
 
     submitblock_StateCatcher sc(block.GetHash());
-    RegisterValidationInterface(&sc);
+    RegisterValidationInterface(&sc, "submitblock");
     bool fAccepted = ProcessNewBlock(Params(), blockptr, true, nullptr);
     UnregisterValidationInterface(&sc);
     if (fBlockPresent) {
@@ -944,6 +944,8 @@ static UniValue setgenerate(const JSONRPCRequest& request)
                 "\nArguments:\n"
                 "1. generate         (boolean, required) Set to true to turn on generation, false to turn off.\n"
                 "2. genproclimit     (numeric, optional) Set the processor limit for when generation is on. Can be -1 for unlimited.\n"
+                "3. tpos             (string, optional) \"true\" to stake for merchant contracts, \"false\" to stop.\n"
+                "4. tposcontractid   (string, optional) The contract to stake for, \"all\" for every contract paying this merchant node.\n"
                 "\nExamples:\n"
                 "\nSet the generation on with a limit of one processor\n"
                 + HelpExampleCli("setgenerate", "true 1") +
@@ -978,6 +980,11 @@ static UniValue setgenerate(const JSONRPCRequest& request)
                 return std::string("Minting stopped");
             }
             else if (params.size() > 3 && params[2].get_str() == "true") {
+                if(params[3].get_str() == "all") {
+                    SetTPoSMinningParams(true, uint256());
+                    return std::string("Minting started, all tpos contracts");
+                }
+
                 uint256 tposTxId = ParseHashV(params[3], "parameter 4");
 
                 if(tposTxId.IsNull())
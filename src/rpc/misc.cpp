@@ -13,6 +13,7 @@
 #include <httpserver.h>
 #include <net.h>
 #include <netbase.h>
+#include <perfstats.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
@@ -269,6 +270,18 @@ static UniValue setmocktime(const JSONRPCRequest& request)
     return NullUniValue;
 }
 
+static UniValue RPCBlockIndexMemoryInfo()
+{
+    size_t nEntries, nArenaBytes, nMapBytes;
+    GetBlockIndexMemoryUsage(nEntries, nArenaBytes, nMapBytes);
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(nEntries));
+    obj.pushKV("entrysize", uint64_t(sizeof(CBlockIndex)));
+    obj.pushKV("entries_usage", uint64_t(nArenaBytes));
+    obj.pushKV("map_usage", uint64_t(nMapBytes));
+    return obj;
+}
+
 static UniValue RPCLockedMemoryInfo()
 {
     LockedPool::Stats stats = LockedPoolManager::Instance().stats();
@@ -323,6 +336,12 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"blockindex\": {           (json object) Information about the in-memory block index\n"
+            "    \"entries\": xxxxx,       (numeric) Number of block index entries\n"
+            "    \"entrysize\": xxxxx,     (numeric) Bytes per entry\n"
+            "    \"entries_usage\": xxxxx, (numeric) Bytes taken by the entries\n"
+            "    \"map_usage\": xxxxx,     (numeric) Bytes taken by the hash map referring to them\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -336,6 +355,7 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("blockindex", RPCBlockIndexMemoryInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -348,6 +368,54 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     }
 }
 
+static UniValue getperfstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 2)
+        throw std::runtime_error(
+            "getperfstats ( \"prefix\" reset )\n"
+            "\nReturns the time spent in instrumented code paths since startup or the last reset.\n"
+            "Durations are in microseconds, quantiles are upper bounds taken from a power of two histogram.\n"
+            "\nArguments:\n"
+            "1. \"prefix\"    (string, optional) Only return counters whose name starts with prefix, e.g. \"connectblock.\" or \"net.msg.\"\n"
+            "2. reset         (boolean, optional, default=false) Clear all counters after reading them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"name\": {            (json object) Counter name\n"
+            "    \"count\": xxxxx,    (numeric) Number of samples\n"
+            "    \"total\": xxxxx,    (numeric) Sum of all samples\n"
+            "    \"average\": xxxxx,  (numeric) Average sample\n"
+            "    \"max\": xxxxx,      (numeric) Longest sample\n"
+            "    \"p50\": xxxxx,      (numeric) Median\n"
+            "    \"p90\": xxxxx,      (numeric) 90th percentile\n"
+            "    \"p99\": xxxxx       (numeric) 99th percentile\n"
+            "  }, ...\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getperfstats", "")
+            + HelpExampleCli("getperfstats", "\"connectblock.\" true")
+            + HelpExampleRpc("getperfstats", "\"net.msg.\"")
+        );
+
+    std::string prefix = request.params[0].isNull() ? "" : request.params[0].get_str();
+    bool fReset = request.params[1].isNull() ? false : request.params[1].get_bool();
+
+    UniValue ret(UniValue::VOBJ);
+    for (const CPerfStats& stats : GetPerfStats(prefix)) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", stats.nCount);
+        obj.pushKV("total", stats.nTotalMicros);
+        obj.pushKV("average", stats.nCount ? stats.nTotalMicros / (int64_t)stats.nCount : 0);
+        obj.pushKV("max", stats.nMaxMicros);
+        obj.pushKV("p50", stats.Quantile(0.5));
+        obj.pushKV("p90", stats.Quantile(0.9));
+        obj.pushKV("p99", stats.Quantile(0.99));
+        ret.pushKV(stats.name, obj);
+    }
+    if (fReset)
+        ResetPerfStats();
+    return ret;
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -475,7 +543,17 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
             "  \"enoughcoins\": true|false,        (boolean) if available coins are greater than reserve balance\n"
             "  \"mnsync\": true|false,             (boolean) if masternode data is synced\n"
             "  \"staking status\": true|false,     (boolean) if the wallet is staking or not\n"
-            "  \"staking tpos txid\" ,             (string)  if the wallet is tposing or not\n"
+            "  \"staking tpos txid\" ,             (string)  if the wallet is tposing or not, \"all\" for every contract\n"
+            "  \"tpos contracts\": [               (array)   the merchant contracts staked for\n"
+            "    {\n"
+            "      \"txid\": \"hash\",               (string)  the contract txid\n"
+            "      \"coins\": n,                     (numeric) coins staking for the contract\n"
+            "      \"amount\": x.xxx,                (numeric) their value\n"
+            "      \"searches\": n,                  (numeric) kernel searches including the contract\n"
+            "      \"kernels\": n,                   (numeric) kernels found for the contract\n"
+            "      \"lastkernel\": ttt               (numeric) time of the last kernel found\n"
+            "    }, ...\n"
+            "  ]\n"
             "}\n"
             "\nExamples:\n" +
             HelpExampleCli("getstakingstatus", "") + HelpExampleRpc("getstakingstatus", ""));
@@ -511,7 +589,7 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
         auto helper = [&txId, &tposStatus] {
             TPoSContract contract;
             std::string strError;
-            if(!TPoSUtils::CheckContract(txId, contract, chainActive.Tip()->nHeight, true, true, strError))
+            if(!txId.IsNull() && !TPoSUtils::CheckContract(txId, contract, chainActive.Tip()->nHeight, true, true, strError))
             {
                 tposStatus = strError;
                 return false;
@@ -537,7 +615,7 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
             CTxDestination merchantAddress;
             ExtractDestination(contract.scriptMerchantAddress, merchantAddress);
 
-            if(merchantAddress != merchantnodePayee)
+            if(!txId.IsNull() && merchantAddress != merchantnodePayee)
             {
                 tposStatus = "Merchantnode is not configured for contract: " + txId.ToString();
             }
@@ -548,7 +626,22 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
         isTPoS = helper();
     }
 
-    obj.push_back(Pair("staking tpos txid", isTPoS ? txId.ToString() : tposStatus));
+    obj.push_back(Pair("staking tpos txid", isTPoS ? (txId.IsNull() ? "all" : txId.ToString()) : tposStatus));
+
+    if (pwalletMain) {
+        UniValue contracts(UniValue::VARR);
+        for (const auto &entry : pwalletMain->GetTPoSStakeStats()) {
+            UniValue contract(UniValue::VOBJ);
+            contract.push_back(Pair("txid", entry.first.ToString()));
+            contract.push_back(Pair("coins", entry.second.nCoins));
+            contract.push_back(Pair("amount", ValueFromAmount(entry.second.nStakeAmount)));
+            contract.push_back(Pair("searches", entry.second.nSearches));
+            contract.push_back(Pair("kernels", entry.second.nKernelsFound));
+            contract.push_back(Pair("lastkernel", entry.second.nLastKernelTime));
+            contracts.push_back(contract);
+        }
+        obj.push_back(Pair("tpos contracts", contracts));
+    }
 
     return obj;
 }
@@ -558,6 +651,7 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
+    { "control",            "getperfstats",           &getperfstats,           {"prefix", "reset"} },
     { "util",               "validateaddress",        &validateaddress,        {"address"} }, /* uses wallet if enabled */
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys"} },
     { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"} },
@@ -14,6 +14,8 @@
 #include <cuckoocache.h>
 #include <boost/thread.hpp>
 
+#include <atomic>
+
 namespace {
 /**
  * Valid signature cache, to avoid doing expensive ECDSA signature checking
@@ -66,6 +68,9 @@ public:
  * signatureCache could be made local to VerifySignature.
 */
 static CSignatureCache signatureCache;
+
+static std::atomic<uint64_t> nSignatureCacheHits(0);
+static std::atomic<uint64_t> nSignatureCacheMisses(0);
 } // namespace
 
 // To be called once in AppInitMain/BasicTestingSetup to initialize the
@@ -84,11 +89,22 @@ bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsig
 {
     uint256 entry;
     signatureCache.ComputeEntry(entry, sighash, vchSig, pubkey);
-    if (signatureCache.Get(entry, !store))
+    if (signatureCache.Get(entry, !store)) {
+        if (countStats)
+            nSignatureCacheHits.fetch_add(1, std::memory_order_relaxed);
         return true;
+    }
+    if (countStats)
+        nSignatureCacheMisses.fetch_add(1, std::memory_order_relaxed);
     if (!TransactionSignatureChecker::VerifySignature(vchSig, pubkey, sighash))
         return false;
     if (store)
         signatureCache.Set(entry);
     return true;
 }
+
+void GetSignatureCacheStats(uint64_t& nHits, uint64_t& nMisses)
+{
+    nHits = nSignatureCacheHits.load(std::memory_order_relaxed);
+    nMisses = nSignatureCacheMisses.load(std::memory_order_relaxed);
+}
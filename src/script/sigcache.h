@@ -44,13 +44,18 @@ class CachingTransactionSignatureChecker : public TransactionSignatureChecker
 {
 private:
     bool store;
+    //! Whether lookups count towards GetSignatureCacheStats, which block connection reports per block
+    bool countStats;
 
 public:
-    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, PrecomputedTransactionData& txdataIn) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn), store(storeIn) {}
+    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, PrecomputedTransactionData& txdataIn, bool countStatsIn = true) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn), store(storeIn), countStats(countStatsIn) {}
 
     bool VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& vchPubKey, const uint256& sighash) const override;
 };
 
 void InitSignatureCache();
 
+/** Number of signature cache lookups that hit and missed since startup */
+void GetSignatureCacheStats(uint64_t& nHits, uint64_t& nMisses);
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
@@ -32,7 +32,9 @@
 #define WINDOW_A 5
 /** larger numbers may result in slightly better performance, at the cost of
     exponentially larger precomputed tables. */
-#ifdef USE_ENDOMORPHISM
+#ifdef ECMULT_WINDOW_SIZE
+#define WINDOW_G ECMULT_WINDOW_SIZE
+#elif defined(USE_ENDOMORPHISM)
 /** Two tables for window size 15: 1.375 MiB. */
 #define WINDOW_G 15
 #else
@@ -41,6 +43,10 @@
 #endif
 #endif
 
+#if WINDOW_G < 2 || WINDOW_G > 24
+#  error Set ECMULT_WINDOW_SIZE to an integer in range [2..24]
+#endif
+
 /** The number of entries a table with precomputed multiples needs to have. */
 #define ECMULT_TABLE_SIZE(w) (1 << ((w)-2))
 
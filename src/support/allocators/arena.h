@@ -0,0 +1,91 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Bump-pointer arena. Memory is handed out from large chunks and is only
+ * released when the arena itself is destroyed; deallocation is a no-op.
+ * Allocation is not thread-safe: an arena is meant to be filled by one thread,
+ * e.g. while loading the block index or deserializing a single block.
+ */
+class MonotonicArena
+{
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+    explicit MonotonicArena(size_t chunkSizeIn = DEFAULT_CHUNK_SIZE) : chunkSize(chunkSizeIn), ptr(nullptr), available(0), allocated(0) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t size)
+    {
+        static const size_t ALIGN = alignof(std::max_align_t);
+        size = (size + ALIGN - 1) & ~(ALIGN - 1);
+        if (size > available) {
+            size_t nChunk = std::max(size, chunkSize);
+            // new[] returns memory suitably aligned for any fundamental type
+            chunks.emplace_back(new char[nChunk]);
+            ptr = chunks.back().get();
+            available = nChunk;
+        }
+        void* p = ptr;
+        ptr += size;
+        available -= size;
+        allocated += size;
+        return p;
+    }
+
+    /** Number of bytes handed out so far */
+    size_t AllocatedBytes() const { return allocated; }
+
+private:
+    const size_t chunkSize;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* ptr;
+    size_t available;
+    size_t allocated;
+};
+
+/**
+ * Allocator drawing from a shared MonotonicArena. Every copy of the allocator keeps
+ * the arena alive, so objects created with std::allocate_shared keep their
+ * arena alive until the last of them is destroyed.
+ */
+template <typename T>
+struct arena_allocator {
+    typedef T value_type;
+
+    std::shared_ptr<MonotonicArena> arena;
+
+    explicit arena_allocator(std::shared_ptr<MonotonicArena> arenaIn) noexcept : arena(std::move(arenaIn)) {}
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : arena(other.arena) {}
+
+    template <typename U>
+    struct rebind {
+        typedef arena_allocator<U> other;
+    };
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(arena->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {}
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a.arena != b.arena; }
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
@@ -0,0 +1,161 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <syncprogress.h>
+
+#include <net_processing_xsn.h>
+#include <protocol.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <algorithm>
+
+UniValue CSyncAssetProgress::ToJSON() const
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("PeersAsked", nPeersAsked));
+    obj.push_back(Pair("PeersAnswered", nPeersAnswered));
+    obj.push_back(Pair("ItemsAnnounced", nItemsAnnounced));
+    obj.push_back(Pair("ItemsRequested", nItemsRequested));
+    obj.push_back(Pair("ItemsReceived", nItemsReceived));
+    obj.push_back(Pair("ItemsLost", nItemsLost));
+    int64_t nTimeEnd = nTimeCompleted ? nTimeCompleted : GetTime();
+    obj.push_back(Pair("Seconds", nTimeEnd - nTimeStarted));
+    obj.push_back(Pair("Completed", nTimeCompleted != 0));
+    return obj;
+}
+
+void CSyncProgressTracker::Start(int nAsset)
+{
+    LOCK(cs);
+    int64_t nNow = GetTime();
+    auto it = mapProgress.find(nTrackedAsset);
+    if (it != mapProgress.end() && it->second.nTimeCompleted == 0)
+        it->second.nTimeCompleted = nNow;
+
+    nTrackedAsset = nAsset;
+    if (nTrackedAsset != 0) {
+        mapProgress[nTrackedAsset] = CSyncAssetProgress();
+        mapProgress[nTrackedAsset].nTimeStarted = nNow;
+    }
+    setPeersAsked.clear();
+    setPeersAnswered.clear();
+    mapPendingItems.clear();
+}
+
+void CSyncProgressTracker::Clear()
+{
+    LOCK(cs);
+    nTrackedAsset = 0;
+    mapProgress.clear();
+    setPeersAsked.clear();
+    setPeersAnswered.clear();
+    mapPendingItems.clear();
+}
+
+void CSyncProgressTracker::RequestedAsset(NodeId nodeId)
+{
+    LOCK(cs);
+    if (nTrackedAsset == 0)
+        return;
+    if (setPeersAsked.insert(nodeId).second)
+        mapProgress[nTrackedAsset].nPeersAsked++;
+}
+
+void CSyncProgressTracker::RequestedItem(const CInv& inv)
+{
+    int nAsset = fnItemAsset(inv.type);
+    if (nAsset == 0)
+        return;
+
+    LOCK(cs);
+    if (nAsset != nTrackedAsset || mapPendingItems.size() >= SYNC_MAX_PENDING_ITEMS)
+        return;
+    if (mapPendingItems.emplace(inv.hash, std::make_pair(inv.type, GetTime())).second)
+        mapProgress[nAsset].nItemsRequested++;
+}
+
+void CSyncProgressTracker::Answered(NodeId nodeId, int nAsset, int nCount, bool fAnswer)
+{
+    LOCK(cs);
+    if (nAsset == 0 || nAsset != nTrackedAsset || !setPeersAsked.count(nodeId))
+        return;
+    CSyncAssetProgress& progress = mapProgress[nAsset];
+    progress.nItemsAnnounced += std::max(0, nCount);
+    if (fAnswer && setPeersAnswered.insert(nodeId).second)
+        progress.nPeersAnswered++;
+}
+
+bool CSyncProgressTracker::Update(const std::vector<NodeId>& vConnected)
+{
+    std::vector<std::pair<uint256, std::pair<int, int64_t> > > vPending;
+    {
+        LOCK(cs);
+        if (nTrackedAsset == 0)
+            return false;
+        vPending.assign(mapPendingItems.begin(), mapPendingItems.end());
+    }
+
+    // Items are looked up the way the inventory is, without holding cs
+    int64_t nNow = GetTime();
+    std::vector<uint256> vReceived;
+    std::vector<uint256> vLost;
+    {
+        LOCK(cs_main);
+        for (const auto& item : vPending) {
+            if (net_processing_xsn::AlreadyHave(CInv(item.second.first, item.first))) {
+                vReceived.push_back(item.first);
+            } else if (nNow - item.second.second > SYNC_ITEM_TIMEOUT_SECONDS) {
+                vLost.push_back(item.first);
+            }
+        }
+    }
+
+    LOCK(cs);
+    if (nTrackedAsset == 0)
+        return false;
+    CSyncAssetProgress& progress = mapProgress[nTrackedAsset];
+    for (const uint256& hash : vReceived) {
+        if (mapPendingItems.erase(hash))
+            progress.nItemsReceived++;
+    }
+    for (const uint256& hash : vLost) {
+        if (mapPendingItems.erase(hash))
+            progress.nItemsLost++;
+    }
+
+    // Peers which can still answer, or did
+    int nCandidates = setPeersAnswered.size();
+    for (NodeId nodeId : vConnected) {
+        if (setPeersAsked.count(nodeId) && !setPeersAnswered.count(nodeId))
+            nCandidates++;
+    }
+    if (setPeersAnswered.empty() || (int)setPeersAnswered.size() < std::min(SYNC_ENOUGH_ANSWERS, nCandidates))
+        return false;
+    return mapPendingItems.empty();
+}
+
+std::map<int, CSyncAssetProgress> CSyncProgressTracker::GetProgress() const
+{
+    LOCK(cs);
+    return mapProgress;
+}
+
+bool CSyncProgressTracker::ReachedPeersHeight(const std::vector<CNode*>& vNodes)
+{
+    // Only outbound peers we picked ourselves, after their version message
+    int nPeersHeight = -1;
+    for (const CNode* pnode : vNodes) {
+        if (pnode->fInbound || !pnode->fSuccessfullyConnected)
+            continue;
+        nPeersHeight = std::max(nPeersHeight, (int)pnode->nStartingHeight);
+    }
+    if (nPeersHeight < 0)
+        return false;
+
+    LOCK(cs_main);
+    if (IsInitialBlockDownload() || !pindexBestHeader || chainActive.Height() < pindexBestHeader->nHeight)
+        return false;
+    return chainActive.Height() >= nPeersHeight;
+}
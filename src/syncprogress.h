@@ -0,0 +1,98 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SYNCPROGRESS_H
+#define BITCOIN_SYNCPROGRESS_H
+
+#include <net.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <univalue.h>
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/** An asset is complete once this many of the peers asked (or all of them, if fewer) answered and their data arrived */
+static const int SYNC_ENOUGH_ANSWERS = 3;
+/** A requested item not received after this long no longer holds up the asset */
+static const int SYNC_ITEM_TIMEOUT_SECONDS = 10;
+/** Items tracked per asset, the rest is left to the sync timeout */
+static const size_t SYNC_MAX_PENDING_ITEMS = 100000;
+
+/** Progress of one sync asset, from the peers' sync status count answers and the items requested from them */
+struct CSyncAssetProgress
+{
+    int nPeersAsked = 0;
+    int nPeersAnswered = 0;
+    /** Items the peers answered they sent us inventory for */
+    int nItemsAnnounced = 0;
+    /** Items we did not have and asked for */
+    int nItemsRequested = 0;
+    int nItemsReceived = 0;
+    /** Items which did not arrive in time or were rejected */
+    int nItemsLost = 0;
+    int64_t nTimeStarted = 0;
+    int64_t nTimeCompleted = 0;
+
+    UniValue ToJSON() const;
+};
+
+/**
+ * Tells when an asset of the masternode or merchantnode sync is complete.
+ * Peers answer a sync request with a status count message after pushing the
+ * inventory, so once enough of them answered and every item we asked them for
+ * arrived (or timed out) there is nothing left to wait for. Asset ids are the
+ * ones of the owning sync, 0 (the initial stage of both) means none.
+ */
+class CSyncProgressTracker
+{
+public:
+    /** Maps an inventory type to the asset it belongs to, 0 if none */
+    typedef int (*item_asset_fn_t)(int nInvType);
+
+    explicit CSyncProgressTracker(item_asset_fn_t fnItemAssetIn) : fnItemAsset(fnItemAssetIn) {}
+
+    /** Track a new asset, the progress of the previous one is kept */
+    void Start(int nAsset);
+    /** Forget the progress of all assets */
+    void Clear();
+
+    /** The current asset was requested from a peer */
+    void RequestedAsset(NodeId nodeId);
+    /** We are going to ask a peer for an inventory item */
+    void RequestedItem(const CInv& inv);
+    /** A peer we asked answered with the number of items it announced, fAnswer is false for follow-up counts */
+    void Answered(NodeId nodeId, int nAsset, int nCount, bool fAnswer = true);
+
+    /**
+     * Drop the pending items which arrived or timed out and tell whether the
+     * tracked asset is complete, given the peers still connected.
+     */
+    bool Update(const std::vector<NodeId>& vConnected);
+
+    std::map<int, CSyncAssetProgress> GetProgress() const;
+
+    /**
+     * Whether our chain caught up with the heights the connected peers
+     * announced, so the blockchain wait of a sync can end without a timeout.
+     */
+    static bool ReachedPeersHeight(const std::vector<CNode*>& vNodes);
+
+private:
+    const item_asset_fn_t fnItemAsset;
+
+    mutable CCriticalSection cs;
+    int nTrackedAsset = 0;
+    std::map<int, CSyncAssetProgress> mapProgress;
+    std::set<NodeId> setPeersAsked;
+    std::set<NodeId> setPeersAnswered;
+    // Requested items of the tracked asset, with their inventory type and the time they were requested
+    std::map<uint256, std::pair<int, int64_t> > mapPendingItems;
+};
+
+#endif // BITCOIN_SYNCPROGRESS_H
@@ -0,0 +1,104 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/regression.h>
+#include <test/test_xsn.h>
+
+#include <univalue.h>
+
+#include <cstdlib>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(bench_regression_tests, BasicTestingSetup)
+
+static UniValue MakeResults(const std::string& strName, const std::vector<double>& samples)
+{
+    UniValue system(UniValue::VOBJ);
+    system.pushKV("cpu", "test");
+    UniValue results(UniValue::VARR);
+    for (double sample : samples)
+        results.push_back(sample);
+    UniValue bench(UniValue::VOBJ);
+    bench.pushKV("name", strName);
+    bench.pushKV("results", results);
+    UniValue benchmarks(UniValue::VARR);
+    benchmarks.push_back(bench);
+    UniValue doc(UniValue::VOBJ);
+    doc.pushKV("system", system);
+    doc.pushKV("benchmarks", benchmarks);
+    return doc;
+}
+
+static std::vector<double> Samples(double start, double step, int count)
+{
+    std::vector<double> ret;
+    for (int i = 0; i < count; i++)
+        ret.push_back(start + i * step);
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(mann_whitney_exact)
+{
+    // Without ties the exact distribution of U is used. For three samples
+    // each U takes 0..9 in 1, 1, 2, 3, 3, 3, 3, 2, 1, 1 of the 20 orderings.
+    BOOST_CHECK_CLOSE(benchmark::MannWhitneySlowerPValue({1, 2, 3}, {4, 5, 6}), 1.0 / 20, 1e-9);
+    BOOST_CHECK_CLOSE(benchmark::MannWhitneySlowerPValue({1, 3, 5}, {2, 4, 6}), 7.0 / 20, 1e-9);
+    BOOST_CHECK_CLOSE(benchmark::MannWhitneySlowerPValue({4, 5, 6}, {1, 2, 3}), 1.0, 1e-9);
+
+    // n * m == 400 is still exact: only one of the C(40, 20) orderings is as slow
+    BOOST_CHECK_CLOSE(benchmark::MannWhitneySlowerPValue(Samples(1, 0.01, 20), Samples(2, 0.01, 20)), 1.0 / 137846528820.0, 1e-6);
+
+    BOOST_CHECK_EQUAL(benchmark::MannWhitneySlowerPValue({}, {1, 2}), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(mann_whitney_ties)
+{
+    // Ties fall back to the normal approximation with continuity and tie
+    // correction: U = 14, mean 8, variance 16 / 12 * (9 - 72 / 56)
+    BOOST_CHECK_CLOSE(benchmark::MannWhitneySlowerPValue({1, 1, 2, 2}, {2, 2, 3, 3}), 0.04317936982350622, 1e-6);
+
+    // all samples equal, nothing is slower
+    BOOST_CHECK_EQUAL(benchmark::MannWhitneySlowerPValue({1, 1, 1}, {1, 1, 1}), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(compare_to_baseline)
+{
+    const UniValue baseline = MakeResults("Bench", Samples(1, 0.01, 20));
+
+    // twice as slow in every sample is a regression
+    std::ostringstream out;
+    BOOST_CHECK_EQUAL(benchmark::CompareToBaseline(baseline, MakeResults("Bench", Samples(2, 0.01, 20)), 0.05, 0.05, out), 1);
+    BOOST_CHECK(out.str().find("Bench, 1.095, 2.095, +91.32%, 0.0000, REGRESSION") != std::string::npos);
+
+    // the same samples are not
+    out.str("");
+    BOOST_CHECK_EQUAL(benchmark::CompareToBaseline(baseline, baseline, 0.05, 0.05, out), 0);
+    BOOST_CHECK(out.str().find("Bench, 1.095, 1.095, +0.00%") != std::string::npos);
+    BOOST_CHECK(out.str().find(", ok") != std::string::npos);
+
+    // and neither are benchmarks the baseline doesn't know
+    out.str("");
+    BOOST_CHECK_EQUAL(benchmark::CompareToBaseline(baseline, MakeResults("Other", Samples(2, 0.01, 20)), 0.05, 0.05, out), 0);
+    BOOST_CHECK(out.str().find("Other, -, 2.095, -, -, new") != std::string::npos);
+
+    // nor is a slowdown below the threshold
+    out.str("");
+    BOOST_CHECK_EQUAL(benchmark::CompareToBaseline(baseline, MakeResults("Bench", Samples(1.03, 0.01, 20)), 0.05, 0.05, out), 0);
+}
+
+BOOST_AUTO_TEST_CASE(check_baseline_exit_code)
+{
+    const UniValue baseline = MakeResults("Bench", Samples(1, 0.01, 20));
+    std::ostringstream out;
+    BOOST_CHECK_EQUAL(benchmark::CheckBaseline(baseline, MakeResults("Bench", Samples(2, 0.01, 20)), 0.05, 0.05, out), benchmark::EXIT_REGRESSION);
+    BOOST_CHECK(out.str().find("1 benchmark(s) regressed by more than 5% against the baseline") != std::string::npos);
+    BOOST_CHECK(benchmark::EXIT_REGRESSION != EXIT_SUCCESS && benchmark::EXIT_REGRESSION != EXIT_FAILURE);
+
+    out.str("");
+    BOOST_CHECK_EQUAL(benchmark::CheckBaseline(baseline, baseline, 0.05, 0.05, out), EXIT_SUCCESS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
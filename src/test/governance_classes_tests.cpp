@@ -0,0 +1,139 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/governance.h>
+#include <governance/governance-classes.h>
+#include <key.h>
+#include <key_io.h>
+#include <test/test_xsn.h>
+#include <utilstrencodings.h>
+#include <utiltime.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct CGovernanceTest
+{
+    static uint256 AddTrigger(int nBlockHeight, const std::string& strAddresses, const std::string& strAmounts)
+    {
+        AssertLockHeld(governance.cs);
+        static int64_t nTime = GetTime();
+        const std::string strData = strprintf("[[\"trigger\",{\"event_block_height\":%d,\"payment_addresses\":\"%s\",\"payment_amounts\":\"%s\",\"type\":%d}]]",
+                                              nBlockHeight, strAddresses, strAmounts, GOVERNANCE_OBJECT_TRIGGER);
+        CGovernanceObject govobj(uint256(), 1, nTime++, uint256(), HexStr(strData));
+        const uint256 nHash = govobj.GetHash();
+        governance.mapObjects.insert(std::make_pair(nHash, govobj));
+        triggerman.AddNewTrigger(nHash);
+        return nHash;
+    }
+
+    static void RemoveObject(const uint256& nHash) { governance.mapObjects.erase(nHash); }
+    static void SetCachedBlockHeight(int nHeight) { governance.nCachedBlockHeight = nHeight; }
+    static void CleanAndRemove() { triggerman.CleanAndRemove(); }
+
+    static CSuperblock_sptr GetTrigger(const uint256& nHash)
+    {
+        auto it = triggerman.mapTrigger.find(nHash);
+        return it == triggerman.mapTrigger.end() ? CSuperblock_sptr() : it->second;
+    }
+
+    static size_t CountTriggers() { return triggerman.mapTrigger.size(); }
+    static size_t CountIndexedTriggers() { return triggerman.mapTriggerByHeight.size(); }
+
+    static std::vector<CSuperblock_sptr> GetActiveTriggers(int nBlockHeight)
+    {
+        std::vector<CSuperblock_sptr> vecTriggers = triggerman.GetActiveTriggers(nBlockHeight);
+        std::sort(vecTriggers.begin(), vecTriggers.end());
+        return vecTriggers;
+    }
+
+    // the scan over all triggers the height index replaced
+    static std::vector<CSuperblock_sptr> ScanActiveTriggers(int nBlockHeight)
+    {
+        std::vector<CSuperblock_sptr> vecTriggers;
+        for (const CSuperblock_sptr& pSuperblock : triggerman.GetActiveTriggers()) {
+            if (pSuperblock->GetBlockStart() == nBlockHeight) {
+                vecTriggers.push_back(pSuperblock);
+            }
+        }
+        std::sort(vecTriggers.begin(), vecTriggers.end());
+        return vecTriggers;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(governance_classes_tests, TestingSetup)
+
+static std::string NewAddress()
+{
+    CKey key;
+    key.MakeNewKey(true);
+    return EncodeDestination(key.GetPubKey().GetID());
+}
+
+static void CheckActiveTriggers(int nBlockHeight, size_t nExpected)
+{
+    std::vector<CSuperblock_sptr> vecTriggers = CGovernanceTest::GetActiveTriggers(nBlockHeight);
+    BOOST_CHECK_EQUAL(vecTriggers.size(), nExpected);
+    BOOST_CHECK(vecTriggers == CGovernanceTest::ScanActiveTriggers(nBlockHeight));
+}
+
+BOOST_AUTO_TEST_CASE(trigger_index)
+{
+    LOCK(governance.cs);
+    const int nCachedBlockHeight = governance.GetCachedBlockHeight();
+    const int nHeight = 1000;
+    const std::string strAddress1 = NewAddress();
+    const std::string strAddress2 = NewAddress();
+
+    const uint256 nHash1 = CGovernanceTest::AddTrigger(nHeight, strAddress1 + "|" + strAddress2, "1.5|2");
+    const uint256 nHash2 = CGovernanceTest::AddTrigger(nHeight, strAddress1, "10");
+    const uint256 nHash3 = CGovernanceTest::AddTrigger(nHeight * 2, strAddress2, "0.25");
+    // a trigger with a broken payment schedule is neither kept nor indexed
+    CGovernanceTest::AddTrigger(nHeight, strAddress1, "1|2");
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountTriggers(), 3U);
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountIndexedTriggers(), 3U);
+
+    CheckActiveTriggers(nHeight - 1, 0);
+    CheckActiveTriggers(nHeight, 2);
+    CheckActiveTriggers(nHeight * 2, 1);
+
+    // totals are kept when the schedule is parsed and match the payments
+    for (const uint256& nHash : {nHash1, nHash2, nHash3}) {
+        CSuperblock_sptr pSuperblock = CGovernanceTest::GetTrigger(nHash);
+        BOOST_REQUIRE(pSuperblock);
+        CAmount nTotal = 0;
+        for (const CGovernancePayment& payment : pSuperblock->GetPayments()) {
+            nTotal += payment.nAmount;
+        }
+        BOOST_CHECK_EQUAL(pSuperblock->GetPaymentsTotalAmount(), nTotal);
+    }
+    BOOST_CHECK_EQUAL(CGovernanceTest::GetTrigger(nHash1)->GetPaymentsTotalAmount(), 350000000);
+    BOOST_CHECK_EQUAL(CGovernanceTest::GetTrigger(nHash2)->GetPaymentsTotalAmount(), 10 * COIN);
+    BOOST_CHECK_EQUAL(CGovernanceTest::GetTrigger(nHash3)->GetPaymentsTotalAmount(), COIN / 4);
+
+    // a trigger whose object is gone is not active anymore
+    CGovernanceTest::RemoveObject(nHash2);
+    CheckActiveTriggers(nHeight, 1);
+
+    // expired triggers are removed from the index as well
+    CGovernanceTest::SetCachedBlockHeight(nHeight + GOVERNANCE_TRIGGER_EXPIRATION_BLOCKS + 1);
+    CGovernanceTest::CleanAndRemove();
+    BOOST_CHECK(!CGovernanceTest::GetTrigger(nHash1));
+    BOOST_CHECK(!CGovernanceTest::GetTrigger(nHash2));
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountTriggers(), 1U);
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountIndexedTriggers(), 1U);
+    CheckActiveTriggers(nHeight, 0);
+    CheckActiveTriggers(nHeight * 2, 1);
+
+    // and so are invalid ones
+    CGovernanceTest::GetTrigger(nHash3)->SetStatus(SEEN_OBJECT_ERROR_INVALID);
+    CGovernanceTest::CleanAndRemove();
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountTriggers(), 0U);
+    BOOST_CHECK_EQUAL(CGovernanceTest::CountIndexedTriggers(), 0U);
+    CheckActiveTriggers(nHeight * 2, 0);
+
+    CGovernanceTest::SetCachedBlockHeight(nCachedBlockHeight);
+    governance.Clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/governance.h>
+#include <governance/governance-intake.h>
+#include <net.h>
+#include <test/test_xsn.h>
+#include <utiltime.h>
+
+#include <mutex>
+
+#include <boost/test/unit_test.hpp>
+
+/** Intake whose workers take the longer the earlier an object arrived */
+class CGovernanceIntakeOrderTest : public CGovernanceIntake
+{
+public:
+    CGovernanceIntakeOrderTest(int64_t nFirstTimeIn, int nObjectsIn) : nFirstTime(nFirstTimeIn), nObjects(nObjectsIn) {}
+    ~CGovernanceIntakeOrderTest() { Stop(); }
+
+    std::mutex mutexOrder;
+    std::vector<uint256> vValidated;
+    std::vector<uint256> vCommitted;
+
+protected:
+    void Validate(CGovernanceObject& govobj, CGovernanceObjectPrecheck& precheck) override
+    {
+        MilliSleep((nObjects - (govobj.GetCreationTime() - nFirstTime)) * 20);
+        std::lock_guard<std::mutex> lock(mutexOrder);
+        vValidated.push_back(govobj.GetHash());
+    }
+
+    void Commit(CNode* pfrom, CGovernanceObject& govobj, bool fRateCheckBypassed, const CGovernanceObjectPrecheck& precheck) override
+    {
+        std::lock_guard<std::mutex> lock(mutexOrder);
+        vCommitted.push_back(govobj.GetHash());
+    }
+
+private:
+    const int64_t nFirstTime;
+    const int nObjects;
+};
+
+BOOST_FIXTURE_TEST_SUITE(governance_intake_tests, TestingSetup)
+
+static bool WaitForCommitted(const CGovernanceIntake& intake, uint64_t nCommitted)
+{
+    for (int i = 0; i < 1000; i++) {
+        if (intake.GetStats().nCommitted >= nCommitted)
+            return true;
+        MilliSleep(10);
+    }
+    return false;
+}
+
+BOOST_AUTO_TEST_CASE(intake_commits_and_releases)
+{
+    CConnman connman(0x1337, 0x1337);
+    CAddress addr(CService(CNetAddr(), 0), NODE_NONE);
+    CNode node(0, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+
+    CGovernanceIntake intake;
+    CGovernanceObject govobjFirst(uint256(), 1, GetTime(), uint256(), "");
+    BOOST_CHECK(!intake.IsRunning());
+    BOOST_CHECK(!intake.Push(&node, govobjFirst, false));
+
+    intake.Start(4, &connman);
+    BOOST_CHECK(intake.IsRunning());
+
+    // objects of an unknown type are rejected when committed
+    const int nObjects = 100;
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < nObjects; i++) {
+        CGovernanceObject govobj(uint256(), 1, GetTime() + i, uint256(), "");
+        vHashes.push_back(govobj.GetHash());
+        BOOST_CHECK(intake.Push(&node, govobj, false));
+    }
+    BOOST_CHECK(WaitForCommitted(intake, nObjects));
+
+    CGovernanceIntake::Stats stats = intake.GetStats();
+    BOOST_CHECK_EQUAL(stats.nQueued, 0U);
+    BOOST_CHECK_EQUAL(stats.nValidating, 0U);
+    BOOST_CHECK(stats.nQueuedMax >= 1 && stats.nQueuedMax <= (size_t)nObjects);
+    BOOST_CHECK_EQUAL(stats.nDropped, 0U);
+    for (const uint256& nHash : vHashes) {
+        BOOST_CHECK(!intake.IsQueued(nHash));
+        BOOST_CHECK(!governance.HaveObjectForHash(nHash));
+    }
+    // every queued object held a reference to the node until it was committed
+    BOOST_CHECK_EQUAL(node.GetRefCount(), 0);
+
+    intake.Stop();
+    BOOST_CHECK(!intake.IsRunning());
+    BOOST_CHECK(!intake.Push(&node, govobjFirst, false));
+}
+
+BOOST_AUTO_TEST_CASE(intake_commits_in_arrival_order)
+{
+    CConnman connman(0x1337, 0x1337);
+    CAddress addr(CService(CNetAddr(), 0), NODE_NONE);
+    CNode node(0, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+
+    const int64_t nFirstTime = GetTime();
+    const int nObjects = 8;
+    CGovernanceIntakeOrderTest intake(nFirstTime, nObjects);
+    intake.Start(4, &connman);
+
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < nObjects; i++) {
+        CGovernanceObject govobj(uint256(), 1, nFirstTime + i, uint256(), "");
+        vHashes.push_back(govobj.GetHash());
+        BOOST_CHECK(intake.Push(&node, govobj, false));
+    }
+    BOOST_CHECK(WaitForCommitted(intake, nObjects));
+
+    // the workers finished out of order, the objects were committed as they arrived
+    std::lock_guard<std::mutex> lock(intake.mutexOrder);
+    BOOST_CHECK_EQUAL(intake.vValidated.size(), (size_t)nObjects);
+    BOOST_CHECK(intake.vValidated != vHashes);
+    BOOST_CHECK(intake.vCommitted == vHashes);
+    BOOST_CHECK_EQUAL(node.GetRefCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <kernel.h>
+#include <key.h>
+#include <script/interpreter.h>
+#include <test/test_xsn.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(kernel_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(kernel_input_on_fork)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    const COutPoint staked(m_coinbase_txns[0]->GetHash(), 0);
+    const COutPoint other(m_coinbase_txns[1]->GetHash(), 0);
+
+    CMutableTransaction spend;
+    spend.nVersion = 1;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = staked;
+    spend.vout.resize(1);
+    spend.vout[0].nValue = 11 * CENT;
+    spend.vout[0].scriptPubKey = scriptPubKey;
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptPubKey, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    spend.vin[0].scriptSig << vchSig;
+    const COutPoint created(spend.GetHash(), 0);
+
+    // The fork spends the staked output in its first block
+    CBlock forkBlock = CreateAndProcessBlock({spend}, scriptPubKey);
+    CBlockIndex* pindexFork;
+    {
+        LOCK(cs_main);
+        pindexFork = chainActive.Tip();
+        BOOST_REQUIRE(pindexFork->GetBlockHash() == forkBlock.GetHash());
+        CValidationState state;
+        BOOST_CHECK(InvalidateBlock(state, Params(), pindexFork));
+    }
+    CValidationState state;
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+    mempool.clear();
+
+    // and loses against a longer active chain where the output is still unspent
+    CreateAndProcessBlock({}, scriptPubKey);
+    CreateAndProcessBlock({}, scriptPubKey);
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(ResetBlockFailureFlags(pindexFork));
+    }
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+
+    LOCK(cs_main);
+    BOOST_CHECK(!chainActive.Contains(pindexFork));
+
+    CTxOut txout;
+    const CBlockIndex* pindexFrom = nullptr;
+    bool fMissingInputs = true;
+    BOOST_CHECK(GetKernelInput(chainActive.Tip(), staked, txout, pindexFrom, fMissingInputs, params));
+    BOOST_CHECK(!fMissingInputs);
+    BOOST_CHECK(pindexFrom == chainActive[1]);
+    BOOST_CHECK(txout == m_coinbase_txns[0]->vout[0]);
+
+    // Unspent at our tip, but spent on the fork a stake on top of pindexFork builds on
+    BOOST_CHECK(!GetKernelInput(pindexFork, staked, txout, pindexFrom, fMissingInputs, params));
+    BOOST_CHECK(!fMissingInputs);
+
+    // Outputs untouched by the fork stay usable there
+    BOOST_CHECK(GetKernelInput(pindexFork, other, txout, pindexFrom, fMissingInputs, params));
+    BOOST_CHECK(pindexFrom == chainActive[2]);
+
+    // and so are the outputs the fork created, which our chain doesn't know about
+    BOOST_CHECK(GetKernelInput(pindexFork, created, txout, pindexFrom, fMissingInputs, params));
+    BOOST_CHECK(pindexFrom == pindexFork);
+    BOOST_CHECK(txout == spend.vout[0]);
+    BOOST_CHECK(!GetKernelInput(chainActive.Tip(), created, txout, pindexFrom, fMissingInputs, params));
+}
+
+BOOST_AUTO_TEST_CASE(stake_modifier_snapshot)
+{
+    // a modifier looked up ahead under cs_main gives the kernel hash the block index does
+    const COutPoint prevout(m_coinbase_txns[0]->GetHash(), 0);
+    const CAmount nValue = m_coinbase_txns[0]->vout[0].nValue;
+    const unsigned int nBits = 0x207fffff;
+
+    LOCK(cs_main);
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    const CBlockIndex* pindexFrom = chainActive[1];
+    const unsigned int nTimeTx = pindexFrom->GetBlockTime() + Params().GetConsensus().nStakeMinAge + 60;
+    for (bool fPoSV3 : {true, false}) {
+        CStakeModifier modifier;
+        if (!GetStakeModifier(pindexTip, pindexFrom->GetBlockHash(), fPoSV3, modifier)) {
+            BOOST_CHECK(!fPoSV3);
+            continue;
+        }
+        BOOST_CHECK_EQUAL(modifier.fPoSV3, fPoSV3);
+        if (fPoSV3)
+            BOOST_CHECK(modifier.hashStakeModifierV3 == pindexTip->hashStakeModifierV3);
+
+        uint256 hashIndex, hashSnapshot;
+        bool fIndex = CheckStakeKernelHash(pindexTip, nBits, pindexFrom->GetBlockHash(), pindexFrom->GetBlockTime(), nValue, prevout, nTimeTx, hashIndex, fPoSV3, false);
+        bool fSnapshot = CheckStakeKernelHash(modifier, nBits, pindexFrom->GetBlockTime(), nValue, prevout, nTimeTx, hashSnapshot);
+        BOOST_CHECK_EQUAL(fIndex, fSnapshot);
+        BOOST_CHECK(hashIndex == hashSnapshot);
+        BOOST_CHECK(!hashSnapshot.IsNull());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
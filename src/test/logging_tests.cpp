@@ -0,0 +1,71 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <logging.h>
+#include <test/test_xsn.h>
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(logging_tests, BasicTestingSetup)
+
+static std::string ReadFile(const fs::path& path)
+{
+    std::ifstream file(path.string());
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(logging_async_writer)
+{
+    fs::path path = fs::temp_directory_path() / fs::unique_path();
+    std::string expected;
+    {
+        BCLog::Logger logger;
+        logger.m_print_to_file = true;
+        logger.m_log_timestamps = false;
+        logger.m_file_path = path;
+
+        // Lines logged before the file is open, synchronously and asynchronously all end up in order
+        logger.LogPrintStr("before open\n");
+        BOOST_CHECK(logger.OpenDebugLog());
+        logger.LogPrintStr("sync\n");
+        logger.StartAsyncWriter();
+        for (int i = 0; i < 1000; i++) {
+            logger.LogPrintStr(strprintf("async %d\n", i));
+        }
+        logger.StopAsyncWriter();
+        logger.LogPrintStr("sync again\n");
+
+        expected = "before open\nsync\n";
+        for (int i = 0; i < 1000; i++) {
+            expected += strprintf("async %d\n", i);
+        }
+        expected += "sync again\n";
+    }
+    BOOST_CHECK_EQUAL(ReadFile(path), expected);
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(logging_rate_limit)
+{
+    BCLog::Logger logger;
+    BOOST_CHECK(logger.WithinRateLimit(BCLog::NET));
+
+    logger.m_rate_limit = 3;
+    int nAccepted = 0;
+    for (int i = 0; i < 10; i++) {
+        nAccepted += logger.WithinRateLimit(BCLog::NET);
+    }
+    // All calls may straddle a second boundary at most once
+    BOOST_CHECK(nAccepted >= 3 && nAccepted <= 6);
+
+    // Categories are limited independently
+    BOOST_CHECK(logger.WithinRateLimit(BCLog::MEMPOOL));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
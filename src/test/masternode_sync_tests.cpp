@@ -0,0 +1,112 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternode-sync.h>
+#include <masternodeman.h>
+#include <net.h>
+#include <protocol.h>
+#include <random.h>
+#include <streams.h>
+#include <test/test_xsn.h>
+#include <utiltime.h>
+#include <version.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct MasternodeSyncSetup : public TestingSetup
+{
+    MasternodeSyncSetup() :
+        connman(0x1337, 0x1337),
+        node1(1, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", /*fInboundIn=*/ false),
+        node2(2, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", /*fInboundIn=*/ false)
+    {
+        masternodeSync.Reset();
+        // past the blockchain sync, to the masternode list
+        masternodeSync.SwitchToNextAsset(connman);
+        masternodeSync.SwitchToNextAsset(connman);
+    }
+
+    ~MasternodeSyncSetup()
+    {
+        SetMockTime(0);
+        mnodeman.Clear();
+        masternodeSync.Reset();
+    }
+
+    void Answer(CNode& node, int nItemID, int nCount)
+    {
+        CDataStream vRecv(SER_NETWORK, PROTOCOL_VERSION);
+        vRecv << nItemID << nCount;
+        masternodeSync.ProcessMessage(&node, NetMsgType::SYNCSTATUSCOUNT, vRecv);
+    }
+
+    CConnman connman;
+    CNode node1;
+    CNode node2;
+};
+
+BOOST_FIXTURE_TEST_SUITE(masternode_sync_tests, MasternodeSyncSetup)
+
+BOOST_AUTO_TEST_CASE(asset_completes_on_answers_and_data)
+{
+    BOOST_CHECK_EQUAL(masternodeSync.GetAssetID(), MASTERNODE_SYNC_LIST);
+    const std::vector<NodeId> vConnected{node1.GetId(), node2.GetId()};
+
+    masternodeSync.RequestedAsset(node1.GetId());
+    masternodeSync.RequestedAsset(node2.GetId());
+    const uint256 hashPing = GetRandHash();
+    masternodeSync.RequestedItem(CInv(MSG_MASTERNODE_PING, hashPing));
+    // items of other assets and transactions are not tracked
+    masternodeSync.RequestedItem(CInv(MSG_MASTERNODE_PAYMENT_VOTE, GetRandHash()));
+    masternodeSync.RequestedItem(CInv(MSG_TX, GetRandHash()));
+    BOOST_CHECK(!masternodeSync.UpdateAssetProgress(vConnected));
+
+    // one answer of two is not enough while the other peer is still connected
+    Answer(node1, MASTERNODE_SYNC_LIST, 1);
+    // answers for other assets do not count
+    Answer(node2, MASTERNODE_SYNC_MNW, 5);
+    BOOST_CHECK(!masternodeSync.UpdateAssetProgress(vConnected));
+    Answer(node2, MASTERNODE_SYNC_LIST, 0);
+    // both answered, the ping they announced is still on its way
+    BOOST_CHECK(!masternodeSync.UpdateAssetProgress(vConnected));
+
+    mnodeman.mapSeenMasternodePing.emplace(hashPing, CMasternodePing());
+    BOOST_CHECK(masternodeSync.UpdateAssetProgress(vConnected));
+
+    const CSyncAssetProgress progress = masternodeSync.GetProgress().at(MASTERNODE_SYNC_LIST);
+    BOOST_CHECK_EQUAL(progress.nPeersAsked, 2);
+    BOOST_CHECK_EQUAL(progress.nPeersAnswered, 2);
+    BOOST_CHECK_EQUAL(progress.nItemsAnnounced, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsRequested, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsReceived, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsLost, 0);
+}
+
+BOOST_AUTO_TEST_CASE(asset_completes_without_lost_items_and_peers)
+{
+    masternodeSync.SwitchToNextAsset(connman);
+    BOOST_CHECK_EQUAL(masternodeSync.GetAssetID(), MASTERNODE_SYNC_MNW);
+
+    int64_t nTime = GetTime();
+    SetMockTime(nTime);
+    masternodeSync.RequestedAsset(node1.GetId());
+    masternodeSync.RequestedAsset(node2.GetId());
+    masternodeSync.RequestedItem(CInv(MSG_MASTERNODE_PAYMENT_VOTE, GetRandHash()));
+    Answer(node1, MASTERNODE_SYNC_MNW, 1);
+
+    // the peer which did not answer disconnected, the vote it announced never arrives
+    const std::vector<NodeId> vConnected{node1.GetId()};
+    BOOST_CHECK(!masternodeSync.UpdateAssetProgress(vConnected));
+    SetMockTime(nTime + SYNC_ITEM_TIMEOUT_SECONDS + 1);
+    BOOST_CHECK(masternodeSync.UpdateAssetProgress(vConnected));
+
+    const CSyncAssetProgress progress = masternodeSync.GetProgress().at(MASTERNODE_SYNC_MNW);
+    BOOST_CHECK_EQUAL(progress.nPeersAnswered, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsLost, 1);
+
+    // the list progress was kept and marked complete
+    BOOST_CHECK(masternodeSync.GetProgress().at(MASTERNODE_SYNC_LIST).nTimeCompleted != 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <masternode-sync.h>
+#include <masternodeman.h>
+#include <net.h>
+#include <netbase.h>
+#include <random.h>
+#include <test/test_xsn.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct MasternodeListSetup : public TestingSetup
+{
+    MasternodeListSetup() : connman(0x1337, 0x1337)
+    {
+        masternodeSync.Reset();
+        while (!masternodeSync.IsMasternodeListSynced()) {
+            masternodeSync.SwitchToNextAsset(connman);
+        }
+    }
+
+    ~MasternodeListSetup()
+    {
+        mnodeman.Clear();
+        masternodeSync.Reset();
+    }
+
+    CConnman connman;
+};
+
+BOOST_FIXTURE_TEST_SUITE(masternodeman_tests, MasternodeListSetup)
+
+static COutPoint AddMasternode(const std::string& strAddr, int nProtocolVersion = PROTOCOL_VERSION)
+{
+    COutPoint outpoint(GetRandHash(), 0);
+    CMasternode mn(LookupNumeric(strAddr.c_str(), Params().GetDefaultPort()), outpoint, CPubKey(), CPubKey(), nProtocolVersion);
+    BOOST_CHECK(mnodeman.Add(mn));
+    return outpoint;
+}
+
+BOOST_AUTO_TEST_CASE(rank_snapshot)
+{
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 50; i++) {
+        vOutpoints.push_back(AddMasternode(strprintf("10.0.0.%d", i % 10)));
+    }
+    const COutPoint outpointOld = AddMasternode("10.0.1.1", MIN_PEER_PROTO_VERSION - 1);
+
+    // ranks are the order of the scores against the block, highest first
+    const uint256 hashBlock = chainActive[0]->GetBlockHash();
+    std::vector<std::pair<arith_uint256, COutPoint> > vScores;
+    for (const COutPoint& outpoint : vOutpoints) {
+        CMasternode mn;
+        BOOST_CHECK(mnodeman.Get(outpoint, mn));
+        vScores.emplace_back(mn.CalculateScore(hashBlock), outpoint);
+    }
+    std::sort(vScores.rbegin(), vScores.rend());
+
+    CMasternodeMan::rank_pair_vec_t vecRanks;
+    BOOST_CHECK(mnodeman.GetMasternodeRanks(vecRanks, 0, MIN_PEER_PROTO_VERSION));
+    BOOST_CHECK_EQUAL(vecRanks.size(), vScores.size());
+    for (size_t i = 0; i < vScores.size(); i++) {
+        int nRank;
+        BOOST_CHECK(mnodeman.GetMasternodeRank(vScores[i].second, nRank, 0, MIN_PEER_PROTO_VERSION));
+        BOOST_CHECK_EQUAL(nRank, (int)i + 1);
+        BOOST_CHECK_EQUAL(vecRanks[i].first, (int)i + 1);
+        BOOST_CHECK(vecRanks[i].second.vin.prevout == vScores[i].second);
+    }
+
+    // too old to be ranked with the protocol filter, ranked without it
+    int nRank;
+    BOOST_CHECK(!mnodeman.GetMasternodeRank(outpointOld, nRank, 0, MIN_PEER_PROTO_VERSION));
+    BOOST_CHECK_EQUAL(nRank, -1);
+    BOOST_CHECK(mnodeman.GetMasternodeRank(outpointOld, nRank, 0, 0));
+
+    // a masternode added after the ranks were computed is ranked too
+    const COutPoint outpointNew = AddMasternode("10.0.2.1");
+    BOOST_CHECK(mnodeman.GetMasternodeRanks(vecRanks, 0, MIN_PEER_PROTO_VERSION));
+    BOOST_CHECK_EQUAL(vecRanks.size(), vScores.size() + 1);
+    BOOST_CHECK(mnodeman.GetMasternodeRank(outpointNew, nRank, 0, MIN_PEER_PROTO_VERSION));
+
+    // no ranks against a block we do not know
+    BOOST_CHECK(!mnodeman.GetMasternodeRank(outpointNew, nRank, chainActive.Height() + 1, MIN_PEER_PROTO_VERSION));
+}
+
+static CBlock BlockSpending(const std::vector<COutPoint>& vSpent, int nOutputs)
+{
+    CMutableTransaction tx;
+    for (const COutPoint& outpoint : vSpent) {
+        tx.vin.emplace_back(outpoint);
+    }
+    tx.vout.resize(nOutputs);
+    for (CTxOut& txout : tx.vout) {
+        txout.nValue = 1000 * COIN;
+    }
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(block_connected_spends_collateral)
+{
+    const COutPoint outpointSpent = AddMasternode("10.0.3.1");
+    const COutPoint outpointKept = AddMasternode("10.0.3.2");
+
+    const int nTipHeight = mnodeman.GetTipHeight();
+    CBlockIndex index;
+    index.nHeight = nTipHeight + 1;
+    const CBlock block = BlockSpending({outpointSpent}, 1);
+    mnodeman.BlockConnected(block, &index);
+    BOOST_CHECK_EQUAL(mnodeman.GetTipHeight(), nTipHeight + 1);
+
+    // the spent collateral is known to be spent without any UTXO lookup
+    CMasternode mn;
+    BOOST_CHECK(mnodeman.Get(outpointSpent, mn));
+    BOOST_CHECK(mn.IsOutpointSpent());
+    BOOST_CHECK(mn.IsCollateralChecked());
+    BOOST_CHECK(mnodeman.Get(outpointKept, mn));
+    BOOST_CHECK(!mn.IsOutpointSpent());
+    BOOST_CHECK(!mn.IsCollateralChecked());
+
+    // undoing the block does not revive the spent masternode
+    mnodeman.BlockDisconnected(block);
+    BOOST_CHECK_EQUAL(mnodeman.GetTipHeight(), nTipHeight);
+    BOOST_CHECK(mnodeman.Get(outpointSpent, mn));
+    BOOST_CHECK(mn.IsOutpointSpent());
+}
+
+BOOST_AUTO_TEST_CASE(block_disconnected_unchecks_collateral)
+{
+    // a masternode whose collateral is created by the block
+    const CBlock block = BlockSpending({}, 2);
+    const COutPoint outpoint(block.vtx[0]->GetHash(), 1);
+    CMasternode mnNew(LookupNumeric("10.0.4.1", Params().GetDefaultPort()), outpoint, CPubKey(), CPubKey(), PROTOCOL_VERSION);
+    BOOST_CHECK(mnodeman.Add(mnNew));
+
+    const int nTipHeight = mnodeman.GetTipHeight();
+    CBlockIndex index;
+    index.nHeight = nTipHeight + 1;
+    mnodeman.BlockConnected(block, &index);
+    CMasternode mn;
+    BOOST_CHECK(mnodeman.Get(outpoint, mn));
+    BOOST_CHECK(!mn.IsOutpointSpent());
+
+    // looked up once by the manager, not in the UTXO set as the block is not in the chain
+    mnodeman.Check();
+    BOOST_CHECK(mnodeman.Get(outpoint, mn));
+    BOOST_CHECK(mn.IsCollateralChecked());
+    BOOST_CHECK(mn.IsOutpointSpent());
+
+    // disconnecting the block asks for another lookup
+    mnodeman.BlockDisconnected(block);
+    BOOST_CHECK_EQUAL(mnodeman.GetTipHeight(), nTipHeight);
+    BOOST_CHECK(mnodeman.Get(outpoint, mn));
+    BOOST_CHECK(!mn.IsCollateralChecked());
+
+    mnodeman.Check();
+    BOOST_CHECK(mnodeman.Get(outpoint, mn));
+    BOOST_CHECK(mn.IsCollateralChecked());
+    BOOST_CHECK(mn.IsOutpointSpent());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
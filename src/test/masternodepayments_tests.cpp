@@ -0,0 +1,114 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <masternode-payments.h>
+#include <test/test_xsn.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(masternodepayments_tests, BasicTestingSetup)
+
+static const CAmount MINT = 10 * COIN;
+
+/** Block at pindex's height paying nValue to payee from its coinbase (PoW) or coinstake (PoS) */
+static CBlock BlockPaying(const CBlockIndex* pindex, const CScript& payee, CAmount nValue)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+
+    CBlock block;
+    block.nTime = pindex->nTime;
+    if (pindex->nHeight > Params().GetConsensus().nLastPoWBlock) {
+        coinbase.vout[0].SetEmpty();
+        CMutableTransaction coinstake;
+        coinstake.vin.resize(1);
+        coinstake.vout.resize(1);
+        coinstake.vout[0].SetEmpty();
+        coinstake.vout.emplace_back(nValue, payee);
+        block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+        block.vtx.push_back(MakeTransactionRef(std::move(coinstake)));
+    } else {
+        coinbase.vout.emplace_back(nValue, payee);
+        block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    }
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(payee_index)
+{
+    std::vector<uint256> vHashes(100);
+    std::vector<CBlockIndex> vBlocks(100);
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        vHashes[i] = ArithToUint256(i + 1);
+        vBlocks[i].nHeight = i;
+        vBlocks[i].nTime = 1000 + i;
+        vBlocks[i].nMint = MINT;
+        vBlocks[i].phashBlock = &vHashes[i];
+        vBlocks[i].pprev = i ? &vBlocks[i - 1] : nullptr;
+        vBlocks[i].BuildSkip();
+    }
+    const CBlockIndex* pindexTip = &vBlocks.back();
+
+    const CScript payeeA = CScript() << OP_1;
+    const CScript payeeB = CScript() << OP_2;
+    const CAmount nPayment = GetMasternodePayment(0, MINT);
+
+    CMasternodePayeeIndex index;
+    std::vector<CBlock> vConnected;
+    for (const CBlockIndex& block : vBlocks) {
+        CBlock blockPaying;
+        if (block.nHeight == 50 || block.nHeight == 80 || block.nHeight == 90) {
+            blockPaying = BlockPaying(&block, payeeA, nPayment);
+        } else if (block.nHeight == 85) {
+            blockPaying = BlockPaying(&block, payeeB, nPayment);
+        } else if (block.nHeight == 95) {
+            // not the masternode reward, not a masternode payment
+            blockPaying = BlockPaying(&block, payeeB, nPayment + 1);
+        } else {
+            blockPaying = BlockPaying(&block, CScript() << OP_3, 0);
+        }
+        index.BlockConnected(blockPaying, &block, 1000);
+        vConnected.push_back(blockPaying);
+    }
+    BOOST_CHECK_EQUAL(index.size(), 100U);
+
+    // PoW coinbase and PoS coinstake payments are both found, latest first
+    BOOST_CHECK(index.GetPaidHeights(payeeA, pindexTip, 0) == std::vector<int>({90, 80, 50}));
+    BOOST_CHECK(index.GetPaidHeights(payeeA, pindexTip, 81) == std::vector<int>({90}));
+    BOOST_CHECK(index.GetPaidHeights(payeeA, &vBlocks[89], 0) == std::vector<int>({80, 50}));
+    BOOST_CHECK(index.GetPaidHeights(payeeB, pindexTip, 0) == std::vector<int>({85}));
+
+    // a block of another chain at the same height does not count
+    CBlockIndex blockFork = vBlocks[90];
+    CBlock blockForkPaying = BlockPaying(&blockFork, payeeB, nPayment);
+    uint256 hashFork = blockForkPaying.GetHash();
+    blockFork.phashBlock = &hashFork;
+    index.BlockConnected(blockForkPaying, &blockFork, 1000);
+    BOOST_CHECK(index.GetPaidHeights(payeeA, pindexTip, 0) == std::vector<int>({80, 50}));
+    BOOST_CHECK(index.GetPaidHeights(payeeB, pindexTip, 0) == std::vector<int>({85}));
+    BOOST_CHECK(index.GetPaidHeights(payeeB, &blockFork, 0) == std::vector<int>({90, 85}));
+
+    // disconnecting removes the entry
+    index.BlockDisconnected(blockForkPaying);
+    BOOST_CHECK(index.GetPaidHeights(payeeB, &blockFork, 0) == std::vector<int>({85}));
+    BOOST_CHECK_EQUAL(index.size(), 99U);
+
+    // blocks more than nKeep below a new tip are forgotten
+    index.BlockConnected(vConnected[99], pindexTip, 15);
+    BOOST_CHECK_EQUAL(index.size(), 14U);
+    BOOST_CHECK(index.GetPaidHeights(payeeA, pindexTip, 0).empty());
+    BOOST_CHECK(index.GetPaidHeights(payeeB, pindexTip, 0) == std::vector<int>({85}));
+
+    index.Clear();
+    BOOST_CHECK_EQUAL(index.size(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
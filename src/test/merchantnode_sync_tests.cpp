@@ -0,0 +1,55 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net.h>
+#include <protocol.h>
+#include <random.h>
+#include <streams.h>
+#include <test/test_xsn.h>
+#include <tpos/merchantnode-sync.h>
+#include <tpos/merchantnodeman.h>
+#include <version.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(merchantnode_sync_tests, TestingSetup)
+
+// The progress tracking itself is covered by syncprogress_tests
+BOOST_AUTO_TEST_CASE(list_completes_on_answers_and_data)
+{
+    CConnman connman(0x1337, 0x1337);
+    CNode node(1, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", /*fInboundIn=*/ false);
+    merchantnodeSync.Reset();
+    // past the blockchain sync, to the merchantnode list
+    merchantnodeSync.SwitchToNextAsset(connman);
+    merchantnodeSync.SwitchToNextAsset(connman);
+    BOOST_CHECK_EQUAL(merchantnodeSync.GetAssetID(), MERCHANTNODE_SYNC_LIST);
+
+    merchantnodeSync.RequestedAsset(node.GetId());
+    const uint256 hashPing = GetRandHash();
+    merchantnodeSync.RequestedItem(CInv(MSG_MERCHANTNODE_PING, hashPing));
+    // masternode items belong to the masternode sync
+    merchantnodeSync.RequestedItem(CInv(MSG_MASTERNODE_PING, GetRandHash()));
+
+    CDataStream vRecv(SER_NETWORK, PROTOCOL_VERSION);
+    vRecv << (int)MERCHANTNODE_SYNC_LIST << 1;
+    merchantnodeSync.ProcessMessage(&node, NetMsgType::MERCHANTSYNCSTATUSCOUNT, vRecv);
+    BOOST_CHECK(!merchantnodeSync.UpdateAssetProgress({node.GetId()}));
+    merchantnodeman.mapSeenMerchantnodePing.emplace(hashPing, CMerchantnodePing());
+    BOOST_CHECK(merchantnodeSync.UpdateAssetProgress({node.GetId()}));
+
+    const CSyncAssetProgress progress = merchantnodeSync.GetProgress().at(MERCHANTNODE_SYNC_LIST);
+    BOOST_CHECK_EQUAL(progress.nPeersAnswered, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsRequested, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsReceived, 1);
+
+    merchantnodeSync.SwitchToNextAsset(connman);
+    BOOST_CHECK(merchantnodeSync.IsSynced());
+
+    merchantnodeman.Clear();
+    merchantnodeSync.Reset();
+    BOOST_CHECK(merchantnodeSync.GetProgress().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <perfstats.h>
+#include <test/test_xsn.h>
+
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(perfstats_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(perfcounter_histogram)
+{
+    CPerfCounter counter("test");
+    counter.Add(0);
+    counter.Add(1);
+    counter.Add(3);
+    counter.Add(100);
+    counter.Add(1000);
+
+    CPerfStats stats = counter.Get();
+    BOOST_CHECK_EQUAL(stats.nCount, 5U);
+    BOOST_CHECK_EQUAL(stats.nTotalMicros, 1104);
+    BOOST_CHECK_EQUAL(stats.nMaxMicros, 1000);
+    BOOST_CHECK_EQUAL(stats.vBuckets[0], 1U);  // 0
+    BOOST_CHECK_EQUAL(stats.vBuckets[1], 1U);  // 1
+    BOOST_CHECK_EQUAL(stats.vBuckets[2], 1U);  // 2..3
+    BOOST_CHECK_EQUAL(stats.vBuckets[7], 1U);  // 64..127
+    BOOST_CHECK_EQUAL(stats.vBuckets[10], 1U); // 512..1023
+
+    BOOST_CHECK_EQUAL(stats.Quantile(0.5), 4);
+    BOOST_CHECK_EQUAL(stats.Quantile(0.99), 1000);
+
+    counter.Reset();
+    BOOST_CHECK_EQUAL(counter.Get().nCount, 0U);
+    BOOST_CHECK_EQUAL(counter.Get().Quantile(0.5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(perfcounter_threads)
+{
+    CPerfCounter counter("test");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < 1000; ++j)
+                counter.Add(j);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    CPerfStats stats = counter.Get();
+    BOOST_CHECK_EQUAL(stats.nCount, 4000U);
+    BOOST_CHECK_EQUAL(stats.nTotalMicros, 4 * 999 * 1000 / 2);
+    BOOST_CHECK_EQUAL(stats.nMaxMicros, 999);
+}
+
+BOOST_AUTO_TEST_CASE(perfstats_registry)
+{
+    CPerfCounter& a = GetPerfCounter("perfstats_tests.a");
+    BOOST_CHECK_EQUAL(&a, &GetPerfCounter("perfstats_tests.a"));
+    GetPerfCounter("perfstats_tests.b").Add(5);
+    {
+        PERF_SCOPE("perfstats_tests.c");
+    }
+
+    std::vector<CPerfStats> stats = GetPerfStats("perfstats_tests.");
+    BOOST_REQUIRE_EQUAL(stats.size(), 3U);
+    BOOST_CHECK_EQUAL(stats[0].name, "perfstats_tests.a");
+    BOOST_CHECK_EQUAL(stats[1].nCount, 1U);
+    BOOST_CHECK_EQUAL(stats[2].nCount, 1U);
+
+    std::string text = FormatPerfStatsPrometheus(stats);
+    BOOST_CHECK(text.find("xsn_perf_seconds_count{name=\"perfstats_tests.b\"} 1\n") != std::string::npos);
+    BOOST_CHECK(text.find("xsn_perf_seconds_bucket{name=\"perfstats_tests.b\",le=\"+Inf\"} 1\n") != std::string::npos);
+    BOOST_CHECK(text.find("xsn_perf_seconds_sum{name=\"perfstats_tests.b\"} 0.000005\n") != std::string::npos);
+
+    ResetPerfStats();
+    BOOST_CHECK_EQUAL(GetPerfStats("perfstats_tests.b")[0].nCount, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,8 +2,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <clientversion.h>
 #include <policy/policy.h>
 #include <policy/fees.h>
+#include <streams.h>
 #include <txmempool.h>
 #include <uint256.h>
 #include <util.h>
@@ -179,4 +181,269 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimates_persistence)
+{
+    CBlockPolicyEstimator feeEst;
+    CTxMemPool mpool(&feeEst);
+    TestMemPoolEntryHelper entry;
+    CAmount basefee(2000);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    tx.vout[0].nValue=0LL;
+
+    // Mine 100 blocks where higher fee txs are confirmed sooner
+    std::vector<uint256> txHashes[10];
+    std::vector<CTransactionRef> block;
+    int blocknum = 0;
+    while (blocknum < 100) {
+        for (int j = 0; j < 10; j++) {
+            for (int k = 0; k < 4; k++) {
+                tx.vin[0].prevout.n = 10000*blocknum+100*j+k;
+                uint256 hash = tx.GetHash();
+                mpool.addUnchecked(hash, entry.Fee(basefee * (j+1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                txHashes[j].push_back(hash);
+            }
+        }
+        for (int h = 0; h <= blocknum%10; h++) {
+            while (txHashes[9-h].size()) {
+                CTransactionRef ptx = mpool.get(txHashes[9-h].back());
+                if (ptx)
+                    block.push_back(ptx);
+                txHashes[9-h].pop_back();
+            }
+        }
+        mpool.removeForBlock(block, ++blocknum);
+        block.clear();
+    }
+
+    // Repeated queries are answered consistently
+    std::vector<CFeeRate> smartEst;
+    for (int i = 1; i <= 48; i++) {
+        FeeCalculation feeCalc;
+        CFeeRate est = feeEst.estimateSmartFee(i, &feeCalc, false);
+        BOOST_CHECK(est == feeEst.estimateSmartFee(i, nullptr, false));
+        BOOST_CHECK_EQUAL(feeCalc.desiredTarget, i);
+        smartEst.push_back(est);
+    }
+    BOOST_CHECK(smartEst[1] != CFeeRate(0));
+
+    // Estimates survive a write/read round trip unchanged
+    CAutoFile file(tmpfile(), SER_DISK, CLIENT_VERSION);
+    BOOST_CHECK(feeEst.Write(file));
+    rewind(file.Get());
+    CBlockPolicyEstimator feeEst2;
+    BOOST_CHECK(feeEst2.Read(file));
+    for (int i = 1; i <= 48; i++) {
+        BOOST_CHECK(feeEst2.estimateSmartFee(i, nullptr, false) == smartEst[i-1]);
+        BOOST_CHECK(feeEst2.estimateRawFee(i, 0.85, FeeEstimateHorizon::MED_HALFLIFE) == feeEst.estimateRawFee(i, 0.85, FeeEstimateHorizon::MED_HALFLIFE));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimates_lazy_decay)
+{
+    CBlockPolicyEstimator feeEst;
+    CTxMemPool mpool(&feeEst);
+    TestMemPoolEntryHelper entry;
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    tx.vout[0].nValue=0LL;
+
+    // 10 txs of the same feerate per block, each confirmed by the next block.
+    // Decaying every average on every block, the txs confirmed within the
+    // target are then counted as count = count * decay + 10 per block.
+    // The short horizon decays fast enough to fold its pending decay into
+    // the stored averages on the way.
+    const FeeEstimateHorizon horizons[] = {FeeEstimateHorizon::SHORT_HALFLIFE, FeeEstimateHorizon::MED_HALFLIFE, FeeEstimateHorizon::LONG_HALFLIFE};
+    double expected[3] = {0, 0, 0};
+    double decay[3];
+    for (int i = 0; i < 3; i++) {
+        EstimationResult result;
+        feeEst.estimateRawFee(1, 0.95, horizons[i], &result);
+        decay[i] = result.decay;
+        BOOST_CHECK(decay[i] > 0 && decay[i] < 1);
+    }
+
+    std::vector<CTransactionRef> block;
+    int blocknum = 0;
+    while (blocknum < 2000) {
+        for (int k = 0; k < 10; k++) {
+            tx.vin[0].prevout.n = 100*blocknum+k;
+            uint256 hash = tx.GetHash();
+            mpool.addUnchecked(hash, entry.Fee(10000).Time(GetTime()).Height(blocknum).FromTx(tx));
+            block.push_back(mpool.get(hash));
+        }
+        mpool.removeForBlock(block, ++blocknum);
+        block.clear();
+        for (int i = 0; i < 3; i++) {
+            expected[i] = expected[i] * decay[i] + 10;
+        }
+
+        if (blocknum % 250 == 0) {
+            for (int i = 0; i < 3; i++) {
+                EstimationResult result;
+                BOOST_CHECK(feeEst.estimateRawFee(1, 0.95, horizons[i], &result) != CFeeRate(0));
+                BOOST_CHECK_CLOSE(result.pass.withinTarget, expected[i], 1e-6);
+                BOOST_CHECK_CLOSE(result.pass.totalConfirmed, expected[i], 1e-6);
+                BOOST_CHECK_EQUAL(result.pass.inMempool, 0);
+                BOOST_CHECK_EQUAL(result.pass.leftMempool, 0);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimates_legacy_file)
+{
+    CBlockPolicyEstimator feeEst;
+    CTxMemPool mpool(&feeEst);
+    TestMemPoolEntryHelper entry;
+    CAmount basefee(2000);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    tx.vout[0].nValue=0LL;
+
+    // Mine 100 blocks where higher fee txs are confirmed sooner, some left unconfirmed
+    std::vector<uint256> txHashes[10];
+    std::vector<CTransactionRef> block;
+    int blocknum = 0;
+    while (blocknum < 100) {
+        for (int j = 0; j < 10; j++) {
+            for (int k = 0; k < 4; k++) {
+                tx.vin[0].prevout.n = 10000*blocknum+100*j+k;
+                uint256 hash = tx.GetHash();
+                mpool.addUnchecked(hash, entry.Fee(basefee * (j+1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                txHashes[j].push_back(hash);
+            }
+        }
+        for (int h = 0; h <= blocknum%10; h++) {
+            while (txHashes[9-h].size()) {
+                CTransactionRef ptx = mpool.get(txHashes[9-h].back());
+                if (ptx)
+                    block.push_back(ptx);
+                txHashes[9-h].pop_back();
+            }
+        }
+        mpool.removeForBlock(block, ++blocknum);
+        block.clear();
+    }
+
+    // Rewrite the flat file in the format written before it, one vector per average
+    CAutoFile file(tmpfile(), SER_DISK, CLIENT_VERSION);
+    BOOST_CHECK(feeEst.Write(file));
+    rewind(file.Get());
+    int nVersionRequired, nVersionThatWrote;
+    unsigned int nBestSeenHeight, nHistoricalFirst, nHistoricalBest;
+    std::vector<double> buckets;
+    file >> nVersionRequired >> nVersionThatWrote >> nBestSeenHeight >> nHistoricalFirst >> nHistoricalBest >> buckets;
+    BOOST_CHECK(nVersionRequired > 149900 && nVersionRequired <= CLIENT_VERSION);
+
+    CAutoFile legacyFile(tmpfile(), SER_DISK, CLIENT_VERSION);
+    legacyFile << 149900 << CLIENT_VERSION << nBestSeenHeight << nHistoricalFirst << nHistoricalBest << buckets;
+    for (int i = 0; i < 3; i++) {
+        double decay;
+        unsigned int scale;
+        uint32_t nPeriods;
+        std::vector<double> data;
+        file >> decay >> scale >> nPeriods >> data;
+        BOOST_REQUIRE_EQUAL(data.size(), buckets.size() * (2 + 2 * nPeriods));
+
+        auto it = data.begin();
+        std::vector<double> avg(it, it + buckets.size());
+        it += buckets.size();
+        std::vector<double> txCtAvg(it, it + buckets.size());
+        it += buckets.size();
+        std::vector<std::vector<double> > confAvg, failAvg;
+        for (unsigned int j = 0; j < nPeriods; j++, it += buckets.size()) {
+            confAvg.emplace_back(it, it + buckets.size());
+        }
+        for (unsigned int j = 0; j < nPeriods; j++, it += buckets.size()) {
+            failAvg.emplace_back(it, it + buckets.size());
+        }
+        legacyFile << decay << scale << avg << txCtAvg << confAvg << failAvg;
+    }
+
+    // The legacy file gives the same estimates and is written back in the flat format
+    rewind(legacyFile.Get());
+    CBlockPolicyEstimator feeEst2;
+    BOOST_CHECK(feeEst2.Read(legacyFile));
+    for (int i = 1; i <= 48; i++) {
+        BOOST_CHECK(feeEst2.estimateSmartFee(i, nullptr, false) == feeEst.estimateSmartFee(i, nullptr, false));
+        BOOST_CHECK(feeEst2.estimateRawFee(i, 0.85, FeeEstimateHorizon::MED_HALFLIFE) == feeEst.estimateRawFee(i, 0.85, FeeEstimateHorizon::MED_HALFLIFE));
+    }
+
+    CAutoFile file2(tmpfile(), SER_DISK, CLIENT_VERSION);
+    BOOST_CHECK(feeEst2.Write(file2));
+    rewind(file2.Get());
+    int nVersionRequired2;
+    file2 >> nVersionRequired2;
+    BOOST_CHECK_EQUAL(nVersionRequired2, nVersionRequired);
+}
+
+BOOST_AUTO_TEST_CASE(BlockPolicyEstimates_cache_invalidation)
+{
+    // Two estimators see the same blocks, only the first one is queried
+    // before the last blocks, so the second one computes fresh estimates
+    CBlockPolicyEstimator feeEst, feeEstFresh;
+    CTxMemPool mpool(&feeEst), mpoolFresh(&feeEstFresh);
+    TestMemPoolEntryHelper entry;
+    CAmount basefee(2000);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    tx.vout[0].nValue=0LL;
+
+    // Higher fee txs are confirmed sooner for 100 blocks, then the lowest fee
+    // txs are all confirmed by the next block
+    std::vector<uint256> txHashes[10];
+    std::vector<CTransactionRef> block;
+    std::vector<CFeeRate> smartEst;
+    int blocknum = 0;
+    while (blocknum < 150) {
+        if (blocknum == 100) {
+            for (int i = 1; i <= 24; i++) {
+                smartEst.push_back(feeEst.estimateSmartFee(i, nullptr, false));
+            }
+        }
+        for (int j = 0; j < 10; j++) {
+            for (int k = 0; k < 4; k++) {
+                if (blocknum >= 100 && j > 0)
+                    continue;
+                tx.vin[0].prevout.n = 10000*blocknum+100*j+k;
+                uint256 hash = tx.GetHash();
+                mpool.addUnchecked(hash, entry.Fee(basefee * (j+1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                mpoolFresh.addUnchecked(hash, entry.Fee(basefee * (j+1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                txHashes[j].push_back(hash);
+            }
+        }
+        for (int h = 0; h < 10; h++) {
+            if (blocknum < 100 ? h > blocknum%10 : h != 9)
+                continue;
+            while (txHashes[9-h].size()) {
+                CTransactionRef ptx = mpool.get(txHashes[9-h].back());
+                if (ptx)
+                    block.push_back(ptx);
+                txHashes[9-h].pop_back();
+            }
+        }
+        mpool.removeForBlock(block, blocknum + 1);
+        mpoolFresh.removeForBlock(block, blocknum + 1);
+        ++blocknum;
+        block.clear();
+    }
+
+    bool fChanged = false;
+    for (int i = 1; i <= 24; i++) {
+        CFeeRate est = feeEst.estimateSmartFee(i, nullptr, false);
+        BOOST_CHECK(est == feeEstFresh.estimateSmartFee(i, nullptr, false));
+        fChanged |= est != smartEst[i-1];
+    }
+    BOOST_CHECK(fChanged);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include <serialize.h>
 #include <streams.h>
 #include <hash.h>
+#include <primitives/block.h>
 #include <test/test_xsn.h>
 
 #include <stdint.h>
@@ -370,4 +371,46 @@ BOOST_AUTO_TEST_CASE(class_methods)
     BOOST_CHECK(methodtest3 == methodtest4);
 }
 
+BOOST_AUTO_TEST_CASE(block_tx_arena)
+{
+    CBlock block;
+    block.nVersion = 3;
+    block.nTime = 1234;
+    for (int i = 0; i < 50; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(i % 3 + 1);
+        tx.vin[0].prevout.n = i;
+        tx.vin[0].scriptSig = CScript() << i << std::vector<unsigned char>(i, 0x42);
+        tx.vout.resize(i % 2 + 1);
+        tx.vout[0].nValue = i;
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+
+    CBlock arenaBlock;
+    BlockTxArenaReader reader(arenaBlock);
+    ss >> reader;
+    BOOST_CHECK(ss.empty());
+
+    BOOST_CHECK(arenaBlock.GetHash() == block.GetHash());
+    BOOST_CHECK_EQUAL(arenaBlock.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        BOOST_CHECK(arenaBlock.vtx[i]->GetHash() == block.vtx[i]->GetHash());
+    }
+
+    // the arena reads the same bytes back
+    CDataStream ss2(SER_NETWORK, PROTOCOL_VERSION);
+    ss2 << arenaBlock;
+    CDataStream ss3(SER_NETWORK, PROTOCOL_VERSION);
+    ss3 << block;
+    BOOST_CHECK(ss2.str() == ss3.str());
+
+    // transactions outlive the block they were deserialized with
+    CTransactionRef tx = arenaBlock.vtx[10];
+    arenaBlock.SetNull();
+    BOOST_CHECK(tx->GetHash() == block.vtx[10]->GetHash());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
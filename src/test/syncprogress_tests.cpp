@@ -0,0 +1,148 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternodeman.h>
+#include <net.h>
+#include <protocol.h>
+#include <random.h>
+#include <syncprogress.h>
+#include <test/test_xsn.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+static const int ASSET_LIST = 2;
+static const int ASSET_VOTES = 3;
+
+static int ItemAsset(int nInvType)
+{
+    switch (nInvType) {
+    case MSG_MASTERNODE_ANNOUNCE:
+    case MSG_MASTERNODE_PING:
+        return ASSET_LIST;
+    case MSG_MASTERNODE_PAYMENT_VOTE:
+        return ASSET_VOTES;
+    default:
+        return 0;
+    }
+}
+
+struct SyncProgressSetup : public TestChain100Setup
+{
+    ~SyncProgressSetup()
+    {
+        SetMockTime(0);
+        mnodeman.Clear();
+    }
+
+    CSyncProgressTracker tracker{ItemAsset};
+};
+
+BOOST_FIXTURE_TEST_SUITE(syncprogress_tests, SyncProgressSetup)
+
+BOOST_AUTO_TEST_CASE(answer_counting)
+{
+    // nothing is tracked before the first asset starts
+    tracker.RequestedAsset(1);
+    BOOST_CHECK(!tracker.Update({1}));
+    BOOST_CHECK(tracker.GetProgress().empty());
+
+    tracker.Start(ASSET_LIST);
+    for (NodeId nodeId : {1, 2, 3, 4, 1})
+        tracker.RequestedAsset(nodeId);
+    BOOST_CHECK(!tracker.Update({1, 2, 3, 4}));
+
+    // answers of peers we did not ask and for other assets don't count
+    tracker.Answered(5, ASSET_LIST, 7);
+    tracker.Answered(1, ASSET_VOTES, 7);
+    tracker.Answered(1, ASSET_LIST, 2);
+    // a peer answers once, follow-up counts only add to the items
+    tracker.Answered(1, ASSET_LIST, 1, false);
+    tracker.Answered(1, ASSET_LIST, 2);
+    tracker.Answered(2, ASSET_LIST, -1);
+    BOOST_CHECK(!tracker.Update({1, 2, 3, 4}));
+
+    CSyncAssetProgress progress = tracker.GetProgress().at(ASSET_LIST);
+    BOOST_CHECK_EQUAL(progress.nPeersAsked, 4);
+    BOOST_CHECK_EQUAL(progress.nPeersAnswered, 2);
+    BOOST_CHECK_EQUAL(progress.nItemsAnnounced, 5);
+
+    // two answers of the two peers left are enough, of three they are not
+    BOOST_CHECK(tracker.Update({1, 2}));
+    BOOST_CHECK(!tracker.Update({1, 2, 3}));
+    tracker.Answered(3, ASSET_LIST, 0);
+    BOOST_CHECK(tracker.Update({1, 2, 3, 4}));
+
+    // the next asset starts over and completes the previous one
+    tracker.Start(ASSET_VOTES);
+    tracker.Answered(1, ASSET_LIST, 1);
+    BOOST_CHECK(!tracker.Update({1, 2, 3, 4}));
+    std::map<int, CSyncAssetProgress> mapProgress = tracker.GetProgress();
+    BOOST_CHECK(mapProgress.at(ASSET_LIST).nTimeCompleted != 0);
+    BOOST_CHECK_EQUAL(mapProgress.at(ASSET_LIST).nPeersAnswered, 3);
+    BOOST_CHECK_EQUAL(mapProgress.at(ASSET_VOTES).nPeersAsked, 0);
+    BOOST_CHECK_EQUAL(mapProgress.at(ASSET_VOTES).nTimeCompleted, 0);
+
+    tracker.Clear();
+    BOOST_CHECK(tracker.GetProgress().empty());
+}
+
+BOOST_AUTO_TEST_CASE(lost_items)
+{
+    int64_t nTime = GetTime();
+    SetMockTime(nTime);
+    tracker.Start(ASSET_LIST);
+    tracker.RequestedAsset(1);
+
+    const uint256 hashPing = GetRandHash();
+    const uint256 hashAnnounce = GetRandHash();
+    tracker.RequestedItem(CInv(MSG_MASTERNODE_PING, hashPing));
+    tracker.RequestedItem(CInv(MSG_MASTERNODE_PING, hashPing));
+    tracker.RequestedItem(CInv(MSG_MASTERNODE_ANNOUNCE, hashAnnounce));
+    // items of other assets and transactions are not tracked
+    tracker.RequestedItem(CInv(MSG_MASTERNODE_PAYMENT_VOTE, GetRandHash()));
+    tracker.RequestedItem(CInv(MSG_TX, GetRandHash()));
+    tracker.Answered(1, ASSET_LIST, 2);
+    BOOST_CHECK(!tracker.Update({1}));
+
+    // the ping arrives, the broadcast holds the asset up until it times out
+    mnodeman.mapSeenMasternodePing.emplace(hashPing, CMasternodePing());
+    BOOST_CHECK(!tracker.Update({1}));
+    SetMockTime(nTime + SYNC_ITEM_TIMEOUT_SECONDS);
+    BOOST_CHECK(!tracker.Update({1}));
+    SetMockTime(nTime + SYNC_ITEM_TIMEOUT_SECONDS + 1);
+    BOOST_CHECK(tracker.Update({1}));
+
+    const CSyncAssetProgress progress = tracker.GetProgress().at(ASSET_LIST);
+    BOOST_CHECK_EQUAL(progress.nItemsRequested, 2);
+    BOOST_CHECK_EQUAL(progress.nItemsReceived, 1);
+    BOOST_CHECK_EQUAL(progress.nItemsLost, 1);
+}
+
+BOOST_AUTO_TEST_CASE(reached_peers_height)
+{
+    CNode inbound(1, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+    CNode outbound(2, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", /*fInboundIn=*/ false);
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+    inbound.nStartingHeight = 0;
+    inbound.fSuccessfullyConnected = true;
+    outbound.nStartingHeight = nHeight;
+
+    // heights only count from outbound peers which finished the handshake
+    BOOST_CHECK(!CSyncProgressTracker::ReachedPeersHeight({}));
+    BOOST_CHECK(!CSyncProgressTracker::ReachedPeersHeight({&inbound}));
+    BOOST_CHECK(!CSyncProgressTracker::ReachedPeersHeight({&inbound, &outbound}));
+
+    outbound.fSuccessfullyConnected = true;
+    BOOST_CHECK(CSyncProgressTracker::ReachedPeersHeight({&inbound, &outbound}));
+    outbound.nStartingHeight = nHeight + 1;
+    BOOST_CHECK(!CSyncProgressTracker::ReachedPeersHeight({&inbound, &outbound}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -10,9 +10,11 @@
 #include <script/script.h>
 #include <test/test_xsn.h>
 #include <tpos/tposutils.h>
+#include <tpos/tposcontractregistry.h>
 #include <keystore.h>
 #include <messagesigner.h>
 #include <masternode-payments.h>
+#include <txdb.h>
 
 #include <numeric>
 #include <boost/test/unit_test.hpp>
@@ -236,6 +238,101 @@ BOOST_FIXTURE_TEST_CASE(tpos_create_new_contract, TestChain100Setup)
     BOOST_ASSERT(TPoSUtils::CheckContract(MakeTransactionRef(unsignedContract), tmp, Params().GetConsensus().nTPoSSignatureUpgradeHFHeight, true, false, strError));
 }
 
+BOOST_FIXTURE_TEST_CASE(tpos_contract_index, TestChain100Setup)
+{
+    m_coinbase_txns.emplace_back(CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey())).vtx[0]);
+    m_coinbase_txns.emplace_back(CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey())).vtx[0]);
+
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    auto utxos = BuildSimpleUtxoMap(m_coinbase_txns);
+
+    CKey tposAddressKey;
+    tposAddressKey.MakeNewKey(true);
+    CKey merchantAddressKey;
+    merchantAddressKey.MakeNewKey(true);
+
+    auto contractTx = CreateContractTx(tposAddressKey.GetPubKey().GetID(),
+                                       merchantAddressKey.GetPubKey().GetID(), 1, true);
+    FundTransaction(contractTx, utxos, contractTx.vout[1].scriptPubKey);
+    SignContract(contractTx, tposAddressKey, true);
+    SignTransaction(contractTx, coinbaseKey);
+
+    CTransactionRef txIndexed;
+    BOOST_CHECK(!pblocktree->ReadTPoSContractTx(contractTx.GetHash(), txIndexed));
+
+    CreateAndProcessBlock({contractTx}, scriptPubKey);
+
+    // the contract is indexed once its block is connected, so it can be checked without the block files
+    BOOST_CHECK(pblocktree->ReadTPoSContractTx(contractTx.GetHash(), txIndexed));
+    BOOST_CHECK(txIndexed->GetHash() == contractTx.GetHash());
+
+    TPoSContract contract;
+    std::string strError;
+    LOCK(cs_main);
+    BOOST_CHECK(TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, true, strError));
+    BOOST_CHECK(contract.txContract->GetHash() == contractTx.GetHash());
+}
+
+BOOST_FIXTURE_TEST_CASE(tpos_contract_registry, TestChain100Setup)
+{
+    m_coinbase_txns.emplace_back(CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey())).vtx[0]);
+    m_coinbase_txns.emplace_back(CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey())).vtx[0]);
+
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    auto utxos = BuildSimpleUtxoMap(m_coinbase_txns);
+
+    CKey tposAddressKey;
+    tposAddressKey.MakeNewKey(true);
+    CKey merchantAddressKey;
+    merchantAddressKey.MakeNewKey(true);
+
+    auto contractTx = CreateContractTx(tposAddressKey.GetPubKey().GetID(),
+                                       merchantAddressKey.GetPubKey().GetID(), 1, true);
+    FundTransaction(contractTx, utxos, contractTx.vout[1].scriptPubKey);
+    SignContract(contractTx, tposAddressKey, true);
+    SignTransaction(contractTx, coinbaseKey);
+
+    // registered with its collateral when its block is connected
+    TPoSContract contract;
+    BOOST_CHECK(!tposcontracts.Get(contractTx.GetHash(), contract));
+    CreateAndProcessBlock({contractTx}, scriptPubKey);
+    BOOST_CHECK(tposcontracts.Get(contractTx.GetHash(), contract));
+
+    // the signature is checked once
+    std::string strError;
+    bool fValid;
+    const bool fNewSignatures = IsTPoSNewSignaturesHardForkActivated(chainActive.Height());
+    BOOST_CHECK(!tposcontracts.GetSignatureResult(contractTx.GetHash(), fNewSignatures, fValid, strError));
+    BOOST_CHECK(TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, true, strError));
+    BOOST_CHECK(tposcontracts.GetSignatureResult(contractTx.GetHash(), fNewSignatures, fValid, strError) && fValid);
+
+    // cancelled by spending the collateral
+    const COutPoint outpointCollateral = TPoSUtils::GetContractCollateralOutpoint(contract);
+    CMutableTransaction cancelTx;
+    cancelTx.vin.emplace_back(outpointCollateral);
+    cancelTx.vout.emplace_back(contractTx.vout[outpointCollateral.n].nValue, scriptPubKey);
+    CBasicKeyStore keystore;
+    keystore.AddKeyPubKey(tposAddressKey, tposAddressKey.GetPubKey());
+    BOOST_CHECK(SignSignature(keystore, CTransaction(contractTx), cancelTx, 0, SIGHASH_ALL));
+    CreateAndProcessBlock({cancelTx}, scriptPubKey);
+    BOOST_CHECK(!TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, true, strError));
+    BOOST_CHECK(TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, false, strError));
+
+    // valid again once the cancellation is disconnected, gone with the contract's block
+    {
+        LOCK(cs_main);
+        CValidationState state;
+        BOOST_CHECK(InvalidateBlock(state, Params(), chainActive.Tip()));
+    }
+    BOOST_CHECK(TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, true, strError));
+    {
+        LOCK(cs_main);
+        CValidationState state;
+        BOOST_CHECK(InvalidateBlock(state, Params(), chainActive.Tip()));
+    }
+    BOOST_CHECK(!TPoSUtils::CheckContract(contractTx.GetHash(), contract, chainActive.Height(), true, true, strError));
+}
+
 BOOST_FIXTURE_TEST_CASE(tpos_contract_payment, TestChain100Setup)
 {
     CAmount basePayment = 10 * COIN;
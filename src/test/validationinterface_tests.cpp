@@ -0,0 +1,105 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/test_xsn.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, TestingSetup)
+
+namespace {
+class InventoryRecorder : public CValidationInterface
+{
+public:
+    std::vector<uint256> vInventory;
+    bool fSlow = false;
+    //! If set, every callback is also appended here, tagged with nId
+    std::vector<std::pair<int, uint256>>* pvShared = nullptr;
+    int nId = 0;
+
+protected:
+    void Inventory(const uint256& hash) override
+    {
+        if (fSlow)
+            MilliSleep(1);
+        vInventory.push_back(hash);
+        if (pvShared)
+            pvShared->emplace_back(nId, hash);
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(validationinterface_subscriber_queues)
+{
+    InventoryRecorder slow, fast;
+    slow.fSlow = true;
+    RegisterValidationInterface(&slow, "slow");
+    RegisterValidationInterface(&fast, "fast");
+
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < 20; i++) {
+        vHashes.push_back(InsecureRand256());
+        GetMainSignals().Inventory(vHashes.back());
+    }
+    SyncWithValidationInterfaceQueue();
+
+    // Every subscriber saw every event, in order
+    BOOST_CHECK(slow.vInventory == vHashes);
+    BOOST_CHECK(fast.vInventory == vHashes);
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPending(), 0U);
+
+    std::vector<ValidationInterfaceQueueStats> vStats = GetMainSignals().GetQueueStats();
+    int nFound = 0;
+    for (const ValidationInterfaceQueueStats& stats : vStats) {
+        if (stats.name == "slow" || stats.name == "fast") {
+            nFound++;
+            BOOST_CHECK_EQUAL(stats.pending, 0U);
+            BOOST_CHECK(stats.maxPending >= 1);
+            BOOST_CHECK_EQUAL(stats.processed, vHashes.size());
+        }
+    }
+    BOOST_CHECK_EQUAL(nFound, 2);
+
+    // Nothing reaches a subscriber after it unregistered
+    UnregisterValidationInterface(&slow);
+    GetMainSignals().Inventory(InsecureRand256());
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(slow.vInventory.size(), vHashes.size());
+    BOOST_CHECK_EQUAL(fast.vInventory.size(), vHashes.size() + 1);
+
+    UnregisterValidationInterface(&fast);
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_single_thread_order)
+{
+    // The test scheduler runs on one thread, so all subscribers share one queue
+    std::vector<std::pair<int, uint256>> vShared;
+    InventoryRecorder slow, fast;
+    slow.fSlow = true;
+    slow.pvShared = fast.pvShared = &vShared;
+    slow.nId = 1;
+    fast.nId = 2;
+    RegisterValidationInterface(&slow, "slow");
+    RegisterValidationInterface(&fast, "fast");
+
+    std::vector<std::pair<int, uint256>> vExpected;
+    for (int i = 0; i < 20; i++) {
+        uint256 hash = InsecureRand256();
+        GetMainSignals().Inventory(hash);
+        vExpected.emplace_back(1, hash);
+        vExpected.emplace_back(2, hash);
+    }
+    SyncWithValidationInterfaceQueue();
+
+    // Every event reached both subscribers before the next one was handled
+    BOOST_CHECK(vShared == vExpected);
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPending(), 0U);
+
+    UnregisterValidationInterface(&slow);
+    UnregisterValidationInterface(&fast);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
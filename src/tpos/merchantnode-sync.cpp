@@ -4,7 +4,6 @@
 
 #include <tpos/activemerchantnode.h>
 #include <checkpoints.h>
-#include <governance/governance.h>
 #include <validation.h>
 #include <tpos/merchantnode-sync.h>
 #include <tpos/merchantnode.h>
@@ -30,6 +29,26 @@ void CMerchantnodeSync::Reset()
     nTimeAssetSyncStarted = GetTime();
     nTimeLastBumped = GetTime();
     nTimeLastFailure = 0;
+    StartAssetProgress();
+}
+
+void CMerchantnodeSync::StartAssetProgress()
+{
+    if(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_INITIAL) {
+        progress.Clear();
+    }
+    progress.Start(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_LIST ? MERCHANTNODE_SYNC_LIST : MERCHANTNODE_SYNC_INITIAL);
+}
+
+int CMerchantnodeSync::GetItemAsset(int nInvType)
+{
+    switch(nInvType) {
+        case(MSG_MERCHANTNODE_ANNOUNCE):
+        case(MSG_MERCHANTNODE_PING):
+            return MERCHANTNODE_SYNC_LIST;
+        default:
+            return MERCHANTNODE_SYNC_INITIAL;
+    }
 }
 
 void CMerchantnodeSync::BumpAssetLastTime(std::string strFuncName)
@@ -41,7 +60,12 @@ void CMerchantnodeSync::BumpAssetLastTime(std::string strFuncName)
 
 std::string CMerchantnodeSync::GetAssetName()
 {
-    switch(nRequestedMerchantnodeAssets)
+    return GetAssetName(nRequestedMerchantnodeAssets);
+}
+
+std::string CMerchantnodeSync::GetAssetName(int nAsset)
+{
+    switch(nAsset)
     {
         case(MERCHANTNODE_SYNC_INITIAL):      return "MERCHANTNODE_SYNC_INITIAL";
         case(MERCHANTNODE_SYNC_WAITING):      return "MERCHANTNODE_SYNC_WAITING";
@@ -91,6 +115,7 @@ void CMerchantnodeSync::SwitchToNextAsset(CConnman& connman)
     nRequestedMerchantnodeAttempt = 0;
     nTimeAssetSyncStarted = GetTime();
     BumpAssetLastTime("CMerchantnodeSync::SwitchToNextAsset");
+    StartAssetProgress();
 }
 
 std::string CMerchantnodeSync::GetSyncStatus()
@@ -117,6 +142,9 @@ void CMerchantnodeSync::ProcessMessage(CNode* pfrom, const std::string& strComma
         vRecv >> nItemID >> nCount;
 
         LogPrint(BCLog::MNSYNC, "MERCHANTSYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->GetId());
+
+        // The count follows the inventory it is about, so every item the peer has for us was asked for by now
+        progress.Answered(pfrom->GetId(), nItemID, nCount);
     }
 }
 
@@ -135,7 +163,7 @@ void CMerchantnodeSync::ClearFulfilledRequests(CConnman& connman)
 void CMerchantnodeSync::ProcessTick(CConnman& connman)
 {
     static int nTick = 0;
-    if(nTick++ % MERCHANTNODE_SYNC_TICK_SECONDS != 0) return;
+    nTick++;
 
     // reset the sync process if the last call to this function was more than 60 minutes ago (client was in sleep mode)
     static int64_t nTimeLastProcess = GetTime();
@@ -158,13 +186,7 @@ void CMerchantnodeSync::ProcessTick(CConnman& connman)
         return;
     }
 
-    // gradually request the rest of the votes after sync finished
-    if(IsSynced()) {
-        std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
-        governance.RequestGovernanceObjectVotes(vNodesCopy, connman);
-        connman.ReleaseNodeVector(vNodesCopy);
-        return;
-    }
+    if(IsSynced()) return;
 
     // Calculate "progress" for LOG reporting / GUI notification
     double nSyncProgress = double(nRequestedMerchantnodeAttempt + (nRequestedMerchantnodeAssets - 1) * 8) / (8*4);
@@ -172,6 +194,7 @@ void CMerchantnodeSync::ProcessTick(CConnman& connman)
     uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
 
     std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
+    std::vector<NodeId> vConnected;
 
     for(CNode* pnode : vNodesCopy)
     {
@@ -182,66 +205,82 @@ void CMerchantnodeSync::ProcessTick(CConnman& connman)
         if(pnode->fMerchantnode || (fMerchantNode && pnode->fInbound)) continue;
 
         // NORMAL NETWORK MODE - TESTNET/MAINNET
-        {
-            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-mrnsync")) {
-                // We already fully synced from this node recently,
-                // disconnect to free this connection slot for another peer.
-                pnode->fDisconnect = true;
-                LogPrintf("CMerchantnodeSync::ProcessTick -- disconnecting from recently synced peer %d\n", pnode->GetId());
-                continue;
-            }
+        if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-mrnsync")) {
+            // We already fully synced from this node recently,
+            // disconnect to free this connection slot for another peer.
+            pnode->fDisconnect = true;
+            LogPrintf("CMerchantnodeSync::ProcessTick -- disconnecting from recently synced peer %d\n", pnode->GetId());
+            continue;
+        }
 
-            // INITIAL TIMEOUT
-
-            if(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_WAITING) {
-                if(GetTime() - nTimeLastBumped > MERCHANTNODE_SYNC_TIMEOUT_SECONDS) {
-                    // At this point we know that:
-                    // a) there are peers (because we are looping on at least one of them);
-                    // b) we waited for at least MERCHANTNODE_SYNC_TIMEOUT_SECONDS since we reached
-                    //    the headers tip the last time (i.e. since we switched from
-                    //     MERCHANTNODE_SYNC_INITIAL to MERCHANTNODE_SYNC_WAITING and bumped time);
-                    // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
-                    //    for at least MERCHANTNODE_SYNC_TIMEOUT_SECONDS.
-                    // We must be at the tip already, let's move to the next asset.
-                    SwitchToNextAsset(connman);
-                }
-            }
+        vConnected.push_back(pnode->GetId());
+
+        // MNLIST : SYNC MERCHANTNODE LIST FROM OTHER CONNECTED CLIENTS, UP TO MERCHANTNODE_SYNC_ENOUGH_PEERS AT ONCE
 
-            // MNLIST : SYNC MERCHANTNODE LIST FROM OTHER CONNECTED CLIENTS
-
-            if(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_LIST) {
-                LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeSync::ProcessTick -- nTick %d nRequestedMerchantnodeAssets %d nTimeLastBumped %lld GetTime() %lld diff %lld\n", nTick, nRequestedMerchantnodeAssets, nTimeLastBumped, GetTime(), GetTime() - nTimeLastBumped);
-                // check for timeout first
-                if(GetTime() - nTimeLastBumped > MERCHANTNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeSync::ProcessTick -- nTick %d nRequestedMerchantnodeAssets %d -- timeout\n", nTick, nRequestedMerchantnodeAssets);
-                    if (nRequestedMerchantnodeAttempt == 0) {
-                        LogPrintf("CMerchantnodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
-                        // there is no way we can continue without masternode list, fail here and try later
-                        Fail();
-                        connman.ReleaseNodeVector(vNodesCopy);
-                        return;
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // only request once from each peer
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "merchantnode-list-sync")) continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "merchantnode-list-sync");
-
-//                if (pnode->nVersion < PROTOCOL_VERSION) continue;
-                nRequestedMerchantnodeAttempt++;
-
-                merchantnodeman.DsegUpdate(pnode, connman);
-
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
+        if(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_LIST) {
+            if(nRequestedMerchantnodeAttempt >= MERCHANTNODE_SYNC_ENOUGH_PEERS) continue;
+
+            // only request once from each peer
+            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "merchantnode-list-sync")) continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "merchantnode-list-sync");
+
+            nRequestedMerchantnodeAttempt++;
+            // a peer asked recently is not asked again and will not answer
+            if(merchantnodeman.DsegUpdate(pnode, connman)) {
+                RequestedAsset(pnode->GetId());
             }
         }
     }
+    bool fReachedPeersHeight = nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_WAITING && CSyncProgressTracker::ReachedPeersHeight(vNodesCopy);
     // looped through all nodes, release them
     connman.ReleaseNodeVector(vNodesCopy);
+
+    // nothing can complete or time out without peers
+    if(vConnected.empty()) return;
+
+    // INITIAL TIMEOUT
+
+    if(nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_WAITING) {
+        if(GetTime() - nTimeLastBumped > MERCHANTNODE_SYNC_TIMEOUT_SECONDS) {
+            // At this point we know that:
+            // a) there are peers;
+            // b) we waited for at least MERCHANTNODE_SYNC_TIMEOUT_SECONDS since we reached
+            //    the headers tip the last time (i.e. since we switched from
+            //     MERCHANTNODE_SYNC_INITIAL to MERCHANTNODE_SYNC_WAITING and bumped time);
+            // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
+            //    for at least MERCHANTNODE_SYNC_TIMEOUT_SECONDS.
+            // We must be at the tip already, let's move to the next asset.
+            SwitchToNextAsset(connman);
+        } else if(fReachedPeersHeight) {
+            // No need to wait for more blocks, we have all the ones our peers told us about
+            LogPrintf("CMerchantnodeSync::ProcessTick -- nTick %d nRequestedMerchantnodeAssets %d -- reached the height of our peers\n", nTick, nRequestedMerchantnodeAssets);
+            SwitchToNextAsset(connman);
+        }
+        return;
+    }
+
+    if(nRequestedMerchantnodeAssets != MERCHANTNODE_SYNC_LIST) return;
+
+    // COMPLETION : ENOUGH PEERS ANSWERED AND EVERYTHING WE ASKED THEM FOR ARRIVED
+
+    if(UpdateAssetProgress(vConnected)) {
+        LogPrintf("CMerchantnodeSync::ProcessTick -- nTick %d nRequestedMerchantnodeAssets %d -- received all data\n", nTick, nRequestedMerchantnodeAssets);
+        SwitchToNextAsset(connman);
+        return;
+    }
+
+    // TIMEOUT : PEERS WHICH DO NOT ANSWER
+
+    if(GetTime() - nTimeLastBumped > MERCHANTNODE_SYNC_TIMEOUT_SECONDS) {
+        LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeSync::ProcessTick -- nTick %d nRequestedMerchantnodeAssets %d -- timeout\n", nTick, nRequestedMerchantnodeAssets);
+        if (nRequestedMerchantnodeAttempt == 0) {
+            LogPrintf("CMerchantnodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
+            // there is no way we can continue without merchantnode list, fail here and try later
+            Fail();
+            return;
+        }
+        SwitchToNextAsset(connman);
+    }
 }
 
 
@@ -6,6 +6,9 @@
 
 #include <chain.h>
 #include <net.h>
+#include <syncprogress.h>
+
+#include <map>
 
 class CMerchantnodeSync;
 
@@ -23,12 +26,19 @@ static const int MERCHANTNODE_SYNC_ENOUGH_PEERS    = 6;
 extern CMerchantnodeSync merchantnodeSync;
 
 //
-// CMerchantnodeSync : Sync masternode assets in stages
+// CMerchantnodeSync : Sync merchantnode assets in stages
+//
+// Same pipeline as the masternode sync: the list is requested from up to
+// MERCHANTNODE_SYNC_ENOUGH_PEERS peers at once and is complete as soon as
+// enough of them answered with MERCHANTSYNCSTATUSCOUNT and every merchantnode
+// we asked them for arrived, the timeouts are only a fallback.
 //
 
 class CMerchantnodeSync
 {
 private:
+    CSyncProgressTracker progress;
+
     // Keep track of current asset
     int nRequestedMerchantnodeAssets;
     // Count peers we've requested the asset from
@@ -43,12 +53,11 @@ private:
 
     void Fail();
     void ClearFulfilledRequests(CConnman& connman);
+    void StartAssetProgress();
+    static int GetItemAsset(int nInvType);
 
 public:
-    CMerchantnodeSync() { Reset(); }
-
-
-    void SendGovernanceSyncRequest(CNode* pnode, CConnman& connman);
+    CMerchantnodeSync() : progress(&CMerchantnodeSync::GetItemAsset) { Reset(); }
 
     bool IsFailed() { return nRequestedMerchantnodeAssets == MERCHANTNODE_SYNC_FAILED; }
     bool IsBlockchainSynced() { return nRequestedMerchantnodeAssets > MERCHANTNODE_SYNC_WAITING; }
@@ -60,7 +69,9 @@ public:
     void BumpAssetLastTime(std::string strFuncName);
     int64_t GetAssetStartTime() { return nTimeAssetSyncStarted; }
     std::string GetAssetName();
+    static std::string GetAssetName(int nAsset);
     std::string GetSyncStatus();
+    std::map<int, CSyncAssetProgress> GetProgress() const { return progress.GetProgress(); }
 
     void Reset();
     void SwitchToNextAsset(CConnman& connman);
@@ -68,6 +79,13 @@ public:
     void ProcessMessage(CNode* pfrom, const std::string &strCommand, CDataStream& vRecv);
     void ProcessTick(CConnman& connman);
 
+    /** Called when the current asset was requested from a peer */
+    void RequestedAsset(NodeId nodeId) { progress.RequestedAsset(nodeId); }
+    /** Called for every item we ask a peer for after its inventory */
+    void RequestedItem(const CInv& inv) { progress.RequestedItem(inv); }
+    /** Whether the current asset is complete, given the peers still connected */
+    bool UpdateAssetProgress(const std::vector<NodeId>& vConnected) { return progress.Update(vConnected); }
+
     void AcceptedBlockHeader(const CBlockIndex *pindexNew);
     void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload, CConnman& connman);
     void UpdatedBlockTip(const CBlockIndex *pindexNew, bool fInitialDownload, CConnman& connman);
@@ -32,15 +32,16 @@ static bool GetBlockHash(uint256 &hash, int nBlockHeight)
     return false;
 }
 
-struct CompareByAddr
-
+static void EraseByAddr(std::multimap<CService, CPubKey>& mapByAddr, const CService& addr, const CPubKey& pubKeyMerchantnode)
 {
-    bool operator()(const CMerchantnode* t1,
-                    const CMerchantnode* t2) const
-    {
-        return t1->addr < t2->addr;
+    auto range = mapByAddr.equal_range(addr);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == pubKeyMerchantnode) {
+            mapByAddr.erase(it);
+            return;
+        }
     }
-};
+}
 
 CMerchantnodeMan::CMerchantnodeMan()
     : cs(),
@@ -66,6 +67,7 @@ bool CMerchantnodeMan::Add(CMerchantnode &mn)
 
     LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeMan::Add -- Adding new Merchantnode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMerchantnodes[mn.pubKeyMerchantnode] = mn;
+    mapMerchantnodesByAddr.emplace(mn.addr, mn.pubKeyMerchantnode);
 
     return true;
 }
@@ -153,6 +155,7 @@ void CMerchantnodeMan::CheckAndRemove(CConnman& connman)
                 mWeAskedForMerchantnodeListEntry.erase(it->first);
 
                 // and finally remove it from the list
+                EraseByAddr(mapMerchantnodesByAddr, it->second.addr, it->first);
                 mapMerchantnodes.erase(it++);
             } else {
                 bool fAsk = (nAskForMnbRecovery > 0) &&
@@ -283,6 +286,7 @@ void CMerchantnodeMan::Clear()
 {
     LOCK(cs);
     mapMerchantnodes.clear();
+    mapMerchantnodesByAddr.clear();
     mAskedUsForMerchantnodeList.clear();
     mWeAskedForMerchantnodeList.clear();
     mWeAskedForMerchantnodeListEntry.clear();
@@ -292,6 +296,24 @@ void CMerchantnodeMan::Clear()
     nLastWatchdogVoteTime = 0;
 }
 
+void CMerchantnodeMan::UpdatedMerchantnode(const CMerchantnode* pmn, const CService& addrOld)
+{
+    AssertLockHeld(cs);
+    if(pmn->addr != addrOld) {
+        EraseByAddr(mapMerchantnodesByAddr, addrOld, pmn->pubKeyMerchantnode);
+        mapMerchantnodesByAddr.emplace(pmn->addr, pmn->pubKeyMerchantnode);
+    }
+}
+
+void CMerchantnodeMan::RebuildIndexes()
+{
+    AssertLockHeld(cs);
+    mapMerchantnodesByAddr.clear();
+    for (const auto& mnpair : mapMerchantnodes) {
+        mapMerchantnodesByAddr.emplace(mnpair.second.addr, mnpair.first);
+    }
+}
+
 int CMerchantnodeMan::CountMerchantnodes(int nProtocolVersion) const
 {
     LOCK(cs);
@@ -337,7 +359,7 @@ int CMerchantnodeMan::CountByIP(int nNetworkType)
 }
 */
 
-void CMerchantnodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
+bool CMerchantnodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
 {
     LOCK(cs);
 
@@ -346,7 +368,7 @@ void CMerchantnodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
             std::map<CNetAddr, int64_t>::iterator it = mWeAskedForMerchantnodeList.find(pnode->addr);
             if(it != mWeAskedForMerchantnodeList.end() && GetTime() < (*it).second) {
                 LogPrintf("CMerchantnodeMan::DsegUpdate -- we already asked %s for the list; skipping...\n", pnode->addr.ToString());
-                return;
+                return false;
             }
         }
     }
@@ -356,6 +378,7 @@ void CMerchantnodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
     mWeAskedForMerchantnodeList[pnode->addr] = askAgain;
 
     LogPrintf("CMerchantnodeMan::DsegUpdate -- asked %s for the list\n", pnode->addr.ToString());
+    return true;
 }
 
 CMerchantnode* CMerchantnodeMan::Find(const CPubKey &pubKeyMerchantnode)
@@ -691,13 +714,6 @@ void CMerchantnodeMan::DoFullVerificationStep(CConnman& connman)
     int nOffset = MAX_POSE_RANK + nMyRank - 1;
     if(nOffset >= (int)vecMerchantnodeRanks.size()) return;
 
-    std::vector<CMerchantnode*> vSortedByAddr;
-    for (auto& mnpair : mapMerchantnodes) {
-        vSortedByAddr.push_back(&mnpair.second);
-    }
-
-    sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
     it = vecMerchantnodeRanks.begin() + nOffset;
     while(it != vecMerchantnodeRanks.end()) {
         if(it->second.IsPoSeVerified() || it->second.IsPoSeBanned()) {
@@ -713,7 +729,7 @@ void CMerchantnodeMan::DoFullVerificationStep(CConnman& connman)
         }
         LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeMan::DoFullVerificationStep -- Verifying merchantnode %s rank %d/%d address %s\n",
                  it->second.vin.prevout.ToStringShort(), it->first, nRanksTotal, it->second.addr.ToString());
-        if(SendVerifyRequest(CAddress(it->second.addr, NODE_NETWORK), vSortedByAddr, connman)) {
+        if(SendVerifyRequest(CAddress(it->second.addr, NODE_NETWORK), connman)) {
             nCount++;
             if(nCount >= MAX_POSE_CONNECTIONS) break;
         }
@@ -758,7 +774,6 @@ void CMerchantnodeMan::CheckSameAddr()
     if(!merchantnodeSync.IsSynced() || mapMerchantnodes.empty()) return;
 
     std::vector<CMerchantnode*> vBan;
-    std::vector<CMerchantnode*> vSortedByAddr;
 
     {
         LOCK(cs);
@@ -766,13 +781,8 @@ void CMerchantnodeMan::CheckSameAddr()
         CMerchantnode* pprevMerchantnode = NULL;
         CMerchantnode* pverifiedMerchantnode = NULL;
 
-        for (auto& mnpair : mapMerchantnodes) {
-            vSortedByAddr.push_back(&mnpair.second);
-        }
-
-        sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
-        for(CMerchantnode* pmn : vSortedByAddr) {
+        for(const auto& addrpair : mapMerchantnodesByAddr) {
+            CMerchantnode* pmn = &mapMerchantnodes.at(addrpair.second);
             // check only (pre)enabled merchantnodes
             if(!pmn->IsEnabled() && !pmn->IsPreEnabled()) continue;
             // initial step
@@ -807,7 +817,7 @@ void CMerchantnodeMan::CheckSameAddr()
     }
 }
 
-bool CMerchantnodeMan::SendVerifyRequest(const CAddress& addr, const std::vector<CMerchantnode*>& vSortedByAddr, CConnman& connman)
+bool CMerchantnodeMan::SendVerifyRequest(const CAddress& addr, CConnman& connman)
 {
     if(netfulfilledman.HasFulfilledRequest(addr, strprintf("%s", NetMsgType::MERCHANTNODEVERIFY)+"-request")) {
         // we already asked for verification, not a good idea to do this too often, skip it
@@ -920,44 +930,44 @@ void CMerchantnodeMan::ProcessVerifyReply(CNode* pnode, CMerchantnodeVerificatio
         CMerchantnode* prealMerchantnode = NULL;
         std::vector<CMerchantnode*> vpMerchantnodesToBan;
         std::string strMessage1 = strprintf("%s%d%s", pnode->addr.ToString(false), mnv.nonce, blockHash.ToString());
-        for (auto& mnpair : mapMerchantnodes) {
-            if(CAddress(mnpair.second.addr, NODE_NETWORK) == pnode->addr) {
-                if(CMessageSigner::VerifyMessage(mnpair.second.pubKeyMerchantnode.GetID(), mnv.vchSig1, strMessage1, strError)) {
-                    // found it!
-                    prealMerchantnode = &mnpair.second;
-                    if(!mnpair.second.IsPoSeVerified()) {
-                        mnpair.second.DecreasePoSeBanScore();
-                    }
-                    netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MERCHANTNODEVERIFY)+"-done");
-
-                    // we can only broadcast it if we are an activated merchantnode
-                    if(!activeMerchantnode.pubKeyMerchantnode.IsValid()) continue;
-                    // update ...
-                    mnv.addr = mnpair.second.addr;
-                    mnv.pubKeyMerchantnode1 = mnpair.second.pubKeyMerchantnode;
-                    mnv.pubKeyMerchantnode2 = activeMerchantnode.pubKeyMerchantnode;
-                    std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(false), mnv.nonce, blockHash.ToString(),
-                                                        HexStr(mnv.pubKeyMerchantnode1.Raw()), HexStr(mnv.pubKeyMerchantnode2.Raw()));
-                    // ... and sign it
-                    if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMerchantnode.keyMerchantnode, CPubKey::InputScriptType::SPENDP2PKH)) {
-                        LogPrintf("MerchantnodeMan::ProcessVerifyReply -- SignMessage() failed\n");
-                        return;
-                    }
+        auto range = mapMerchantnodesByAddr.equal_range(pnode->addr);
+        for (auto it = range.first; it != range.second; ++it) {
+            CMerchantnode& mn = mapMerchantnodes.at(it->second);
+            if(CMessageSigner::VerifyMessage(mn.pubKeyMerchantnode.GetID(), mnv.vchSig1, strMessage1, strError)) {
+                // found it!
+                prealMerchantnode = &mn;
+                if(!mn.IsPoSeVerified()) {
+                    mn.DecreasePoSeBanScore();
+                }
+                netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MERCHANTNODEVERIFY)+"-done");
+
+                // we can only broadcast it if we are an activated merchantnode
+                if(!activeMerchantnode.pubKeyMerchantnode.IsValid()) continue;
+                // update ...
+                mnv.addr = mn.addr;
+                mnv.pubKeyMerchantnode1 = mn.pubKeyMerchantnode;
+                mnv.pubKeyMerchantnode2 = activeMerchantnode.pubKeyMerchantnode;
+                std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(false), mnv.nonce, blockHash.ToString(),
+                                                    HexStr(mnv.pubKeyMerchantnode1.Raw()), HexStr(mnv.pubKeyMerchantnode2.Raw()));
+                // ... and sign it
+                if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMerchantnode.keyMerchantnode, CPubKey::InputScriptType::SPENDP2PKH)) {
+                    LogPrintf("MerchantnodeMan::ProcessVerifyReply -- SignMessage() failed\n");
+                    return;
+                }
 
-                    std::string strError;
+                std::string strError;
 
-                    if(!CMessageSigner::VerifyMessage(activeMerchantnode.pubKeyMerchantnode.GetID(), mnv.vchSig2, strMessage2, strError)) {
-                        LogPrintf("MerchantnodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
-                        return;
-                    }
+                if(!CMessageSigner::VerifyMessage(activeMerchantnode.pubKeyMerchantnode.GetID(), mnv.vchSig2, strMessage2, strError)) {
+                    LogPrintf("MerchantnodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
+                    return;
+                }
 
-                    mWeAskedForVerification[pnode->addr] = mnv;
-                    mapSeenMerchantnodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
-                    mnv.Relay();
+                mWeAskedForVerification[pnode->addr] = mnv;
+                mapSeenMerchantnodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
+                mnv.Relay();
 
-                } else {
-                    vpMerchantnodesToBan.push_back(&mnpair.second);
-                }
+            } else {
+                vpMerchantnodesToBan.push_back(&mn);
             }
         }
         // no real merchantnode found?...
@@ -1119,7 +1129,10 @@ void CMerchantnodeMan::UpdateMerchantnodeList(CMerchantnodeBroadcast mnb, CConnm
         }
     } else {
         CMerchantnodeBroadcast mnbOld = mapSeenMerchantnodeBroadcast[CMerchantnodeBroadcast(*pmn).GetHash()].second;
-        if(pmn->UpdateFromNewBroadcast(mnb, connman)) {
+        const CService addrOld = pmn->addr;
+        bool fUpdated = pmn->UpdateFromNewBroadcast(mnb, connman);
+        UpdatedMerchantnode(pmn, addrOld);
+        if(fUpdated) {
             merchantnodeSync.BumpAssetLastTime("CMerchantnodeMan::UpdateMerchantnodeList - seen");
             mapSeenMerchantnodeBroadcast.erase(mnbOld.GetHash());
         }
@@ -1188,7 +1201,10 @@ bool CMerchantnodeMan::CheckMnbAndUpdateMerchantnodeList(CNode* pfrom, CMerchant
         CMerchantnode* pmn = Find(mnb.pubKeyMerchantnode);
         if(pmn) {
             CMerchantnodeBroadcast mnbOld = mapSeenMerchantnodeBroadcast[CMerchantnodeBroadcast(*pmn).GetHash()].second;
-            if(!mnb.Update(pmn, nDos, connman)) {
+            const CService addrOld = pmn->addr;
+            bool fUpdated = mnb.Update(pmn, nDos, connman);
+            UpdatedMerchantnode(pmn, addrOld);
+            if(!fUpdated) {
                 LogPrint(BCLog::MERCHANTNODE, "CMerchantnodeMan::CheckMnbAndUpdateMerchantnodeList -- Update() failed, merchantnode=%s\n",
                          mnb.pubKeyMerchantnode.GetID().ToString());
                 return false;
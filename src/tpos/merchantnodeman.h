@@ -44,6 +44,8 @@ private:
 
     // map to hold all MNs
     std::map<CPubKey, CMerchantnode> mapMerchantnodes;
+    // all MNs ordered by address, kept in step with mapMerchantnodes
+    std::multimap<CService, CPubKey> mapMerchantnodesByAddr;
     // who's asked for the Merchantnode list and the last time
     std::map<CNetAddr, int64_t> mAskedUsForMerchantnodeList;
     // who we asked for the Merchantnode list and the last time
@@ -65,6 +67,10 @@ private:
     friend class CMerchantnodeSync;
     /// Find an entry
     CMerchantnode* Find(const CPubKey &pubKeyMerchantnode);
+
+    /// Keep the address index in step after pmn was updated from a broadcast
+    void UpdatedMerchantnode(const CMerchantnode* pmn, const CService& addrOld);
+    void RebuildIndexes();
 public:
     // Keep track of all broadcasts I've seen
     std::map<uint256, std::pair<int64_t, CMerchantnodeBroadcast> > mapSeenMerchantnodeBroadcast;
@@ -104,6 +110,9 @@ public:
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if(ser_action.ForRead()) {
+            RebuildIndexes();
+        }
     }
 
     CMerchantnodeMan();
@@ -138,7 +147,8 @@ public:
     /// Count Merchantnodes by network type - NET_IPV4, NET_IPV6, NET_TOR
     // int CountByIP(int nNetworkType);
 
-    void DsegUpdate(CNode* pnode, CConnman& connman);
+    /// Ask a peer for the whole list, false if it was asked recently
+    bool DsegUpdate(CNode* pnode, CConnman& connman);
 
     /// Versions of Find that are safe to use from outside the class
     bool Get(const CKeyID &pubKeyID, CMerchantnode& masternodeRet);
@@ -159,7 +169,7 @@ public:
     void DoFullVerificationStep(CConnman& connman);
     void AskForMissing(CConnman& connman);
     void CheckSameAddr();
-    bool SendVerifyRequest(const CAddress& addr, const std::vector<CMerchantnode*>& vSortedByAddr, CConnman& connman);
+    bool SendVerifyRequest(const CAddress& addr, CConnman& connman);
     void SendVerifyReply(CNode* pnode, CMerchantnodeVerification& mnv, CConnman& connman);
     void ProcessVerifyReply(CNode* pnode, CMerchantnodeVerification& mnv);
     void ProcessVerifyBroadcast(CNode* pnode, const CMerchantnodeVerification& mnv);
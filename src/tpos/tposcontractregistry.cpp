@@ -0,0 +1,154 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tpos/tposcontractregistry.h>
+
+#include <primitives/block.h>
+
+CTPoSContractRegistry tposcontracts;
+
+CTPoSContractRegistry::Entry* CTPoSContractRegistry::AddEntry(const TPoSContract& contract)
+{
+    const uint256 hash = contract.txContract->GetHash();
+    auto it = mapContracts.find(hash);
+    if (it != mapContracts.end())
+        return &it->second;
+    if (mapContracts.size() >= MAX_TPOS_CONTRACT_REGISTRY_SIZE)
+        return nullptr;
+
+    Entry& entry = mapContracts[hash];
+    entry.contract = contract;
+    entry.outpointCollateral = TPoSUtils::GetContractCollateralOutpoint(contract);
+    if (!entry.outpointCollateral.IsNull())
+        mapCollaterals[entry.outpointCollateral] = hash;
+    return &entry;
+}
+
+bool CTPoSContractRegistry::Add(const TPoSContract& contract)
+{
+    if (!contract.IsValid())
+        return false;
+    LOCK(cs);
+    return AddEntry(contract) != nullptr;
+}
+
+bool CTPoSContractRegistry::Get(const uint256& hashContractTx, TPoSContract& contractRet) const
+{
+    LOCK(cs);
+    auto it = mapContracts.find(hashContractTx);
+    if (it == mapContracts.end())
+        return false;
+    contractRet = it->second.contract;
+    return true;
+}
+
+bool CTPoSContractRegistry::GetSignatureResult(const uint256& hashContractTx, bool fNewSignatures, bool& fValidRet, std::string& strErrorRet) const
+{
+    LOCK(cs);
+    auto it = mapContracts.find(hashContractTx);
+    if (it == mapContracts.end() || it->second.nSigValid[fNewSignatures] < 0)
+        return false;
+    fValidRet = it->second.nSigValid[fNewSignatures] != 0;
+    if (!fValidRet)
+        strErrorRet = it->second.strSigError;
+    return true;
+}
+
+void CTPoSContractRegistry::SetSignatureResult(const uint256& hashContractTx, bool fNewSignatures, bool fValid, const std::string& strError)
+{
+    LOCK(cs);
+    auto it = mapContracts.find(hashContractTx);
+    if (it == mapContracts.end())
+        return;
+    it->second.nSigValid[fNewSignatures] = fValid ? 1 : 0;
+    if (!fValid)
+        it->second.strSigError = strError;
+}
+
+bool CTPoSContractRegistry::GetCollateralUnspent(const uint256& hashContractTx, bool& fUnspentRet) const
+{
+    LOCK(cs);
+    auto it = mapContracts.find(hashContractTx);
+    if (it == mapContracts.end() || !it->second.fCollateralTracked)
+        return false;
+    fUnspentRet = it->second.fCollateralUnspent;
+    return true;
+}
+
+void CTPoSContractRegistry::SetCollateralUnspent(const TPoSContract& contract, bool fUnspent)
+{
+    if (!contract.IsValid())
+        return;
+    LOCK(cs);
+    Entry* pentry = AddEntry(contract);
+    if (!pentry)
+        return;
+    pentry->fCollateralTracked = true;
+    pentry->fCollateralUnspent = fUnspent && !pentry->outpointCollateral.IsNull();
+}
+
+void CTPoSContractRegistry::BlockConnected(const CBlock& block)
+{
+    LOCK(cs);
+    for (const auto& tx : block.vtx) {
+        // a contract is cancelled by spending its collateral
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                auto it = mapCollaterals.find(txin.prevout);
+                if (it == mapCollaterals.end())
+                    continue;
+                Entry& entry = mapContracts.at(it->second);
+                entry.fCollateralTracked = true;
+                entry.fCollateralUnspent = false;
+            }
+        }
+
+        TPoSContract contract = TPoSContract::FromTPoSContractTx(tx);
+        if (!contract.IsValid())
+            continue;
+        Entry* pentry = AddEntry(contract);
+        if (pentry) {
+            pentry->fCollateralTracked = true;
+            pentry->fCollateralUnspent = !pentry->outpointCollateral.IsNull();
+        }
+    }
+}
+
+void CTPoSContractRegistry::BlockDisconnected(const CBlock& block)
+{
+    LOCK(cs);
+    for (auto itTx = block.vtx.rbegin(); itTx != block.vtx.rend(); ++itTx) {
+        const auto& tx = *itTx;
+        // the contract is no longer in the active chain, the entry is kept for its signature
+        auto itContract = mapContracts.find(tx->GetHash());
+        if (itContract != mapContracts.end()) {
+            itContract->second.fCollateralTracked = true;
+            itContract->second.fCollateralUnspent = false;
+        }
+
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                auto it = mapCollaterals.find(txin.prevout);
+                if (it == mapCollaterals.end())
+                    continue;
+                Entry& entry = mapContracts.at(it->second);
+                entry.fCollateralTracked = true;
+                entry.fCollateralUnspent = true;
+            }
+        }
+    }
+}
+
+size_t CTPoSContractRegistry::size() const
+{
+    LOCK(cs);
+    return mapContracts.size();
+}
+
+void CTPoSContractRegistry::Clear()
+{
+    LOCK(cs);
+    mapContracts.clear();
+    mapCollaterals.clear();
+}
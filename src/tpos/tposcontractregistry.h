@@ -0,0 +1,74 @@
+// Copyright (c) 2018 The XSN developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef TPOSCONTRACTREGISTRY_H
+#define TPOSCONTRACTREGISTRY_H
+
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <tpos/tposutils.h>
+#include <uint256.h>
+
+#include <map>
+#include <string>
+
+class CBlock;
+class CTPoSContractRegistry;
+
+/** Contracts kept in the registry, lookups past it parse the contract every time */
+static const size_t MAX_TPOS_CONTRACT_REGISTRY_SIZE = 100000;
+
+extern CTPoSContractRegistry tposcontracts;
+
+/**
+ * Parsed TPoS contracts with the results of their signature checks and the
+ * state of their collateral in the active chain. A contract and its signature
+ * are fixed by its txid, so they are kept for every contract looked up. The
+ * collateral state follows ConnectTip/DisconnectTip under cs_main once it was
+ * looked up in pcoinsTip, so checking a TPoS block needs neither the contract
+ * transaction nor a signature verification nor a coin lookup.
+ */
+class CTPoSContractRegistry
+{
+private:
+    struct Entry {
+        TPoSContract contract;
+        COutPoint outpointCollateral;
+        // signature check result before and after the signature hard fork, -1 while not checked
+        int8_t nSigValid[2] = {-1, -1};
+        std::string strSigError;
+        // whether fCollateralUnspent follows the active chain
+        bool fCollateralTracked = false;
+        bool fCollateralUnspent = false;
+    };
+
+    mutable CCriticalSection cs;
+    std::map<uint256, Entry> mapContracts;
+    std::map<COutPoint, uint256> mapCollaterals;
+
+    Entry* AddEntry(const TPoSContract& contract);
+
+public:
+    /** Keep a parsed valid contract, false if the registry is full */
+    bool Add(const TPoSContract& contract);
+    bool Get(const uint256& hashContractTx, TPoSContract& contractRet) const;
+
+    /** Result of an earlier signature check for the same side of the hard fork, false if none */
+    bool GetSignatureResult(const uint256& hashContractTx, bool fNewSignatures, bool& fValidRet, std::string& strErrorRet) const;
+    void SetSignatureResult(const uint256& hashContractTx, bool fNewSignatures, bool fValid, const std::string& strError);
+
+    /** Whether the collateral is unspent in the active chain, false if not tracked. Requires cs_main. */
+    bool GetCollateralUnspent(const uint256& hashContractTx, bool& fUnspentRet) const;
+    /** Track the collateral from its state in pcoinsTip. Requires cs_main. */
+    void SetCollateralUnspent(const TPoSContract& contract, bool fUnspent);
+
+    /** Register the contracts of a block connected to the active chain and their spent collaterals */
+    void BlockConnected(const CBlock& block);
+    void BlockDisconnected(const CBlock& block);
+
+    size_t size() const;
+    void Clear();
+};
+
+#endif // TPOSCONTRACTREGISTRY_H
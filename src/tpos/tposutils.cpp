@@ -4,9 +4,11 @@
 #include <utilmoneystr.h>
 #include <policy/policy.h>
 #include <validation.h>
+#include <txdb.h>
 #include <wallet/coincontrol.h>
 #include <tpos/merchantnode-sync.h>
 #include <tpos/merchantnodeman.h>
+#include <tpos/tposcontractregistry.h>
 #include <tpos/activemerchantnode.h>
 #include <consensus/validation.h>
 #include <messagesigner.h>
@@ -46,38 +48,27 @@ bool TPoSUtils::GetTPoSPayments(const CWallet *wallet,
     if(!tx->IsCoinStake())
         return false;
 
-    CAmount nCredit = wallet->GetCredit(*tx, ISMINE_ALL);
-    CAmount nDebit = wallet->GetDebit(*tx, ISMINE_ALL);
-    CAmount nNet = nCredit - nDebit;
-
-    std::vector<TPoSContract> tposContracts;
-
-    for(auto &&pair : wallet->tposOwnerContracts)
-        tposContracts.emplace_back(pair.second);
-
-    for(auto &&pair : wallet->tposMerchantContracts)
-        tposContracts.emplace_back(pair.second);
-
     CTxDestination address;
     auto scriptKernel = tx->vout.at(1).scriptPubKey;
     commissionAmount = stakeAmount = 0;
-    auto it = std::find_if(std::begin(tposContracts), std::end(tposContracts), [scriptKernel](const TPoSContract &entry) {
-        return entry.scriptTPoSAddress == scriptKernel;
-    });
+    auto vContracts = wallet->GetTPoSContractsByTPoSScript(scriptKernel);
 
-    if(it != std::end(tposContracts))
+    if(!vContracts.empty())
     {
-        auto merchantScript = it->scriptMerchantAddress;
+        const TPoSContract &contract = vContracts.front();
+        auto merchantScript = contract.scriptMerchantAddress;
         auto commissionIt = std::find_if(std::begin(tx->vout), std::end(tx->vout), [merchantScript](const CTxOut &txOut) {
             return txOut.scriptPubKey == merchantScript;
         });
 
         if(commissionIt != tx->vout.end())
         {
-            stakeAmount = nNet;
+            CAmount nCredit = wallet->GetCredit(*tx, ISMINE_ALL);
+            CAmount nDebit = wallet->GetDebit(*tx, ISMINE_ALL);
+            stakeAmount = nCredit - nDebit;
             commissionAmount = commissionIt->nValue;
-            ExtractDestination(it->scriptTPoSAddress, tposAddress);
-            ExtractDestination(it->scriptMerchantAddress, merchantAddress);
+            ExtractDestination(contract.scriptTPoSAddress, tposAddress);
+            ExtractDestination(contract.scriptMerchantAddress, merchantAddress);
 
             return true;
         }
@@ -89,8 +80,11 @@ bool TPoSUtils::GetTPoSPayments(const CWallet *wallet,
 
 bool TPoSUtils::IsTPoSMerchantContract(CWallet *wallet, const CTransactionRef &tx)
 {
-    TPoSContract contract = TPoSContract::FromTPoSContractTx(tx);
+    return IsTPoSMerchantContract(wallet, TPoSContract::FromTPoSContractTx(tx));
+}
 
+bool TPoSUtils::IsTPoSMerchantContract(CWallet *wallet, const TPoSContract &contract)
+{
     bool isMerchantNode = contract.scriptMerchantAddress ==
             GetScriptForDestination(activeMerchantnode.pubKeyMerchantnode.GetID());
 
@@ -103,8 +97,11 @@ bool TPoSUtils::IsTPoSMerchantContract(CWallet *wallet, const CTransactionRef &t
 
 bool TPoSUtils::IsTPoSOwnerContract(CWallet *wallet, const CTransactionRef &tx)
 {
-    TPoSContract contract = TPoSContract::FromTPoSContractTx(tx);
+    return IsTPoSOwnerContract(wallet, TPoSContract::FromTPoSContractTx(tx));
+}
 
+bool TPoSUtils::IsTPoSOwnerContract(CWallet *wallet, const TPoSContract &contract)
+{
     CTxDestination dest;
     ExtractDestination(contract.scriptTPoSAddress, dest);
 
@@ -235,65 +232,104 @@ COutPoint TPoSUtils::GetContractCollateralOutpoint(const TPoSContract &contract)
 
 bool TPoSUtils::CheckContract(const uint256 &hashContractTx, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError)
 {
-    CTransactionRef tx;
-    uint256 hashBlock;
-    if (!GetTransaction(hashContractTx, tx, Params().GetConsensus(), hashBlock, true)) {
-        strError = strprintf("%s : failed to get transaction for tpos contract %s", __func__,
-                             hashContractTx.ToString());
+    TPoSContract tmpContract;
+    if (!tposcontracts.Get(hashContractTx, tmpContract)) {
+        CTransactionRef tx;
+        uint256 hashBlock;
+        // contracts confirmed in the active chain are indexed when their block is connected,
+        // which keeps TPoS blocks verifiable after the contract's block file has been pruned
+        if (!pblocktree->ReadTPoSContractTx(hashContractTx, tx) &&
+                !GetTransaction(hashContractTx, tx, Params().GetConsensus(), hashBlock, true)) {
+            strError = strprintf("%s : failed to get transaction for tpos contract %s", __func__,
+                                 hashContractTx.ToString());
 
-        return error(strError.c_str());
-    }
+            return error(strError.c_str());
+        }
 
-    return CheckContract(tx, contract, nBlockHeight, fCheckSignature, fCheckContractOutpoint, strError);
+        tmpContract = TPoSContract::FromTPoSContractTx(tx);
+        tposcontracts.Add(tmpContract);
+    }
 
+    return CheckContract(tmpContract, contract, nBlockHeight, fCheckSignature, fCheckContractOutpoint, strError);
 }
 
 bool TPoSUtils::CheckContract(const CTransactionRef &txContract, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError)
 {
-    TPoSContract tmpContract = TPoSContract::FromTPoSContractTx(txContract);
+    TPoSContract tmpContract;
+    if (!tposcontracts.Get(txContract->GetHash(), tmpContract)) {
+        tmpContract = TPoSContract::FromTPoSContractTx(txContract);
+    }
+
+    return CheckContract(tmpContract, contract, nBlockHeight, fCheckSignature, fCheckContractOutpoint, strError);
+}
+
+bool TPoSUtils::CheckContractSignature(const TPoSContract &contract, bool fNewSignatures, std::string &strError)
+{
+    if (contract.txContract->vin.empty()) {
+        strError = strprintf("%s : TPoS contract has no inputs", __func__);
+        return false;
+    }
+
+    auto hashMessage = SerializeHash(contract.txContract->vin.front().prevout);
+    std::string strVerifyHashError;
 
+    CTxDestination tposAddress;
+    if(!ExtractDestination(contract.scriptTPoSAddress, tposAddress)) {
+        strError = strprintf("%s : TPoS contract invalid tpos address", __func__);
+        return false;
+    }
+
+    if (fNewSignatures) {
+        auto prevout = contract.txContract->vin.front().prevout;
+        std::string newHashMessage = prevout.hash.ToString() + ":" + std::to_string(prevout.n);
+        if(CMessageSigner::VerifyMessage(tposAddress, contract.vchSig, newHashMessage, strVerifyHashError)) {
+            return true;
+        }
+    }
+
+    if(!CHashSigner::VerifyHash(hashMessage, tposAddress, contract.vchSig, strVerifyHashError)) {
+        strError = strprintf("%s : TPoS contract signature is invalid %s", __func__, strVerifyHashError);
+        return false;
+    }
+
+    return true;
+}
+
+bool TPoSUtils::CheckContract(const TPoSContract &tmpContract, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError)
+{
     if (!tmpContract.IsValid()) {
         strError = "CheckContract() : invalid transaction for tpos contract";
         return error(strError.c_str());
     }
 
+    const uint256 hashContractTx = tmpContract.txContract->GetHash();
+
     if(fCheckSignature)
     {
-        if (tmpContract.txContract->vin.empty()) {
-            return false;
+        // the signature is fixed by the txid, so its check is done once per side of the hard fork
+        bool fNewSignatures = IsTPoSNewSignaturesHardForkActivated(nBlockHeight);
+        bool fValid;
+        if (!tposcontracts.GetSignatureResult(hashContractTx, fNewSignatures, fValid, strError)) {
+            fValid = CheckContractSignature(tmpContract, fNewSignatures, strError);
+            tposcontracts.SetSignatureResult(hashContractTx, fNewSignatures, fValid, strError);
         }
-
-        auto hashMessage = SerializeHash(tmpContract.txContract->vin.front().prevout);
-        std::string strVerifyHashError;
-
-        CTxDestination tposAddress;
-        if(!ExtractDestination(tmpContract.scriptTPoSAddress, tposAddress)) {
-            strError = strprintf("%s : TPoS contract invalid tpos address", __func__);
+        if (!fValid) {
             return error(strError.c_str());
         }
-
-        if (IsTPoSNewSignaturesHardForkActivated(nBlockHeight)) {
-            auto prevout = tmpContract.txContract->vin.front().prevout;
-            std::string newHashMessage = prevout.hash.ToString() + ":" + std::to_string(prevout.n);
-            if(!CMessageSigner::VerifyMessage(tposAddress, tmpContract.vchSig, newHashMessage, strVerifyHashError)) {
-                if(!CHashSigner::VerifyHash(hashMessage, tposAddress, tmpContract.vchSig, strVerifyHashError)) {
-                    strError = strprintf("%s : TPoS contract signature is invalid %s", __func__, strVerifyHashError);
-                    return error(strError.c_str());
-                }
-            }
-        } else {
-            if(!CHashSigner::VerifyHash(hashMessage, tposAddress, tmpContract.vchSig, strVerifyHashError)) {
-                strError = strprintf("%s : TPoS contract signature is invalid %s", __func__, strVerifyHashError);
-                return error(strError.c_str());
-            }
-        }
     }
 
     if(fCheckContractOutpoint)
     {
-        auto tposContractOutpoint = TPoSUtils::GetContractCollateralOutpoint(tmpContract);
-        Coin coin;
-        if(!pcoinsTip->GetCoin(tposContractOutpoint, coin) || coin.IsSpent())
+        // the registry follows the collateral through connected and disconnected blocks once it was looked up
+        LOCK(cs_main);
+        bool fUnspent;
+        if (!tposcontracts.GetCollateralUnspent(hashContractTx, fUnspent)) {
+            auto tposContractOutpoint = TPoSUtils::GetContractCollateralOutpoint(tmpContract);
+            Coin coin;
+            fUnspent = pcoinsTip->GetCoin(tposContractOutpoint, coin) && !coin.IsSpent();
+            tposcontracts.SetCollateralUnspent(tmpContract, fUnspent);
+        }
+        if(!fUnspent)
         {
             strError = "CheckContract() : tpos contract invalid, collateral is spent";
             return error(strError.c_str());
@@ -69,6 +69,8 @@ public:
     static COutPoint GetContractCollateralOutpoint(const TPoSContract &contract);
     static bool CheckContract(const uint256 &hashContractTx, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError);
     static bool CheckContract(const CTransactionRef &txContract, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError);
+    static bool CheckContract(const TPoSContract &parsedContract, TPoSContract &contract, int nBlockHeight, bool fCheckSignature, bool fCheckContractOutpoint, std::string &strError);
+    static bool CheckContractSignature(const TPoSContract &contract, bool fNewSignatures, std::string &strError);
     static bool IsMerchantPaymentValid(CValidationState &state, const CBlock &block, int nBlockHeight, CAmount expectedReward, CAmount actualReward);
 
     static std::vector<unsigned char> GenerateContractPayload(const TPoSContract &contract);
@@ -97,6 +99,8 @@ public:
 
     static bool IsTPoSOwnerContract(CWallet *wallet, const CTransactionRef &tx);
     static bool IsTPoSMerchantContract(CWallet *wallet, const CTransactionRef &tx);
+    static bool IsTPoSOwnerContract(CWallet *wallet, const TPoSContract &contract);
+    static bool IsTPoSMerchantContract(CWallet *wallet, const TPoSContract &contract);
 
     static bool CreateTPoSTransaction(CWallet *wallet,
                                       CTransactionRef &transactionOut,
@@ -30,6 +30,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_TPOS_CONTRACT = 'K';
 
 namespace {
 
@@ -248,6 +249,17 @@ bool CBlockTreeDB::WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos>
     return WriteBatch(batch);
 }
 
+bool CBlockTreeDB::ReadTPoSContractTx(const uint256 &txid, CTransactionRef &tx) {
+    return Read(std::make_pair(DB_TPOS_CONTRACT, txid), tx);
+}
+
+bool CBlockTreeDB::WriteTPoSContractTxs(const std::vector<CTransactionRef> &vtx) {
+    CDBBatch batch(*this);
+    for (const CTransactionRef &tx : vtx)
+        batch.Write(std::make_pair(DB_TPOS_CONTRACT, tx->GetHash()), tx);
+    return WriteBatch(batch);
+}
+
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
 }
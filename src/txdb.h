@@ -120,6 +120,9 @@ public:
     bool ReadReindexing(bool &fReindexing);
     bool ReadTxIndex(const uint256 &txid, CDiskTxPos &pos);
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
+    /** TPoS contract transactions are kept here so that TPoS blocks can be checked without the block files */
+    bool ReadTPoSContractTx(const uint256 &txid, CTransactionRef &tx);
+    bool WriteTPoSContractTxs(const std::vector<CTransactionRef> &vtx);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
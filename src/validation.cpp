@@ -18,6 +18,8 @@
 #include <hash.h>
 #include <index/txindex.h>
 #include <init.h>
+#include <memusage.h>
+#include <perfstats.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/rbf.h>
@@ -29,6 +31,7 @@
 #include <script/script.h>
 #include <script/sigcache.h>
 #include <script/standard.h>
+#include <support/allocators/arena.h>
 #include <timedata.h>
 #include <tinyformat.h>
 #include <txdb.h>
@@ -44,9 +47,11 @@
 #include <masternode-payments.h>
 #include <blocksigner.h>
 #include <tpos/tposutils.h>
+#include <tpos/tposcontractregistry.h>
 
 #include <future>
 #include <sstream>
+#include <type_traits>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -61,6 +66,9 @@
 
 static std::map<uint256, uint256> mapProofOfStake;
 
+/** Block index entries are allocated in chunks of this many bytes */
+static const size_t BLOCK_INDEX_ARENA_CHUNK_SIZE = 1 << 20;
+
 /**
  * Global state
  */
@@ -154,6 +162,12 @@ private:
 public:
     CChain chainActive;
     BlockMap mapBlockIndex;
+    /**
+     * Backing memory of the entries in mapBlockIndex. Entries are carved out
+     * of large chunks instead of being heap allocated one by one, and are only
+     * released all at once by UnloadBlockIndex.
+     */
+    std::unique_ptr<MonotonicArena> m_block_index_arena{new MonotonicArena(BLOCK_INDEX_ARENA_CHUNK_SIZE)};
     std::multimap<CBlockIndex*, CBlockIndex*> mapBlocksUnlinked;
     CBlockIndex *pindexBestInvalid = nullptr;
 
@@ -196,8 +210,21 @@ private:
     bool ConnectTip(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, DisconnectedBlockTransactions &disconnectpool);
 
     CBlockIndex* AddToBlockIndex(const CBlockHeader& block);
+
+public:
     /** Create a new block index entry for a given block hash */
     CBlockIndex * InsertBlockIndex(const uint256& hash);
+
+    /** Construct a block index entry in m_block_index_arena */
+    template <typename... Args>
+    CBlockIndex* NewBlockIndex(Args&&... args)
+    {
+        // CBlockIndex is trivially destructible, so entries can be dropped with the arena
+        static_assert(std::is_trivially_destructible<CBlockIndex>::value, "CBlockIndex must not need a destructor");
+        return new (m_block_index_arena->Allocate(sizeof(CBlockIndex))) CBlockIndex(std::forward<Args>(args)...);
+    }
+
+private:
     /**
      * Make various assertions about the state of the block index.
      *
@@ -1113,7 +1140,7 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fTxArena)
 {
     block.SetNull();
 
@@ -1124,7 +1151,12 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
 
     // Read block
     try {
-        filein >> block;
+        if (fTxArena) {
+            BlockTxArenaReader reader(block);
+            filein >> reader;
+        } else {
+            filein >> block;
+        }
     }
     catch (const std::exception& e) {
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
@@ -1137,7 +1169,7 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fTxArena)
 {
     CDiskBlockPos blockPos;
     {
@@ -1145,7 +1177,7 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
         blockPos = pindex->GetBlockPos();
     }
 
-    if (!ReadBlockFromDisk(block, blockPos, consensusParams))
+    if (!ReadBlockFromDisk(block, blockPos, consensusParams, fTxArena))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
@@ -1367,6 +1399,21 @@ int GetSpendHeight(const CCoinsViewCache& inputs)
 
 static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
 static uint256 scriptExecutionCacheNonce(GetRandHash());
+static uint64_t nScriptCacheHits = 0;
+static uint64_t nScriptCacheMisses = 0;
+
+static CScriptCacheStats scriptCacheStatsLastBlock;
+static CScriptCacheStats scriptCacheStatsTotal;
+
+static uint256 GetScriptExecutionCacheEntry(const CTransaction& tx, unsigned int flags)
+{
+    uint256 hashCacheEntry;
+    // We only use the first 19 bytes of nonce to avoid a second SHA
+    // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
+    static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
+    CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+    return hashCacheEntry;
+}
 
 void InitScriptExecutionCache() {
     // nMaxCacheSize is unsigned. If -maxsigcachesize is set to zero,
@@ -1379,6 +1426,115 @@ void InitScriptExecutionCache() {
 
 
 
+void GetScriptCacheStats(CScriptCacheStats& lastBlock, CScriptCacheStats& total)
+{
+    LOCK(cs_main);
+    lastBlock = scriptCacheStatsLastBlock;
+    total = scriptCacheStatsTotal;
+}
+
+// Mempool transactions that failed verification with nScriptCacheWarmupFlags
+static CCriticalSection cs_scriptCacheWarmup;
+static unsigned int nScriptCacheWarmupFlags = 0;
+static std::set<uint256> setScriptCacheWarmupFailed;
+// Set on every new tip, cleared once a pass finds the next block keeps the flags of the tip
+static std::atomic<bool> fScriptCacheWarmupNeeded(true);
+
+void WarmScriptCacheFromMempool(const CChainParams& chainparams, unsigned int nMaxTxs)
+{
+    // Only the blocks right before a deployment activates bring new flags
+    if (!fScriptCacheWarmupNeeded)
+        return;
+
+    LOCK(cs_scriptCacheWarmup);
+
+    unsigned int flags;
+    const CBlockIndex* pindexTip;
+    std::vector<std::pair<CTransactionRef, std::vector<CTxOut>>> vCandidates;
+    {
+        LOCK2(cs_main, mempool.cs);
+        pindexTip = chainActive.Tip();
+        if (IsInitialBlockDownload() || pindexTip == nullptr)
+            return;
+
+        // Script flags of a new block on top of the current tip
+        CBlockIndex indexDummy;
+        indexDummy.pprev = chainActive.Tip();
+        indexDummy.nHeight = chainActive.Height() + 1;
+        flags = GetBlockScriptFlags(&indexDummy, chainparams.GetConsensus());
+
+        // AcceptToMemoryPool already cached the results with the flags of the tip,
+        // there is only something to do when the next block brings new flags
+        if (flags == GetBlockScriptFlags(pindexTip, chainparams.GetConsensus())) {
+            fScriptCacheWarmupNeeded = false;
+            return;
+        }
+
+        if (flags != nScriptCacheWarmupFlags || setScriptCacheWarmupFailed.size() > SCRIPT_CACHE_WARMUP_MAX_FAILED) {
+            nScriptCacheWarmupFlags = flags;
+            setScriptCacheWarmupFailed.clear();
+        }
+
+        CCoinsView viewDummy;
+        CCoinsViewCache view(&viewDummy);
+        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), mempool);
+        view.SetBackend(viewMemPool);
+
+        for (const CTxMemPoolEntry& entry : mempool.mapTx) {
+            if (vCandidates.size() >= nMaxTxs)
+                break;
+            const CTransactionRef& tx = entry.GetSharedTx();
+            if (tx->IsCoinBase() || tx->IsCoinStake())
+                continue;
+            if (setScriptCacheWarmupFailed.count(tx->GetWitnessHash()))
+                continue;
+            if (scriptExecutionCache.contains(GetScriptExecutionCacheEntry(*tx, flags), false))
+                continue;
+
+            std::vector<CTxOut> vSpent;
+            for (const CTxIn& txin : tx->vin) {
+                const Coin& coin = view.AccessCoin(txin.prevout);
+                if (coin.IsSpent())
+                    break;
+                vSpent.push_back(coin.out);
+            }
+            if (vSpent.size() == tx->vin.size())
+                vCandidates.emplace_back(tx, std::move(vSpent));
+        }
+    }
+
+    // Verify without cs_main, the signature cache has its own lock
+    std::vector<uint256> vVerified;
+    for (const auto& candidate : vCandidates) {
+        const CTransaction& tx = *candidate.first;
+        PrecomputedTransactionData txdata(tx);
+        bool fValid = true;
+        for (unsigned int i = 0; i < tx.vin.size() && fValid; i++) {
+            // Lookups are left out of the signature cache stats, they would be
+            // attributed to whichever block is being connected meanwhile
+            CachingTransactionSignatureChecker checker(&tx, i, candidate.second[i].nValue, true, txdata, false);
+            fValid = VerifyScript(tx.vin[i].scriptSig, candidate.second[i].scriptPubKey, &tx.vin[i].scriptWitness, flags, checker);
+        }
+        // Failures are left to block validation, they are not verified again with these flags
+        if (fValid)
+            vVerified.push_back(GetScriptExecutionCacheEntry(tx, flags));
+        else
+            setScriptCacheWarmupFailed.insert(tx.GetWitnessHash());
+    }
+
+    if (vVerified.empty())
+        return;
+
+    LOCK(cs_main);
+    // The results only hold for the flags they were verified with
+    if (chainActive.Tip() != pindexTip)
+        return;
+    for (const uint256& hashCacheEntry : vVerified)
+        scriptExecutionCache.insert(hashCacheEntry);
+    scriptCacheStatsTotal.nWarmedTxs += vVerified.size();
+    LogPrint(BCLog::BENCH, "%s: verified %u of %u mempool txs with next block flags\n", __func__, vVerified.size(), vCandidates.size());
+}
+
 void ReprocessBlocks(int nBlocks)
 {
     {
@@ -1425,15 +1581,13 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
             // correct (ie that the transaction hash which is in tx's prevouts
             // properly commits to the scriptPubKey in the inputs view of that
             // transaction).
-            uint256 hashCacheEntry;
-            // We only use the first 19 bytes of nonce to avoid a second SHA
-            // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
-            static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
-            CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+            uint256 hashCacheEntry = GetScriptExecutionCacheEntry(tx, flags);
             AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
             if (scriptExecutionCache.contains(hashCacheEntry, !cacheFullScriptStore)) {
+                nScriptCacheHits++;
                 return true;
             }
+            nScriptCacheMisses++;
 
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
                 const COutPoint &prevout = tx.vin[i].prevout;
@@ -1518,7 +1672,9 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
-static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
+} // namespace
+
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
 {
     CDiskBlockPos pos = pindex->GetUndoPos();
     if (pos.IsNull()) {
@@ -1549,6 +1705,8 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     return true;
 }
 
+namespace {
+
 /** Abort with a message */
 static bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
 {
@@ -1864,6 +2022,13 @@ static int64_t nTimeCallbacks = 0;
 static int64_t nTimeTotal = 0;
 static int64_t nBlocksTotal = 0;
 
+static CPerfCounter& perfConnectChecks = GetPerfCounter("connectblock.checks");
+static CPerfCounter& perfConnectForks = GetPerfCounter("connectblock.forks");
+static CPerfCounter& perfConnectTxs = GetPerfCounter("connectblock.connect");
+static CPerfCounter& perfConnectVerify = GetPerfCounter("connectblock.verify");
+static CPerfCounter& perfConnectIndex = GetPerfCounter("connectblock.index");
+static CPerfCounter& perfConnectCallbacks = GetPerfCounter("connectblock.callbacks");
+
 /** Apply the effects of this block (with given index) on the UTXO set represented by coins.
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
@@ -1948,6 +2113,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     }
 
     int64_t nTime1 = GetTimeMicros(); nTimeCheck += nTime1 - nTimeStart;
+    perfConnectChecks.Add(nTime1 - nTimeStart);
     LogPrint(BCLog::BENCH, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime1 - nTimeStart), nTimeCheck * MICRO, nTimeCheck * MILLI / nBlocksTotal);
 
     // Do not allow blocks that contain transactions which 'overwrite' older transactions,
@@ -2050,10 +2216,16 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     unsigned int flags = GetBlockScriptFlags(pindex, chainparams.GetConsensus());
 
     int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
+    perfConnectForks.Add(nTime2 - nTime1);
     LogPrint(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), nTimeForks * MICRO, nTimeForks * MILLI / nBlocksTotal);
 
     CBlockUndo blockundo;
 
+    uint64_t nSigCacheHitsStart, nSigCacheMissesStart;
+    GetSignatureCacheStats(nSigCacheHitsStart, nSigCacheMissesStart);
+    uint64_t nScriptCacheHitsStart = nScriptCacheHits;
+    uint64_t nScriptCacheMissesStart = nScriptCacheMisses;
+
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
 
     std::vector<int> prevheights;
@@ -2142,6 +2314,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     pindex->nMint = pindex->nMoneySupply - nMoneySupplyPrev;
 
     int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
+    perfConnectTxs.Add(nTime3 - nTime2);
     LogPrint(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * MICRO, nTimeConnect * MILLI / nBlocksTotal);
 
     // XSN : MODIFIED TO CHECK MASTERNODE PAYMENTS AND SUPERBLOCKS
@@ -2177,11 +2350,29 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
+    perfConnectVerify.Add(nTime4 - nTime2);
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
 
     if (fJustCheck)
         return true;
 
+    CScriptCacheStats& cacheStats = scriptCacheStatsLastBlock;
+    GetSignatureCacheStats(cacheStats.nSigCacheHits, cacheStats.nSigCacheMisses);
+    cacheStats.nHeight = pindex->nHeight;
+    cacheStats.hashBlock = block.GetHash();
+    cacheStats.nSigCacheHits -= nSigCacheHitsStart;
+    cacheStats.nSigCacheMisses -= nSigCacheMissesStart;
+    cacheStats.nScriptCacheHits = nScriptCacheHits - nScriptCacheHitsStart;
+    cacheStats.nScriptCacheMisses = nScriptCacheMisses - nScriptCacheMissesStart;
+    scriptCacheStatsTotal.nHeight = cacheStats.nHeight;
+    scriptCacheStatsTotal.hashBlock = cacheStats.hashBlock;
+    scriptCacheStatsTotal.nSigCacheHits += cacheStats.nSigCacheHits;
+    scriptCacheStatsTotal.nSigCacheMisses += cacheStats.nSigCacheMisses;
+    scriptCacheStatsTotal.nScriptCacheHits += cacheStats.nScriptCacheHits;
+    scriptCacheStatsTotal.nScriptCacheMisses += cacheStats.nScriptCacheMisses;
+    LogPrint(BCLog::BENCH, "    - Script cache: sigcache %u hits, %u misses; script execution cache %u hits, %u misses\n",
+             cacheStats.nSigCacheHits, cacheStats.nSigCacheMisses, cacheStats.nScriptCacheHits, cacheStats.nScriptCacheMisses);
+
     if (!WriteUndoDataForBlock(blockundo, state, pindex, chainparams))
         return false;
 
@@ -2196,14 +2387,25 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         }
     }
 
+    std::vector<CTransactionRef> vTPoSContracts;
+    for (const auto& tx : block.vtx) {
+        if (TPoSUtils::IsTPoSContract(tx))
+            vTPoSContracts.push_back(tx);
+    }
+    if (!vTPoSContracts.empty() && !pblocktree->WriteTPoSContractTxs(vTPoSContracts)) {
+        return AbortNode(state, "Failed to write TPoS contract index");
+    }
+
     assert(pindex->phashBlock);
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
 
     int64_t nTime5 = GetTimeMicros(); nTimeIndex += nTime5 - nTime4;
+    perfConnectIndex.Add(nTime5 - nTime4);
     LogPrint(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5 - nTime4), nTimeIndex * MICRO, nTimeIndex * MILLI / nBlocksTotal);
 
     int64_t nTime6 = GetTimeMicros(); nTimeCallbacks += nTime6 - nTime5;
+    perfConnectCallbacks.Add(nTime6 - nTime5);
     LogPrint(BCLog::BENCH, "    - Callbacks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime6 - nTime5), nTimeCallbacks * MICRO, nTimeCallbacks * MILLI / nBlocksTotal);
 
     return true;
@@ -2219,6 +2421,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
  * besides checking if we need to prune.
  */
 bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &state, FlushStateMode mode, int nManualPruneHeight) {
+    PERF_SCOPE("flushstatetodisk");
     int64_t nMempoolUsage = mempool.DynamicMemoryUsage();
     LOCK(cs_main);
     static int64_t nLastWrite = 0;
@@ -2433,6 +2636,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
         bool flushed = view.Flush();
         assert(flushed);
+        tposcontracts.BlockDisconnected(block);
     }
     LogPrint(BCLog::BENCH, "- Disconnect block: %.2fms\n", (GetTimeMicros() - nStart) * MILLI);
     // Write the chain state to disk, if necessary.
@@ -2484,6 +2688,8 @@ static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
 static int64_t nTimePostConnect = 0;
 
+static CPerfCounter& perfConnectTip = GetPerfCounter("connecttip.total");
+
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
     std::shared_ptr<const CBlock> pblock;
@@ -2587,6 +2793,8 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
         LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
         bool flushed = view.Flush();
         assert(flushed);
+        // the contract registry follows pcoinsTip, unlike ConnectBlock it is not run for VerifyDB
+        tposcontracts.BlockConnected(blockConnecting);
     }
     int64_t nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
     LogPrint(BCLog::BENCH, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, nTimeFlush * MICRO, nTimeFlush * MILLI / nBlocksTotal);
@@ -2603,6 +2811,7 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     UpdateTip(pindexNew, chainparams);
 
     int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
+    perfConnectTip.Add(nTime6 - nTime1);
     LogPrint(BCLog::BENCH, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime5) * MILLI, nTimePostConnect * MICRO, nTimePostConnect * MILLI / nBlocksTotal);
     LogPrint(BCLog::BENCH, "- Connect block: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime1) * MILLI, nTimeTotal * MICRO, nTimeTotal * MILLI / nBlocksTotal);
 
@@ -2853,6 +3062,9 @@ bool CChainState::ActivateBestChain(CValidationState &state, const CChainParams&
             // Enqueue while holding cs_main to ensure that UpdatedBlockTip is called in the order in which blocks are connected
             GetMainSignals().UpdatedBlockTip(pindexNewTip, pindexFork, fInitialDownload);
 
+            if (pindexFork != pindexNewTip)
+                fScriptCacheWarmupNeeded = true;
+
             // Always notify the UI if a new block tip was connected
             if (pindexFork != pindexNewTip) {
                 uiInterface.NotifyBlockTip(fInitialDownload, pindexNewTip);
@@ -3037,9 +3249,6 @@ static void AcceptProofOfStakeBlock(const CBlock &block, CBlockIndex *pindexNew,
     //update previous block pointer
     //        pindexNew->pprev->pnext = pindexNew;
 
-    // ppcoin: compute chain trust score
-    pindexNew->bnChainTrust = (pindexNew->pprev ? pindexNew->pprev->bnChainTrust : ArithToUint256(0 + pindexNew->GetBlockTrust()));
-
     // ppcoin: compute stake entropy bit for stake modifier
     if (!pindexNew->SetStakeEntropyBit(pindexNew->GetStakeEntropyBit()))
         LogPrintf("AcceptProofOfStakeBlock() : SetStakeEntropyBit() failed \n");
@@ -3086,7 +3295,7 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         return it->second;
 
     // Construct new block index object
-    CBlockIndex* pindexNew = new CBlockIndex(block);
+    CBlockIndex* pindexNew = NewBlockIndex(block);
     // We assign the sequence id to blocks only when the full data is available,
     // to avoid miners withholding blocks but broadcasting headers, to get a
     // competitive advantage.
@@ -3251,8 +3460,16 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
 static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
 {
     // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetHash(), block.nBits, consensusParams))
-        return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+    if (fCheckPOW) {
+        uint256 hash;
+        {
+            // HashX11 lives in the consensus library, time it where the node checks headers
+            PERF_SCOPE("hashx11.checkblockheader");
+            hash = block.GetHash();
+        }
+        if (!CheckProofOfWork(hash, block.nBits, consensusParams))
+            return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+    }
 
     return true;
 }
@@ -3749,7 +3966,11 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
 
     if(block.IsProofOfStake())
     {
-        if(!CheckProofOfStake(pindex->pprev, block, hashProofOfStake, chainparams.GetConsensus())) {
+        bool fMissingInputs = false;
+        if(!CheckProofOfStake(pindex->pprev, block, hashProofOfStake, chainparams.GetConsensus(), &fMissingInputs)) {
+            // not the block's fault if we can't look up its kernel, e.g. its parent isn't stored yet
+            if (fMissingInputs)
+                return error("AcceptBlock(): kernel input of block %s is not available\n", hash.ToString().c_str());
             return state.DoS(100, error("AcceptBlock(): check proof-of-stake failed for block %s\n", hash.ToString().c_str()),
                              REJECT_INVALID);
         }
@@ -4070,7 +4291,7 @@ CBlockIndex * CChainState::InsertBlockIndex(const uint256& hash)
         return (*mi).second;
 
     // Create new
-    CBlockIndex* pindexNew = new CBlockIndex();
+    CBlockIndex* pindexNew = NewBlockIndex();
     mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
     pindexNew->phashBlock = &((*mi).first);
 
@@ -4523,6 +4744,21 @@ void CChainState::UnloadBlockIndex() {
     nBlockSequenceId = 1;
     m_failed_blocks.clear();
     setBlockIndexCandidates.clear();
+    mapBlockIndex.clear();
+    m_block_index_arena.reset(new MonotonicArena(BLOCK_INDEX_ARENA_CHUNK_SIZE));
+}
+
+CBlockIndex* InsertBlockIndex(const uint256& hash)
+{
+    return g_chainstate.InsertBlockIndex(hash);
+}
+
+void GetBlockIndexMemoryUsage(size_t& nEntries, size_t& nArenaBytes, size_t& nMapBytes)
+{
+    LOCK(cs_main);
+    nEntries = mapBlockIndex.size();
+    nArenaBytes = g_chainstate.m_block_index_arena->AllocatedBytes();
+    nMapBytes = memusage::DynamicUsage(mapBlockIndex);
 }
 
 // May NOT be used after any connections are up as much
@@ -4541,14 +4777,11 @@ void UnloadBlockIndex()
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
     versionbitscache.Clear();
+    tposcontracts.Clear();
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
     }
 
-    for (BlockMap::value_type& entry : mapBlockIndex) {
-        delete entry.second;
-    }
-    mapBlockIndex.clear();
     fHavePruned = false;
 
     g_chainstate.UnloadBlockIndex();
@@ -4609,13 +4842,16 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return g_chainstate.LoadGenesisBlock(chainparams);
 }
 
-bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
-{
-    // Map of disk positions for blocks with unknown parent (only used for reindex)
-    static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
-    int64_t nStart = GetTimeMillis();
+/** Map of disk positions for blocks with unknown parent (only used for reindex) */
+static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
 
-    int nLoaded = 0;
+/**
+ * Locate the blocks in a block file and hand each one to fn together with
+ * its position in the file. Stops at the end of the file or when fn returns
+ * false. Takes over fileIn.
+ */
+static void ScanBlockFile(const CChainParams& chainparams, FILE* fileIn, const std::function<bool(const std::shared_ptr<CBlock>&, uint64_t, unsigned int)>& fn)
+{
     try {
         // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
         CBufferedFile blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION);
@@ -4646,91 +4882,285 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
             try {
                 // read block
                 uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
                 blkdat.SetLimit(nBlockPos + nSize);
                 blkdat.SetPos(nBlockPos);
                 std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-                CBlock& block = *pblock;
-                blkdat >> block;
+                blkdat >> *pblock;
                 nRewind = blkdat.GetPos();
 
-                uint256 hash = block.GetHash();
-                {
-                    LOCK(cs_main);
-                    // detect out of order blocks, and store them for later
-                    if (hash != chainparams.GetConsensus().hashGenesisBlock && !LookupBlockIndex(block.hashPrevBlock)) {
-                        LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                                 block.hashPrevBlock.ToString());
-                        if (dbp)
-                            mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
-                        continue;
-                    }
+                if (!fn(pblock, nBlockPos, nSize))
+                    break;
+            } catch (const std::exception& e) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        AbortNode(std::string("System error: ") + e.what());
+    }
+}
 
-                    // process in case the block isn't known yet
-                    CBlockIndex* pindex = LookupBlockIndex(hash);
-                    if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                        CValidationState state;
-                        if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr)) {
-                            nLoaded++;
-                        }
-                        if (state.IsError()) {
-                            break;
-                        }
-                    } else if (hash != chainparams.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
-                        LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
-                    }
+/**
+ * Accept a block read from a block file and connect whatever it makes
+ * connectable, including earlier encountered children of it. Returns false
+ * if importing the rest of the file should be given up.
+ */
+static bool ImportBlock(const CChainParams& chainparams, const std::shared_ptr<CBlock>& pblock, CDiskBlockPos* dbp, int& nLoaded)
+{
+    const CBlock& block = *pblock;
+    uint256 hash = block.GetHash();
+    {
+        LOCK(cs_main);
+        // detect out of order blocks, and store them for later
+        if (hash != chainparams.GetConsensus().hashGenesisBlock && !LookupBlockIndex(block.hashPrevBlock)) {
+            LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                     block.hashPrevBlock.ToString());
+            if (dbp)
+                mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+            return true;
+        }
 
-                }
+        // process in case the block isn't known yet
+        CBlockIndex* pindex = LookupBlockIndex(hash);
+        if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+            CValidationState state;
+            if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr)) {
+                nLoaded++;
+            }
+            if (state.IsError()) {
+                return false;
+            }
+        } else if (hash != chainparams.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+            LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
+        }
 
-                {
-                    CValidationState state;
-                    if (!ActivateBestChain(state, chainparams)) {
-                        break;
-                    }
-                }
+    }
 
-                NotifyHeaderTip();
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
-                        {
-                            LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
-                                     head.ToString());
-                            LOCK(cs_main);
-                            CValidationState dummy;
-                            if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr))
-                            {
-                                nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
-                            }
-                        }
-                        range.first++;
-                        mapBlocksUnknownParent.erase(it);
-                        NotifyHeaderTip();
-                    }
+    {
+        CValidationState state;
+        if (!ActivateBestChain(state, chainparams)) {
+            return false;
+        }
+    }
+
+    NotifyHeaderTip();
+
+    // Recursively process earlier encountered successors of this block
+    std::deque<uint256> queue;
+    queue.push_back(hash);
+    while (!queue.empty()) {
+        uint256 head = queue.front();
+        queue.pop_front();
+        std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
+        while (range.first != range.second) {
+            std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
+            std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+            if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
+            {
+                LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
+                         head.ToString());
+                LOCK(cs_main);
+                CValidationState dummy;
+                if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr))
+                {
+                    nLoaded++;
+                    queue.push_back(pblockrecursive->GetHash());
                 }
-            } catch (const std::exception& e) {
-                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
             }
+            range.first++;
+            mapBlocksUnknownParent.erase(it);
+            NotifyHeaderTip();
         }
-    } catch (const std::runtime_error& e) {
-        AbortNode(std::string("System error: ") + e.what());
     }
+    return true;
+}
+
+bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
+{
+    int64_t nStart = GetTimeMillis();
+
+    int nLoaded = 0;
+    ScanBlockFile(chainparams, fileIn, [&](const std::shared_ptr<CBlock>& pblock, uint64_t nBlockPos, unsigned int nSize) {
+        if (dbp)
+            dbp->nPos = nBlockPos;
+        return ImportBlock(chainparams, pblock, dbp, nLoaded);
+    });
     if (nLoaded > 0)
         LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
     return nLoaded > 0;
 }
 
+namespace {
+
+/** Serialized size of the blocks a reader may queue ahead of the import thread, per file */
+static const size_t IMPORT_QUEUE_MAX_BYTES = 4 * MAX_BLOCK_SERIALIZED_SIZE;
+
+/**
+ * Blocks read from one file by a reader thread, waiting to be accepted by
+ * the import thread. Bounded so that readers running ahead of the import
+ * thread don't hold more than a few blocks per file in memory.
+ */
+class CImportFileQueue
+{
+private:
+    struct QueuedBlock {
+        std::shared_ptr<CBlock> pblock;
+        uint64_t nBlockPos;
+        unsigned int nSize;
+    };
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    std::deque<QueuedBlock> queue;
+    size_t nQueuedBytes = 0;
+    bool fDone = false;
+    bool fAbandoned = false;
+
+public:
+    /** Queue a block; returns false if the import thread no longer wants blocks from this file */
+    bool Push(const std::shared_ptr<CBlock>& pblock, uint64_t nBlockPos, unsigned int nSize)
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while (!fAbandoned && !queue.empty() && nQueuedBytes + nSize > IMPORT_QUEUE_MAX_BYTES)
+            cond.wait(lock);
+        if (fAbandoned)
+            return false;
+        queue.push_back(QueuedBlock{pblock, nBlockPos, nSize});
+        nQueuedBytes += nSize;
+        cond.notify_all();
+        return true;
+    }
+
+    /** Mark that no more blocks will be queued */
+    void Finish()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fDone = true;
+        cond.notify_all();
+    }
+
+    /** Drop queued blocks and make the reader stop */
+    void Abandon()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fAbandoned = true;
+        queue.clear();
+        nQueuedBytes = 0;
+        cond.notify_all();
+    }
+
+    /** Wait for the next block of the file; returns false once the file has been read completely */
+    bool Pop(std::shared_ptr<CBlock>& pblock, uint64_t& nBlockPos)
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while (queue.empty() && !fDone)
+            cond.wait(lock);
+        if (queue.empty())
+            return false;
+        pblock = std::move(queue.front().pblock);
+        nBlockPos = queue.front().nBlockPos;
+        nQueuedBytes -= queue.front().nSize;
+        queue.pop_front();
+        cond.notify_all();
+        return true;
+    }
+};
+
+/** Reader thread: claims files in order, deserializes and context-free checks their blocks */
+void ThreadReadBlockFiles(const CChainParams& chainparams, const std::vector<fs::path>& vFiles, std::vector<CImportFileQueue>& vQueues, std::atomic<size_t>& nNextFile)
+{
+    while (true) {
+        size_t nFile = nNextFile++;
+        if (nFile >= vFiles.size())
+            return;
+        CImportFileQueue& queue = vQueues[nFile];
+        FILE* file = fsbridge::fopen(vFiles[nFile], "rb");
+        if (!file) {
+            LogPrintf("Warning: Could not open blocks file %s\n", vFiles[nFile].string());
+            queue.Finish();
+            continue;
+        }
+        ScanBlockFile(chainparams, file, [&](const std::shared_ptr<CBlock>& pblock, uint64_t nBlockPos, unsigned int nSize) {
+            // Sets fChecked on success so AcceptBlock doesn't redo the work
+            // under cs_main. A failing block is checked again there, which
+            // records the failure in the block index as before.
+            CValidationState state;
+            CheckBlock(*pblock, state, chainparams.GetConsensus());
+            return queue.Push(pblock, nBlockPos, nSize);
+        });
+        queue.Finish();
+    }
+}
+
+} // namespace
+
+void LoadExternalBlockFiles(const CChainParams& chainparams, const std::vector<fs::path>& vFiles, bool fBlockFiles, int nThreads)
+{
+    if (nThreads <= 1) {
+        for (size_t nFile = 0; nFile < vFiles.size(); nFile++) {
+            CDiskBlockPos pos(nFile, 0);
+            FILE* file = fsbridge::fopen(vFiles[nFile], "rb");
+            if (!file) {
+                LogPrintf("Warning: Could not open blocks file %s\n", vFiles[nFile].string());
+                continue;
+            }
+            if (fBlockFiles)
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+            else
+                LogPrintf("Importing blocks file %s...\n", vFiles[nFile].string());
+            LoadExternalBlockFile(chainparams, file, fBlockFiles ? &pos : nullptr);
+        }
+        return;
+    }
+
+    std::vector<CImportFileQueue> vQueues(vFiles.size());
+    std::atomic<size_t> nNextFile(0);
+    boost::thread_group readerThreads;
+    for (int i = 0; i < nThreads && (size_t)i < vFiles.size(); i++) {
+        readerThreads.create_thread([&chainparams, &vFiles, &vQueues, &nNextFile, i] {
+            RenameThread(strprintf("xsn-loadblk.%d", i).c_str());
+            ThreadReadBlockFiles(chainparams, vFiles, vQueues, nNextFile);
+        });
+    }
+
+    try {
+        for (size_t nFile = 0; nFile < vFiles.size(); nFile++) {
+            if (fBlockFiles)
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+            else
+                LogPrintf("Importing blocks file %s...\n", vFiles[nFile].string());
+
+            int64_t nStart = GetTimeMillis();
+            int nLoaded = 0;
+            CDiskBlockPos pos(nFile, 0);
+            std::shared_ptr<CBlock> pblock;
+            uint64_t nBlockPos;
+            while (vQueues[nFile].Pop(pblock, nBlockPos)) {
+                boost::this_thread::interruption_point();
+                pos.nPos = nBlockPos;
+                bool fContinue;
+                try {
+                    fContinue = ImportBlock(chainparams, pblock, fBlockFiles ? &pos : nullptr, nLoaded);
+                } catch (const std::exception& e) {
+                    LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+                    fContinue = true;
+                }
+                if (!fContinue) {
+                    vQueues[nFile].Abandon();
+                    break;
+                }
+            }
+            if (nLoaded > 0)
+                LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
+        }
+    } catch (...) {
+        // Readers may be waiting on full queues
+        readerThreads.interrupt_all();
+        readerThreads.join_all();
+        throw;
+    }
+    readerThreads.join_all();
+}
+
 void CChainState::CheckBlockIndex(const Consensus::Params& consensusParams)
 {
     if (!fCheckBlockIndex) {
@@ -5098,10 +5528,7 @@ class CMainCleanup
 public:
     CMainCleanup() {}
     ~CMainCleanup() {
-        // block headers
-        BlockMap::iterator it1 = mapBlockIndex.begin();
-        for (; it1 != mapBlockIndex.end(); it1++)
-            delete (*it1).second;
+        // block headers; the entries themselves are owned by the block index arena
         mapBlockIndex.clear();
     }
 } instance_of_cmaincleanup;
@@ -33,6 +33,7 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
 class CChainParams;
 class CCoinsViewDB;
 class CInv;
@@ -81,6 +82,10 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Maximum number of block file reader threads used for -reindex and -loadblock */
+static const int MAX_LOADBLOCK_THREADS = 16;
+/** -loadblockthreads default (number of block file reader threads, 0 = auto) */
+static const int DEFAULT_LOADBLOCK_THREADS = 0;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -131,6 +136,14 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = true;
+/** Default for -scriptcachewarmup */
+static const bool DEFAULT_SCRIPT_CACHE_WARMUP = true;
+/** Maximum number of mempool transactions verified per script cache warmup pass */
+static const unsigned int SCRIPT_CACHE_WARMUP_BATCH = 200;
+/** Interval in milliseconds between script cache warmup passes */
+static const int64_t SCRIPT_CACHE_WARMUP_INTERVAL = 2000;
+/** Mempool transactions remembered as failing the next block flags before starting over */
+static const size_t SCRIPT_CACHE_WARMUP_MAX_FAILED = 10000;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
@@ -262,8 +275,20 @@ bool CheckDiskSpace(uint64_t nAdditionalBytes = 0, bool blocks_dir = false);
 FILE* OpenBlockFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 /** Translation to a filesystem path */
 fs::path GetBlockPosFilename(const CDiskBlockPos &pos, const char *prefix);
+/** Create a new block index entry for a given block hash, or return the existing one */
+CBlockIndex* InsertBlockIndex(const uint256& hash);
+/** Memory held by the block index: number of entries, bytes of entries in the arena, and bytes of mapBlockIndex itself */
+void GetBlockIndexMemoryUsage(size_t& nEntries, size_t& nArenaBytes, size_t& nMapBytes);
 /** Import blocks from an external file */
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp = nullptr);
+/**
+ * Import blocks from several files. Up to nThreads threads read the files
+ * and check their blocks independently of context, while the calling thread
+ * accepts and connects them in file order. With fBlockFiles the files are
+ * this node's own blk?????.dat files starting at blk00000.dat, and block
+ * positions are recorded in the index (reindex).
+ */
+void LoadExternalBlockFiles(const CChainParams& chainparams, const std::vector<fs::path>& vFiles, bool fBlockFiles, int nThreads);
 /** Ensures we have a genesis block in the block tree, possibly writing one to disk. */
 bool LoadGenesisBlock(const CChainParams& chainparams);
 /** Load the block tree and coins database from disk,
@@ -396,11 +421,40 @@ public:
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
+/** Signature cache and script execution cache lookups of connected blocks */
+struct CScriptCacheStats
+{
+    int nHeight = -1;
+    uint256 hashBlock;
+    uint64_t nSigCacheHits = 0;
+    uint64_t nSigCacheMisses = 0;
+    uint64_t nScriptCacheHits = 0;
+    uint64_t nScriptCacheMisses = 0;
+    /** Mempool transactions verified ahead of time by the warmup pass */
+    uint64_t nWarmedTxs = 0;
+};
+
+/** Cache lookups of the last connected block, and totals over all blocks connected since startup */
+void GetScriptCacheStats(CScriptCacheStats& lastBlock, CScriptCacheStats& total);
+
+/**
+ * Verify up to nMaxTxs mempool transactions with the script flags the next
+ * block will be validated with, so that their results are in the script
+ * execution and signature caches by the time that block is connected. Does
+ * nothing unless the next block's flags differ from those of the tip, which
+ * AcceptToMemoryPool caches with; that is checked once per new tip. Inputs are
+ * looked up under cs_main, the scripts are verified without it, and the
+ * signature cache lookups are not counted in the per-block cache stats.
+ */
+void WarmScriptCacheFromMempool(const CChainParams& chainparams, unsigned int nMaxTxs);
+
 void ReprocessBlocks(int nBlocks);
 
 /** Functions for disk access for blocks */
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** With fTxArena, the block's transactions are allocated from a per-block arena (see BlockTxArenaReader) */
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fTxArena = false);
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fTxArena = false);
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -16,17 +16,43 @@
 #include <list>
 #include <atomic>
 #include <future>
+#include <set>
 
 #include <boost/signals2/signal.hpp>
 
+/**
+ * Background callbacks for one subscriber. With more than one scheduler
+ * thread every subscriber has its own queue, so that a slow one (say, a wallet
+ * rescanning a block) only delays itself and the queues are worked off in
+ * parallel; each subscriber still sees events in the order they were
+ * signalled. With a single thread all subscribers share one queue, which
+ * keeps the order of events across subscribers as well.
+ */
+struct ValidationInterfaceQueue {
+    /** The queue of this subscriber alone, unset if it shares the common one */
+    std::unique_ptr<SingleThreadedSchedulerClient> m_own_client;
+    SingleThreadedSchedulerClient* m_client;
+    /** The subscriber, or nullptr if the queue is free to be reused */
+    CValidationInterface* m_subscriber = nullptr;
+    std::string m_name;
+    /** Cleared on unregistering, so callbacks still queued for the subscriber are dropped */
+    std::shared_ptr<std::atomic<bool>> m_active;
+    /** Callbacks queued for this subscriber that have not run yet */
+    std::atomic<size_t> m_pending{0};
+    std::atomic<size_t> m_max_pending{0};
+    std::atomic<uint64_t> m_processed{0};
+
+    ValidationInterfaceQueue(CScheduler *pscheduler, SingleThreadedSchedulerClient* pclient)
+    {
+        if (!pclient) {
+            m_own_client.reset(new SingleThreadedSchedulerClient(pscheduler));
+            pclient = m_own_client.get();
+        }
+        m_client = pclient;
+    }
+};
+
 struct MainSignalsInstance {
-    boost::signals2::signal<void (const CBlockIndex *, const CBlockIndex *, bool fInitialDownload)> UpdatedBlockTip;
-    boost::signals2::signal<void (const CTransactionRef &)> TransactionAddedToMempool;
-    boost::signals2::signal<void (const std::shared_ptr<const CBlock> &, const CBlockIndex *pindex, const std::vector<CTransactionRef>&)> BlockConnected;
-    boost::signals2::signal<void (const std::shared_ptr<const CBlock> &)> BlockDisconnected;
-    boost::signals2::signal<void (const CTransactionRef &)> TransactionRemovedFromMempool;
-    boost::signals2::signal<void (const CBlockLocator &)> ChainStateFlushed;
-    boost::signals2::signal<void (const uint256 &)> Inventory;
     boost::signals2::signal<void (int64_t nBestBlockTime, CConnman* connman)> Broadcast;
     boost::signals2::signal<void (const CBlock&, const CValidationState&)> BlockChecked;
     boost::signals2::signal<void (const CBlockIndex *, const std::shared_ptr<const CBlock>&)> NewPoWValidBlock;
@@ -39,17 +65,76 @@ struct MainSignalsInstance {
 
     // We are not allowed to assume the scheduler only runs in one thread,
     // but must ensure all callbacks happen in-order, so we end up creating
-    // our own queue here :(
+    // our own queues here :(
+    CScheduler *m_pscheduler;
     SingleThreadedSchedulerClient m_schedulerClient;
+    /** Whether every subscriber gets its own queue, or all of them share m_schedulerClient */
+    const bool m_subscriber_queues;
+
+    /**
+     * Queues are never destroyed while the scheduler may still be running
+     * them; the queue of an unregistered subscriber is reused for the next
+     * one to register.
+     */
+    CCriticalSection m_cs_queues;
+    std::vector<std::unique_ptr<ValidationInterfaceQueue>> m_queues;
+
+    MainSignalsInstance(CScheduler *pscheduler, bool subscriber_queues) : m_pscheduler(pscheduler), m_schedulerClient(pscheduler), m_subscriber_queues(subscriber_queues) {}
+
+    ValidationInterfaceQueue* NewQueue()
+    {
+        m_queues.emplace_back(new ValidationInterfaceQueue(m_pscheduler, m_subscriber_queues ? nullptr : &m_schedulerClient));
+        return m_queues.back().get();
+    }
 
-    explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler) {}
+    /** Queue func(subscriber) for every registered subscriber */
+    void Enqueue(const std::function<void (CValidationInterface*)>& func)
+    {
+        LOCK(m_cs_queues);
+        for (const auto& queue : m_queues) {
+            if (!queue->m_subscriber)
+                continue;
+            CValidationInterface* subscriber = queue->m_subscriber;
+            std::shared_ptr<std::atomic<bool>> active = queue->m_active;
+            ValidationInterfaceQueue* pqueue = queue.get();
+            size_t pending = ++queue->m_pending;
+            queue->m_client->AddToProcessQueue([func, subscriber, active, pqueue] {
+                if (*active)
+                    func(subscriber);
+                pqueue->m_pending--;
+                pqueue->m_processed++;
+            });
+            if (pending > queue->m_max_pending)
+                queue->m_max_pending = pending;
+        }
+    }
+
+    /** Call func once every queue has finished what is queued now */
+    void EnqueueBarrier(std::function<void ()> func)
+    {
+        LOCK(m_cs_queues);
+        std::set<SingleThreadedSchedulerClient*> clients{&m_schedulerClient};
+        for (const auto& queue : m_queues) {
+            if (queue->m_subscriber)
+                clients.insert(queue->m_client);
+        }
+        auto remaining = std::make_shared<std::atomic<size_t>>(clients.size());
+        auto pfunc = std::make_shared<std::function<void ()>>(std::move(func));
+        for (SingleThreadedSchedulerClient* client : clients) {
+            client->AddToProcessQueue([remaining, pfunc] {
+                if (--*remaining == 0)
+                    (*pfunc)();
+            });
+        }
+    }
 };
 
 static CMainSignals g_signals;
 
-void CMainSignals::RegisterBackgroundSignalScheduler(CScheduler& scheduler) {
+void CMainSignals::RegisterBackgroundSignalScheduler(CScheduler& scheduler, int nThreads) {
     assert(!m_internals);
-    m_internals.reset(new MainSignalsInstance(&scheduler));
+    // One thread can't run queues in parallel, so separate queues would only lose the order across subscribers
+    m_internals.reset(new MainSignalsInstance(&scheduler, nThreads > 1));
 }
 
 void CMainSignals::UnregisterBackgroundSignalScheduler() {
@@ -59,12 +144,46 @@ void CMainSignals::UnregisterBackgroundSignalScheduler() {
 void CMainSignals::FlushBackgroundCallbacks() {
     if (m_internals) {
         m_internals->m_schedulerClient.EmptyQueue();
+        // Callbacks may take cs_main, so don't run them under m_cs_queues
+        std::set<SingleThreadedSchedulerClient*> clients;
+        {
+            LOCK(m_internals->m_cs_queues);
+            for (const auto& queue : m_internals->m_queues) {
+                clients.insert(queue->m_client);
+            }
+        }
+        for (SingleThreadedSchedulerClient* client : clients) {
+            client->EmptyQueue();
+        }
     }
 }
 
 size_t CMainSignals::CallbacksPending() {
     if (!m_internals) return 0;
-    return m_internals->m_schedulerClient.CallbacksPending();
+    // The deepest queue tells how many events the slowest subscriber is behind
+    size_t pending = m_internals->m_schedulerClient.CallbacksPending();
+    LOCK(m_internals->m_cs_queues);
+    for (const auto& queue : m_internals->m_queues) {
+        pending = std::max(pending, queue->m_pending.load());
+    }
+    return pending;
+}
+
+std::vector<ValidationInterfaceQueueStats> CMainSignals::GetQueueStats() {
+    std::vector<ValidationInterfaceQueueStats> ret;
+    if (!m_internals) return ret;
+    LOCK(m_internals->m_cs_queues);
+    for (const auto& queue : m_internals->m_queues) {
+        if (!queue->m_subscriber)
+            continue;
+        ValidationInterfaceQueueStats stats;
+        stats.name = queue->m_name;
+        stats.pending = queue->m_pending;
+        stats.maxPending = queue->m_max_pending;
+        stats.processed = queue->m_processed;
+        ret.push_back(stats);
+    }
+    return ret;
 }
 
 void CMainSignals::RegisterWithMempoolSignals(CTxMemPool& pool) {
@@ -81,13 +200,28 @@ CMainSignals& GetMainSignals()
 }
 
 void RegisterValidationInterface(CValidationInterface* pwalletIn) {
-    g_signals.m_internals->UpdatedBlockTip.connect(boost::bind(&CValidationInterface::UpdatedBlockTip, pwalletIn, _1, _2, _3));
-    g_signals.m_internals->TransactionAddedToMempool.connect(boost::bind(&CValidationInterface::TransactionAddedToMempool, pwalletIn, _1));
-    g_signals.m_internals->BlockConnected.connect(boost::bind(&CValidationInterface::BlockConnected, pwalletIn, _1, _2, _3));
-    g_signals.m_internals->BlockDisconnected.connect(boost::bind(&CValidationInterface::BlockDisconnected, pwalletIn, _1));
-    g_signals.m_internals->TransactionRemovedFromMempool.connect(boost::bind(&CValidationInterface::TransactionRemovedFromMempool, pwalletIn, _1));
-    g_signals.m_internals->ChainStateFlushed.connect(boost::bind(&CValidationInterface::ChainStateFlushed, pwalletIn, _1));
-    g_signals.m_internals->Inventory.connect(boost::bind(&CValidationInterface::Inventory, pwalletIn, _1));
+    RegisterValidationInterface(pwalletIn, "unnamed");
+}
+
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const std::string& name) {
+    {
+        LOCK(g_signals.m_internals->m_cs_queues);
+        ValidationInterfaceQueue* pqueue = nullptr;
+        for (const auto& queue : g_signals.m_internals->m_queues) {
+            if (!queue->m_subscriber) {
+                pqueue = queue.get();
+                break;
+            }
+        }
+        if (!pqueue) {
+            pqueue = g_signals.m_internals->NewQueue();
+        }
+        pqueue->m_subscriber = pwalletIn;
+        pqueue->m_name = name;
+        pqueue->m_active = std::make_shared<std::atomic<bool>>(true);
+        pqueue->m_max_pending = 0;
+        pqueue->m_processed = 0;
+    }
     g_signals.m_internals->Broadcast.connect(boost::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, _1, _2));
     g_signals.m_internals->BlockChecked.connect(boost::bind(&CValidationInterface::BlockChecked, pwalletIn, _1, _2));
     g_signals.m_internals->NewPoWValidBlock.connect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
@@ -97,15 +231,17 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn) {
 }
 
 void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
+    {
+        LOCK(g_signals.m_internals->m_cs_queues);
+        for (const auto& queue : g_signals.m_internals->m_queues) {
+            if (queue->m_subscriber == pwalletIn) {
+                *queue->m_active = false;
+                queue->m_subscriber = nullptr;
+            }
+        }
+    }
     g_signals.m_internals->BlockChecked.disconnect(boost::bind(&CValidationInterface::BlockChecked, pwalletIn, _1, _2));
     g_signals.m_internals->Broadcast.disconnect(boost::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, _1, _2));
-    g_signals.m_internals->Inventory.disconnect(boost::bind(&CValidationInterface::Inventory, pwalletIn, _1));
-    g_signals.m_internals->ChainStateFlushed.disconnect(boost::bind(&CValidationInterface::ChainStateFlushed, pwalletIn, _1));
-    g_signals.m_internals->TransactionAddedToMempool.disconnect(boost::bind(&CValidationInterface::TransactionAddedToMempool, pwalletIn, _1));
-    g_signals.m_internals->BlockConnected.disconnect(boost::bind(&CValidationInterface::BlockConnected, pwalletIn, _1, _2, _3));
-    g_signals.m_internals->BlockDisconnected.disconnect(boost::bind(&CValidationInterface::BlockDisconnected, pwalletIn, _1));
-    g_signals.m_internals->TransactionRemovedFromMempool.disconnect(boost::bind(&CValidationInterface::TransactionRemovedFromMempool, pwalletIn, _1));
-    g_signals.m_internals->UpdatedBlockTip.disconnect(boost::bind(&CValidationInterface::UpdatedBlockTip, pwalletIn, _1, _2, _3));
     g_signals.m_internals->NewPoWValidBlock.disconnect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
     g_signals.m_internals->NotifyTransactionLock.disconnect(boost::bind(&CValidationInterface::NotifyTransactionLock, pwalletIn, _1));
     g_signals.m_internals->NotifyHeaderTip.disconnect(boost::bind(&CValidationInterface::NotifyHeaderTip, pwalletIn, _1, _2));
@@ -117,15 +253,17 @@ void UnregisterAllValidationInterfaces() {
     if (!g_signals.m_internals) {
         return;
     }
+    {
+        LOCK(g_signals.m_internals->m_cs_queues);
+        for (const auto& queue : g_signals.m_internals->m_queues) {
+            if (queue->m_subscriber) {
+                *queue->m_active = false;
+                queue->m_subscriber = nullptr;
+            }
+        }
+    }
     g_signals.m_internals->BlockChecked.disconnect_all_slots();
     g_signals.m_internals->Broadcast.disconnect_all_slots();
-    g_signals.m_internals->Inventory.disconnect_all_slots();
-    g_signals.m_internals->ChainStateFlushed.disconnect_all_slots();
-    g_signals.m_internals->TransactionAddedToMempool.disconnect_all_slots();
-    g_signals.m_internals->BlockConnected.disconnect_all_slots();
-    g_signals.m_internals->BlockDisconnected.disconnect_all_slots();
-    g_signals.m_internals->TransactionRemovedFromMempool.disconnect_all_slots();
-    g_signals.m_internals->UpdatedBlockTip.disconnect_all_slots();
     g_signals.m_internals->NewPoWValidBlock.disconnect_all_slots();
     g_signals.m_internals->NotifyTransactionLock.disconnect_all_slots();
     g_signals.m_internals->NotifyHeaderTip.disconnect_all_slots();
@@ -133,7 +271,7 @@ void UnregisterAllValidationInterfaces() {
 }
 
 void CallFunctionInValidationInterfaceQueue(std::function<void ()> func) {
-    g_signals.m_internals->m_schedulerClient.AddToProcessQueue(std::move(func));
+    g_signals.m_internals->EnqueueBarrier(std::move(func));
 }
 
 void SyncWithValidationInterfaceQueue() {
@@ -148,8 +286,8 @@ void SyncWithValidationInterfaceQueue() {
 
 void CMainSignals::MempoolEntryRemoved(CTransactionRef ptx, MemPoolRemovalReason reason) {
     if (reason != MemPoolRemovalReason::BLOCK && reason != MemPoolRemovalReason::CONFLICT) {
-        m_internals->m_schedulerClient.AddToProcessQueue([ptx, this] {
-            m_internals->TransactionRemovedFromMempool(ptx);
+        m_internals->Enqueue([ptx](CValidationInterface* subscriber) {
+            subscriber->TransactionRemovedFromMempool(ptx);
         });
     }
 }
@@ -159,38 +297,38 @@ void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockInd
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    m_internals->m_schedulerClient.AddToProcessQueue([pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
+    m_internals->Enqueue([pindexNew, pindexFork, fInitialDownload](CValidationInterface* subscriber) {
+        subscriber->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     });
 }
 
 void CMainSignals::TransactionAddedToMempool(const CTransactionRef &ptx) {
-    m_internals->m_schedulerClient.AddToProcessQueue([ptx, this] {
-        m_internals->TransactionAddedToMempool(ptx);
+    m_internals->Enqueue([ptx](CValidationInterface* subscriber) {
+        subscriber->TransactionAddedToMempool(ptx);
     });
 }
 
 void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex, const std::shared_ptr<const std::vector<CTransactionRef>>& pvtxConflicted) {
-    m_internals->m_schedulerClient.AddToProcessQueue([pblock, pindex, pvtxConflicted, this] {
-        m_internals->BlockConnected(pblock, pindex, *pvtxConflicted);
+    m_internals->Enqueue([pblock, pindex, pvtxConflicted](CValidationInterface* subscriber) {
+        subscriber->BlockConnected(pblock, pindex, *pvtxConflicted);
     });
 }
 
 void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock> &pblock) {
-    m_internals->m_schedulerClient.AddToProcessQueue([pblock, this] {
-        m_internals->BlockDisconnected(pblock);
+    m_internals->Enqueue([pblock](CValidationInterface* subscriber) {
+        subscriber->BlockDisconnected(pblock);
     });
 }
 
 void CMainSignals::ChainStateFlushed(const CBlockLocator &locator) {
-    m_internals->m_schedulerClient.AddToProcessQueue([locator, this] {
-        m_internals->ChainStateFlushed(locator);
+    m_internals->Enqueue([locator](CValidationInterface* subscriber) {
+        subscriber->ChainStateFlushed(locator);
     });
 }
 
 void CMainSignals::Inventory(const uint256 &hash) {
-    m_internals->m_schedulerClient.AddToProcessQueue([hash, this] {
-        m_internals->Inventory(hash);
+    m_internals->Enqueue([hash](CValidationInterface* subscriber) {
+        subscriber->Inventory(hash);
     });
 }
 
@@ -10,6 +10,8 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 class CBlock;
 class CBlockIndex;
@@ -24,10 +26,29 @@ class CScheduler;
 class CTxMemPool;
 enum class MemPoolRemovalReason;
 
+/**
+ * -schedulerthreads default. More threads work off the subscribers' callback
+ * queues in parallel, but also run the scheduleEvery tasks (masternode and
+ * governance maintenance, wallet flush, ...) concurrently with each other.
+ *
+ * Callbacks reach every subscriber in the order they were signalled. Only
+ * with a single scheduler thread, where all subscribers share one queue, is
+ * that order also kept across subscribers: with more threads, one subscriber
+ * may already handle BlockConnected for a block while another is still behind
+ * on an earlier UpdatedBlockTip. The wallet, net_processing, zmq and the
+ * masternode, governance and InstantSend listeners behind dsnotification only
+ * look at their own state in their callbacks, so they don't depend on it.
+ */
+static const int DEFAULT_SCHEDULER_THREADS = 1;
+/** Maximum number of scheduler threads */
+static const int MAX_SCHEDULER_THREADS = 16;
+
 // These functions dispatch to one or all registered wallets
 
 /** Register a wallet to receive updates from core */
 void RegisterValidationInterface(CValidationInterface* pwalletIn);
+/** Register a wallet to receive updates from core, naming its callback queue in getvalidationqueueinfo */
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const std::string& name);
 /** Unregister a wallet from core */
 void UnregisterValidationInterface(CValidationInterface* pwalletIn);
 /** Unregister all wallets from core */
@@ -53,6 +74,18 @@ void CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
  */
 void SyncWithValidationInterfaceQueue();
 
+/** Callback queue depth of one validation interface subscriber */
+struct ValidationInterfaceQueueStats
+{
+    std::string name;
+    /** Callbacks waiting to run */
+    size_t pending;
+    /** Deepest the queue has been since the subscriber registered */
+    size_t maxPending;
+    /** Callbacks run since the subscriber registered */
+    uint64_t processed;
+};
+
 class CValidationInterface {
 protected:
     /**
@@ -135,9 +168,10 @@ protected:
     virtual void NotifyTransactionLock(const CTransactionRef &tx) {}
     virtual void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload) {}
     virtual void AcceptedBlockHeader(const CBlockIndex *pindexNew) {}
-    friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const std::string&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
+    friend class CMainSignals;
 };
 
 struct MainSignalsInstance;
@@ -145,7 +179,7 @@ class CMainSignals {
 private:
     std::unique_ptr<MainSignalsInstance> m_internals;
 
-    friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const std::string&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
     friend void ::CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
@@ -153,14 +187,20 @@ private:
     void MempoolEntryRemoved(CTransactionRef tx, MemPoolRemovalReason reason);
 
 public:
-    /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
-    void RegisterBackgroundSignalScheduler(CScheduler& scheduler);
+    /**
+     * Register a CScheduler to give callbacks which should run in the background (may only be called once).
+     * nThreads is the number of threads running the scheduler; with more than one, every subscriber gets its own queue.
+     */
+    void RegisterBackgroundSignalScheduler(CScheduler& scheduler, int nThreads = 1);
     /** Unregister a CScheduler to give callbacks which should run in the background - these callbacks will now be dropped! */
     void UnregisterBackgroundSignalScheduler();
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Number of callbacks waiting in the deepest subscriber queue */
     size_t CallbacksPending();
+    /** Queue depth of every registered subscriber */
+    std::vector<ValidationInterfaceQueueStats> GetQueueStats();
 
     /** Register with mempool to call TransactionRemovedFromMempool callbacks */
     void RegisterWithMempoolSignals(CTxMemPool& pool);
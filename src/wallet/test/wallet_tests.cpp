@@ -13,7 +13,9 @@
 #include <consensus/validation.h>
 #include <rpc/server.h>
 #include <test/test_xsn.h>
+#include <tpos/tposutils.h>
 #include <validation.h>
+#include <utiltime.h>
 #include <wallet/coincontrol.h>
 #include <wallet/test/wallet_test_fixture.h>
 
@@ -203,12 +205,8 @@ static int64_t AddTx(CWallet& wallet, uint32_t lockTime, int64_t mockTime, int64
     CBlockIndex* block = nullptr;
     if (blockTime > 0) {
         LOCK(cs_main);
-        auto inserted = mapBlockIndex.emplace(GetRandHash(), new CBlockIndex);
-        assert(inserted.second);
-        const uint256& hash = inserted.first->first;
-        block = inserted.first->second;
+        block = InsertBlockIndex(GetRandHash());
         block->nTime = blockTime;
-        block->phashBlock = &hash;
     }
 
     CWalletTx wtx(&wallet, MakeTransactionRef(tx));
@@ -265,6 +263,229 @@ BOOST_AUTO_TEST_CASE(LoadReceiveRequests)
     BOOST_CHECK_EQUAL(values[1], "val_rr1");
 }
 
+BOOST_AUTO_TEST_CASE(tpos_contract_lookups)
+{
+    CKey tposAddressKey;
+    tposAddressKey.MakeNewKey(true);
+    CKey merchantAddressKey;
+    merchantAddressKey.MakeNewKey(true);
+
+    CMutableTransaction tx;
+    std::string strError;
+    BOOST_CHECK(TPoSUtils::CreateTPoSTransaction(tx, tposAddressKey.GetPubKey().GetID(),
+                                                 merchantAddressKey.GetPubKey().GetID(), 1, true, strError));
+    CBasicKeyStore keystore;
+    keystore.AddKeyPubKey(tposAddressKey, tposAddressKey.GetPubKey());
+    auto unsignedContract = TPoSContract::FromTPoSContractTx(MakeTransactionRef(tx));
+    unsignedContract.nVersion = 1;
+    BOOST_CHECK(TPoSUtils::SignTPoSContract(tx, &keystore, unsignedContract));
+
+    CTransactionRef txContract = MakeTransactionRef(tx);
+    auto contract = TPoSContract::FromTPoSContractTx(txContract);
+    BOOST_CHECK(contract.IsValid());
+    COutPoint collateral = TPoSUtils::GetContractCollateralOutpoint(contract);
+    BOOST_CHECK(!collateral.IsNull());
+
+    AddKey(m_wallet, tposAddressKey);
+    LOCK(m_wallet.cs_wallet);
+    BOOST_CHECK(m_wallet.LoadTPoSContract(CWalletTx(&m_wallet, txContract)));
+    // loading it again keeps a single entry
+    BOOST_CHECK(m_wallet.LoadTPoSContract(CWalletTx(&m_wallet, txContract)));
+
+    BOOST_CHECK(m_wallet.IsTPoSOwnerScript(contract.scriptTPoSAddress));
+    BOOST_CHECK(m_wallet.IsLockedCoin(collateral.hash, collateral.n));
+    BOOST_CHECK(!m_wallet.IsTPoSOwnerScript(contract.scriptMerchantAddress));
+    auto byTPoSScript = m_wallet.GetTPoSContractsByTPoSScript(contract.scriptTPoSAddress);
+    BOOST_CHECK_EQUAL(byTPoSScript.size(), 1U);
+    BOOST_CHECK(byTPoSScript.front().txContract->GetHash() == txContract->GetHash());
+    BOOST_CHECK_EQUAL(m_wallet.GetTPoSContractsByMerchantScript(contract.scriptMerchantAddress).size(), 1U);
+
+    BOOST_CHECK(m_wallet.RemoveTPoSContract(txContract->GetHash()));
+    BOOST_CHECK(!m_wallet.IsTPoSOwnerScript(contract.scriptTPoSAddress));
+    BOOST_CHECK(m_wallet.GetTPoSContractsByTPoSScript(contract.scriptTPoSAddress).empty());
+    BOOST_CHECK(m_wallet.GetTPoSContractsByMerchantScript(contract.scriptMerchantAddress).empty());
+}
+
+/** Target most stake candidates meet within a few tries, so every search finds a kernel early on */
+static const unsigned int COINSTAKE_TEST_BITS = 0x1e07ffff;
+
+/**
+ * A merchant wallet on regtest with a chain of headers without blocks on top
+ * of genesis, one every minute up to ten minutes ago, and the time mocked so
+ * that kernel searches are repeatable.
+ */
+class CoinStakeTestingSetup : public WalletTestingSetup
+{
+public:
+    static const int CHAIN_HEIGHT = 200;
+
+    CoinStakeTestingSetup() : WalletTestingSetup(CBaseChainParams::REGTEST), vHashes(CHAIN_HEIGHT), vIndex(CHAIN_HEIGHT)
+    {
+        nMockTime = GetTime();
+        SetMockTime(nMockTime);
+
+        LOCK(cs_main);
+        pindexGenesis = chainActive.Tip();
+        for (int i = 0; i < CHAIN_HEIGHT; i++) {
+            vHashes[i] = GetRandHash();
+            CBlockIndex& index = vIndex[i];
+            index.phashBlock = &vHashes[i];
+            index.pprev = i > 0 ? &vIndex[i - 1] : pindexGenesis;
+            index.nHeight = i + 1;
+            index.nTime = nMockTime - (CHAIN_HEIGHT - i + 9) * 60;
+            index.nBits = pindexGenesis->nBits;
+            index.hashStakeModifierV3 = GetRandHash();
+            index.nStatus = BLOCK_VALID_SCRIPTS;
+            index.BuildSkip();
+            mapBlockIndex.emplace(vHashes[i], &index);
+        }
+        chainActive.SetTip(&vIndex.back());
+    }
+
+    ~CoinStakeTestingSetup()
+    {
+        gArgs.ForceSetArg("-stakerthreads", itostr(DEFAULT_STAKER_THREADS));
+        SetMockTime(0);
+
+        LOCK(cs_main);
+        chainActive.SetTip(pindexGenesis);
+        for (const uint256& hash : vHashes) {
+            mapBlockIndex.erase(hash);
+        }
+    }
+
+    /** A contract of merchantKeyID whose collateral and nCoins coins of 1000 XSN are in the wallet */
+    TPoSContract AddContract(const CKeyID& merchantKeyID, int nCoins)
+    {
+        CKey tposKey;
+        tposKey.MakeNewKey(true);
+        const CScript scriptTPoS = GetScriptForDestination(tposKey.GetPubKey().GetID());
+
+        CMutableTransaction txContract;
+        txContract.vin.emplace_back(COutPoint(GetRandHash(), 0));
+        txContract.vout.emplace_back(1 * COIN, scriptTPoS);
+        TPoSContract contract(MakeTransactionRef(std::move(txContract)), merchantKeyID,
+                              tposKey.GetPubKey().GetID(), 10, std::vector<unsigned char>(65, 1));
+        BOOST_CHECK(contract.IsValid());
+        BOOST_CHECK(TPoSUtils::GetContractCollateralOutpoint(contract) == COutPoint(contract.txContract->GetHash(), 0));
+
+        LOCK(m_wallet.cs_wallet);
+        m_wallet.LoadWatchOnly(scriptTPoS);
+        AddTx(contract.txContract, 10);
+        for (int i = 0; i < nCoins; i++) {
+            CMutableTransaction tx;
+            tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+            tx.vout.emplace_back(1000 * COIN, scriptTPoS);
+            AddTx(MakeTransactionRef(std::move(tx)), 10 + i % 150);
+        }
+        return contract;
+    }
+
+    bool CreateCoinStake(const std::vector<TPoSContract>& vContracts, CMutableTransaction& txNew,
+                         unsigned int& nTxNewTime, TPoSContract& contractRet)
+    {
+        std::vector<const CWalletTx*> vwtxPrev;
+        bool fFound = m_wallet.CreateCoinStake(COINSTAKE_TEST_BITS, 10 * COIN, txNew, nTxNewTime, vContracts, contractRet, vwtxPrev, false);
+        // the merchant does not sign for the owner's coins
+        BOOST_CHECK(vwtxPrev.empty());
+        return fFound;
+    }
+
+private:
+    void AddTx(const CTransactionRef& tx, int nHeight)
+    {
+        CWalletTx wtx(&m_wallet, tx);
+        const CBlockIndex* pindex = chainActive[nHeight];
+        wtx.SetMerkleBranch(pindex, 1);
+        wtx.nTimeReceived = pindex->nTime;
+        m_wallet.LoadToWallet(wtx);
+    }
+
+    int64_t nMockTime;
+    CBlockIndex* pindexGenesis;
+    std::vector<uint256> vHashes;
+    std::vector<CBlockIndex> vIndex;
+};
+
+BOOST_FIXTURE_TEST_CASE(coinstake_tpos_contracts, CoinStakeTestingSetup)
+{
+    CKey merchantKey;
+    merchantKey.MakeNewKey(true);
+    std::vector<TPoSContract> vContracts;
+    std::set<COutPoint> setCollaterals;
+    for (int i = 0; i < 4; i++) {
+        vContracts.push_back(AddContract(merchantKey.GetPubKey().GetID(), MIN_STAKE_COINS_PER_THREAD));
+        setCollaterals.insert(TPoSUtils::GetContractCollateralOutpoint(vContracts.back()));
+    }
+
+    // a single thread searching all contracts at once
+    gArgs.ForceSetArg("-stakerthreads", "1");
+    CMutableTransaction txNew;
+    unsigned int nTxNewTime = 0;
+    TPoSContract contract;
+    BOOST_REQUIRE(CreateCoinStake(vContracts, txNew, nTxNewTime, contract));
+    BOOST_REQUIRE(contract.IsValid());
+    const uint256 hashWinner = contract.txContract->GetHash();
+    const COutPoint prevoutWinner = txNew.vin.at(0).prevout;
+
+    // the contract returned is the one the kernel stakes for, collaterals are never staked
+    BOOST_CHECK(!setCollaterals.count(prevoutWinner));
+    {
+        LOCK(m_wallet.cs_wallet);
+        const CWalletTx* pwtx = m_wallet.GetWalletTx(prevoutWinner.hash);
+        BOOST_REQUIRE(pwtx);
+        BOOST_CHECK(pwtx->tx->vout[prevoutWinner.n].scriptPubKey == contract.scriptTPoSAddress);
+    }
+
+    std::map<uint256, CTPoSStakeStats> mapStats = m_wallet.GetTPoSStakeStats();
+    BOOST_CHECK_EQUAL(mapStats.size(), vContracts.size());
+    for (const TPoSContract& contractIn : vContracts) {
+        const CTPoSStakeStats& stats = mapStats[contractIn.txContract->GetHash()];
+        BOOST_CHECK_EQUAL(stats.nCoins, (int)MIN_STAKE_COINS_PER_THREAD);
+        BOOST_CHECK_EQUAL(stats.nStakeAmount, (CAmount)MIN_STAKE_COINS_PER_THREAD * 1000 * COIN);
+        BOOST_CHECK_EQUAL(stats.nSearches, 1);
+        BOOST_CHECK_EQUAL(stats.nKernelsFound, contractIn.txContract->GetHash() == hashWinner ? 1 : 0);
+    }
+
+    // several threads take the same kernel
+    gArgs.ForceSetArg("-stakerthreads", "4");
+    CMutableTransaction txNewThreads;
+    unsigned int nTxNewTimeThreads = 0;
+    TPoSContract contractThreads;
+    BOOST_REQUIRE(CreateCoinStake(vContracts, txNewThreads, nTxNewTimeThreads, contractThreads));
+    BOOST_CHECK(contractThreads.txContract->GetHash() == hashWinner);
+    BOOST_CHECK(txNewThreads.vin.at(0).prevout == prevoutWinner);
+    BOOST_CHECK_EQUAL(nTxNewTimeThreads, nTxNewTime);
+    BOOST_CHECK(CTransaction(txNewThreads).GetHash() == CTransaction(txNew).GetHash());
+
+    // statistics are kept for the contracts still searched and dropped for the others
+    std::vector<TPoSContract> vContractsLess;
+    uint256 hashDropped;
+    for (const TPoSContract& contractIn : vContracts) {
+        if (hashDropped.IsNull() && contractIn.txContract->GetHash() != hashWinner) {
+            hashDropped = contractIn.txContract->GetHash();
+        } else {
+            vContractsLess.push_back(contractIn);
+        }
+    }
+    BOOST_REQUIRE(CreateCoinStake(vContractsLess, txNew, nTxNewTime, contract));
+    BOOST_CHECK(contract.txContract->GetHash() == hashWinner);
+    BOOST_CHECK(txNew.vin.at(0).prevout == prevoutWinner);
+    mapStats = m_wallet.GetTPoSStakeStats();
+    BOOST_CHECK_EQUAL(mapStats.size(), vContractsLess.size());
+    BOOST_CHECK(!mapStats.count(hashDropped));
+    BOOST_CHECK_EQUAL(mapStats[hashWinner].nSearches, 3);
+    BOOST_CHECK_EQUAL(mapStats[hashWinner].nKernelsFound, 3);
+
+    // a contract searched again starts over
+    BOOST_REQUIRE(CreateCoinStake(vContracts, txNew, nTxNewTime, contract));
+    mapStats = m_wallet.GetTPoSStakeStats();
+    BOOST_CHECK_EQUAL(mapStats.size(), vContracts.size());
+    BOOST_CHECK_EQUAL(mapStats[hashDropped].nSearches, 1);
+    BOOST_CHECK_EQUAL(mapStats[hashDropped].nCoins, (int)MIN_STAKE_COINS_PER_THREAD);
+    BOOST_CHECK_EQUAL(mapStats[hashWinner].nSearches, 4);
+}
+
 class ListCoinsTestingSetup : public TestChain100Setup
 {
 public:
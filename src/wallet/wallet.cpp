@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <future>
+#include <thread>
 
 
 #include <boost/algorithm/string/replace.hpp>
@@ -154,23 +155,19 @@ void CWallet::LoadContractsFromDB()
 {
     LOCK(cs_wallet);
     for (auto &&contractTx : std::move(tposContractsTxLoadedFromDB)) {
+        auto tposContract = TPoSContract::FromTPoSContractTx(contractTx.tx);
+        bool isMerchant = TPoSUtils::IsTPoSMerchantContract(this, tposContract);
         if (!LoadTPoSContract(contractTx)) {
             // if contract was not added, there is a big chance that it's deprecated, let's cleanup watch only address
-            if (TPoSUtils::IsTPoSMerchantContract(this, contractTx.tx)) {
-                auto tposContract = TPoSContract::FromTPoSContractTx(contractTx.tx);
-                if (tposContract.IsValid()) {
-                    auto script = tposContract.scriptTPoSAddress;
-                    if (HaveWatchOnly(script)) {
-                        RemoveWatchOnly(script);
-                    }
+            if (isMerchant && tposContract.IsValid()) {
+                auto script = tposContract.scriptTPoSAddress;
+                if (HaveWatchOnly(script)) {
+                    RemoveWatchOnly(script);
                 }
             }
         } else {
-            if (TPoSUtils::IsTPoSMerchantContract(this, contractTx.tx)) {
-                auto tposContract = TPoSContract::FromTPoSContractTx(contractTx.tx);
-                if (tposContract.IsValid() && !HaveWatchOnly(tposContract.scriptTPoSAddress)) {
-                    AddWatchOnly(tposContract.scriptTPoSAddress);
-                }
+            if (isMerchant && tposContract.IsValid() && !HaveWatchOnly(tposContract.scriptTPoSAddress)) {
+                AddWatchOnly(tposContract.scriptTPoSAddress);
             }
         }
     }
@@ -402,10 +399,11 @@ CAmount GetStakeReward(CAmount blockReward, unsigned int percentage)
     return (blockReward / 100) * percentage;
 }
 
-bool CWallet::CreateCoinStakeKernel(CScript &kernelScript, const CScript &stakeScript, CBlockIndex *pindex,
+bool CWallet::CreateCoinStakeKernel(CScript &kernelScript, const CScript &stakeScript,
+                                    const CStakeModifier &modifier, int64_t nMedianTimePast,
                                     unsigned int nBits, const CBlock &blockFrom, const CTransactionRef &txPrev,
                                     const COutPoint &prevout, unsigned int &nTimeTx,
-                                    const TPoSContract &contract, bool fGenerateSegwit, bool fPrintProofOfStake) const
+                                    const TPoSContract &contract, bool fGenerateSegwit) const
 {
     unsigned int nTryTime = 0;
     uint256 hashProofOfStake;
@@ -432,17 +430,14 @@ bool CWallet::CreateCoinStakeKernel(CScript &kernelScript, const CScript &stakeS
         }
     }
 
-    bool isProofOfStakeV3 = Params().GetConsensus().nPoSUpdgradeHFHeight < pindex->nHeight;
-
-    auto blockFromHash = blockFrom.GetHash();
     auto blockFromTime = blockFrom.GetBlockTime();
     for(unsigned int i = 0; i < nHashDrift; ++i)
     {
         nTryTime = nTimeTx + nHashDrift - i;
-        if (CheckStakeKernelHash(pindex, nBits, blockFromHash, blockFromTime, txPrev, prevout, nTryTime, hashProofOfStake, isProofOfStakeV3, fPrintProofOfStake))
+        if (CheckStakeKernelHash(modifier, nBits, blockFromTime, txPrev->vout[prevout.n].nValue, prevout, nTryTime, hashProofOfStake))
         {
             //Double check that this will pass time requirements
-            if (nTryTime <= chainActive.Tip()->GetMedianTimePast()) {
+            if (nTryTime <= nMedianTimePast) {
                 LogPrintf("CreateCoinStakeKernel() : kernel found, but it is too far in the past \n");
                 continue;
             }
@@ -514,18 +509,8 @@ void CWallet::FillCoinStakePayments(CMutableTransaction &transaction,
 
 bool CWallet::IsTPoSContractSpent(COutPoint outpoint) const
 {
-    TPoSContract contract;
-    for(const auto &container : {tposOwnerContracts, tposMerchantContracts})
-    {
-        auto it = container.find(outpoint.hash);
-        if(it != std::end(container))
-        {
-            contract = it->second;
-            break;
-        }
-    }
-
-    return contract.IsValid() && TPoSUtils::GetContractCollateralOutpoint(contract) == outpoint;
+    LOCK(cs_wallet);
+    return mapTPoSContractsByCollateral.count(outpoint) != 0;
 }
 
 bool CWallet::AddWatchOnly(const CScript& dest, int64_t nCreateTime)
@@ -1516,8 +1501,8 @@ bool CWallet::AddToWalletIfTPoSContract(const CTransactionRef &tx)
         //            return true;
         //        }
         //        else
-        bool isMerchant = TPoSUtils::IsTPoSMerchantContract(this, tx);
-        bool isOwner = TPoSUtils::IsTPoSOwnerContract(this, tx);
+        bool isMerchant = TPoSUtils::IsTPoSMerchantContract(this, contract);
+        bool isOwner = TPoSUtils::IsTPoSOwnerContract(this, contract);
 
         if(isMerchant || isOwner) {
             std::string strError;
@@ -2917,13 +2902,22 @@ bool CWallet::MintableCoins()
 }
 
 bool CWallet::SelectStakeCoins(StakeCoinsSet &setCoins, CAmount nTargetAmount, bool fSelectWitness, const CScript &scriptFilterPubKey) const
+{
+    std::set<CScript> setFilterPubKeys;
+    if(!scriptFilterPubKey.empty())
+        setFilterPubKeys.insert(scriptFilterPubKey);
+
+    return SelectStakeCoins(setCoins, nTargetAmount, fSelectWitness, setFilterPubKeys);
+}
+
+bool CWallet::SelectStakeCoins(StakeCoinsSet &setCoins, CAmount nTargetAmount, bool fSelectWitness, const std::set<CScript> &setFilterPubKeys) const
 {
     std::vector<COutput> vCoins;
     CCoinControl coinControl;
-    coinControl.fAllowWatchOnly = !scriptFilterPubKey.empty();
+    coinControl.fAllowWatchOnly = !setFilterPubKeys.empty();
     {
         LOCK2(cs_main, cs_wallet);
-        AvailableCoins(vCoins, !scriptFilterPubKey.empty(), &coinControl);
+        AvailableCoins(vCoins, !setFilterPubKeys.empty(), &coinControl);
     }
     CAmount nAmountSelected = 0;
 
@@ -2971,7 +2965,7 @@ bool CWallet::SelectStakeCoins(StakeCoinsSet &setCoins, CAmount nTargetAmount, b
 
         auto scriptPubKeyCoin = out.tx->tx->vout[out.i].scriptPubKey;
 
-        if(!scriptFilterPubKey.empty() && scriptPubKeyCoin != scriptFilterPubKey)
+        if(!setFilterPubKeys.empty() && !setFilterPubKeys.count(scriptPubKeyCoin))
             continue;
 
         //        LogPrintf("filtering is good\n");
@@ -2979,15 +2973,9 @@ bool CWallet::SelectStakeCoins(StakeCoinsSet &setCoins, CAmount nTargetAmount, b
         if(rejectCache.count(scriptPubKeyCoin)) {
             continue;
         }
-        else {
-            auto it = std::find_if(std::begin(tposOwnerContracts), std::end(tposOwnerContracts), [scriptPubKeyCoin](const std::pair<uint256, TPoSContract> &entry) {
-                return entry.second.scriptTPoSAddress == scriptPubKeyCoin;
-            });
-
-            if(it != std::end(tposOwnerContracts)) {
-                rejectCache.insert(scriptPubKeyCoin);
-                continue;
-            }
+        else if(IsTPoSOwnerScript(scriptPubKeyCoin)) {
+            rejectCache.insert(scriptPubKeyCoin);
+            continue;
         }
 
         //        LogPrintf("reject is good\n");
@@ -3698,6 +3686,98 @@ bool CWallet::CreateCoinStake(unsigned int nBits,
                               const TPoSContract &tposContract,
                               std::vector<const CWalletTx*> &vwtxPrev,
                               bool fGenerateSegwit)
+{
+    std::vector<TPoSContract> vTPoSContracts;
+    if(tposContract.IsValid())
+        vTPoSContracts.push_back(tposContract);
+
+    TPoSContract tposContractFound;
+    return CreateCoinStake(nBits, blockReward, txNew, nTxNewTime, vTPoSContracts, tposContractFound, vwtxPrev, fGenerateSegwit);
+}
+
+bool CWallet::UpdateStakeCoins(const std::map<uint256, const TPoSContract*> &mapContracts, bool fGenerateSegwit)
+{
+    AssertLockHeld(cs_stake);
+
+    vStakeCoins.clear();
+    setStakeCoinsContracts.clear();
+
+    // coins of a TPoS address shared by several contracts stake for the first of them
+    std::map<CScript, uint256> mapContractsByScript;
+    std::set<CScript> setFilterPubKeys;
+    std::set<COutPoint> setCollaterals;
+    for(const auto &entry : mapContracts) {
+        mapContractsByScript.emplace(entry.second->scriptTPoSAddress, entry.first);
+        setFilterPubKeys.insert(entry.second->scriptTPoSAddress);
+        setCollaterals.insert(TPoSUtils::GetContractCollateralOutpoint(*entry.second));
+    }
+
+    StakeCoinsSet setCoins;
+    if (!SelectStakeCoins(setCoins, GetBalance() /*- nReserveBalance*/, fGenerateSegwit, setFilterPubKeys))
+        return false;
+
+    std::map<uint256, CTPoSStakeStats> mapStats;
+    for(const auto &entry : mapContracts)
+        mapStats[entry.first];
+
+    {
+        LOCK(cs_main);
+        for(const std::pair<const CWalletTx*, unsigned int> &pcoin : setCoins)
+        {
+            COutPoint prevoutStake = COutPoint(pcoin.first->GetHash(), pcoin.second);
+            // this is probably collateral, don't stake it.
+            if(setCollaterals.count(prevoutStake))
+                continue;
+
+            //make sure that enough time has elapsed between
+            BlockMap::iterator it = mapBlockIndex.find(pcoin.first->hashBlock);
+            if (it == mapBlockIndex.end()) {
+                LogPrint(BCLog::KERNEL, "failed to find block index \n");
+                continue;
+            }
+
+            const CTxOut &txout = pcoin.first->tx->vout[pcoin.second];
+            uint256 hashTPoSContract;
+            if(!mapContracts.empty()) {
+                hashTPoSContract = mapContractsByScript.at(txout.scriptPubKey);
+                CTPoSStakeStats &stats = mapStats[hashTPoSContract];
+                ++stats.nCoins;
+                stats.nStakeAmount += txout.nValue;
+            }
+
+            vStakeCoins.push_back(StakeCoin{pcoin.first, pcoin.second, CBlock(it->second->GetBlockHeader()), hashTPoSContract});
+        }
+    }
+
+    {
+        LOCK(cs_tposstakestats);
+        // contracts no longer staked for are dropped with their statistics
+        for(auto &entry : mapStats) {
+            auto it = mapTPoSStakeStats.find(entry.first);
+            if(it != mapTPoSStakeStats.end()) {
+                entry.second.nSearches = it->second.nSearches;
+                entry.second.nKernelsFound = it->second.nKernelsFound;
+                entry.second.nLastKernelTime = it->second.nLastKernelTime;
+            }
+        }
+        mapTPoSStakeStats.swap(mapStats);
+    }
+
+    for(const auto &entry : mapContracts)
+        setStakeCoinsContracts.insert(entry.first);
+    nLastStakeSetUpdate = GetTime();
+
+    return true;
+}
+
+bool CWallet::CreateCoinStake(unsigned int nBits,
+                              CAmount blockReward,
+                              CMutableTransaction &txNew,
+                              unsigned int &nTxNewTime,
+                              const std::vector<TPoSContract> &vTPoSContracts,
+                              TPoSContract &tposContractRet,
+                              std::vector<const CWalletTx*> &vwtxPrev,
+                              bool fGenerateSegwit)
 {
     // The following split & combine thresholds are important to security
     // Should not be adjusted if you don't understand the consequences
@@ -3709,8 +3789,15 @@ bool CWallet::CreateCoinStake(unsigned int nBits,
     CScript scriptEmpty;
     scriptEmpty.clear();
     txNew.vout.push_back(CTxOut(0, scriptEmpty));
-    // Choose coins to use
-    CAmount nBalance = GetBalance();
+
+    std::map<uint256, const TPoSContract*> mapContracts;
+    std::set<uint256> setContracts;
+    for(const TPoSContract &contract : vTPoSContracts) {
+        if(!contract.IsValid())
+            continue;
+        mapContracts.emplace(contract.txContract->GetHash(), &contract);
+        setContracts.insert(contract.txContract->GetHash());
+    }
 
     //    if (mapArgs.count("-reservebalance") && !ParseMoney(mapArgs["-reservebalance"], nReserveBalance))
     //        return error("CreateCoinStake : invalid reserve balance amount");
@@ -3718,75 +3805,102 @@ bool CWallet::CreateCoinStake(unsigned int nBits,
     //    if (nBalance <= nReserveBalance)
     //        return false;
 
-    // presstab HyperStake - Initialize as static and don't update the set on every run of CreateCoinStake() in order to lighten resource use
-    static StakeCoinsSet setStakeCoins;
-    static int nLastStakeSetUpdate = 0;
-
-    bool fIsTPoS = tposContract.IsValid();
-    if (GetTime() - nLastStakeSetUpdate > nStakeSetUpdateTime) {
-        setStakeCoins.clear();
-
-        CScript scriptPubKey;
-        if(fIsTPoS) {
-            scriptPubKey = tposContract.scriptTPoSAddress;
-        }
+    //prevent staking a time that won't be accepted, without holding cs_stake while waiting
+    bool fTipTooRecent;
+    {
+        LOCK(cs_main);
+        fTipTooRecent = GetAdjustedTime() <= chainActive.Tip()->nTime;
+    }
+    if (fTipTooRecent)
+        MilliSleep(10000);
 
-        if (!SelectStakeCoins(setStakeCoins, nBalance /*- nReserveBalance*/, fGenerateSegwit, scriptPubKey)) {
+    // presstab HyperStake - don't update the set on every run of CreateCoinStake() in order to lighten resource use,
+    // the candidates and their block headers are shared by all contracts searched
+    LOCK(cs_stake);
+    if (GetTime() - nLastStakeSetUpdate > nStakeSetUpdateTime || setContracts != setStakeCoinsContracts) {
+        if (!UpdateStakeCoins(mapContracts, fGenerateSegwit)) {
             return error("Failed to select coins for staking");
         }
 
-        LogPrintf("Selected %d coins for staking\n", setStakeCoins.size());
-
-        nLastStakeSetUpdate = GetTime();
+        LogPrintf("Selected %d coins for staking\n", vStakeCoins.size());
     }
 
-    if (setStakeCoins.empty())
+    if (vStakeCoins.empty())
         return error("CreateCoinStake() : No Coins to stake");
 
-    //prevent staking a time that won't be accepted
-    if (GetAdjustedTime() <= chainActive.Tip()->nTime)
-        MilliSleep(10000);
+    // every thread searches every nThreads-th coin and stops at the first kernel found,
+    // the kernel of the coin coming first in vStakeCoins is taken
+    int nThreads = gArgs.GetArg("-stakerthreads", DEFAULT_STAKER_THREADS);
+    if (nThreads <= 0)
+        nThreads = GetNumCores();
+    nThreads = std::max<int>(1, std::min<size_t>(nThreads, vStakeCoins.size() / MIN_STAKE_COINS_PER_THREAD));
 
-    bool fKernelFound = false;
-
-    COutPoint tposContractOutpoint = TPoSUtils::GetContractCollateralOutpoint(tposContract);
-    for(const std::pair<const CWalletTx*, unsigned int> &pcoin : setStakeCoins)
+    struct KernelHit
     {
-        // this is probably collateral, don't stake it.
-        if(pcoin.first->GetHash() == tposContractOutpoint.hash &&
-                pcoin.second == tposContractOutpoint.n)
-            continue;
+        CScript kernelScript;
+        unsigned int nTime;
+    };
+    std::vector<KernelHit> vHits(nThreads);
+    std::atomic<size_t> nFirstHit(vStakeCoins.size());
+    const TPoSContract noContract;
+
+    // The search threads don't take cs_main, what they need of the chain is looked up here
+    int nHeight;
+    int64_t nMedianTimePast;
+    std::vector<CStakeModifier> vModifiers(vStakeCoins.size());
+    std::vector<bool> vHaveModifier(vStakeCoins.size());
+    {
+        LOCK(cs_main);
+        const CBlockIndex *pindexTip = chainActive.Tip();
+        nHeight = pindexTip->nHeight + 1;
+        nMedianTimePast = pindexTip->GetMedianTimePast();
+        bool isProofOfStakeV3 = Params().GetConsensus().nPoSUpdgradeHFHeight < pindexTip->nHeight;
+        for (size_t i = 0; i < vStakeCoins.size(); ++i)
+            vHaveModifier[i] = GetStakeModifier(pindexTip, vStakeCoins[i].blockFrom.GetHash(), isProofOfStakeV3, vModifiers[i]);
+    }
 
-        //make sure that enough time has elapsed between
-        CBlockIndex* pindex = NULL;
-        BlockMap::iterator it = mapBlockIndex.find(pcoin.first->hashBlock);
-        if (it != mapBlockIndex.end())
-            pindex = it->second;
-        else {
-            LogPrint(BCLog::KERNEL, "failed to find block index \n");
-            continue;
+    auto search = [&](int nThread) {
+        for (size_t i = nThread; i < nFirstHit.load(); i += nThreads) {
+            if (!vHaveModifier[i])
+                continue;
+            const StakeCoin &coin = vStakeCoins[i];
+            const TPoSContract &contract = coin.hashTPoSContract.IsNull() ? noContract : *mapContracts.at(coin.hashTPoSContract);
+
+            unsigned int nTime = GetAdjustedTime();
+            //iterates each utxo inside of CheckStakeKernelHash()
+            CScript kernelScript;
+            auto stakeScript = coin.pwtx->tx->vout[coin.n].scriptPubKey;
+            if (CreateCoinStakeKernel(kernelScript, stakeScript, vModifiers[i], nMedianTimePast, nBits,
+                                      coin.blockFrom, coin.pwtx->tx, COutPoint(coin.pwtx->GetHash(), coin.n),
+                                      nTime, contract, fGenerateSegwit)) {
+                vHits[nThread] = KernelHit{kernelScript, nTime};
+                size_t nPrev = nFirstHit.load();
+                while (i < nPrev && !nFirstHit.compare_exchange_weak(nPrev, i)) {}
+                return;
+            }
         }
+    };
 
-        // Read block header
-        CBlockHeader block = pindex->GetBlockHeader();
-        COutPoint prevoutStake = COutPoint(pcoin.first->GetHash(), pcoin.second);
+    // The threads only live for one search. The staker runs a search at most every
+    // few seconds and only spawns threads for wallets with MIN_STAKE_COINS_PER_THREAD
+    // candidates per thread, so creating them costs far less than the search itself.
+    std::vector<std::thread> vThreads;
+    for (int i = 1; i < nThreads; ++i)
+        vThreads.emplace_back(search, i);
+    search(0);
+    for (std::thread &thread : vThreads)
+        thread.join();
 
-        nTxNewTime = GetAdjustedTime();
-        //iterates each utxo inside of CheckStakeKernelHash()
-        CScript kernelScript;
-        auto stakeScript = pcoin.first->tx->vout[pcoin.second].scriptPubKey;
-        fKernelFound = CreateCoinStakeKernel(kernelScript, stakeScript,
-                                             chainActive.Tip(),  nBits,
-                                             block, pcoin.first->tx,
-                                             prevoutStake, nTxNewTime, tposContract, fGenerateSegwit, false);
-
-        if(fKernelFound)
-        {
-            if(!fIsTPoS) // we won't sign in case of tpos block
-                vwtxPrev.push_back(pcoin.first);
-
-            FillCoinStakePayments(txNew, tposContract, kernelScript, prevoutStake, blockReward);
-            break;
+    const size_t nHit = nFirstHit.load();
+    const bool fKernelFound = nHit < vStakeCoins.size();
+    if (!mapContracts.empty()) {
+        LOCK(cs_tposstakestats);
+        for (auto &entry : mapTPoSStakeStats)
+            ++entry.second.nSearches;
+        if (fKernelFound) {
+            CTPoSStakeStats &stats = mapTPoSStakeStats[vStakeCoins[nHit].hashTPoSContract];
+            ++stats.nKernelsFound;
+            stats.nLastKernelTime = GetTime();
         }
     }
 
@@ -3796,13 +3910,22 @@ bool CWallet::CreateCoinStake(unsigned int nBits,
         return false;
     }
 
+    const StakeCoin &coin = vStakeCoins[nHit];
+    const KernelHit &hit = vHits[nHit % nThreads];
+    tposContractRet = coin.hashTPoSContract.IsNull() ? noContract : *mapContracts.at(coin.hashTPoSContract);
+    nTxNewTime = hit.nTime;
+
+    if(!tposContractRet.IsValid()) // we won't sign in case of tpos block
+        vwtxPrev.push_back(coin.pwtx);
+
+    FillCoinStakePayments(txNew, tposContractRet, hit.kernelScript, COutPoint(coin.pwtx->GetHash(), coin.n), blockReward);
+
     // Update coinbase transaction with additional info about masternode and governance payments,
     // get some info back to pass to getblocktemplate
     CTxOut txoutMasternode;
     std::vector<CTxOut> voutSuperblock;
-    int nHeight = chainActive.Tip()->nHeight + 1;
     FillBlockPayments(txNew, nHeight, blockReward, txoutMasternode, voutSuperblock);
-    AdjustMasternodePayment(txNew, txoutMasternode, tposContract);
+    AdjustMasternodePayment(txNew, txoutMasternode, tposContractRet);
     LogPrintf("CreateCoinStake -- nBlockHeight %d blockReward %lld txoutMasternode %s txNew %s",
               nHeight, blockReward, txoutMasternode.ToString(), txNew.ToString());
 
@@ -3810,6 +3933,12 @@ bool CWallet::CreateCoinStake(unsigned int nBits,
     return true;
 }
 
+std::map<uint256, CTPoSStakeStats> CWallet::GetTPoSStakeStats() const
+{
+    LOCK(cs_tposstakestats);
+    return mapTPoSStakeStats;
+}
+
 /**
  * Call after CreateTransaction unless you want to abort
  */
@@ -4544,18 +4673,21 @@ void CWallet::ListLockedCoins(std::vector<COutPoint>& vOutpts) const
 
 bool CWallet::LoadTPoSContract(const CWalletTx &walletTx)
 {
-    bool isMerchant = TPoSUtils::IsTPoSMerchantContract(this, walletTx.tx);
-    bool isOwner = TPoSUtils::IsTPoSOwnerContract(this, walletTx.tx);
+    auto contract = TPoSContract::FromTPoSContractTx(walletTx.tx);
+
+    bool isMerchant = TPoSUtils::IsTPoSMerchantContract(this, contract);
+    bool isOwner = TPoSUtils::IsTPoSOwnerContract(this, contract);
 
     if(!isMerchant && !isOwner)
         return false; // shouldn't happen
 
-    auto contract = TPoSContract::FromTPoSContractTx(walletTx.tx);
     auto txHash = walletTx.GetHash();
 
     if(contract.vchSig.empty())
         return false;
 
+    UnindexTPoSContract(txHash);
+
     if(isMerchant) {
         tposMerchantContracts[txHash] = contract;
     }
@@ -4565,6 +4697,8 @@ bool CWallet::LoadTPoSContract(const CWalletTx &walletTx)
         LockCoin(TPoSUtils::GetContractCollateralOutpoint(contract));
     }
 
+    IndexTPoSContract(txHash, contract);
+
     return true;
 }
 
@@ -4580,6 +4714,8 @@ bool CWallet::RemoveTPoSContract(const uint256 &contractTxId)
     if (!WalletBatch(*database).EraseTPoSContractTx(contractTxId))
         return false;
 
+    UnindexTPoSContract(contractTxId);
+
     if(tposMerchantContracts.count(contractTxId))
         tposMerchantContracts.erase(contractTxId);
 
@@ -4589,6 +4725,99 @@ bool CWallet::RemoveTPoSContract(const uint256 &contractTxId)
     return true;
 }
 
+const TPoSContract *CWallet::FindTPoSContract(const uint256 &contractTxId) const
+{
+    auto it = tposOwnerContracts.find(contractTxId);
+    if(it != tposOwnerContracts.end())
+        return &it->second;
+
+    it = tposMerchantContracts.find(contractTxId);
+    if(it != tposMerchantContracts.end())
+        return &it->second;
+
+    return nullptr;
+}
+
+void CWallet::IndexTPoSContract(const uint256 &contractTxId, const TPoSContract &contract)
+{
+    mapTPoSContractsByTPoSScript[contract.scriptTPoSAddress].insert(contractTxId);
+    mapTPoSContractsByMerchantScript[contract.scriptMerchantAddress].insert(contractTxId);
+
+    auto outpoint = TPoSUtils::GetContractCollateralOutpoint(contract);
+    if(!outpoint.IsNull())
+        mapTPoSContractsByCollateral[outpoint] = contractTxId;
+}
+
+void CWallet::UnindexTPoSContract(const uint256 &contractTxId)
+{
+    const TPoSContract *pcontract = FindTPoSContract(contractTxId);
+    if(!pcontract)
+        return;
+
+    auto eraseFrom = [&contractTxId](std::map<CScript, std::set<uint256>> &mapIndex, const CScript &script) {
+        auto it = mapIndex.find(script);
+        if(it == mapIndex.end())
+            return;
+        it->second.erase(contractTxId);
+        if(it->second.empty())
+            mapIndex.erase(it);
+    };
+    eraseFrom(mapTPoSContractsByTPoSScript, pcontract->scriptTPoSAddress);
+    eraseFrom(mapTPoSContractsByMerchantScript, pcontract->scriptMerchantAddress);
+
+    auto outpoint = TPoSUtils::GetContractCollateralOutpoint(*pcontract);
+    auto it = mapTPoSContractsByCollateral.find(outpoint);
+    if(it != mapTPoSContractsByCollateral.end() && it->second == contractTxId)
+        mapTPoSContractsByCollateral.erase(it);
+}
+
+std::vector<TPoSContract> CWallet::GetTPoSContractsByTPoSScript(const CScript &scriptTPoSAddress) const
+{
+    LOCK(cs_wallet);
+    std::vector<TPoSContract> result;
+    auto it = mapTPoSContractsByTPoSScript.find(scriptTPoSAddress);
+    if(it == mapTPoSContractsByTPoSScript.end())
+        return result;
+
+    for(const auto &container : {&tposOwnerContracts, &tposMerchantContracts}) {
+        for(const uint256 &contractTxId : it->second) {
+            auto itContract = container->find(contractTxId);
+            if(itContract != container->end())
+                result.push_back(itContract->second);
+        }
+    }
+    return result;
+}
+
+std::vector<TPoSContract> CWallet::GetTPoSContractsByMerchantScript(const CScript &scriptMerchantAddress) const
+{
+    LOCK(cs_wallet);
+    std::vector<TPoSContract> result;
+    auto it = mapTPoSContractsByMerchantScript.find(scriptMerchantAddress);
+    if(it == mapTPoSContractsByMerchantScript.end())
+        return result;
+
+    for(const uint256 &contractTxId : it->second) {
+        if(const TPoSContract *pcontract = FindTPoSContract(contractTxId))
+            result.push_back(*pcontract);
+    }
+    return result;
+}
+
+bool CWallet::IsTPoSOwnerScript(const CScript &script) const
+{
+    LOCK(cs_wallet);
+    auto it = mapTPoSContractsByTPoSScript.find(script);
+    if(it == mapTPoSContractsByTPoSScript.end())
+        return false;
+
+    for(const uint256 &contractTxId : it->second) {
+        if(tposOwnerContracts.count(contractTxId))
+            return true;
+    }
+    return false;
+}
+
 /** @} */ // end of Actions
 
 void CWallet::GetKeyBirthTimes(std::map<CTxDestination, int64_t> &mapKeyBirth) const {
@@ -4995,7 +5224,7 @@ CWallet* CWallet::CreateWalletFromFile(const std::string& name, const fs::path&
     }
 
     walletInstance->m_last_block_processed = chainActive.Tip();
-    RegisterValidationInterface(walletInstance);
+    RegisterValidationInterface(walletInstance, "wallet " + walletInstance->GetName());
 
     if (chainActive.Tip() && chainActive.Tip() != pindexRescan)
     {
@@ -8,6 +8,7 @@
 
 #include <amount.h>
 #include <policy/feerate.h>
+#include <primitives/block.h>
 #include <streams.h>
 #include <tinyformat.h>
 #include <ui_interface.h>
@@ -61,6 +62,10 @@ static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 static const bool DEFAULT_WALLET_RBF = false;
 static const bool DEFAULT_WALLETBROADCAST = true;
 static const bool DEFAULT_DISABLE_WALLET = false;
+//! -stakerthreads default, one per core
+static const int DEFAULT_STAKER_THREADS = 0;
+//! Stake candidates a staker thread searches at least, fewer are not worth a thread
+static const size_t MIN_STAKE_COINS_PER_THREAD = 250;
 
 static const int64_t TIMESTAMP_MIN = 0;
 
@@ -74,6 +79,7 @@ class CTxMemPool;
 class CBlockPolicyEstimator;
 class CWalletTx;
 class TPoSContract;
+struct CStakeModifier;
 struct FeeCalculation;
 enum class FeeEstimateMode;
 
@@ -124,6 +130,16 @@ constexpr OutputType DEFAULT_ADDRESS_TYPE{OutputType::LEGACY};
 //! Default for -changetype
 constexpr OutputType DEFAULT_CHANGE_TYPE{OutputType::CHANGE_AUTO};
 
+/** Kernel search statistics of a TPoS contract a merchant stakes for */
+struct CTPoSStakeStats
+{
+    int nCoins = 0;              // coins staking for the contract in the last search
+    CAmount nStakeAmount = 0;    // and their value
+    int64_t nSearches = 0;       // kernel searches the contract took part in
+    int64_t nKernelsFound = 0;
+    int64_t nLastKernelTime = 0;
+};
+
 struct CompactTallyItem
 {
     CTxDestination txdest;
@@ -786,11 +802,12 @@ private:
      */
     const CBlockIndex* m_last_block_processed = nullptr;
 
+    /** Runs on the staker threads without cs_main, the chain state comes with modifier and nMedianTimePast */
     bool CreateCoinStakeKernel(CScript &kernelScript, const CScript &stakeScript,
-                               CBlockIndex *pindex,
+                               const CStakeModifier &modifier, int64_t nMedianTimePast,
                                unsigned int nBits, const CBlock& blockFrom, const CTransactionRef &txPrev,
                                const COutPoint& prevout, unsigned int &nTimeTx,
-                               const TPoSContract &contract, bool fGenerateSegwit, bool fPrintProofOfStake) const;
+                               const TPoSContract &contract, bool fGenerateSegwit) const;
 
     void FillCoinStakePayments(CMutableTransaction &transaction,
                                const TPoSContract &tposContract,
@@ -798,6 +815,37 @@ private:
                                const COutPoint &stakePrevout, CAmount blockReward) const;
 
     bool IsTPoSContractSpent(COutPoint outpoint) const;
+
+    /** A stake candidate with the header of its block, kept across kernel searches */
+    struct StakeCoin
+    {
+        const CWalletTx *pwtx;
+        unsigned int n;
+        CBlock blockFrom;
+        uint256 hashTPoSContract; // contract staking the coin, null for our own coins
+    };
+
+    /** Stake candidates of the contracts in setStakeCoinsContracts, reselected every nStakeSetUpdateTime */
+    CCriticalSection cs_stake;
+    std::vector<StakeCoin> vStakeCoins;
+    std::set<uint256> setStakeCoinsContracts;
+    int64_t nLastStakeSetUpdate = 0;
+    bool UpdateStakeCoins(const std::map<uint256, const TPoSContract*> &mapContracts, bool fGenerateSegwit);
+
+    mutable CCriticalSection cs_tposstakestats;
+    std::map<uint256, CTPoSStakeStats> mapTPoSStakeStats;
+
+    /*
+     * Txids of tposOwnerContracts and tposMerchantContracts by their scripts
+     * and collateral, kept by LoadTPoSContract and RemoveTPoSContract.
+     */
+    std::map<CScript, std::set<uint256>> mapTPoSContractsByTPoSScript;
+    std::map<CScript, std::set<uint256>> mapTPoSContractsByMerchantScript;
+    std::map<COutPoint, uint256> mapTPoSContractsByCollateral;
+    void IndexTPoSContract(const uint256 &contractTxId, const TPoSContract &contract);
+    void UnindexTPoSContract(const uint256 &contractTxId);
+    const TPoSContract *FindTPoSContract(const uint256 &contractTxId) const;
+
     bool GetOutpointAndKeysFromOutput(const COutput& out, COutPoint& outpointRet, CPubKey& pubKeyRet, CKey& keyRet);
     void LoadContractsFromDB();
 
@@ -905,6 +953,7 @@ public:
     using StakeCoinsSet = std::set<std::pair<const CWalletTx*, unsigned int>>;
     bool MintableCoins();
     bool SelectStakeCoins(StakeCoinsSet& setCoins, CAmount nTargetAmount, bool fSelectWitness, const CScript &scriptFilterPubKey = CScript()) const;
+    bool SelectStakeCoins(StakeCoinsSet& setCoins, CAmount nTargetAmount, bool fSelectWitness, const std::set<CScript> &setFilterPubKeys) const;
     bool SelectCoinsGrouppedByAddresses(std::vector<CompactTallyItem>& vecTallyRet, bool fSkipDenominated = true, bool fAnonymizable = true, bool fSkipUnconfirmed = true) const;
 
 #if 0
@@ -929,6 +978,13 @@ public:
     void LoadTPoSContractFromDB(CWalletTx walletTx);
     bool RemoveTPoSContract(const uint256 &contractTxId);
 
+    /** Contracts staking to a TPoS address, owner contracts first */
+    std::vector<TPoSContract> GetTPoSContractsByTPoSScript(const CScript &scriptTPoSAddress) const;
+    /** Contracts paying a merchant address */
+    std::vector<TPoSContract> GetTPoSContractsByMerchantScript(const CScript &scriptMerchantAddress) const;
+    /** Whether coins of this script are staked by an owner contract of ours and not ours to stake */
+    bool IsTPoSOwnerScript(const CScript &script) const;
+
     /*
      * Rescan abort properties
      */
@@ -1042,6 +1098,17 @@ public:
                          CMutableTransaction& txNew, unsigned int& nTxNewTime,
                          const TPoSContract &tposContract, std::vector<const CWalletTx *> &vwtxPrev,
                          bool fGenerateSegwit);
+    /**
+     * Search a kernel among the coins of all given merchant contracts at once,
+     * or among our own coins if there are none. The contract staking the found
+     * kernel is returned in tposContractRet.
+     */
+    bool CreateCoinStake(unsigned int nBits, CAmount blockReward,
+                         CMutableTransaction& txNew, unsigned int& nTxNewTime,
+                         const std::vector<TPoSContract> &vTPoSContracts, TPoSContract &tposContractRet,
+                         std::vector<const CWalletTx *> &vwtxPrev, bool fGenerateSegwit);
+    /** Kernel search statistics of the merchant contracts staked for, by contract txid */
+    std::map<uint256, CTPoSStakeStats> GetTPoSStakeStats() const;
     bool CommitTransaction(CTransactionRef tx, mapValue_t mapValue, std::vector<std::pair<std::string, std::string>> orderForm, std::string fromAccount, CReserveKey& reservekey, CConnman* connman, CValidationState& state);
 
     void ListAccountCreditDebit(const std::string& strAccount, std::list<CAccountingEntry>& entries);
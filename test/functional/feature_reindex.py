@@ -7,6 +7,7 @@
 - Start a single node and generate 3 blocks.
 - Stop the node and restart it with -reindex. Verify that the node has reindexed up to block 3.
 - Stop the node and restart it with -reindex-chainstate. Verify that the node has reindexed up to block 3.
+- Repeat -reindex with block files read on the import thread only and with several reader threads.
 """
 
 from test_framework.test_framework import XSNTestFramework
@@ -18,11 +19,11 @@ class ReindexTest(XSNTestFramework):
         self.setup_clean_chain = True
         self.num_nodes = 1
 
-    def reindex(self, justchainstate=False):
+    def reindex(self, justchainstate=False, loadblockthreads=0):
         self.nodes[0].generate(3)
         blockcount = self.nodes[0].getblockcount()
         self.stop_nodes()
-        extra_args = [["-reindex-chainstate" if justchainstate else "-reindex", "-checkblockindex=1"]]
+        extra_args = [["-reindex-chainstate" if justchainstate else "-reindex", "-checkblockindex=1", "-loadblockthreads=%d" % loadblockthreads]]
         self.start_nodes(extra_args)
         wait_until(lambda: self.nodes[0].getblockcount() == blockcount)
         self.log.info("Success")
@@ -32,6 +33,8 @@ class ReindexTest(XSNTestFramework):
         self.reindex(True)
         self.reindex(False)
         self.reindex(True)
+        self.reindex(False, loadblockthreads=1)
+        self.reindex(False, loadblockthreads=4)
 
 if __name__ == '__main__':
     ReindexTest().main()
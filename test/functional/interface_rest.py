@@ -26,6 +26,7 @@ class ReqType(Enum):
     JSON = 1
     BIN = 2
     HEX = 3
+    TEXT = 4
 
 class RetType(Enum):
     OBJ = 1
@@ -51,6 +52,8 @@ class RESTTest (XSNTestFramework):
             rest_uri += '.bin'
         elif req_type == ReqType.HEX:
             rest_uri += '.hex'
+        elif req_type == ReqType.TEXT:
+            rest_uri += '.txt'
 
         conn = http.client.HTTPConnection(self.url.hostname, self.url.port)
         self.log.debug('%s %s %s', http_method, rest_uri, body)
@@ -296,5 +299,14 @@ class RESTTest (XSNTestFramework):
         json_obj = self.test_rest_request("/chaininfo")
         assert_equal(json_obj['bestblockhash'], bb_hash)
 
+        self.log.info("Test the /perfstats URI")
+
+        perf_stats = self.nodes[0].getperfstats("connectblock.")
+        assert_greater_than(perf_stats['connectblock.checks']['count'], 0)
+        text = self.test_rest_request("/perfstats", req_type=ReqType.TEXT, ret_type=RetType.BYTES).decode('utf-8')
+        assert '# TYPE xsn_perf_seconds histogram' in text
+        assert 'xsn_perf_seconds_count{name="connectblock.checks"}' in text
+        self.test_rest_request("/perfstats", status=404, ret_type=RetType.OBJ)
+
 if __name__ == '__main__':
     RESTTest().main()